@@ -72,6 +72,27 @@ typedef enum _cups_uatokens_e		/**** UserAgentTokens values */
   _CUPS_UATOKENS_FULL			/* CUPS/major.minor.patch (osname osversion; architecture) IPP/2.1 */
 } _cups_uatokens_t;
 
+typedef enum _cups_stats_io_e		/**** I/O statistics counters ****/
+{
+  _CUPS_STATS_HTTP_CONNECT,		/* HTTP connections */
+  _CUPS_STATS_HTTP_READ,		/* HTTP socket/TLS reads */
+  _CUPS_STATS_HTTP_WRITE,		/* HTTP socket/TLS writes */
+  _CUPS_STATS_IPP_READ,			/* IPP messages read */
+  _CUPS_STATS_IPP_WRITE,		/* IPP messages written */
+  _CUPS_STATS_IO_MAX			/* Number of I/O counters */
+} _cups_stats_io_t;
+
+typedef enum _cups_stats_time_e		/**** Latency statistics histograms ****/
+{
+  _CUPS_STATS_HTTP_UPDATE,		/* httpUpdate */
+  _CUPS_STATS_HTTP_WAIT,		/* httpWait */
+  _CUPS_STATS_TLS_HANDSHAKE,		/* TLS handshake */
+  _CUPS_STATS_TIME_MAX			/* Number of histograms */
+} _cups_stats_time_t;
+
+typedef struct _cups_stats_s _cups_stats_t;
+					/**** Per-thread statistics ****/
+
 typedef struct _cups_globals_s		/**** CUPS global state data ****/
 {
   /* Multiple places... */
@@ -91,6 +112,7 @@ typedef struct _cups_globals_s		/**** CUPS global state data ****/
   /* debug.c */
 #  ifdef DEBUG
   int			thread_id;	/* Friendly thread ID */
+  void			*debug_trace;	/* Trace ring buffer for thread */
 #  endif /* DEBUG */
 
   /* file.c */
@@ -140,6 +162,10 @@ typedef struct _cups_globals_s		/**** CUPS global state data ****/
   ipp_status_t		last_error;	/* Last IPP error */
   char			*last_status_message;
 					/* Last IPP status-message */
+  bool			response_arena;	/* Read responses into arena messages? */
+
+  /* stats.c */
+  _cups_stats_t		*stats;		/* HTTP/IPP statistics for thread */
 
   /* tempfile.c */
   char			tempfile[1024];	/* cupsTempFd/File buffer */
@@ -226,6 +252,14 @@ struct _cups_dinfo_s			/* Destination capability and status
 };
 
 
+/*
+ * Globals...
+ */
+
+extern bool		_cups_stats_enabled _CUPS_INTERNAL;
+					/* Are statistics being collected? */
+
+
 /*
  * Prototypes...
  */
@@ -253,6 +287,11 @@ extern _cups_globals_t	*_cupsGlobals(void) _CUPS_PRIVATE;
 extern void		_cupsSetDefaults(void) _CUPS_INTERNAL;
 extern void		_cupsSetError(ipp_status_t status, const char *message, int localize) _CUPS_PRIVATE;
 extern void		_cupsSetHTTPError(http_status_t status) _CUPS_INTERNAL;
+extern void		_cupsStatsAddIO(_cups_stats_io_t io, size_t count, size_t bytes, size_t items) _CUPS_INTERNAL;
+extern void		_cupsStatsAddRequest(ipp_op_t op, double start) _CUPS_INTERNAL;
+extern void		_cupsStatsAddTime(_cups_stats_time_t t, double start) _CUPS_INTERNAL;
+extern double		_cupsStatsGetTime(void) _CUPS_INTERNAL;
+extern void		_cupsStatsRelease(_cups_stats_t *stats) _CUPS_INTERNAL;
 
 
 #  ifdef __cplusplus
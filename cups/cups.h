@@ -13,6 +13,7 @@
 #  define _CUPS_CUPS_H_
 #  include "file.h"
 #  include "ipp.h"
+#  include "json.h"
 #  include "language.h"
 #  include "pwg.h"
 #  ifdef __cplusplus
@@ -276,6 +277,7 @@ extern size_t		cupsAddOption(const char *name, const char *value, size_t num_opt
 
 extern ipp_status_t	cupsCancelDestJob(http_t *http, cups_dest_t *dest, int job_id) _CUPS_PUBLIC;
 extern bool		cupsCheckDestSupported(http_t *http, cups_dest_t *dest, cups_dinfo_t *info, const char *option, const char *value) _CUPS_PUBLIC;
+extern void		cupsClearDestInfoCache(const char *uri) _CUPS_PUBLIC;
 extern ipp_status_t	cupsCloseDestJob(http_t *http, cups_dest_t *dest, cups_dinfo_t *info, int job_id) _CUPS_PUBLIC;
 extern size_t		cupsConcatString(char *dst, const char *src, size_t dstsize) _CUPS_PUBLIC;
 extern http_t		*cupsConnectDest(cups_dest_t *dest, unsigned flags, int msec, int *cancel, char *resource, size_t resourcesize, cups_dest_cb_t cb, void *user_data) _CUPS_PUBLIC;
@@ -314,6 +316,7 @@ extern cups_dest_t	*cupsGetDestWithURI(const char *name, const char *uri) _CUPS_
 extern size_t		cupsGetDests(http_t *http, cups_dest_t **dests) _CUPS_PUBLIC;
 extern http_encryption_t cupsGetEncryption(void) _CUPS_PUBLIC;
 extern http_status_t	cupsGetFd(http_t *http, const char *resource, int fd) _CUPS_PUBLIC;
+extern http_status_t	cupsGetFdRange(http_t *http, const char *resource, int fd, off_t offset, off_t length, size_t num_connections) _CUPS_PUBLIC;
 extern http_status_t	cupsGetFile(http_t *http, const char *resource, const char *filename) _CUPS_PUBLIC;
 extern int		cupsGetIntegerOption(const char *name, size_t num_options, cups_option_t *options) _CUPS_PUBLIC;
 extern size_t		cupsGetJobs(http_t *http, cups_job_t **jobs, const char *name, bool myjobs, cups_whichjobs_t whichjobs) _CUPS_PUBLIC;
@@ -323,6 +326,7 @@ extern const char	*cupsGetPassword(const char *prompt, http_t *http, const char
 extern unsigned		cupsGetRand(void) _CUPS_PUBLIC;
 extern ipp_t		*cupsGetResponse(http_t *http, const char *resource) _CUPS_PUBLIC;
 extern const char	*cupsGetServer(void) _CUPS_PUBLIC;
+extern cups_json_t	*cupsGetStatistics(void) _CUPS_PUBLIC;
 extern const char	*cupsGetUser(void) _CUPS_PUBLIC;
 extern const char	*cupsGetUserAgent(void) _CUPS_PUBLIC;
 
@@ -353,12 +357,15 @@ extern void		cupsSetOAuthCB(cups_oauth_cb_t cb, void *data) _CUPS_PUBLIC;
 extern void		cupsSetClientCertCB(cups_client_cert_cb_t cb, void *user_data) _CUPS_PUBLIC;
 extern bool		cupsSetCredentials(cups_array_t *certs) _CUPS_PUBLIC;
 extern void		cupsSetDefaultDest(const char *name, const char *instance, size_t num_dests, cups_dest_t *dests) _CUPS_PUBLIC;
+extern void		cupsSetDestInfoCacheTTL(int ttl) _CUPS_PUBLIC;
 extern bool		cupsSetDests(http_t *http, size_t num_dests, cups_dest_t *dests) _CUPS_PUBLIC;
 extern void		cupsSetEncryption(http_encryption_t e) _CUPS_PUBLIC;
 extern void		cupsSetPasswordCB(cups_password_cb_t cb, void *user_data) _CUPS_PUBLIC;
+extern void		cupsSetResponseArena(bool enable) _CUPS_PUBLIC;
 extern void		cupsSetServer(const char *server) _CUPS_PUBLIC;
 extern void		cupsSetServerCertCB(cups_server_cert_cb_t cb, void *user_data) _CUPS_PUBLIC;
 extern int		cupsSetServerCredentials(const char *path, const char *common_name, int auto_create) _CUPS_PUBLIC;
+extern void		cupsSetStatistics(bool enable) _CUPS_PUBLIC;
 extern void		cupsSetUser(const char *user) _CUPS_PUBLIC;
 extern void		cupsSetUserAgent(const char *user_agent) _CUPS_PUBLIC;
 extern http_status_t	cupsStartDestDocument(http_t *http, cups_dest_t *dest, cups_dinfo_t *info, int job_id, const char *docname, const char *format, size_t num_options, cups_option_t *options, bool last_document) _CUPS_PUBLIC;
@@ -366,6 +373,7 @@ extern int		cupsTempFd(const char *prefix, const char *suffix, char *filename, s
 extern cups_file_t	*cupsTempFile(const char *prefix, const char *suffix, char *filename, size_t len) _CUPS_PUBLIC;
 
 extern http_status_t	cupsWriteRequestData(http_t *http, const char *buffer, size_t length) _CUPS_PUBLIC;
+extern http_status_t	cupsWriteRequestFd(http_t *http, int fd, off_t length) _CUPS_PUBLIC;
 
 
 #  ifdef __cplusplus
@@ -56,6 +56,27 @@ extern "C" {
 #  endif /* DEBUG */
 
 
+/*
+ * Binary trace files (CUPS_DEBUG_TRACE) start with the 8-byte magic string
+ * "CUPSTRC1" followed by fixed-size records in the native byte order of the
+ * traced process.  Use the "debugtrace" program to decode them.
+ */
+
+#  define _CUPS_TRACE_MAGIC	"CUPSTRC1"
+					/* Magic string at start of trace file */
+#  define _CUPS_TRACE_MESSAGE	112	/* Size of message in trace record */
+
+typedef struct _cups_trace_rec_s	/**** Trace record ****/
+{
+  uint64_t	time;			/* Time in microseconds since the epoch */
+  uint32_t	thread;			/* Friendly thread ID */
+  uint16_t	level;			/* Log level (0 to 9) */
+  uint16_t	length;			/* Length of message */
+  char		message[_CUPS_TRACE_MESSAGE];
+					/* Message (not nul-terminated) */
+} _cups_trace_rec_t;
+
+
 /*
  * Prototypes...
  */
@@ -65,6 +86,7 @@ extern int	_cups_debug_fd _CUPS_INTERNAL;
 extern int	_cups_debug_level _CUPS_INTERNAL;
 extern void	_cups_debug_printf(const char *format, ...) _CUPS_FORMAT(1,2) _CUPS_INTERNAL;
 extern void	_cups_debug_puts(const char *s) _CUPS_INTERNAL;
+extern void	_cups_debug_trace_release(void *ring) _CUPS_INTERNAL;
 #  endif /* DEBUG */
 
 
@@ -36,9 +36,39 @@ _cups_gettimeofday(struct timeval *tv,	/* I  - Timeval struct */
 #endif /* _WIN32 */
 #include <regex.h>
 #include <fcntl.h>
+#if defined(DEBUG) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#  include <stdatomic.h>
+#  define _CUPS_DEBUG_TRACE 1		/* Binary tracing is supported */
+#endif /* DEBUG && C11 atomics */
 
 
 #ifdef DEBUG
+/*
+ * Local constants...
+ */
+
+#  define _CUPS_TRACE_RECORDS	1024	/* Records per thread, power of 2 */
+
+
+#  ifdef _CUPS_DEBUG_TRACE
+/*
+ * Local types...
+ */
+
+typedef struct _cups_trace_ring_s	/**** Per-thread trace ring buffer ****/
+{
+  struct _cups_trace_ring_s *next;	/* Next ring buffer */
+  int			thread;		/* Friendly thread ID */
+  atomic_size_t		head,		/* Next record to write (owning thread) */
+			tail,		/* Next record to flush (flush thread) */
+			dropped;	/* Number of records dropped */
+  atomic_bool		done;		/* Has the owning thread exited? */
+  _cups_trace_rec_t	records[_CUPS_TRACE_RECORDS];
+					/* Records */
+} _cups_trace_ring_t;
+#  endif /* _CUPS_DEBUG_TRACE */
+
+
 /*
  * Globals...
  */
@@ -60,6 +90,27 @@ static cups_mutex_t	debug_init_mutex = CUPS_MUTEX_INITIALIZER,
 					/* Mutex to control initialization */
 			debug_log_mutex = CUPS_MUTEX_INITIALIZER;
 					/* Mutex to serialize log entries */
+static int		debug_trace_fd = -1;
+					/* Binary trace file descriptor */
+#  ifdef _CUPS_DEBUG_TRACE
+static cups_mutex_t	debug_trace_mutex = CUPS_MUTEX_INITIALIZER;
+					/* Mutex for ring buffer list */
+static cups_cond_t	debug_trace_cond = CUPS_COND_INITIALIZER;
+					/* Condition for flush thread */
+static _cups_trace_ring_t *debug_trace_rings = NULL;
+					/* Ring buffers */
+
+
+/*
+ * Local functions...
+ */
+
+static _cups_trace_rec_t	*debug_trace_begin(_cups_trace_ring_t **ring, int level);
+static void		debug_trace_end(_cups_trace_ring_t *ring, _cups_trace_rec_t *rec, size_t length);
+static void		debug_trace_exit(void);
+static void		debug_trace_flush(void);
+static void		*debug_trace_thread(void *data);
+#  endif /* _CUPS_DEBUG_TRACE */
 
 
 /*
@@ -99,7 +150,7 @@ _cups_debug_printf(const char *format,	/* I - Printf-style format string */
     _cups_debug_set(getenv("CUPS_DEBUG_LOG"), getenv("CUPS_DEBUG_LEVEL"),
                     getenv("CUPS_DEBUG_FILTER"), 0);
 
-  if (_cups_debug_fd < 0)
+  if (_cups_debug_fd < 0 && debug_trace_fd < 0)
     return;
 
  /*
@@ -114,6 +165,26 @@ _cups_debug_printf(const char *format,	/* I - Printf-style format string */
   if (level > _cups_debug_level)
     return;
 
+#  ifdef _CUPS_DEBUG_TRACE
+  if (debug_trace_fd >= 0)
+  {
+    _cups_trace_ring_t	*ring;		/* Ring buffer */
+    _cups_trace_rec_t	*rec;		/* Trace record */
+
+    if ((rec = debug_trace_begin(&ring, level)) != NULL)
+    {
+      va_start(ap, format);
+      bytes = _cups_safe_vsnprintf(rec->message, sizeof(rec->message), format, ap);
+      va_end(ap);
+
+      debug_trace_end(ring, rec, bytes < 0 ? 0 : (size_t)bytes);
+    }
+  }
+#  endif /* _CUPS_DEBUG_TRACE */
+
+  if (_cups_debug_fd < 0)
+    return;
+
   if (debug_filter)
   {
     int	result;				/* Filter result */
@@ -182,7 +253,7 @@ _cups_debug_puts(const char *s)		/* I - String to output */
     _cups_debug_set(getenv("CUPS_DEBUG_LOG"), getenv("CUPS_DEBUG_LEVEL"),
                     getenv("CUPS_DEBUG_FILTER"), 0);
 
-  if (_cups_debug_fd < 0)
+  if (_cups_debug_fd < 0 && debug_trace_fd < 0)
     return;
 
  /*
@@ -197,6 +268,23 @@ _cups_debug_puts(const char *s)		/* I - String to output */
   if (level > _cups_debug_level)
     return;
 
+#  ifdef _CUPS_DEBUG_TRACE
+  if (debug_trace_fd >= 0)
+  {
+    _cups_trace_ring_t	*ring;		/* Ring buffer */
+    _cups_trace_rec_t	*rec;		/* Trace record */
+
+    if ((rec = debug_trace_begin(&ring, level)) != NULL)
+    {
+      cupsCopyString(rec->message, s, sizeof(rec->message));
+      debug_trace_end(ring, rec, strlen(rec->message));
+    }
+  }
+#  endif /* _CUPS_DEBUG_TRACE */
+
+  if (_cups_debug_fd < 0)
+    return;
+
   if (debug_filter)
   {
     int	result;				/* Filter result */
@@ -310,6 +398,37 @@ _cups_debug_set(const char *logfile,	/* I - Log file or NULL */
       }
     }
 
+#  ifdef _CUPS_DEBUG_TRACE
+    const char	*tracefile;		/* Trace file */
+
+    if (!debug_init && (tracefile = getenv("CUPS_DEBUG_TRACE")) != NULL)
+    {
+     /*
+      * Start binary tracing - messages are recorded in per-thread ring
+      * buffers and written to the trace file by a separate thread...
+      */
+
+      char		buffer[1024];	/* Filename buffer */
+      cups_thread_t	thread;		/* Flush thread */
+
+      snprintf(buffer, sizeof(buffer), tracefile, getpid());
+
+      if ((debug_trace_fd = open(buffer, O_WRONLY | O_TRUNC | O_CREAT, 0644)) >= 0)
+      {
+        if (write(debug_trace_fd, _CUPS_TRACE_MAGIC, 8) != 8 || (thread = cupsThreadCreate((cups_thread_func_t)debug_trace_thread, NULL)) == CUPS_THREAD_INVALID)
+        {
+          close(debug_trace_fd);
+          debug_trace_fd = -1;
+        }
+        else
+        {
+          cupsThreadDetach(thread);
+          atexit(debug_trace_exit);
+        }
+      }
+    }
+#  endif /* _CUPS_DEBUG_TRACE */
+
     debug_init = 1;
   }
 
@@ -317,6 +436,237 @@ _cups_debug_set(const char *logfile,	/* I - Log file or NULL */
 }
 
 
+/*
+ * '_cups_debug_trace_release()' - Release the trace ring buffer of an exiting
+ *                                 thread.
+ *
+ * The ring buffer is freed by the flush thread once it has been written.
+ */
+
+void
+_cups_debug_trace_release(void *ring)	/* I - Ring buffer or `NULL` */
+{
+#  ifdef _CUPS_DEBUG_TRACE
+  if (ring)
+    atomic_store_explicit(&((_cups_trace_ring_t *)ring)->done, true, memory_order_release);
+#  else
+  (void)ring;
+#  endif /* _CUPS_DEBUG_TRACE */
+}
+
+
+#  ifdef _CUPS_DEBUG_TRACE
+/*
+ * 'debug_trace_begin()' - Start a new trace record for the current thread.
+ *
+ * Returns `NULL` if the ring buffer is full - the record is counted as dropped
+ * rather than blocking the thread.
+ */
+
+static _cups_trace_rec_t *		/* O - Trace record or `NULL` */
+debug_trace_begin(
+    _cups_trace_ring_t **ring,		/* O - Ring buffer */
+    int                level)		/* I - Log level */
+{
+  _cups_globals_t	*cg = _cupsGlobals();
+					/* Global data */
+  _cups_trace_ring_t	*r;		/* Ring buffer */
+  _cups_trace_rec_t	*rec;		/* Trace record */
+  size_t		head;		/* Next record */
+  struct timeval	curtime;	/* Current time */
+
+
+  if ((r = (_cups_trace_ring_t *)cg->debug_trace) == NULL)
+  {
+   /*
+    * First message from this thread, allocate and register a ring buffer...
+    */
+
+    if ((r = calloc(1, sizeof(_cups_trace_ring_t))) == NULL)
+      return (NULL);
+
+    r->thread = cg->thread_id;
+
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->dropped, 0);
+    atomic_init(&r->done, false);
+
+    cupsMutexLock(&debug_trace_mutex);
+    r->next           = debug_trace_rings;
+    debug_trace_rings = r;
+    cupsMutexUnlock(&debug_trace_mutex);
+
+    cg->debug_trace = r;
+  }
+
+  head = atomic_load_explicit(&r->head, memory_order_relaxed);
+
+  if ((head - atomic_load_explicit(&r->tail, memory_order_acquire)) >= _CUPS_TRACE_RECORDS)
+  {
+    atomic_fetch_add_explicit(&r->dropped, 1, memory_order_relaxed);
+    return (NULL);
+  }
+
+  gettimeofday(&curtime, NULL);
+
+  rec         = r->records + (head & (_CUPS_TRACE_RECORDS - 1));
+  rec->time   = (uint64_t)curtime.tv_sec * 1000000 + (uint64_t)curtime.tv_usec;
+  rec->thread = (uint32_t)r->thread;
+  rec->level  = (uint16_t)level;
+
+  *ring = r;
+
+  return (rec);
+}
+
+
+/*
+ * 'debug_trace_end()' - Finish a trace record and make it visible to the flush
+ *                       thread.
+ *
+ * The flush thread is woken up early when the ring buffer becomes half full.
+ */
+
+static void
+debug_trace_end(
+    _cups_trace_ring_t *ring,		/* I - Ring buffer */
+    _cups_trace_rec_t  *rec,		/* I - Trace record */
+    size_t             length)		/* I - Length of message */
+{
+  size_t	head;			/* New head of ring buffer */
+
+
+  if (length >= sizeof(rec->message))
+    length = sizeof(rec->message) - 1;
+
+  rec->length = (uint16_t)length;
+
+  head = atomic_load_explicit(&ring->head, memory_order_relaxed) + 1;
+  atomic_store_explicit(&ring->head, head, memory_order_release);
+
+  if ((head - atomic_load_explicit(&ring->tail, memory_order_relaxed)) == (_CUPS_TRACE_RECORDS / 2))
+    cupsCondBroadcast(&debug_trace_cond);
+}
+
+
+/*
+ * 'debug_trace_exit()' - Write any remaining trace records at exit.
+ */
+
+static void
+debug_trace_exit(void)
+{
+  cupsMutexLock(&debug_trace_mutex);
+  debug_trace_flush();
+  cupsMutexUnlock(&debug_trace_mutex);
+}
+
+
+/*
+ * 'debug_trace_flush()' - Write pending trace records to the trace file.
+ *
+ * The caller must hold the trace mutex.
+ */
+
+static void
+debug_trace_flush(void)
+{
+  _cups_trace_ring_t	*ring,		/* Current ring buffer */
+			*prev,		/* Previous ring buffer */
+			*next;		/* Next ring buffer */
+  size_t		head,		/* Next record to be written */
+			tail,		/* Next record to flush */
+			count,		/* Number of records to write */
+			dropped;	/* Number of dropped records */
+  bool			done;		/* Has the thread exited? */
+  _cups_trace_rec_t	rec;		/* Dropped records record */
+  struct timeval	curtime;	/* Current time */
+
+
+  for (ring = debug_trace_rings, prev = NULL; ring; ring = next)
+  {
+    next = ring->next;
+    done = atomic_load_explicit(&ring->done, memory_order_acquire);
+    head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+   /*
+    * Write the records in (at most) two contiguous chunks...
+    */
+
+    while (tail < head)
+    {
+      if ((count = head - tail) > (_CUPS_TRACE_RECORDS - (tail & (_CUPS_TRACE_RECORDS - 1))))
+        count = _CUPS_TRACE_RECORDS - (tail & (_CUPS_TRACE_RECORDS - 1));
+
+      write(debug_trace_fd, ring->records + (tail & (_CUPS_TRACE_RECORDS - 1)), count * sizeof(_cups_trace_rec_t));
+      tail += count;
+    }
+
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+    if ((dropped = atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed)) > 0)
+    {
+     /*
+      * Note that messages were dropped because the ring buffer was full...
+      */
+
+      gettimeofday(&curtime, NULL);
+
+      memset(&rec, 0, sizeof(rec));
+      rec.time   = (uint64_t)curtime.tv_sec * 1000000 + (uint64_t)curtime.tv_usec;
+      rec.thread = (uint32_t)ring->thread;
+      rec.length = (uint16_t)snprintf(rec.message, sizeof(rec.message), "(%u messages dropped)", (unsigned)dropped);
+
+      write(debug_trace_fd, &rec, sizeof(rec));
+    }
+
+    if (done)
+    {
+     /*
+      * The thread has exited, free its ring buffer...
+      */
+
+      if (prev)
+        prev->next = next;
+      else
+        debug_trace_rings = next;
+
+      free(ring);
+    }
+    else
+    {
+      prev = ring;
+    }
+  }
+}
+
+
+/*
+ * 'debug_trace_thread()' - Periodically write trace records to the trace file.
+ */
+
+static void *				/* O - Thread exit status (not used) */
+debug_trace_thread(void *data)		/* I - Thread data (not used) */
+{
+  (void)data;
+
+  cupsMutexLock(&debug_trace_mutex);
+
+  while (debug_trace_fd >= 0)
+  {
+    cupsCondWait(&debug_trace_cond, &debug_trace_mutex, 0.1);
+    debug_trace_flush();
+  }
+
+  cupsMutexUnlock(&debug_trace_mutex);
+
+  return (NULL);
+}
+#  endif /* _CUPS_DEBUG_TRACE */
+
+
 #else
 /*
  * '_cups_debug_set()' - Enable or disable debug logging.
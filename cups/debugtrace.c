@@ -0,0 +1,215 @@
+/*
+ * Debug trace decoder program for CUPS.
+ *
+ * Copyright © 2022 by OpenPrinting.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ *
+ * Usage:
+ *
+ *   ./debugtrace [-l level] [-f regex] [-t thread] trace-file ...
+ */
+
+/*
+ * Include necessary headers...
+ */
+
+#include "cups-private.h"
+#include <regex.h>
+
+
+/*
+ * Local functions...
+ */
+
+static int	compare_recs(_cups_trace_rec_t *a, _cups_trace_rec_t *b);
+static void	usage(void) _CUPS_NORETURN;
+
+
+/*
+ * 'main()' - Decode binary trace files written using CUPS_DEBUG_TRACE.
+ */
+
+int					/* O - Exit status */
+main(int  argc,				/* I - Number of command-line arguments */
+     char *argv[])			/* I - Command-line arguments */
+{
+  int			i;		/* Looping var */
+  const char		*opt;		/* Current option */
+  int			level = 9,	/* Maximum log level */
+			thread = 0;	/* Thread to show or 0 for all */
+  regex_t		filter;		/* Filter expression */
+  bool			have_filter = false;
+					/* Have a filter expression? */
+  cups_file_t		*fp;		/* Trace file */
+  char			magic[8];	/* Magic string */
+  _cups_trace_rec_t	*recs = NULL,	/* Trace records */
+			*rec;		/* Current record */
+  size_t		num_recs = 0,	/* Number of records */
+			alloc_recs = 0;	/* Allocated records */
+  ssize_t		bytes;		/* Bytes read */
+  char			message[_CUPS_TRACE_MESSAGE + 1];
+					/* Message string */
+  time_t		secs;		/* Seconds */
+
+
+ /*
+  * Parse command-line...
+  */
+
+  for (i = 1; i < argc; i ++)
+  {
+    if (argv[i][0] == '-' && argv[i][1])
+    {
+      for (opt = argv[i] + 1; *opt; opt ++)
+      {
+        switch (*opt)
+        {
+          case 'f' : /* -f regex */
+              i ++;
+              if (i >= argc || have_filter)
+                usage();
+
+              if (regcomp(&filter, argv[i], REG_EXTENDED | REG_NOSUB))
+              {
+                fprintf(stderr, "debugtrace: Bad regular expression \"%s\".\n", argv[i]);
+                return (1);
+              }
+
+              have_filter = true;
+              break;
+
+          case 'l' : /* -l level */
+              i ++;
+              if (i >= argc || !isdigit(argv[i][0] & 255))
+                usage();
+
+              level = atoi(argv[i]);
+              break;
+
+          case 't' : /* -t thread */
+              i ++;
+              if (i >= argc || !isdigit(argv[i][0] & 255))
+                usage();
+
+              thread = atoi(argv[i]);
+              break;
+
+          default :
+              usage();
+        }
+      }
+    }
+    else if ((fp = cupsFileOpen(argv[i], "rm")) == NULL)
+    {
+      fprintf(stderr, "debugtrace: Unable to open \"%s\": %s\n", argv[i], strerror(errno));
+      return (1);
+    }
+    else
+    {
+     /*
+      * Load the records from this file...
+      */
+
+      if (cupsFileRead(fp, magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, _CUPS_TRACE_MAGIC, sizeof(magic)))
+      {
+        fprintf(stderr, "debugtrace: \"%s\" is not a trace file.\n", argv[i]);
+        cupsFileClose(fp);
+        return (1);
+      }
+
+      for (;;)
+      {
+        if (num_recs >= alloc_recs)
+        {
+          alloc_recs += 65536;
+
+          if ((rec = realloc(recs, alloc_recs * sizeof(_cups_trace_rec_t))) == NULL)
+          {
+            fputs("debugtrace: Out of memory.\n", stderr);
+            return (1);
+          }
+
+          recs = rec;
+        }
+
+        if ((bytes = cupsFileRead(fp, (char *)(recs + num_recs), sizeof(_cups_trace_rec_t))) <= 0)
+          break;
+        else if (bytes != sizeof(_cups_trace_rec_t))
+        {
+          fprintf(stderr, "debugtrace: \"%s\" is truncated.\n", argv[i]);
+          break;
+        }
+
+        if (recs[num_recs].level <= level && (!thread || recs[num_recs].thread == (uint32_t)thread))
+          num_recs ++;
+      }
+
+      cupsFileClose(fp);
+    }
+  }
+
+  if (!recs)
+    usage();
+
+ /*
+  * Records are written one thread at a time, so sort them by time and show
+  * them in the same format as CUPS_DEBUG_LOG...
+  */
+
+  qsort(recs, num_recs, sizeof(_cups_trace_rec_t), (int (*)(const void *, const void *))compare_recs);
+
+  for (rec = recs; rec < (recs + num_recs); rec ++)
+  {
+    memcpy(message, rec->message, rec->length < _CUPS_TRACE_MESSAGE ? rec->length : _CUPS_TRACE_MESSAGE);
+    message[rec->length < _CUPS_TRACE_MESSAGE ? rec->length : _CUPS_TRACE_MESSAGE] = '\0';
+
+    if (have_filter && regexec(&filter, message, 0, NULL, 0))
+      continue;
+
+    secs = (time_t)(rec->time / 1000000);
+
+    printf("T%03u %02d:%02d:%02d.%06u  %s\n", (unsigned)rec->thread, (int)((secs / 3600) % 24), (int)((secs / 60) % 60), (int)(secs % 60), (unsigned)(rec->time % 1000000), message);
+  }
+
+  free(recs);
+
+  if (have_filter)
+    regfree(&filter);
+
+  return (0);
+}
+
+
+/*
+ * 'compare_recs()' - Compare the times of two trace records.
+ */
+
+static int				/* O - Result of comparison */
+compare_recs(_cups_trace_rec_t *a,	/* I - First record */
+             _cups_trace_rec_t *b)	/* I - Second record */
+{
+  if (a->time < b->time)
+    return (-1);
+  else if (a->time > b->time)
+    return (1);
+  else if (a->thread < b->thread)
+    return (-1);
+  else if (a->thread > b->thread)
+    return (1);
+  else
+    return (a < b ? -1 : a > b);
+}
+
+
+/*
+ * 'usage()' - Show program usage.
+ */
+
+static void
+usage(void)
+{
+  puts("Usage: ./debugtrace [-l level] [-f regex] [-t thread] trace-file ...");
+  exit(1);
+}
@@ -21,6 +21,23 @@
  */
 
 #define _CUPS_MEDIA_READY_TTL	30	/* Life of xxx-ready values */
+#define _CUPS_DCACHE_MAX	32	/* Maximum number of cached destinations */
+
+
+/*
+ * Local types...
+ */
+
+typedef struct _cups_dcache_s		/* Cached destination information */
+{
+  char		*uri;			/* Printer URI */
+  time_t	validated;		/* When the information was last validated */
+  bool		has_time,		/* Have printer-config-change-time? */
+		has_date;		/* Have printer-config-change-date-time? */
+  int		config_time;		/* printer-config-change-time value */
+  ipp_uchar_t	config_date[11];	/* printer-config-change-date-time value */
+  cups_dinfo_t	*dinfo;			/* Destination information */
+} _cups_dcache_t;
 
 
 /*
@@ -30,20 +47,36 @@
 static void		cups_add_dconstres(cups_array_t *a, ipp_t *collection);
 static bool		cups_collection_contains(ipp_t *test, ipp_t *match);
 static size_t		cups_collection_string(ipp_attribute_t *attr, char *buffer, size_t bufsize) _CUPS_NONNULL((1,2));
+static int		cups_compare_dcache(_cups_dcache_t *a, _cups_dcache_t *b, void *data);
 static int		cups_compare_dconstres(_cups_dconstres_t *a, _cups_dconstres_t *b);
 static int		cups_compare_media_db(_cups_media_db_t *a, _cups_media_db_t *b);
+static cups_dinfo_t	*cups_copy_dinfo(cups_dinfo_t *src, const char *uri);
 static _cups_media_db_t	*cups_copy_media_db(_cups_media_db_t *mdb);
 static void		cups_create_cached(http_t *http, cups_dinfo_t *dinfo, unsigned flags);
 static void		cups_create_constraints(cups_dinfo_t *dinfo);
 static void		cups_create_defaults(cups_dinfo_t *dinfo);
 static void		cups_create_media_db(cups_dinfo_t *dinfo, unsigned flags);
+static void		cups_free_dcache(_cups_dcache_t *dc, void *data);
 static void		cups_free_media_db(_cups_media_db_t *mdb);
+static cups_dinfo_t	*cups_get_dcache(http_t *http, const char *uri, const char *resource);
 static bool		cups_get_media_db(http_t *http, cups_dinfo_t *dinfo, pwg_media_t *pwg, unsigned flags, cups_size_t *size);
 static bool		cups_is_close_media_db(_cups_media_db_t *a, _cups_media_db_t *b);
+static void		cups_put_dcache(cups_dinfo_t *dinfo);
 static cups_array_t	*cups_test_constraints(cups_dinfo_t *dinfo, const char *new_option, const char *new_value, size_t num_options, cups_option_t *options, size_t *num_conflicts, cups_option_t **conflicts);
 static void		cups_update_ready(http_t *http, cups_dinfo_t *dinfo);
 
 
+/*
+ * Local globals...
+ */
+
+static cups_mutex_t	dcache_mutex = CUPS_MUTEX_INITIALIZER;
+					/* Mutex for destination information cache */
+static cups_array_t	*dcache = NULL;	/* Cached destination information */
+static int		dcache_ttl = 0;
+					/* Life of cached destination information */
+
+
 /*
  * 'cupsAddDestMediaOptions()' - Add the option corresponding to the specified media size.
  */
@@ -352,6 +385,42 @@ cupsCheckDestSupported(
 }
 
 
+/*
+ * 'cupsClearDestInfoCache()' - Clear cached destination information.
+ *
+ * This function removes the cached capabilities for the printer URI "uri", or
+ * all cached capabilities when "uri" is `NULL`, so that the next call to
+ * @link cupsCopyDestInfo@ queries the printer again.
+ */
+
+void
+cupsClearDestInfoCache(const char *uri)	/* I - Printer URI or `NULL` for all */
+{
+  _cups_dcache_t	key,		/* Search key */
+			*dc;		/* Matching entry */
+
+
+  DEBUG_printf(("cupsClearDestInfoCache(uri=\"%s\")", uri));
+
+  cupsMutexLock(&dcache_mutex);
+
+  if (!uri)
+  {
+    cupsArrayDelete(dcache);
+    dcache = NULL;
+  }
+  else
+  {
+    key.uri = (char *)uri;
+
+    if ((dc = (_cups_dcache_t *)cupsArrayFind(dcache, &key)) != NULL)
+      cupsArrayRemove(dcache, dc);
+  }
+
+  cupsMutexUnlock(&dcache_mutex);
+}
+
+
 /*
  * 'cupsCopyDestConflicts()' - Get conflicts and resolutions for a new
  *                             option/value pair.
@@ -657,6 +726,9 @@ cupsCopyDestConflicts(
  *
  * The caller is responsible for calling @link cupsFreeDestInfo@ on the return
  * value. @code NULL@ is returned on error.
+ *
+ * The supported values are cached for the current process - see
+ * @link cupsSetDestInfoCacheTTL@ and @link cupsClearDestInfoCache@ for details.
  */
 
 cups_dinfo_t *				/* O - Destination information */
@@ -730,6 +802,16 @@ cupsCopyDestInfo(
     return (NULL);
   }
 
+ /*
+  * Use the cached supported attributes if they are still valid...
+  */
+
+  if ((dinfo = cups_get_dcache(http, uri, resource)) != NULL)
+  {
+    DEBUG_printf(("1cupsCopyDestInfo: Using cached information, version=%d, uri=\"%s\", resource=\"%s\".", dinfo->version, uri, resource));
+    return (dinfo);
+  }
+
  /*
   * Get the supported attributes...
   */
@@ -807,6 +889,8 @@ cupsCopyDestInfo(
   dinfo->resource = _cupsStrAlloc(resource);
   dinfo->attrs    = response;
 
+  cups_put_dcache(dinfo);
+
   return (dinfo);
 }
 
@@ -1335,6 +1419,37 @@ cupsGetDestMediaDefault(
 }
 
 
+/*
+ * 'cupsSetDestInfoCacheTTL()' - Set how long destination information is cached.
+ *
+ * @link cupsCopyDestInfo@ caches the capabilities of each printer for the
+ * current process.  Cached capabilities are reused for "ttl" seconds, after
+ * which they are revalidated using the "printer-config-change-time" and
+ * "printer-config-change-date-time" attributes before being used again.
+ *
+ * Caching is disabled by default.  A "ttl" value of `0` disables (and clears)
+ * the cache.
+ */
+
+void
+cupsSetDestInfoCacheTTL(int ttl)	/* I - Time-to-live in seconds or `0` to disable */
+{
+  DEBUG_printf(("cupsSetDestInfoCacheTTL(ttl=%d)", ttl));
+
+  cupsMutexLock(&dcache_mutex);
+
+  if ((dcache_ttl = ttl) <= 0)
+  {
+    dcache_ttl = 0;
+
+    cupsArrayDelete(dcache);
+    dcache = NULL;
+  }
+
+  cupsMutexUnlock(&dcache_mutex);
+}
+
+
 /*
  * 'cups_add_dconstres()' - Add a constraint or resolver to an array.
  */
@@ -1703,6 +1818,22 @@ cups_collection_string(
 }
 
 
+/*
+ * 'cups_compare_dcache()' - Compare two cached destination information entries.
+ */
+
+static int				/* O - Result of comparison */
+cups_compare_dcache(
+    _cups_dcache_t *a,			/* I - First entry */
+    _cups_dcache_t *b,			/* I - Second entry */
+    void           *data)		/* I - Callback data (unused) */
+{
+  (void)data;
+
+  return (strcmp(a->uri, b->uri));
+}
+
+
 /*
  * 'cups_compare_dconstres()' - Compare to resolver entries.
  */
@@ -1735,6 +1866,45 @@ cups_compare_media_db(
 }
 
 
+/*
+ * 'cups_copy_dinfo()' - Copy destination information.
+ *
+ * The printer attributes and media database are copied so that the new
+ * destination information can be used independently of the original.
+ */
+
+static cups_dinfo_t *			/* O - New destination information */
+cups_copy_dinfo(cups_dinfo_t *src,	/* I - Destination information */
+                const char   *uri)	/* I - Printer URI */
+{
+  cups_dinfo_t	*dinfo;			/* New destination information */
+
+
+  if ((dinfo = calloc(1, sizeof(cups_dinfo_t))) == NULL)
+    return (NULL);
+
+  dinfo->version  = src->version;
+  dinfo->uri      = uri;
+  dinfo->resource = _cupsStrAlloc(src->resource);
+  dinfo->attrs    = ippNew();
+
+  if (!ippCopyAttributes(dinfo->attrs, src->attrs, false, NULL, NULL))
+  {
+    cupsFreeDestInfo(dinfo);
+    return (NULL);
+  }
+
+  if (src->media_db)
+  {
+    dinfo->media_db = cupsArrayDup(src->media_db);
+    dinfo->min_size = src->min_size;
+    dinfo->max_size = src->max_size;
+  }
+
+  return (dinfo);
+}
+
+
 /*
  * 'cups_copy_media_db()' - Copy a media entry.
  */
@@ -2219,6 +2389,22 @@ cups_create_media_db(
 }
 
 
+/*
+ * 'cups_free_dcache()' - Free a cached destination information entry.
+ */
+
+static void
+cups_free_dcache(_cups_dcache_t *dc,	/* I - Cache entry */
+                 void           *data)	/* I - Callback data (unused) */
+{
+  (void)data;
+
+  free(dc->uri);
+  cupsFreeDestInfo(dc->dinfo);
+  free(dc);
+}
+
+
 /*
  * 'cups_free_media_cb()' - Free a media entry.
  */
@@ -2244,6 +2430,124 @@ cups_free_media_db(
 }
 
 
+/*
+ * 'cups_get_dcache()' - Get a copy of the cached destination information.
+ *
+ * Cached information older than the TTL is revalidated with a small
+ * Get-Printer-Attributes request for the configuration change time.  `NULL`
+ * is returned if there is no valid cached information.
+ */
+
+static cups_dinfo_t *			/* O - Destination information or `NULL` */
+cups_get_dcache(http_t     *http,	/* I - Connection to destination */
+                const char *uri,	/* I - Printer URI */
+                const char *resource)	/* I - Resource path */
+{
+  _cups_dcache_t	key,		/* Search key */
+			*dc;		/* Matching entry */
+  cups_dinfo_t		*dinfo = NULL;	/* Destination information */
+  time_t		curtime,	/* Current time */
+			validated;	/* Time of last validation */
+  int			version,	/* IPP version */
+			config_time;	/* printer-config-change-time value */
+  bool			has_time,	/* Have printer-config-change-time? */
+			has_date,	/* Have printer-config-change-date-time? */
+			valid = false;	/* Is the cached information valid? */
+  ipp_uchar_t		config_date[11];/* printer-config-change-date-time value */
+  ipp_t			*request,	/* Get-Printer-Attributes request */
+			*response;	/* Configuration change times */
+  ipp_attribute_t	*attr;		/* Attribute */
+  static const char * const requested_attrs[] =
+  {					/* Requested attributes */
+    "printer-config-change-date-time",
+    "printer-config-change-time"
+  };
+
+
+  key.uri = (char *)uri;
+  curtime = time(NULL);
+
+  cupsMutexLock(&dcache_mutex);
+
+  if ((dc = (_cups_dcache_t *)cupsArrayFind(dcache, &key)) == NULL)
+  {
+    cupsMutexUnlock(&dcache_mutex);
+    return (NULL);
+  }
+
+  if ((curtime - dc->validated) < dcache_ttl)
+  {
+    DEBUG_printf(("4cups_get_dcache: Using cached information for \"%s\".", uri));
+
+    dinfo = cups_copy_dinfo(dc->dinfo, uri);
+
+    cupsMutexUnlock(&dcache_mutex);
+    return (dinfo);
+  }
+
+  version     = dc->dinfo->version;
+  validated   = dc->validated;
+  config_time = dc->config_time;
+  has_time    = dc->has_time;
+  has_date    = dc->has_date;
+
+  memcpy(config_date, dc->config_date, sizeof(config_date));
+
+  cupsMutexUnlock(&dcache_mutex);
+
+ /*
+  * Ask the printer whether its configuration has changed...
+  */
+
+  if (has_time || has_date)
+  {
+    DEBUG_printf(("4cups_get_dcache: Validating cached information for \"%s\".", uri));
+
+    request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
+
+    ippSetVersion(request, version / 10, version % 10);
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, uri);
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME, "requesting-user-name", NULL, cupsGetUser());
+    ippAddStrings(request, IPP_TAG_OPERATION, IPP_TAG_KEYWORD, "requested-attributes", (int)(sizeof(requested_attrs) / sizeof(requested_attrs[0])), NULL, requested_attrs);
+
+    response = cupsDoRequest(http, request, resource);
+    valid    = cupsLastError() <= IPP_STATUS_OK_IGNORED_OR_SUBSTITUTED;
+
+    if (valid && has_time)
+      valid = (attr = ippFindAttribute(response, "printer-config-change-time", IPP_TAG_INTEGER)) != NULL && ippGetInteger(attr, 0) == config_time;
+
+    if (valid && has_date)
+      valid = (attr = ippFindAttribute(response, "printer-config-change-date-time", IPP_TAG_DATE)) != NULL && !memcmp(ippGetDate(attr, 0), config_date, sizeof(config_date));
+
+    ippDelete(response);
+  }
+
+ /*
+  * Update or remove the entry, unless another thread has already replaced it...
+  */
+
+  cupsMutexLock(&dcache_mutex);
+
+  if ((dc = (_cups_dcache_t *)cupsArrayFind(dcache, &key)) != NULL && dc->validated == validated)
+  {
+    if (valid)
+    {
+      dc->validated = curtime;
+      dinfo         = cups_copy_dinfo(dc->dinfo, uri);
+    }
+    else
+    {
+      DEBUG_printf(("4cups_get_dcache: Cached information for \"%s\" is out of date.", uri));
+      cupsArrayRemove(dcache, dc);
+    }
+  }
+
+  cupsMutexUnlock(&dcache_mutex);
+
+  return (dinfo);
+}
+
+
 /*
  * 'cups_get_media_db()' - Lookup the media entry for a given size.
  */
@@ -2531,6 +2835,98 @@ cups_is_close_media_db(
 }
 
 
+/*
+ * 'cups_put_dcache()' - Add destination information to the cache.
+ */
+
+static void
+cups_put_dcache(cups_dinfo_t *dinfo)	/* I - Destination information */
+{
+  _cups_dcache_t	*dc,		/* New entry */
+			*current,	/* Current entry */
+			*oldest;	/* Oldest entry */
+  ipp_attribute_t	*attr;		/* Attribute */
+  int			ttl;		/* Cache time-to-live */
+
+
+  cupsMutexLock(&dcache_mutex);
+  ttl = dcache_ttl;
+  cupsMutexUnlock(&dcache_mutex);
+
+  if (ttl <= 0)
+    return;
+
+ /*
+  * Create the new entry with its own copy of the information and media
+  * database...
+  */
+
+  if ((dc = (_cups_dcache_t *)calloc(1, sizeof(_cups_dcache_t))) == NULL)
+    return;
+
+  if ((dc->uri = strdup(dinfo->uri)) == NULL || (dc->dinfo = cups_copy_dinfo(dinfo, NULL)) == NULL)
+  {
+    cups_free_dcache(dc, NULL);
+    return;
+  }
+
+  cups_create_media_db(dc->dinfo, CUPS_MEDIA_FLAGS_DEFAULT);
+
+  dc->validated = time(NULL);
+
+  if ((attr = ippFindAttribute(dinfo->attrs, "printer-config-change-time", IPP_TAG_INTEGER)) != NULL)
+  {
+    dc->has_time    = true;
+    dc->config_time = ippGetInteger(attr, 0);
+  }
+
+  if ((attr = ippFindAttribute(dinfo->attrs, "printer-config-change-date-time", IPP_TAG_DATE)) != NULL)
+  {
+    dc->has_date = true;
+    memcpy(dc->config_date, ippGetDate(attr, 0), sizeof(dc->config_date));
+  }
+
+ /*
+  * Replace any existing entry and make room as needed...
+  */
+
+  cupsMutexLock(&dcache_mutex);
+
+  if (dcache_ttl <= 0)
+  {
+   /*
+    * The cache was disabled while we were copying the information...
+    */
+
+    cupsMutexUnlock(&dcache_mutex);
+    cups_free_dcache(dc, NULL);
+    return;
+  }
+
+  if (!dcache)
+    dcache = cupsArrayNew((cups_array_cb_t)cups_compare_dcache, NULL, NULL, 0, NULL, (cups_afree_cb_t)cups_free_dcache);
+
+  if ((current = (_cups_dcache_t *)cupsArrayFind(dcache, dc)) != NULL)
+    cupsArrayRemove(dcache, current);
+
+  if (cupsArrayGetCount(dcache) >= _CUPS_DCACHE_MAX)
+  {
+    for (oldest = current = (_cups_dcache_t *)cupsArrayGetFirst(dcache); current; current = (_cups_dcache_t *)cupsArrayGetNext(dcache))
+    {
+      if (current->validated < oldest->validated)
+        oldest = current;
+    }
+
+    cupsArrayRemove(dcache, oldest);
+  }
+
+  if (!cupsArrayAdd(dcache, dc))
+    cups_free_dcache(dc, NULL);
+
+  cupsMutexUnlock(&dcache_mutex);
+}
+
+
 /*
  * 'cups_test_constraints()' - Test constraints.
  */
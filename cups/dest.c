@@ -47,6 +47,7 @@
 
 #define _CUPS_DNSSD_GET_DESTS 250     /* Milliseconds for cupsGetDests */
 #define _CUPS_DNSSD_MAXTIME	50	/* Milliseconds for maximum quantum of time */
+#define _CUPS_DNSSD_EXPIRE	300	/* Seconds to keep services that went away */
 
 
 /*
@@ -63,10 +64,37 @@ typedef enum _cups_dnssd_state_e	/* Enumerated device state */
   _CUPS_DNSSD_ERROR
 } _cups_dnssd_state_t;
 
+typedef struct _cups_dnssd_cache_s	/* Shared DNS-SD browse cache */
+{
+  cups_mutex_t		mutex;		/* Mutex for services */
+  cups_cond_t		cond;		/* Condition for changes */
+  cups_dnssd_t		*dnssd;		/* DNS-SD context */
+  cups_array_t		*services;	/* Services, sorted by full name */
+  unsigned		generation;	/* Generation, incremented on each change */
+#ifndef _WIN32
+  pid_t			pid;		/* Process that owns the browses */
+#endif /* !_WIN32 */
+} _cups_dnssd_cache_t;
+
+typedef struct _cups_dnssd_entry_s	/* Cached DNS-SD service */
+{
+  _cups_dnssd_cache_t	*cache;		/* Browse cache */
+  char			*name,		/* Service name */
+			*regtype,	/* Registration type */
+			*domain,	/* Domain name */
+			*fullname;	/* Full name for query */
+  int			refs;		/* Number of interfaces reporting service */
+  time_t		removed;	/* Time when the service went away */
+  cups_dnssd_query_t	*query;		/* TXT query */
+  bool			error;		/* Did the query fail? */
+  uint8_t		*txt;		/* TXT record, if any */
+  uint16_t		txtlen;		/* Length of TXT record */
+} _cups_dnssd_entry_t;
+
 typedef struct _cups_dnssd_data_s	/* Enumeration data */
 {
   cups_rwlock_t		rwlock;		/* Reader/writer lock */
-  cups_dnssd_t		*dnssd;		/* DNS-SD context */
+  unsigned		generation;	/* Cache generation last seen */
   cups_dest_cb_t	cb;		/* Callback */
   void			*user_data;	/* User data pointer */
   cups_ptype_t		type,		/* Printer type filter */
@@ -81,7 +109,7 @@ typedef struct _cups_dnssd_data_s	/* Enumeration data */
 typedef struct _cups_dnssd_device_s	/* Enumerated device */
 {
   _cups_dnssd_state_t	state;		/* State of device listing */
-  cups_dnssd_query_t	*query;		/* DNS-SD query request */
+  bool			local;		/* Local queue for this device? */
   char			*fullname,	/* Full name */
 			*regtype,	/* Registration type */
 			*domain;	/* Domain name */
@@ -127,8 +155,14 @@ static CFStringRef	appleGetPrinter(CFArrayRef locations, CFStringRef network, CF
 static cups_dest_t	*cups_add_dest(const char *name, const char *instance, size_t *num_dests, cups_dest_t **dests);
 static int		cups_compare_dests(cups_dest_t *a, cups_dest_t *b);
 static void		cups_dest_browse_cb(cups_dnssd_browse_t *browse, void *cb_data, cups_dnssd_flags_t flags, uint32_t if_index, const char *name, const char *regtype, const char *domain);
+static _cups_dnssd_cache_t *cups_dnssd_cache_get(void);
+static void		cups_dnssd_cache_query_cb(cups_dnssd_query_t *query, void *cb_data, cups_dnssd_flags_t flags, uint32_t if_index, const char *fullname, uint16_t rrtype, const void *qdata, uint16_t qlen);
+static void		cups_dnssd_cache_sync(_cups_dnssd_cache_t *cache, _cups_dnssd_data_t *data);
+static void		cups_dnssd_cache_wait(_cups_dnssd_cache_t *cache, _cups_dnssd_data_t *data, int msec);
 static int		cups_dnssd_compare_devices(_cups_dnssd_device_t *a, _cups_dnssd_device_t *b);
+static int		cups_dnssd_compare_entries(_cups_dnssd_entry_t *a, _cups_dnssd_entry_t *b);
 static void		cups_dnssd_free_device(_cups_dnssd_device_t *device, _cups_dnssd_data_t *data);
+static void		cups_dnssd_free_entry(_cups_dnssd_entry_t *entry);
 static _cups_dnssd_device_t *cups_dnssd_get_device(_cups_dnssd_data_t *data, const char *serviceName, const char *regtype, const char *replyDomain);
 static void		cups_dest_query_cb(cups_dnssd_query_t *query, void *cb_data, cups_dnssd_flags_t flags, uint32_t if_index, const char *fullname, uint16_t rrtype, const void *qdata, uint16_t qlen);
 static const char	*cups_dest_resolve(cups_dest_t *dest, const char *uri, int msec, int *cancel, cups_dest_cb_t cb, void *user_data);
@@ -145,6 +179,16 @@ static bool		cups_name_cb(_cups_namedata_t *data, unsigned flags, cups_dest_t *d
 static void		cups_queue_name(char *name, const char *serviceName, size_t namesize);
 
 
+/*
+ * Local globals...
+ */
+
+static _cups_dnssd_cache_t *cups_dnssd_cache = NULL;
+					/* Shared DNS-SD browse cache */
+static cups_mutex_t	cups_dnssd_cache_mutex = CUPS_MUTEX_INITIALIZER;
+					/* Mutex for cache and its queries */
+
+
 /*
  * 'cupsAddDest()' - Add a destination to the list of destinations.
  *
@@ -2352,32 +2396,387 @@ cups_compare_dests(cups_dest_t *a,	/* I - First destination */
 static void
 cups_dest_browse_cb(
     cups_dnssd_browse_t *browse,	/* I - DNS-SD browser */
-    void                *context,	/* I - Enumeration data */
+    void                *context,	/* I - Browse cache */
     cups_dnssd_flags_t  flags,		/* I - Flags */
     uint32_t            if_index,	/* I - Interface */
     const char          *serviceName,	/* I - Name of service/device */
     const char          *regtype,	/* I - Type of service */
     const char          *replyDomain)	/* I - Service domain */
 {
-  _cups_dnssd_data_t	*data = (_cups_dnssd_data_t *)context;
-					/* Enumeration data */
+  _cups_dnssd_cache_t	*cache = (_cups_dnssd_cache_t *)context;
+					/* Browse cache */
+  _cups_dnssd_entry_t	key,		/* Search key */
+			*entry;		/* Cached service */
+  char			fullname[1024];	/* Full name for query */
 
 
   DEBUG_printf(("5cups_dest_browse_cb(browse=%p, context=%p, flags=%x, if_index=%d, serviceName=\"%s\", regtype=\"%s\", replyDomain=\"%s\")", (void *)browse, context, flags, if_index, serviceName, regtype, replyDomain));
 
  /*
-  * Don't do anything on error, only add services...
+  * Don't do anything on error...
+  */
+
+  if (flags & CUPS_DNSSD_FLAGS_ERROR)
+    return;
+
+ /*
+  * Services are reported once per interface, so keep a count of how many
+  * interfaces still have the service.  This callback is run with the DNS-SD
+  * context locked, so only the cache is updated here - queries are started
+  * by cups_dnssd_cache_sync()...
   */
 
-  if ((flags & CUPS_DNSSD_FLAGS_ERROR) || !(flags & CUPS_DNSSD_FLAGS_ADD))
+  cupsDNSSDAssembleFullName(fullname, sizeof(fullname), serviceName, regtype, replyDomain);
+  key.fullname = fullname;
+
+  cupsMutexLock(&cache->mutex);
+
+  if ((entry = (_cups_dnssd_entry_t *)cupsArrayFind(cache->services, &key)) == NULL && (flags & CUPS_DNSSD_FLAGS_ADD))
+  {
+    if ((entry = calloc(1, sizeof(_cups_dnssd_entry_t))) != NULL)
+    {
+      DEBUG_printf(("6cups_dest_browse_cb: Caching '%s'.", fullname));
+
+      entry->cache    = cache;
+      entry->name     = _cupsStrAlloc(serviceName);
+      entry->regtype  = _cupsStrAlloc(regtype);
+      entry->domain   = _cupsStrAlloc(replyDomain);
+      entry->fullname = _cupsStrAlloc(fullname);
+
+      cupsArrayAdd(cache->services, entry);
+    }
+  }
+
+  if (entry)
+  {
+    if (flags & CUPS_DNSSD_FLAGS_ADD)
+      entry->refs ++;
+    else if (entry->refs > 0 && -- entry->refs == 0)
+      entry->removed = time(NULL);
+
+    cache->generation ++;
+    cupsCondBroadcast(&cache->cond);
+  }
+
+  cupsMutexUnlock(&cache->mutex);
+}
+
+
+/*
+ * 'cups_dnssd_cache_get()' - Get the shared DNS-SD browse cache, starting the
+ *                            browses as needed.
+ */
+
+static _cups_dnssd_cache_t *		/* O - Browse cache or `NULL` on error */
+cups_dnssd_cache_get(void)
+{
+  _cups_dnssd_cache_t	*cache;		/* Browse cache */
+  _cups_dnssd_entry_t	*entry;		/* Cached service */
+
+
+  cupsMutexLock(&cups_dnssd_cache_mutex);
+
+#ifndef _WIN32
+  if (cups_dnssd_cache && cups_dnssd_cache->pid != getpid())
+  {
+   /*
+    * The browses belong to our parent process, start over...
+    */
+
+    cups_dnssd_cache = NULL;
+  }
+#endif /* !_WIN32 */
+
+  if (!cups_dnssd_cache && (cache = calloc(1, sizeof(_cups_dnssd_cache_t))) != NULL)
+  {
+    cupsMutexInit(&cache->mutex);
+    cupsCondInit(&cache->cond);
+
+#ifndef _WIN32
+    cache->pid      = getpid();
+#endif /* !_WIN32 */
+    cache->services = cupsArrayNew((cups_array_cb_t)cups_dnssd_compare_entries, NULL, NULL, 0, NULL, NULL);
+
+    if ((cache->dnssd = cupsDNSSDNew(NULL, NULL)) == NULL || !cupsDNSSDBrowseNew(cache->dnssd, CUPS_DNSSD_IF_INDEX_ANY, "_ipp._tcp", /*domain*/NULL, cups_dest_browse_cb, cache) || !cupsDNSSDBrowseNew(cache->dnssd, CUPS_DNSSD_IF_INDEX_ANY, "_ipps._tcp", /*domain*/NULL, cups_dest_browse_cb, cache))
+    {
+      DEBUG_puts("3cups_dnssd_cache_get: Unable to create service browsers.");
+
+      cupsDNSSDDelete(cache->dnssd);
+
+      for (entry = (_cups_dnssd_entry_t *)cupsArrayGetFirst(cache->services); entry; entry = (_cups_dnssd_entry_t *)cupsArrayGetNext(cache->services))
+        cups_dnssd_free_entry(entry);
+
+      cupsArrayDelete(cache->services);
+      cupsCondDestroy(&cache->cond);
+      cupsMutexDestroy(&cache->mutex);
+      free(cache);
+    }
+    else
+    {
+      cups_dnssd_cache = cache;
+    }
+  }
+
+  cache = cups_dnssd_cache;
+
+  cupsMutexUnlock(&cups_dnssd_cache_mutex);
+
+  return (cache);
+}
+
+
+/*
+ * 'cups_dnssd_cache_query_cb()' - Cache TXT record data.
+ */
+
+static void
+cups_dnssd_cache_query_cb(
+    cups_dnssd_query_t  *query,		/* I - Query request */
+    void                *context,	/* I - Cached service */
+    cups_dnssd_flags_t	flags,		/* I - DNS-SD flags */
+    uint32_t            if_index,	/* I - Interface */
+    const char          *fullname,	/* I - Full service name */
+    uint16_t            rrtype,		/* I - Record type */
+    const void          *rdata,		/* I - Record data */
+    uint16_t            rdlen)		/* I - Length of record data */
+{
+  _cups_dnssd_entry_t	*entry = (_cups_dnssd_entry_t *)context;
+					/* Cached service */
+  _cups_dnssd_cache_t	*cache = entry->cache;
+					/* Browse cache */
+  uint8_t		*txt;		/* Copy of TXT record */
+
+
+  (void)query;
+  (void)if_index;
+  (void)rrtype;
+
+  DEBUG_printf(("5cups_dnssd_cache_query_cb(..., flags=%x, fullname=\"%s\", rdlen=%u)", flags, fullname, rdlen));
+
+  if ((flags & CUPS_DNSSD_FLAGS_ERROR) || !rdlen)
+    return;
+
+  cupsMutexLock(&cache->mutex);
+
+  if ((entry->txtlen != rdlen || memcmp(entry->txt, rdata, rdlen)) && (txt = malloc(rdlen)) != NULL)
+  {
+    memcpy(txt, rdata, rdlen);
+
+    free(entry->txt);
+    entry->txt    = txt;
+    entry->txtlen = rdlen;
+
+    cache->generation ++;
+    cupsCondBroadcast(&cache->cond);
+  }
+
+  cupsMutexUnlock(&cache->mutex);
+}
+
+
+/*
+ * 'cups_dnssd_cache_sync()' - Update the enumerated devices from the cache.
+ *
+ * Queries are started and stopped without holding the cache mutex since the
+ * DNS-SD callbacks are run with the DNS-SD context locked.  The cache is then
+ * copied so that the enumeration callbacks are also run without any locks
+ * held.
+ */
+
+static void
+cups_dnssd_cache_sync(
+    _cups_dnssd_cache_t *cache,		/* I - Browse cache */
+    _cups_dnssd_data_t  *data)		/* I - Enumeration data */
+{
+  size_t		i,		/* Looping var */
+			count,		/* Number of cached services */
+			num_query = 0,	/* Number of queries to start */
+			num_expired = 0;/* Number of expired services */
+  _cups_dnssd_entry_t	key,		/* Search key */
+			*entry,		/* Cached service */
+			*copy,		/* Copy of service */
+			**query = NULL,	/* Services to query */
+			**expired = NULL;/* Services to free */
+  cups_array_t		*services = NULL;/* Copy of current services */
+  _cups_dnssd_device_t	dkey,		/* Device search key */
+			*device;	/* Current device */
+  char			name[128];	/* Queue name */
+  time_t		curtime = time(NULL);
+					/* Current time */
+
+
+  cupsMutexLock(&cups_dnssd_cache_mutex);
+  cupsMutexLock(&cache->mutex);
+
+  if ((count = cupsArrayGetCount(cache->services)) > 0)
+  {
+    query   = calloc(count, sizeof(_cups_dnssd_entry_t *));
+    expired = calloc(count, sizeof(_cups_dnssd_entry_t *));
+  }
+
+  if (query && expired)
+  {
+    for (i = count; i > 0; i --)
+    {
+      entry = (_cups_dnssd_entry_t *)cupsArrayGetElement(cache->services, i - 1);
+
+      if (entry->refs > 0 && !entry->query && !entry->error)
+      {
+        query[num_query ++] = entry;
+      }
+      else if (entry->refs == 0 && (curtime - entry->removed) >= _CUPS_DNSSD_EXPIRE)
+      {
+        cupsArrayRemove(cache->services, entry);
+        expired[num_expired ++] = entry;
+      }
+    }
+  }
+
+  cupsMutexUnlock(&cache->mutex);
+
+  for (i = 0; i < num_query; i ++)
+  {
+    DEBUG_printf(("6cups_dnssd_cache_sync: Querying '%s'.", query[i]->fullname));
+
+    if ((query[i]->query = cupsDNSSDQueryNew(cache->dnssd, CUPS_DNSSD_IF_INDEX_ANY, query[i]->fullname, CUPS_DNSSD_RRTYPE_TXT, cups_dnssd_cache_query_cb, query[i])) == NULL)
+      DEBUG_puts("6cups_dnssd_cache_sync: Query failed.");
+  }
+
+  for (i = 0; i < num_expired; i ++)
+  {
+    DEBUG_printf(("6cups_dnssd_cache_sync: Expiring '%s'.", expired[i]->fullname));
+
+    cupsDNSSDQueryDelete(expired[i]->query);
+    cups_dnssd_free_entry(expired[i]);
+  }
+
+  cupsMutexLock(&cache->mutex);
+
+  for (i = 0; i < num_query; i ++)
+  {
+    if (!query[i]->query)
+    {
+      query[i]->error = true;
+      cache->generation ++;
+    }
+  }
+
+  if (cache->generation != data->generation)
+  {
+   /*
+    * Copy the services that are currently available...
+    */
+
+    services = cupsArrayNew((cups_array_cb_t)cups_dnssd_compare_entries, NULL, NULL, 0, NULL, (cups_afree_cb_t)cups_dnssd_free_entry);
+
+    for (entry = (_cups_dnssd_entry_t *)cupsArrayGetFirst(cache->services); entry; entry = (_cups_dnssd_entry_t *)cupsArrayGetNext(cache->services))
+    {
+      if (entry->refs == 0 || (copy = calloc(1, sizeof(_cups_dnssd_entry_t))) == NULL)
+        continue;
+
+      copy->name     = _cupsStrRetain(entry->name);
+      copy->regtype  = _cupsStrRetain(entry->regtype);
+      copy->domain   = _cupsStrRetain(entry->domain);
+      copy->fullname = _cupsStrRetain(entry->fullname);
+      copy->error    = entry->error;
+
+      if (entry->txt && (copy->txt = malloc(entry->txtlen)) != NULL)
+      {
+        memcpy(copy->txt, entry->txt, entry->txtlen);
+        copy->txtlen = entry->txtlen;
+      }
+
+      cupsArrayAdd(services, copy);
+    }
+
+    data->generation = cache->generation;
+  }
+
+  cupsMutexUnlock(&cache->mutex);
+  cupsMutexUnlock(&cups_dnssd_cache_mutex);
+
+  free(query);
+  free(expired);
+
+  if (!services)
     return;
 
  /*
-  * Get the device...
+  * Remove devices whose service has gone away...
+  */
+
+  for (i = cupsArrayGetCount(data->devices); i > 0; i --)
+  {
+    device = (_cups_dnssd_device_t *)cupsArrayGetElement(data->devices, i - 1);
+
+    if (device->local)
+      continue;
+
+    key.fullname = device->fullname;
+
+    if (cupsArrayFind(services, &key))
+      continue;
+
+    if (device->state == _CUPS_DNSSD_ACTIVE)
+    {
+      DEBUG_printf(("6cups_dnssd_cache_sync: Remove callback for \"%s\".", device->dest.name));
+
+      (*data->cb)(data->user_data, CUPS_DEST_FLAGS_REMOVED, &device->dest);
+    }
+
+    cupsRWLockWrite(&data->rwlock);
+    cupsArrayRemove(data->devices, device);
+    cupsRWUnlock(&data->rwlock);
+  }
+
+ /*
+  * Then add or update devices for the current services...
   */
 
-  cups_dnssd_get_device(data, serviceName, regtype, replyDomain);
+  for (entry = (_cups_dnssd_entry_t *)cupsArrayGetFirst(services); entry; entry = (_cups_dnssd_entry_t *)cupsArrayGetNext(services))
+    cups_dnssd_get_device(data, entry->name, entry->regtype, entry->domain);
+
+ /*
+  * and use the TXT record of the preferred service for each new device...
+  */
+
+  for (entry = (_cups_dnssd_entry_t *)cupsArrayGetFirst(services); entry; entry = (_cups_dnssd_entry_t *)cupsArrayGetNext(services))
+  {
+    cups_queue_name(name, entry->name, sizeof(name));
+    dkey.dest.name = name;
+
+    if ((device = (_cups_dnssd_device_t *)cupsArrayFind(data->devices, &dkey)) == NULL || device->state != _CUPS_DNSSD_NEW || strcmp(device->fullname, entry->fullname))
+      continue;
+
+    if (entry->txt)
+      cups_dest_query_cb(NULL, data, CUPS_DNSSD_FLAGS_ADD, CUPS_DNSSD_IF_INDEX_ANY, entry->fullname, CUPS_DNSSD_RRTYPE_TXT, entry->txt, entry->txtlen);
+    else if (entry->error)
+      device->state = _CUPS_DNSSD_ERROR;
+  }
+
+  cupsArrayDelete(services);
 }
+
+
+/*
+ * 'cups_dnssd_cache_wait()' - Wait for the cache to change.
+ */
+
+static void
+cups_dnssd_cache_wait(
+    _cups_dnssd_cache_t *cache,		/* I - Browse cache */
+    _cups_dnssd_data_t  *data,		/* I - Enumeration data */
+    int                 msec)		/* I - Maximum time to wait in milliseconds */
+{
+  cupsMutexLock(&cache->mutex);
+
+  if (cache->generation == data->generation && msec > 0)
+    cupsCondWait(&cache->cond, &cache->mutex, msec * 0.001);
+
+  cupsMutexUnlock(&cache->mutex);
+}
+
+
 /*
  * 'cups_dnssd_compare_device()' - Compare two devices.
  */
@@ -2391,6 +2790,19 @@ cups_dnssd_compare_devices(
 }
 
 
+/*
+ * 'cups_dnssd_compare_entries()' - Compare two cached services.
+ */
+
+static int				/* O - Result of comparison */
+cups_dnssd_compare_entries(
+    _cups_dnssd_entry_t *a,		/* I - First service */
+    _cups_dnssd_entry_t *b)		/* I - Second service */
+{
+  return (strcmp(a->fullname, b->fullname));
+}
+
+
 /*
  * 'cups_dnssd_free_device()' - Free the memory used by a device.
  */
@@ -2413,6 +2825,24 @@ cups_dnssd_free_device(
 }
 
 
+/*
+ * 'cups_dnssd_free_entry()' - Free the memory used by a cached service.
+ */
+
+static void
+cups_dnssd_free_entry(
+    _cups_dnssd_entry_t *entry)		/* I - Cached service */
+{
+  _cupsStrFree(entry->name);
+  _cupsStrFree(entry->regtype);
+  _cupsStrFree(entry->domain);
+  _cupsStrFree(entry->fullname);
+
+  free(entry->txt);
+  free(entry);
+}
+
+
 /*
  * 'cups_dnssd_get_device()' - Lookup a device and create it as needed.
  */
@@ -2524,9 +2954,6 @@ cups_dnssd_get_device(
   _cupsStrFree(device->fullname);
   device->fullname = _cupsStrAlloc(fullname);
 
-  cupsDNSSDQueryDelete(device->query);
-  device->query = NULL;
-
   if (device->state == _CUPS_DNSSD_ACTIVE)
   {
     DEBUG_printf(("6cups_dnssd_get_device: Remove callback for \"%s\".", device->dest.name));
@@ -2540,7 +2967,7 @@ cups_dnssd_get_device(
 
 
 /*
- * 'cups_dest_query_cb()' - Process query data.
+ * 'cups_dest_query_cb()' - Process TXT record data for a device.
  */
 
 static void
@@ -2983,13 +3410,12 @@ cups_enum_dests(
                 *dest;			/* Current destination */
   cups_option_t	*option;		/* Current option */
   const char	*user_default;		/* Default printer from environment */
-  size_t	count,			/* Number of queries started */
-		completed;		/* Number of completed queries */
+  size_t	completed;		/* Number of completed devices */
   int		remaining;		/* Remainder of timeout */
   struct timeval curtime;               /* Current time */
   _cups_dnssd_data_t data;		/* Data for callback */
   _cups_dnssd_device_t *device;         /* Current device */
-  cups_dnssd_t	*dnssd = NULL;		/* DNS-SD context */
+  _cups_dnssd_cache_t *cache;		/* DNS-SD browse cache */
   char		filename[1024];		/* Local lpoptions file */
   _cups_globals_t *cg = _cupsGlobals();	/* Pointer to library globals */
 
@@ -3154,7 +3580,10 @@ cups_enum_dests(
               replyDomain += 6;
 
               if ((device = cups_dnssd_get_device(&data, serviceName, regtype, replyDomain)) != NULL)
+              {
                 device->state = _CUPS_DNSSD_ACTIVE;
+                device->local = true;
+              }
             }
           }
         }
@@ -3175,12 +3604,14 @@ cups_enum_dests(
     goto enum_finished;
 
  /*
-  * Get DNS-SD printers...
+  * Get DNS-SD printers from the shared browse cache, which keeps browsing
+  * between calls so that previously discovered printers are reported right
+  * away...
   */
 
   gettimeofday(&curtime, NULL);
 
-  if ((dnssd = cupsDNSSDNew(NULL, NULL)) == NULL)
+  if ((cache = cups_dnssd_cache_get()) == NULL)
   {
     DEBUG_puts("1cups_enum_dests: Unable to create service browser, returning 0.");
 
@@ -3190,28 +3621,6 @@ cups_enum_dests(
     return (false);
   }
 
-  if (!cupsDNSSDBrowseNew(dnssd, CUPS_DNSSD_IF_INDEX_ANY, "_ipp._tcp", /*domain*/NULL, cups_dest_browse_cb, &data))
-  {
-    DEBUG_puts("1cups_enum_dests: Unable to create IPP browser, returning 0.");
-    cupsDNSSDDelete(dnssd);
-
-    cupsFreeDests(data.num_dests, data.dests);
-    cupsArrayDelete(data.devices);
-
-    return (false);
-  }
-
-  if (!cupsDNSSDBrowseNew(dnssd, CUPS_DNSSD_IF_INDEX_ANY, "_ipps._tcp", /*domain*/NULL, cups_dest_browse_cb, &data))
-  {
-    DEBUG_puts("1cups_enum_dests: Unable to create IPPS browser, returning 0.");
-    cupsDNSSDDelete(dnssd);
-
-    cupsFreeDests(data.num_dests, data.dests);
-    cupsArrayDelete(data.devices);
-
-    return (false);
-  }
-
   if (msec < 0)
     remaining = INT_MAX;
   else
@@ -3220,43 +3629,24 @@ cups_enum_dests(
   while (remaining > 0 && (!cancel || !*cancel))
   {
    /*
-    * Check for input...
+    * Check for changes...
     */
 
     DEBUG_printf(("1cups_enum_dests: remaining=%d", remaining));
 
-    cups_elapsed(&curtime);
-
     remaining -= cups_elapsed(&curtime);
 
+    cups_dnssd_cache_sync(cache, &data);
+
     cupsRWLockRead(&data.rwlock);
 
-    for (i = 0, num_devices = cupsArrayGetCount(data.devices), count = 0, completed = 0; i < num_devices; i ++)
+    for (i = 0, num_devices = cupsArrayGetCount(data.devices), completed = 0; i < num_devices; i ++)
     {
       device = cupsArrayGetElement(data.devices, i);
 
-      if (device->query)
-        count ++;
-
-      if (device->state == _CUPS_DNSSD_ACTIVE)
+      if (device->state == _CUPS_DNSSD_ACTIVE || device->state == _CUPS_DNSSD_INCOMPATIBLE || device->state == _CUPS_DNSSD_ERROR)
         completed ++;
-
-      if (!device->query && device->state == _CUPS_DNSSD_NEW)
-      {
-        DEBUG_printf(("1cups_enum_dests: Querying '%s'.", device->fullname));
-
-	if ((device->query = cupsDNSSDQueryNew(dnssd, CUPS_DNSSD_IF_INDEX_ANY, device->fullname, CUPS_DNSSD_RRTYPE_TXT, cups_dest_query_cb, &data)) != NULL)
-        {
-          count ++;
-        }
-        else
-        {
-          device->state = _CUPS_DNSSD_ERROR;
-
-          DEBUG_puts("1cups_enum_dests: Query failed.");
-        }
-      }
-      else if (device->query && device->state == _CUPS_DNSSD_PENDING)
+      else if (device->state == _CUPS_DNSSD_PENDING)
       {
         completed ++;
 
@@ -3316,14 +3706,14 @@ cups_enum_dests(
       }
     }
 
-    DEBUG_printf(("1cups_enum_dests: remaining=%d, completed=%u, count=%u, devices count=%u", remaining, (unsigned)completed, (unsigned)count, (unsigned)cupsArrayGetCount(data.devices)));
+    DEBUG_printf(("1cups_enum_dests: remaining=%d, completed=%u, devices count=%u", remaining, (unsigned)completed, (unsigned)cupsArrayGetCount(data.devices)));
 
     cupsRWUnlock(&data.rwlock);
 
     if (completed && completed == cupsArrayGetCount(data.devices))
       break;
 
-    usleep(100000);
+    cups_dnssd_cache_wait(cache, &data, remaining > 100 ? 100 : remaining);
   }
 
  /*
@@ -3332,8 +3722,6 @@ cups_enum_dests(
 
   enum_finished:
 
-  cupsDNSSDDelete(dnssd);
-
   cupsFreeDests(data.num_dests, data.dests);
   cupsArrayDelete(data.devices);
 
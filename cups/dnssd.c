@@ -49,6 +49,9 @@ struct _cups_dnssd_s			// DNS-SD context
 {
   cups_mutex_t		mutex;		// Mutex for context
   size_t		config_changes;	// Number of hostname/network changes
+  cups_mutex_t		wait_mutex;	// Mutex for cupsDNSSDWait
+  cups_cond_t		wait_cond;	// Condition for cupsDNSSDWait
+  size_t		events;		// Number of callbacks delivered
   cups_dnssd_error_cb_t	cb;		// Error callback function
   void			*cb_data;	// Error callback data
   cups_array_t		*browses,	// Browse requests
@@ -145,6 +148,7 @@ static void		delete_query(cups_dnssd_query_t *query);
 static void		delete_resolve(cups_dnssd_resolve_t *resolve);
 static void		delete_service(cups_dnssd_service_t *service);
 static void		record_config_change(cups_dnssd_t *dnssd, cups_dnssd_flags_t flags);
+static void		record_event(cups_dnssd_t *dnssd, cups_dnssd_flags_t flags);
 static void		report_error(cups_dnssd_t *dnssd, const char *message, ...) _CUPS_FORMAT(2,3);
 
 #ifdef __APPLE__
@@ -420,6 +424,8 @@ cupsDNSSDDelete(cups_dnssd_t *dnssd)	// I - DNS-SD context
 
   cupsMutexUnlock(&dnssd->mutex);
   cupsMutexDestroy(&dnssd->mutex);
+  cupsCondDestroy(&dnssd->wait_cond);
+  cupsMutexDestroy(&dnssd->wait_mutex);
   free(dnssd);
 }
 
@@ -527,8 +533,10 @@ cupsDNSSDNew(
   dnssd->cb      = error_cb;
   dnssd->cb_data = cb_data;
 
-  // Initialize the mutex...
+  // Initialize the mutexes...
   cupsMutexInit(&dnssd->mutex);
+  cupsMutexInit(&dnssd->wait_mutex);
+  cupsCondInit(&dnssd->wait_cond);
 
 #ifdef __APPLE__
   // Use the system configuration dynamic store for host info...
@@ -1429,6 +1437,51 @@ cupsDNSSDServiceSetLocation(
 }
 
 
+//
+// 'cupsDNSSDWait()' - Wait for browse, query, resolve, or service callbacks.
+//
+// This function waits up to "msec" milliseconds for callbacks to be delivered
+// for the DNS-SD context.  The "events" argument is the value returned by the
+// previous call, or `0` for the first call, and the function returns as soon
+// as the number of delivered callbacks differs from it.  Waiting threads are
+// not woken while more callbacks are known to be coming, so a caller typically
+// runs once per batch of results:
+//
+// ```
+// size_t events = 0;
+//
+// while (!done)
+// {
+//   events = cupsDNSSDWait(dnssd, events, 250);
+//
+//   ... process results ...
+// }
+// ```
+//
+// A "msec" value of `-1` waits indefinitely.
+//
+
+size_t					// O - Number of callbacks delivered
+cupsDNSSDWait(cups_dnssd_t *dnssd,	// I - DNS-SD context
+              size_t       events,	// I - Previous number of callbacks delivered
+              int          msec)	// I - Timeout in milliseconds or `-1` for indefinite
+{
+  if (!dnssd)
+    return (0);
+
+  cupsMutexLock(&dnssd->wait_mutex);
+
+  if (dnssd->events == events && msec != 0)
+    cupsCondWait(&dnssd->wait_cond, &dnssd->wait_mutex, msec > 0 ? 0.001 * msec : 0.0);
+
+  events = dnssd->events;
+
+  cupsMutexUnlock(&dnssd->wait_mutex);
+
+  return (events);
+}
+
+
 //
 // 'delete_browse()' - Delete a browse request.
 //
@@ -1537,6 +1590,27 @@ record_config_change(cups_dnssd_t       *dnssd,	// I - DNS-SD context
   cupsMutexUnlock(&dnssd->mutex);
 }
 
+
+//
+// 'record_event()' - Record that a callback was delivered and wake any threads
+//                    waiting in cupsDNSSDWait.
+//
+
+static void
+record_event(cups_dnssd_t       *dnssd,	// I - DNS-SD context
+             cups_dnssd_flags_t flags)	// I - Callback flags
+{
+  cupsMutexLock(&dnssd->wait_mutex);
+
+  dnssd->events ++;
+
+  if (!(flags & CUPS_DNSSD_FLAGS_MORE))
+    cupsCondBroadcast(&dnssd->wait_cond);
+
+  cupsMutexUnlock(&dnssd->wait_mutex);
+}
+
+
 //
 // 'report_error()' - Report an error.
 //
@@ -1614,12 +1688,17 @@ mdns_browse_cb(
     const char          *domain,	// I - Domain
     cups_dnssd_browse_t *browse)	// I - Browse request
 {
+  cups_dnssd_t	*dnssd = browse->dnssd;	// DNS-SD context
+
+
   (void)ref;
 
   if (error != kDNSServiceErr_NoError)
     report_error(browse->dnssd, "DNS-SD browse error: %s", mdns_strerror(error));
 
   (browse->cb)(browse, browse->cb_data, mdns_to_cups(flags, error), if_index, name, regtype, domain);
+
+  record_event(dnssd, mdns_to_cups(flags, error));
 }
 
 
@@ -1663,6 +1742,9 @@ mdns_query_cb(
     uint32_t            ttl,		// I - Time-to-live value
     cups_dnssd_query_t  *query)		// I - Query request
 {
+  cups_dnssd_t	*dnssd = query->dnssd;	// DNS-SD context
+
+
   (void)ref;
   (void)rrclass;
   (void)ttl;
@@ -1671,6 +1753,8 @@ mdns_query_cb(
     report_error(query->dnssd, "DNS-SD query error: %s", mdns_strerror(error));
 
   (query->cb)(query, query->cb_data, mdns_to_cups(flags, error), if_index, name, rrtype, rdata, rdlen);
+
+  record_event(dnssd, mdns_to_cups(flags, error));
 }
 
 
@@ -1693,6 +1777,8 @@ mdns_resolve_cb(
 {
   size_t	num_txt;		// Number of TXT key/value pairs
   cups_option_t	*txt;			// TXT key/value pairs
+  cups_dnssd_t	*dnssd = resolve->dnssd;
+					// DNS-SD context
 
 
   (void)ref;
@@ -1704,6 +1790,8 @@ mdns_resolve_cb(
 
   (resolve->cb)(resolve, resolve->cb_data, mdns_to_cups(flags, error), if_index, fullname, host, ntohs(port), num_txt, txt);
 
+  record_event(dnssd, mdns_to_cups(flags, error));
+
   cupsFreeOptions(num_txt, txt);
 }
 
@@ -1723,6 +1811,10 @@ mdns_service_cb(
     const char           *domain,	// I - Domain
     cups_dnssd_service_t *service)	// I - Service registration
 {
+  cups_dnssd_t	*dnssd = service->dnssd;
+					// DNS-SD context
+
+
   (void)ref;
   (void)name;
   (void)regtype;
@@ -1732,6 +1824,8 @@ mdns_service_cb(
     report_error(service->dnssd, "DNS-SD service registration error: %s", mdns_strerror(error));
 
   (service->cb)(service, service->cb_data, mdns_to_cups(flags, error));
+
+  record_event(dnssd, mdns_to_cups(flags, error));
 }
 
 
@@ -1895,6 +1989,7 @@ avahi_browse_cb(
     cups_dnssd_browse_t    *browse)	// I - CUPS browse request
 {
   cups_dnssd_flags_t	cups_flags;	// CUPS DNS-SD flags
+  cups_dnssd_t	*dnssd = browse->dnssd;	// DNS-SD context
 
 
   (void)protocol;
@@ -1918,6 +2013,8 @@ avahi_browse_cb(
   }
 
   (browse->cb)(browse, browse->cb_data, cups_flags, (uint32_t)if_index, name, type, domain);
+
+  record_event(dnssd, cups_flags);
 }
 
 
@@ -2029,11 +2126,16 @@ avahi_query_cb(
     AvahiLookupResultFlags flags,	// I - Flags
     cups_dnssd_query_t     *query)	// I - Query request
 {
+  cups_dnssd_t	*dnssd = query->dnssd;	// DNS-SD context
+
+
   (void)browser;
   (void)protocol;
   (void)rrclass;
 
   (query->cb)(query, query->cb_data, event == AVAHI_BROWSER_NEW ? CUPS_DNSSD_FLAGS_NONE : CUPS_DNSSD_FLAGS_ERROR, (uint32_t)if_index, fullname, rrtype, rdata, rdlen);
+
+  record_event(dnssd, CUPS_DNSSD_FLAGS_NONE);
 }
 
 
@@ -2061,6 +2163,8 @@ avahi_resolve_cb(
   size_t	num_txt = 0;		// Number of TXT key/value pairs
   cups_option_t	*txt = NULL;		// TXT key/value pairs
   char		fullname[1024];		// Full service name
+  cups_dnssd_t	*dnssd = resolve->dnssd;
+					// DNS-SD context
 
 
   DEBUG_printf(("avahi_resolve_cb(resolver=%p, if_index=%d, protocol=%d, event=%d, name=\"%s\", type=\"%s\", domain=\"%s\", host=\"%s\", address=%p, port=%u, txtrec=%p, flags=%u, resolve=%p)", (void *)resolver, if_index, protocol, event, name, type, domain, host, (void *)address, (unsigned)port, (void *)txtrec, (unsigned)flags, (void *)resolve));
@@ -2092,6 +2196,8 @@ avahi_resolve_cb(
   // Do the resolve callback and free the TXT record stuff...
   (resolve->cb)(resolve, resolve->cb_data, event == AVAHI_RESOLVER_FOUND ? CUPS_DNSSD_FLAGS_NONE : CUPS_DNSSD_FLAGS_ERROR, (uint32_t)if_index, fullname, host, port, num_txt, txt);
 
+  record_event(dnssd, CUPS_DNSSD_FLAGS_NONE);
+
   cupsFreeOptions(num_txt, txt);
 }
 
@@ -2106,8 +2212,14 @@ avahi_service_cb(
     AvahiEntryGroupState state,		// I - Registration state
     cups_dnssd_service_t *service)	// I - Service registration
 {
+  cups_dnssd_t	*dnssd = service->dnssd;
+					// DNS-SD context
+
+
   (void)srv;
 
   (service->cb)(service, service->cb_data, state == AVAHI_ENTRY_GROUP_COLLISION ? CUPS_DNSSD_FLAGS_COLLISION : CUPS_DNSSD_FLAGS_NONE);
+
+  record_event(dnssd, CUPS_DNSSD_FLAGS_NONE);
 }
 #endif // HAVE_MDNSRESPONDER
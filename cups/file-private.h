@@ -41,6 +41,8 @@ extern "C" {
  */
 
 extern bool	_cupsFilePeekAhead(cups_file_t *fp, int ch);
+extern const char *_cupsFilePeekBuffer(cups_file_t *fp, size_t *bytes);
+extern void	_cupsFileSkip(cups_file_t *fp, size_t bytes);
 
 
 #  ifdef __cplusplus
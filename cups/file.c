@@ -22,29 +22,77 @@
 #include "debug-internal.h"
 #include <sys/stat.h>
 #include <sys/types.h>
+#ifndef _WIN32
+#  include <sys/mman.h>
+#endif /* !_WIN32 */
 #include <zlib.h>
 
 
+/*
+ * Local constants...
+ */
+
+#define _CUPS_FILE_BUFSIZE	4096	/* Default buffer size */
+#define _CUPS_FILE_MAX_BUFSIZE	4194304	/* Maximum buffer size */
+#define _CUPS_FILE_BLOCKSIZE	131072	/* Minimum size of parallel compression blocks */
+
+
 /*
  * Internal structures...
  */
 
+typedef enum _cups_fblock_state_e	/**** Compression block state ****/
+{
+  _CUPS_FBLOCK_FREE,			/* Block is unused */
+  _CUPS_FBLOCK_QUEUED,			/* Block is queued for compression */
+  _CUPS_FBLOCK_BUSY,			/* Block is being compressed */
+  _CUPS_FBLOCK_DONE			/* Block is compressed and ready to write */
+} _cups_fblock_state_t;
+
+typedef struct _cups_fblock_s		/**** Compression block ****/
+{
+  _cups_fblock_state_t	state;		/* Block state */
+  Bytef			*input;		/* Uncompressed data */
+  size_t		inused;		/* Bytes of uncompressed data */
+  Bytef			*output;	/* Compressed data */
+  size_t		outsize,	/* Size of output buffer */
+			outused;	/* Bytes of compressed data */
+  uLong			crc;		/* CRC of uncompressed data */
+  bool			error;		/* Did compression fail? */
+} _cups_fblock_t;
+
 struct _cups_file_s			/**** CUPS file structure... ****/
 {
   int		fd;			/* File descriptor */
   bool		compressed;		/* Compression used? */
   char		mode,			/* Mode ('r' or 'w') */
-		buf[4096],		/* Buffer */
+		*buf,			/* Buffer */
 		*ptr,			/* Pointer into buffer */
 		*end;			/* End of buffer data */
+  size_t	bufsize;		/* Size of buffer */
   bool		is_stdio,		/* stdin/out/err? */
-		eof;			/* End of file? */
+		eof,			/* End of file? */
+		mapped;			/* Is the buffer a memory mapping? */
   off_t		pos,			/* Position in file */
 		bufpos;			/* File position for start of buffer */
 
   z_stream	stream;			/* (De)compression stream */
-  Bytef		cbuf[4096];		/* (De)compression buffer */
+  Bytef		*cbuf;			/* (De)compression buffer */
+  size_t	cbufsize;		/* Size of (de)compression buffer */
   uLong		crc;			/* (De)compression CRC */
+  int		level;			/* Compression level */
+
+  cups_mutex_t	mutex;			/* Mutex for compression threads */
+  cups_cond_t	cond;			/* Condition for compression threads */
+  int		num_threads;		/* Number of compression threads */
+  cups_thread_t	*threads;		/* Compression threads */
+  bool		stop;			/* Stop compression threads? */
+  size_t	num_blocks,		/* Number of compression blocks */
+		block_size,		/* Size of each compression block */
+		block_first,		/* First block to write */
+		block_current,		/* Block being filled */
+		block_pending;		/* Number of queued or busy blocks */
+  _cups_fblock_t *blocks;		/* Compression blocks */
 
   char		*printf_buffer;		/* cupsFilePrintf buffer */
   size_t	printf_size;		/* Size of cupsFilePrintf buffer */
@@ -56,6 +104,11 @@ struct _cups_file_s			/**** CUPS file structure... ****/
  */
 
 static bool	cups_compress(cups_file_t *fp, const char *buf, size_t bytes);
+static bool	cups_compress_drain(cups_file_t *fp);
+static bool	cups_compress_queue(cups_file_t *fp);
+static void	cups_compress_stop(cups_file_t *fp);
+static void	*cups_compress_thread(cups_file_t *fp);
+static bool	cups_compress_write(cups_file_t *fp);
 static ssize_t	cups_fill(cups_file_t *fp);
 static int	cups_open(const char *filename, int mode);
 static ssize_t	cups_read(cups_file_t *fp, char *buf, size_t bytes);
@@ -90,6 +143,18 @@ cupsFileClose(cups_file_t *fp)		/* I - CUPS file */
   else
     status = true;
 
+  if (fp->num_threads > 0)
+  {
+   /*
+    * Write any blocks that are still being compressed...
+    */
+
+    if (!cups_compress_drain(fp))
+      status = false;
+
+    cups_compress_stop(fp);
+  }
+
   if (fp->compressed && status)
   {
     if (fp->mode == 'r')
@@ -119,7 +184,7 @@ cupsFileClose(cups_file_t *fp)		/* I - CUPS file */
 	  status = cups_write(fp, (char *)fp->cbuf, (size_t)(fp->stream.next_out - fp->cbuf));
 
 	  fp->stream.next_out  = fp->cbuf;
-	  fp->stream.avail_out = sizeof(fp->cbuf);
+	  fp->stream.avail_out = (uInt)fp->cbufsize;
 	}
 
         if (done || !status)
@@ -169,6 +234,13 @@ cupsFileClose(cups_file_t *fp)		/* I - CUPS file */
   if (fp->printf_buffer)
     free(fp->printf_buffer);
 
+#ifndef _WIN32
+  if (fp->mapped)
+    munmap(fp->buf, fp->bufsize);
+  else
+#endif /* !_WIN32 */
+  free(fp->buf);
+  free(fp->cbuf);
   free(fp);
 
  /*
@@ -706,6 +778,10 @@ cupsFileNumber(cups_file_t *fp)		/* I - CUPS file */
  * supplied which enables Flate compression of the file.  Compression is
  * not supported for the "a" (append) mode.
  *
+ * When opening for reading ("r"), an optional "m" can be supplied which maps
+ * uncompressed regular files into memory so that they are read without any
+ * further system calls.  The file must not be truncated while it is open.
+ *
  * When opening a socket connection, the filename is a string of the form
  * "address:port" or "hostname:port". The socket will make an IPv4 or IPv6
  * connection as needed, generally preferring IPv6 connections when there is
@@ -825,6 +901,10 @@ cupsFileOpen(const char *filename,	/* I - Name of file */
  * When opening for writing ("w"), an optional number from `1` to `9` can be
  * supplied which enables Flate compression of the file.  Compression is
  * not supported for the "a" (append) mode.
+ *
+ * When opening for reading ("r"), an optional "m" can be supplied which maps
+ * uncompressed regular files into memory when the file descriptor is at the
+ * beginning of the file.
  */
 
 cups_file_t *				/* O - CUPS file or `NULL` if the file could not be opened */
@@ -848,11 +928,18 @@ cupsFileOpenFd(int        fd,		/* I - File descriptor */
   if ((fp = calloc(1, sizeof(cups_file_t))) == NULL)
     return (NULL);
 
+  if ((fp->buf = malloc(_CUPS_FILE_BUFSIZE)) == NULL)
+  {
+    free(fp);
+    return (NULL);
+  }
+
  /*
   * Open the file...
   */
 
-  fp->fd = fd;
+  fp->fd      = fd;
+  fp->bufsize = _CUPS_FILE_BUFSIZE;
 
   switch (*mode)
   {
@@ -863,7 +950,7 @@ cupsFileOpenFd(int        fd,		/* I - File descriptor */
 
 	fp->mode = 'w';
 	fp->ptr  = fp->buf;
-	fp->end  = fp->buf + sizeof(fp->buf);
+	fp->end  = fp->buf + fp->bufsize;
 
 	if (mode[1] >= '1' && mode[1] <= '9')
 	{
@@ -876,6 +963,15 @@ cupsFileOpenFd(int        fd,		/* I - File descriptor */
 	  time_t	curtime;	/* Current time */
 
 
+          if ((fp->cbuf = malloc(fp->bufsize)) == NULL)
+          {
+            free(fp->buf);
+            free(fp);
+            return (NULL);
+          }
+
+          fp->cbufsize = fp->bufsize;
+
           curtime   = time(NULL);
 	  header[0] = 0x1f;
 	  header[1] = 0x8b;
@@ -896,19 +992,58 @@ cupsFileOpenFd(int        fd,		/* I - File descriptor */
 
           if (deflateInit2(&(fp->stream), mode[1] - '0', Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) < Z_OK)
           {
+            free(fp->cbuf);
+            free(fp->buf);
             free(fp);
 	    return (NULL);
           }
 
 	  fp->stream.next_out  = fp->cbuf;
-	  fp->stream.avail_out = sizeof(fp->cbuf);
+	  fp->stream.avail_out = (uInt)fp->cbufsize;
 	  fp->compressed       = true;
+	  fp->level            = mode[1] - '0';
 	  fp->crc              = crc32(0L, Z_NULL, 0);
 	}
         break;
 
     case 'r' :
 	fp->mode = 'r';
+
+#ifndef _WIN32
+	if (mode[1] == 'm')
+	{
+	 /*
+	  * Map regular files into memory...
+	  */
+
+	  struct stat	fileinfo;	/* File information */
+	  char		*map;		/* Memory mapping */
+
+	  if (!fstat(fd, &fileinfo) && S_ISREG(fileinfo.st_mode) && fileinfo.st_size > 0 && (uintmax_t)fileinfo.st_size <= SIZE_MAX && lseek(fd, 0, SEEK_CUR) == 0 && (map = mmap(NULL, (size_t)fileinfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED)
+	  {
+	    if (fileinfo.st_size >= 2 && map[0] == 0x1f && (map[1] & 255) == 0x8b)
+	    {
+	     /*
+	      * Compressed files are read through the buffer...
+	      */
+
+	      munmap(map, (size_t)fileinfo.st_size);
+	    }
+	    else
+	    {
+	      madvise(map, (size_t)fileinfo.st_size, MADV_SEQUENTIAL);
+
+	      free(fp->buf);
+
+	      fp->buf     = map;
+	      fp->bufsize = (size_t)fileinfo.st_size;
+	      fp->ptr     = fp->buf;
+	      fp->end     = fp->buf + fp->bufsize;
+	      fp->mapped  = true;
+	    }
+	  }
+	}
+#endif /* !_WIN32 */
 	break;
 
     case 's' :
@@ -916,6 +1051,8 @@ cupsFileOpenFd(int        fd,		/* I - File descriptor */
 	break;
 
     default : /* Remove bogus compiler warning... */
+        free(fp->buf);
+        free(fp);
         return (NULL);
   }
 
@@ -944,6 +1081,34 @@ _cupsFilePeekAhead(cups_file_t *fp,	/* I - CUPS file */
 }
 
 
+/*
+ * '_cupsFilePeekBuffer()' - Return the buffered data for a file.
+ *
+ * The buffer is filled as needed.  Use @link _cupsFileSkip@ to consume the
+ * returned data.
+ */
+
+const char *				/* O - Pointer to buffered data or `NULL` on end of file */
+_cupsFilePeekBuffer(cups_file_t *fp,	/* I - CUPS file */
+                    size_t      *bytes)	/* O - Number of bytes of buffered data */
+{
+  *bytes = 0;
+
+  if (!fp || (fp->mode != 'r' && fp->mode != 's') || fp->eof)
+    return (NULL);
+
+  if (fp->ptr >= fp->end)
+  {
+    if (cups_fill(fp) <= 0)
+      return (NULL);
+  }
+
+  *bytes = (size_t)(fp->end - fp->ptr);
+
+  return (fp->ptr);
+}
+
+
 /*
  * 'cupsFilePeekChar()' - Peek at the next character from a file.
  */
@@ -1047,7 +1212,7 @@ cupsFilePrintf(cups_file_t *fp,		/* I - CUPS file */
 
   fp->pos += bytes;
 
-  if ((size_t)bytes > sizeof(fp->buf))
+  if ((size_t)bytes > fp->bufsize)
   {
     if (fp->compressed)
       return (cups_compress(fp, fp->printf_buffer, (size_t)bytes));
@@ -1209,7 +1374,7 @@ cupsFilePuts(cups_file_t *fp,		/* I - CUPS file */
 
   fp->pos += bytes;
 
-  if (bytes > sizeof(fp->buf))
+  if (bytes > fp->bufsize)
   {
     if (fp->compressed)
       return (cups_compress(fp, s, bytes) > 0);
@@ -1399,6 +1564,19 @@ cupsFileSeek(cups_file_t *fp,		/* I - CUPS file */
     }
   }
 
+  if (fp->mapped)
+  {
+   /*
+    * Seeking past the end of a mapped file...
+    */
+
+    fp->pos = pos;
+    fp->ptr = fp->end;
+    fp->eof = false;
+
+    return (pos);
+  }
+
   if (!fp->compressed && !fp->ptr)
   {
    /*
@@ -1482,6 +1660,257 @@ cupsFileSeek(cups_file_t *fp,		/* I - CUPS file */
 }
 
 
+/*
+ * 'cupsFileSetBufferSize()' - Set the size of the I/O buffer for a file.
+ *
+ * This function sets the size of the buffer used for reading and writing the
+ * file, and for compressed files the size of the (de)compression buffer.
+ * Larger buffers reduce the number of system calls for large sequential
+ * reads and writes.  A size of `0` restores the default size of 4k.
+ *
+ * Files opened for writing can change their buffer size at any time.  Files
+ * opened for reading can only change their buffer size before the first read.
+ */
+
+bool					/* O - `true` on success, `false` on error */
+cupsFileSetBufferSize(
+    cups_file_t *fp,			/* I - CUPS file */
+    size_t      bufsize)		/* I - Buffer size in bytes or `0` for the default */
+{
+  char	*buf;				/* New buffer */
+  Bytef	*cbuf;				/* New (de)compression buffer */
+
+
+ /*
+  * Range check input...
+  */
+
+  if (!fp)
+    return (false);
+
+  if (fp->mapped)
+    return (true);
+
+  if (bufsize == 0)
+    bufsize = _CUPS_FILE_BUFSIZE;
+  else if (bufsize < 256)
+    bufsize = 256;
+  else if (bufsize > _CUPS_FILE_MAX_BUFSIZE)
+    bufsize = _CUPS_FILE_MAX_BUFSIZE;
+
+  if (bufsize == fp->bufsize)
+    return (true);
+
+  if (fp->mode == 'w')
+  {
+   /*
+    * Write any buffered data...
+    */
+
+    if (!cupsFileFlush(fp))
+      return (false);
+
+    if (fp->compressed && fp->stream.next_out > fp->cbuf)
+    {
+      if (!cups_write(fp, (char *)fp->cbuf, (size_t)(fp->stream.next_out - fp->cbuf)))
+        return (false);
+    }
+  }
+  else if (fp->ptr)
+  {
+   /*
+    * Can't resize a read buffer that contains data...
+    */
+
+    return (false);
+  }
+
+ /*
+  * Reallocate the buffers...
+  */
+
+  if ((buf = realloc(fp->buf, bufsize)) == NULL)
+    return (false);
+
+  fp->buf     = buf;
+  fp->bufsize = bufsize;
+
+  if (fp->mode == 'w')
+  {
+   /*
+    * Point at the new buffer now so a failed (de)compression buffer
+    * reallocation below doesn't leave us using the old one...
+    */
+
+    fp->ptr = fp->buf;
+    fp->end = fp->buf + fp->bufsize;
+  }
+
+  if (fp->cbuf)
+  {
+    if ((cbuf = realloc(fp->cbuf, bufsize)) == NULL)
+      return (false);
+
+    fp->cbuf     = cbuf;
+    fp->cbufsize = bufsize;
+
+    if (fp->mode == 'w' && fp->compressed)
+    {
+      fp->stream.next_out  = fp->cbuf;
+      fp->stream.avail_out = (uInt)fp->cbufsize;
+    }
+  }
+
+  return (true);
+}
+
+
+/*
+ * 'cupsFileSetThreads()' - Set the number of compression threads for a file.
+ *
+ * This function sets the number of threads used to compress data written to a
+ * file opened with a compression level ("w1" to "w9").  Data is collected
+ * into blocks of at least 128k that are compressed in parallel and then
+ * written in order as a single gzip stream, so the file can be read by
+ * @link cupsFileOpen@, gunzip, and other gzip readers.
+ *
+ * A value of `0` (the default) compresses the data on the calling thread.
+ */
+
+bool					/* O - `true` on success, `false` on error */
+cupsFileSetThreads(cups_file_t *fp,	/* I - CUPS file */
+                   int         num_threads)
+					/* I - Number of threads or `0` for none */
+{
+  bool		ret;			/* Return value */
+  size_t	i;			/* Looping var */
+  int		status;			/* Deflate status */
+
+
+ /*
+  * Range check input...
+  */
+
+  if (!fp || fp->mode != 'w' || !fp->compressed || num_threads < 0)
+    return (false);
+
+  if (num_threads > 256)
+    num_threads = 256;
+
+ /*
+  * Write any buffered data...
+  */
+
+  ret = cupsFileFlush(fp);
+
+  if (fp->num_threads > 0)
+  {
+   /*
+    * Write any pending blocks and stop the current threads...
+    */
+
+    if (!cups_compress_drain(fp))
+      ret = false;
+
+    cups_compress_stop(fp);
+  }
+  else if (num_threads > 0 && ret)
+  {
+   /*
+    * Flush the compression stream to a byte boundary so that the blocks from
+    * the threads can follow it, and then start a new stream since the blocks
+    * do not share a dictionary with it...
+    */
+
+    bool	done;			/* Done writing... */
+
+    fp->stream.next_in  = NULL;
+    fp->stream.avail_in = 0;
+
+    for (done = false;;)
+    {
+      if (fp->stream.next_out > fp->cbuf)
+      {
+	ret = cups_write(fp, (char *)fp->cbuf, (size_t)(fp->stream.next_out - fp->cbuf));
+
+	fp->stream.next_out  = fp->cbuf;
+	fp->stream.avail_out = (uInt)fp->cbufsize;
+      }
+
+      if (done || !ret)
+	break;
+
+      if ((status = deflate(&fp->stream, Z_SYNC_FLUSH)) < Z_OK && status != Z_BUF_ERROR)
+        ret = false;
+
+      done = fp->stream.avail_out > 0;
+    }
+
+    deflateReset(&fp->stream);
+  }
+
+  if (num_threads == 0 || !ret)
+    return (ret);
+
+ /*
+  * Start the new threads...
+  */
+
+  fp->block_size = fp->bufsize > _CUPS_FILE_BLOCKSIZE ? fp->bufsize : _CUPS_FILE_BLOCKSIZE;
+
+  if ((fp->blocks = calloc((size_t)(2 * num_threads), sizeof(_cups_fblock_t))) == NULL || (fp->threads = calloc((size_t)num_threads, sizeof(cups_thread_t))) == NULL)
+  {
+    free(fp->blocks);
+    fp->blocks = NULL;
+    return (false);
+  }
+
+  cupsMutexInit(&fp->mutex);
+  cupsCondInit(&fp->cond);
+
+  fp->num_blocks    = (size_t)(2 * num_threads);
+  fp->block_first   = 0;
+  fp->block_current = 0;
+  fp->block_pending = 0;
+  fp->stop          = false;
+
+  for (i = 0; i < fp->num_blocks; i ++)
+  {
+    fp->blocks[i].outsize = compressBound((uLong)fp->block_size) + 64;
+
+    if ((fp->blocks[i].input = malloc(fp->block_size)) == NULL || (fp->blocks[i].output = malloc(fp->blocks[i].outsize)) == NULL)
+    {
+      cups_compress_stop(fp);
+      return (false);
+    }
+  }
+
+  for (fp->num_threads = 0; fp->num_threads < num_threads; fp->num_threads ++)
+  {
+    if ((fp->threads[fp->num_threads] = cupsThreadCreate((cups_thread_func_t)cups_compress_thread, fp)) == CUPS_THREAD_INVALID)
+    {
+      cups_compress_stop(fp);
+      return (false);
+    }
+  }
+
+  return (ret);
+}
+
+
+/*
+ * '_cupsFileSkip()' - Consume buffered data returned by @link _cupsFilePeekBuffer@.
+ */
+
+void
+_cupsFileSkip(cups_file_t *fp,		/* I - CUPS file */
+              size_t      bytes)	/* I - Number of bytes to consume */
+{
+  fp->ptr += bytes;
+  fp->pos += (off_t)bytes;
+}
+
+
 /*
  * 'cupsFileStderr()' - Return a CUPS file associated with stderr.
  */
@@ -1656,7 +2085,7 @@ cupsFileWrite(cups_file_t *fp,		/* I - CUPS file */
 
   fp->pos += (off_t)bytes;
 
-  if (bytes > sizeof(fp->buf))
+  if (bytes > fp->bufsize)
   {
     if (fp->compressed)
       return (cups_compress(fp, buf, bytes));
@@ -1684,6 +2113,35 @@ cups_compress(cups_file_t *fp,		/* I - CUPS file */
   int	status;				/* Deflate status */
 
 
+  if (fp->num_threads > 0)
+  {
+   /*
+    * Copy the bytes into compression blocks for the threads...
+    */
+
+    _cups_fblock_t	*block;		/* Current block */
+    size_t		count;		/* Bytes to copy */
+
+    while (bytes > 0)
+    {
+      block = fp->blocks + fp->block_current;
+
+      if ((count = fp->block_size - block->inused) > bytes)
+        count = bytes;
+
+      memcpy(block->input + block->inused, buf, count);
+
+      block->inused += count;
+      buf           += count;
+      bytes         -= count;
+
+      if (block->inused == fp->block_size && !cups_compress_queue(fp))
+        return (false);
+    }
+
+    return (true);
+  }
+
  /*
   * Update the CRC...
   */
@@ -1703,13 +2161,13 @@ cups_compress(cups_file_t *fp,		/* I - CUPS file */
     * Flush the current buffer...
     */
 
-    if (fp->stream.avail_out < (uInt)(sizeof(fp->cbuf) / 8))
+    if (fp->stream.avail_out < (uInt)(fp->cbufsize / 8))
     {
       if (!cups_write(fp, (char *)fp->cbuf, (size_t)(fp->stream.next_out - fp->cbuf)))
         return (false);
 
       fp->stream.next_out  = fp->cbuf;
-      fp->stream.avail_out = sizeof(fp->cbuf);
+      fp->stream.avail_out = (uInt)fp->cbufsize;
     }
 
     if ((status = deflate(&(fp->stream), Z_NO_FLUSH)) < Z_OK && status != Z_BUF_ERROR)
@@ -1720,6 +2178,228 @@ cups_compress(cups_file_t *fp,		/* I - CUPS file */
 }
 
 
+/*
+ * 'cups_compress_drain()' - Compress and write all pending blocks.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+cups_compress_drain(cups_file_t *fp)	/* I - CUPS file */
+{
+  bool	ret = true;			/* Return value */
+
+
+  if (fp->num_threads == 0)
+    return (true);
+
+  if (fp->blocks[fp->block_current].inused > 0)
+    ret = cups_compress_queue(fp);
+
+  while (fp->block_pending > 0)
+  {
+    if (!cups_compress_write(fp))
+      ret = false;
+  }
+
+  return (ret);
+}
+
+
+/*
+ * 'cups_compress_queue()' - Queue the current block for the compression threads.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+cups_compress_queue(cups_file_t *fp)	/* I - CUPS file */
+{
+  cupsMutexLock(&fp->mutex);
+
+  fp->blocks[fp->block_current].state = _CUPS_FBLOCK_QUEUED;
+  fp->block_current = (fp->block_current + 1) % fp->num_blocks;
+  fp->block_pending ++;
+
+  cupsCondBroadcast(&fp->cond);
+  cupsMutexUnlock(&fp->mutex);
+
+ /*
+  * Write the oldest block if we need its buffers for the next one...
+  */
+
+  if (fp->block_pending == fp->num_blocks)
+    return (cups_compress_write(fp));
+  else
+    return (true);
+}
+
+
+/*
+ * 'cups_compress_stop()' - Stop the compression threads and free the blocks.
+ */
+
+static void
+cups_compress_stop(cups_file_t *fp)	/* I - CUPS file */
+{
+  size_t	i;			/* Looping var */
+
+
+  if (!fp->blocks)
+    return;
+
+  cupsMutexLock(&fp->mutex);
+  fp->stop = true;
+  cupsCondBroadcast(&fp->cond);
+  cupsMutexUnlock(&fp->mutex);
+
+  for (i = 0; i < (size_t)fp->num_threads; i ++)
+    cupsThreadWait(fp->threads[i]);
+
+  for (i = 0; i < fp->num_blocks; i ++)
+  {
+    free(fp->blocks[i].input);
+    free(fp->blocks[i].output);
+  }
+
+  cupsCondDestroy(&fp->cond);
+  cupsMutexDestroy(&fp->mutex);
+
+  free(fp->blocks);
+  free(fp->threads);
+
+  fp->blocks      = NULL;
+  fp->threads     = NULL;
+  fp->num_blocks  = 0;
+  fp->num_threads = 0;
+}
+
+
+/*
+ * 'cups_compress_thread()' - Compress blocks of data.
+ *
+ * Each block is compressed as an independent series of deflate blocks that
+ * ends on a byte boundary, so the blocks can simply be concatenated.
+ */
+
+static void *				/* O - Thread exit status */
+cups_compress_thread(cups_file_t *fp)	/* I - CUPS file */
+{
+  size_t		i;		/* Looping var */
+  _cups_fblock_t	*block;		/* Current block */
+  z_stream		stream;		/* Compression stream */
+  bool			ok;		/* Is the compression stream OK? */
+
+
+  memset(&stream, 0, sizeof(stream));
+
+  ok = deflateInit2(&stream, fp->level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+
+  cupsMutexLock(&fp->mutex);
+
+  while (!fp->stop)
+  {
+   /*
+    * Find the oldest block that needs to be compressed...
+    */
+
+    for (i = 0, block = NULL; i < fp->block_pending; i ++)
+    {
+      block = fp->blocks + (fp->block_first + i) % fp->num_blocks;
+
+      if (block->state == _CUPS_FBLOCK_QUEUED)
+        break;
+
+      block = NULL;
+    }
+
+    if (!block)
+    {
+      cupsCondWait(&fp->cond, &fp->mutex, 0.0);
+      continue;
+    }
+
+   /*
+    * Compress the block without holding the lock...
+    */
+
+    block->state = _CUPS_FBLOCK_BUSY;
+
+    cupsMutexUnlock(&fp->mutex);
+
+    block->crc   = crc32(crc32(0L, Z_NULL, 0), block->input, (uInt)block->inused);
+    block->error = !ok;
+
+    if (ok)
+    {
+      deflateReset(&stream);
+
+      stream.next_in   = block->input;
+      stream.avail_in  = (uInt)block->inused;
+      stream.next_out  = block->output;
+      stream.avail_out = (uInt)block->outsize;
+
+      if (deflate(&stream, Z_SYNC_FLUSH) != Z_OK || stream.avail_in > 0 || stream.avail_out == 0)
+        block->error = true;
+
+      block->outused = (size_t)(stream.next_out - block->output);
+    }
+
+    cupsMutexLock(&fp->mutex);
+
+    block->state = _CUPS_FBLOCK_DONE;
+
+    cupsCondBroadcast(&fp->cond);
+  }
+
+  cupsMutexUnlock(&fp->mutex);
+
+  if (ok)
+    deflateEnd(&stream);
+
+  return (NULL);
+}
+
+
+/*
+ * 'cups_compress_write()' - Write the oldest block once it is compressed.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+cups_compress_write(cups_file_t *fp)	/* I - CUPS file */
+{
+  _cups_fblock_t	*block;		/* Block to write */
+  bool			ret;		/* Return value */
+
+
+  block = fp->blocks + fp->block_first;
+
+  cupsMutexLock(&fp->mutex);
+  while (block->state != _CUPS_FBLOCK_DONE)
+    cupsCondWait(&fp->cond, &fp->mutex, 0.0);
+  cupsMutexUnlock(&fp->mutex);
+
+  DEBUG_printf(("4cups_compress_write: Writing " CUPS_LLFMT " bytes for " CUPS_LLFMT " bytes of data.", CUPS_LLCAST block->outused, CUPS_LLCAST block->inused));
+
+  if (block->error)
+  {
+    ret = false;
+  }
+  else
+  {
+    ret     = cups_write(fp, (char *)block->output, block->outused);
+    fp->crc = crc32_combine(fp->crc, block->crc, (z_off_t)block->inused);
+  }
+
+  cupsMutexLock(&fp->mutex);
+
+  block->state    = _CUPS_FBLOCK_FREE;
+  block->inused   = 0;
+  fp->block_first = (fp->block_first + 1) % fp->num_blocks;
+  fp->block_pending --;
+
+  cupsMutexUnlock(&fp->mutex);
+
+  return (ret);
+}
+
+
 /*
  * 'cups_fill()' - Fill the input buffer.
  */
@@ -1733,6 +2413,17 @@ cups_fill(cups_file_t *fp)		/* I - CUPS file */
 			*end;		/* End of buffer */
 
 
+  if (fp->mapped)
+  {
+   /*
+    * All of a mapped file is already in the buffer...
+    */
+
+    fp->eof = true;
+
+    return (0);
+  }
+
   if (fp->ptr && fp->end)
     fp->bufpos += fp->end - fp->buf;
 
@@ -1756,7 +2447,7 @@ cups_fill(cups_file_t *fp)		/* I - CUPS file */
       * file...
       */
 
-      if ((bytes = cups_read(fp, (char *)fp->buf, sizeof(fp->buf))) < 0)
+      if ((bytes = cups_read(fp, (char *)fp->buf, fp->bufsize)) < 0)
       {
        /*
 	* Can't read from file!
@@ -1895,6 +2586,18 @@ cups_fill(cups_file_t *fp)		/* I - CUPS file */
       * Copy the flate-compressed data to the compression buffer...
       */
 
+      if (!fp->cbuf)
+      {
+        if ((fp->cbuf = malloc(fp->bufsize)) == NULL)
+        {
+          fp->eof = true;
+
+          return (-1);
+        }
+
+        fp->cbufsize = fp->bufsize;
+      }
+
       if ((bytes = end - ptr) > 0)
         memcpy(fp->cbuf, ptr, (size_t)bytes);
 
@@ -1937,7 +2640,7 @@ cups_fill(cups_file_t *fp)		/* I - CUPS file */
 
       if (fp->stream.avail_in == 0)
       {
-	if ((bytes = cups_read(fp, (char *)fp->cbuf, sizeof(fp->cbuf))) <= 0)
+	if ((bytes = cups_read(fp, (char *)fp->cbuf, fp->cbufsize)) <= 0)
 	{
 	  fp->eof = true;
 
@@ -1953,7 +2656,7 @@ cups_fill(cups_file_t *fp)		/* I - CUPS file */
       */
 
       fp->stream.next_out  = (Bytef *)fp->buf;
-      fp->stream.avail_out = sizeof(fp->buf);
+      fp->stream.avail_out = (uInt)fp->bufsize;
 
       status = inflate(&(fp->stream), Z_NO_FLUSH);
 
@@ -2030,7 +2733,7 @@ cups_fill(cups_file_t *fp)		/* I - CUPS file */
 	return (-1);
       }
 
-      bytes = (ssize_t)sizeof(fp->buf) - (ssize_t)fp->stream.avail_out;
+      bytes = (ssize_t)fp->bufsize - (ssize_t)fp->stream.avail_out;
 
      /*
       * Return the decompressed data...
@@ -2048,7 +2751,7 @@ cups_fill(cups_file_t *fp)		/* I - CUPS file */
   * Read a buffer's full of data...
   */
 
-  if ((bytes = cups_read(fp, fp->buf, sizeof(fp->buf))) <= 0)
+  if ((bytes = cups_read(fp, fp->buf, fp->bufsize)) <= 0)
   {
    /*
     * Can't read from file!
@@ -61,6 +61,8 @@ extern bool		cupsFilePuts(cups_file_t *fp, const char *s) _CUPS_PUBLIC;
 extern ssize_t		cupsFileRead(cups_file_t *fp, char *buf, size_t bytes) _CUPS_PUBLIC;
 extern off_t		cupsFileRewind(cups_file_t *fp) _CUPS_PUBLIC;
 extern off_t		cupsFileSeek(cups_file_t *fp, off_t pos) _CUPS_PUBLIC;
+extern bool		cupsFileSetBufferSize(cups_file_t *fp, size_t bufsize) _CUPS_PUBLIC;
+extern bool		cupsFileSetThreads(cups_file_t *fp, int num_threads) _CUPS_PUBLIC;
 extern cups_file_t	*cupsFileStderr(void) _CUPS_PUBLIC;
 extern cups_file_t	*cupsFileStdin(void) _CUPS_PUBLIC;
 extern cups_file_t	*cupsFileStdout(void) _CUPS_PUBLIC;
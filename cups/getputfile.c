@@ -24,6 +24,53 @@
 #endif /* _WIN32 || __EMX__ */
 
 
+/*
+ * Local constants...
+ */
+
+#define _CUPS_GET_CHUNK		1048576	/* Size of parallel range requests */
+#define _CUPS_GET_MAX		8	/* Maximum number of connections */
+#define _CUPS_GET_RETRIES	3	/* Retries without progress */
+
+
+/*
+ * Local types...
+ */
+
+typedef struct _cups_getrange_s		/**** Ranged GET data ****/
+{
+  cups_mutex_t	mutex;			/* Mutex for data */
+  const char	*resource;		/* Resource name */
+  int		fd;			/* File descriptor */
+  char		host[HTTP_MAX_HOST],	/* Hostname */
+		authstring[HTTP_MAX_VALUE],
+					/* Authorization value */
+		validator[HTTP_MAX_VALUE];
+					/* If-Range value */
+  int		port;			/* Port number */
+  http_encryption_t encryption;		/* Encryption requirements */
+  off_t		chunk,			/* Size of each range or 0 for the rest */
+		next,			/* Next byte to request */
+		last;			/* Last byte to request */
+  bool		cancel;			/* Stop requesting ranges? */
+  size_t	num_retries;		/* Number of ranges to retry */
+  off_t		retries[_CUPS_GET_MAX][2];
+					/* Ranges to retry */
+} _cups_getrange_t;
+
+
+/*
+ * Local functions...
+ */
+
+static bool		cups_get_chunk(_cups_getrange_t *gr, off_t *first, off_t *last);
+static bool		cups_get_copy(_cups_getrange_t *gr, http_t *http, off_t pos, off_t *first, off_t last);
+static http_status_t	cups_get_range(_cups_getrange_t *gr, http_t *http, off_t *first, off_t last, bool can_auth);
+static http_status_t	cups_get_request(http_t *http, const char *resource, off_t first, off_t last, const char *validator, bool can_auth);
+static void		*cups_get_thread(_cups_getrange_t *gr);
+static bool		cups_get_write(int fd, const char *buffer, size_t bytes, off_t offset);
+
+
 /*
  * 'cupsGetFd()' - Get a file from the server.
  *
@@ -38,10 +85,6 @@ cupsGetFd(http_t     *http,		/* I - Connection to server or @code CUPS_HTTP_DEFA
   ssize_t	bytes;			/* Number of bytes read */
   char		buffer[8192];		/* Buffer for file */
   http_status_t	status;			/* HTTP status from server */
-  char		if_modified_since[HTTP_MAX_VALUE];
-					/* If-Modified-Since header */
-  int		new_auth = 0;		/* Using new auth information? */
-  int		digest;			/* Are we using Digest authentication? */
 
 
  /*
@@ -66,130 +109,251 @@ cupsGetFd(http_t     *http,		/* I - Connection to server or @code CUPS_HTTP_DEFA
   * Then send GET requests to the HTTP server...
   */
 
-  cupsCopyString(if_modified_since, httpGetField(http, HTTP_FIELD_IF_MODIFIED_SINCE),
-          sizeof(if_modified_since));
+  status = cups_get_request(http, resource, -1, -1, NULL, true);
 
-  do
+ /*
+  * See if we actually got the file or an error...
+  */
+
+  if (status == HTTP_STATUS_OK)
   {
-    if (!_cups_strcasecmp(httpGetField(http, HTTP_FIELD_CONNECTION), "close"))
-    {
-      httpClearFields(http);
-      if (!httpReconnect(http, 30000, NULL))
-      {
-	status = HTTP_STATUS_ERROR;
-	break;
-      }
-    }
+   /*
+    * Yes, copy the file...
+    */
 
-    httpClearFields(http);
-    httpSetField(http, HTTP_FIELD_IF_MODIFIED_SINCE, if_modified_since);
+    while ((bytes = httpRead(http, buffer, sizeof(buffer))) > 0)
+      write(fd, buffer, (size_t)bytes);
+  }
+  else
+  {
+    _cupsSetHTTPError(status);
+    httpFlush(http);
+  }
 
-    digest = http->authstring && !strncmp(http->authstring, "Digest ", 7);
+ /*
+  * Return the request status...
+  */
 
-    if (digest && !new_auth)
-    {
-     /*
-      * Update the Digest authentication string...
-      */
+  DEBUG_printf(("1cupsGetFd: Returning %d...", status));
 
-      _httpSetDigestAuthString(http, http->nextnonce, "GET", resource);
+  return (status);
+}
+
+
+/*
+ * 'cupsGetFdRange()' - Get part of a file from the server.
+ *
+ * This function gets "length" bytes starting at byte "offset" of the resource,
+ * or everything from "offset" to the end of the resource when "length" is
+ * `0`.  The data is written to the file descriptor at the same offset, so an
+ * interrupted download can be continued by passing the current size of the
+ * file as the "offset".  Non-seekable file descriptors such as pipes receive
+ * the data sequentially.
+ *
+ * Range requests use the "If-Range" header field with the resource's entity
+ * tag or modification date, and are automatically resumed when a connection
+ * is dropped.  When "num_connections" is greater than `1` and "fd" is
+ * seekable, up to that many connections are used to get large resources in
+ * parallel.
+ *
+ * This function returns @code HTTP_STATUS_OK@ when the requested data is
+ * successfully retrieved.
+ */
+
+http_status_t				/* O - HTTP status */
+cupsGetFdRange(
+    http_t     *http,			/* I - Connection to server or @code CUPS_HTTP_DEFAULT@ */
+    const char *resource,		/* I - Resource name */
+    int        fd,			/* I - File descriptor */
+    off_t      offset,			/* I - Offset of first byte */
+    off_t      length,			/* I - Number of bytes or `0` for the rest of the resource */
+    size_t     num_connections)		/* I - Maximum number of connections */
+{
+  http_status_t		status;		/* HTTP status from server */
+  _cups_getrange_t	gr;		/* Range data */
+  off_t			first,		/* First byte of current range */
+			last;		/* Last byte of current range */
+  long long		cr_first,	/* First byte from Content-Range */
+			cr_last,	/* Last byte from Content-Range */
+			cr_total;	/* Total length from Content-Range */
+  const char		*value;		/* Header field value */
+  size_t		i,		/* Looping var */
+			num_threads = 0;/* Number of threads */
+  cups_thread_t		threads[_CUPS_GET_MAX];
+					/* Worker threads */
+
+
+ /*
+  * Range check input...
+  */
+
+  DEBUG_printf(("cupsGetFdRange(http=%p, resource=\"%s\", fd=%d, offset=" CUPS_LLFMT ", length=" CUPS_LLFMT ", num_connections=%u)", (void *)http, resource, fd, CUPS_LLCAST offset, CUPS_LLCAST length, (unsigned)num_connections));
+
+  if (!resource || fd < 0 || offset < 0 || length < 0)
+  {
+    if (http)
+      http->error = EINVAL;
+
+    return (HTTP_STATUS_ERROR);
+  }
+
+  if (!http)
+    if ((http = _cupsConnect()) == NULL)
+      return (HTTP_STATUS_SERVICE_UNAVAILABLE);
+
+  if (num_connections < 1)
+    num_connections = 1;
+  else if (num_connections > _CUPS_GET_MAX)
+    num_connections = _CUPS_GET_MAX;
+
+#ifdef _WIN32
+  num_connections = 1;
+#else
+  if (num_connections > 1 && lseek(fd, 0, SEEK_CUR) < 0)
+    num_connections = 1;
+#endif /* _WIN32 */
+
+  memset(&gr, 0, sizeof(gr));
+  cupsMutexInit(&gr.mutex);
+
+  gr.resource = resource;
+  gr.fd       = fd;
+  gr.chunk    = num_connections > 1 ? _CUPS_GET_CHUNK : 0;
+
+ /*
+  * Request the first range, which tells us the length of the resource...
+  */
+
+  first = offset;
+  last  = length > 0 ? offset + length - 1 : -1;
+
+  if (gr.chunk && (last < 0 || (last - first) >= gr.chunk))
+    status = cups_get_request(http, resource, first, first + gr.chunk - 1, NULL, true);
+  else
+    status = cups_get_request(http, resource, first, last, NULL, true);
+
+  if (status == HTTP_STATUS_OK)
+  {
+   /*
+    * Server doesn't support ranges, skip to the requested data...
+    */
+
+    if (!cups_get_copy(&gr, http, 0, &first, last))
+    {
+      httpFlush(http);
+      status = HTTP_STATUS_ERROR;
     }
+    else if (last >= 0 && first > last)
+    {
+      if (httpGetState(http) != HTTP_STATE_WAITING)
+        httpFlush(http);
+    }
+    else if (httpGetState(http) != HTTP_STATE_WAITING)
+      status = HTTP_STATUS_ERROR;
+  }
+  else if (status == HTTP_STATUS_PARTIAL_CONTENT)
+  {
+   /*
+    * Figure out which part of the resource we are getting...
+    */
 
-    httpSetField(http, HTTP_FIELD_AUTHORIZATION, http->authstring);
+    cr_total = -1;
 
-    if (!httpWriteRequest(http, "GET", resource))
+    if (sscanf(httpGetField(http, HTTP_FIELD_CONTENT_RANGE), "bytes " CUPS_LLFMT "-" CUPS_LLFMT "/" CUPS_LLFMT, &cr_first, &cr_last, &cr_total) < 2 || cr_first != first || cr_last < cr_first)
     {
-      if (httpReconnect(http, 30000, NULL))
-      {
-        status = HTTP_STATUS_UNAUTHORIZED;
-        continue;
-      }
-      else
-      {
-        status = HTTP_STATUS_ERROR;
-	break;
-      }
+      DEBUG_printf(("1cupsGetFdRange: Bad Content-Range \"%s\".", httpGetField(http, HTTP_FIELD_CONTENT_RANGE)));
+      httpFlush(http);
+      status = HTTP_STATUS_ERROR;
+      goto done;
     }
 
-    new_auth = 0;
+    if (last < 0)
+      last = cr_total > 0 ? (off_t)cr_total - 1 : (off_t)cr_last;
+    else if (cr_total > 0 && last >= cr_total)
+      last = (off_t)cr_total - 1;
 
-    while ((status = httpUpdate(http)) == HTTP_STATUS_CONTINUE);
+   /*
+    * Use a strong entity tag or the modification date to make sure the
+    * resource doesn't change between requests...
+    */
 
-    if (status == HTTP_STATUS_UNAUTHORIZED)
-    {
-     /*
-      * Flush any error message...
-      */
+    if ((value = httpGetField(http, HTTP_FIELD_ETAG)) != NULL && *value == '\"')
+      cupsCopyString(gr.validator, value, sizeof(gr.validator));
+    else if ((value = httpGetField(http, HTTP_FIELD_LAST_MODIFIED)) != NULL)
+      cupsCopyString(gr.validator, value, sizeof(gr.validator));
 
-      httpFlush(http);
+    gr.next = (off_t)cr_last + 1;
+    gr.last = last;
 
-     /*
-      * See if we can do authentication...
-      */
+   /*
+    * Start additional connections as needed...
+    */
 
-      new_auth = 1;
+    if (gr.chunk && gr.next <= gr.last)
+    {
+      cupsCopyString(gr.host, http->hostname, sizeof(gr.host));
+      cupsCopyString(gr.authstring, http->authstring ? http->authstring : "", sizeof(gr.authstring));
 
-      if (cupsDoAuthentication(http, "GET", resource))
-      {
-        status = HTTP_STATUS_CUPS_AUTHORIZATION_CANCELED;
-        break;
-      }
+      gr.port       = httpAddrGetPort(http->hostaddr);
+      gr.encryption = http->encryption;
 
-      if (!httpReconnect(http, 30000, NULL))
+      for (i = (size_t)((gr.last - gr.next) / gr.chunk + 1); num_threads < (num_connections - 1) && num_threads < i; num_threads ++)
       {
-        status = HTTP_STATUS_ERROR;
-        break;
+        if ((threads[num_threads] = cupsThreadCreate((cups_thread_func_t)cups_get_thread, &gr)) == CUPS_THREAD_INVALID)
+          break;
       }
-
-      continue;
     }
-#ifdef HAVE_TLS
-    else if (status == HTTP_STATUS_UPGRADE_REQUIRED)
+
+   /*
+    * Copy the first range and then any ranges left over...
+    */
+
+    if (!cups_get_copy(&gr, http, first, &first, (off_t)cr_last))
     {
-      /* Flush any error message... */
       httpFlush(http);
+      status = HTTP_STATUS_ERROR;
+    }
+    else
+    {
+      if (first <= cr_last)
+        status = cups_get_range(&gr, http, &first, (off_t)cr_last, true);
+      else
+        status = HTTP_STATUS_OK;
 
-      /* Reconnect... */
-      if (!httpReconnect(http, 30000, NULL))
-      {
-        status = HTTP_STATUS_ERROR;
-        break;
-      }
-
-      /* Upgrade with encryption... */
-      httpSetEncryption(http, HTTP_ENCRYPTION_REQUIRED);
+      while (status == HTTP_STATUS_OK && cups_get_chunk(&gr, &first, &last))
+        status = cups_get_range(&gr, http, &first, last, true);
+    }
 
-      /* Try again, this time with encryption enabled... */
-      continue;
+    if (status != HTTP_STATUS_OK)
+    {
+      cupsMutexLock(&gr.mutex);
+      gr.cancel = true;
+      cupsMutexUnlock(&gr.mutex);
     }
-#endif /* HAVE_TLS */
-  }
-  while (status == HTTP_STATUS_UNAUTHORIZED || status == HTTP_STATUS_UPGRADE_REQUIRED);
 
- /*
-  * See if we actually got the file or an error...
-  */
+    for (i = 0; i < num_threads; i ++)
+      cupsThreadWait(threads[i]);
 
-  if (status == HTTP_STATUS_OK)
-  {
    /*
-    * Yes, copy the file...
+    * Get any ranges the other connections were unable to get...
     */
 
-    while ((bytes = httpRead(http, buffer, sizeof(buffer))) > 0)
-      write(fd, buffer, (size_t)bytes);
+    while (status == HTTP_STATUS_OK && cups_get_chunk(&gr, &first, &last))
+      status = cups_get_range(&gr, http, &first, last, true);
   }
   else
   {
-    _cupsSetHTTPError(status);
     httpFlush(http);
   }
 
- /*
-  * Return the request status...
-  */
+  done:
 
-  DEBUG_printf(("1cupsGetFd: Returning %d...", status));
+  if (status != HTTP_STATUS_OK)
+    _cupsSetHTTPError(status);
+
+  cupsMutexDestroy(&gr.mutex);
+
+  DEBUG_printf(("1cupsGetFdRange: Returning %d...", status));
 
   return (status);
 }
@@ -272,9 +436,8 @@ cupsPutFd(http_t     *http,		/* I - Connection to server or @code CUPS_HTTP_DEFA
           const char *resource,		/* I - Resource name */
 	  int        fd)		/* I - File descriptor */
 {
-  ssize_t	bytes;			/* Number of bytes read */
+  off_t		bytes;			/* Number of bytes written */
   int		retries;		/* Number of retries */
-  char		buffer[8192];		/* Buffer for file */
   http_status_t	status;			/* HTTP status from server */
   int		new_auth = 0;		/* Using new auth information? */
   int		digest;			/* Are we using Digest authentication? */
@@ -367,25 +530,27 @@ cupsPutFd(http_t     *http,		/* I - Connection to server or @code CUPS_HTTP_DEFA
 
       lseek(fd, 0, SEEK_SET);
 
-      while ((bytes = read(fd, buffer, sizeof(buffer))) > 0)
+      do
       {
 	if (httpCheck(http))
 	{
           if ((status = httpUpdate(http)) != HTTP_STATUS_CONTINUE)
             break;
 	}
-	else if (httpWrite(http, buffer, (size_t)bytes) < 0)
+
+	if ((bytes = httpWriteFd(http, fd, _HTTP_MAX_SENDFILE)) < 0)
 	{
 	  status = HTTP_STATUS_ERROR;
 	  break;
 	}
       }
+      while (bytes > 0);
     }
 
     if (status == HTTP_STATUS_CONTINUE)
     {
       // Write 0-length chunk...
-      if (httpWrite(http, buffer, 0) < 0)
+      if (httpWrite(http, "", 0) < 0)
       {
         status = HTTP_STATUS_ERROR;
       }
@@ -541,3 +706,396 @@ cupsPutFile(http_t     *http,		/* I - Connection to server or @code CUPS_HTTP_DE
 
   return (status);
 }
+
+
+/*
+ * 'cups_get_chunk()' - Get the next range to request.
+ */
+
+static bool				/* O - `true` if there is a range, `false` if done */
+cups_get_chunk(_cups_getrange_t *gr,	/* I - Range data */
+               off_t            *first,	/* O - First byte */
+               off_t            *last)	/* O - Last byte */
+{
+  bool	ret = true;			/* Return value */
+
+
+  cupsMutexLock(&gr->mutex);
+
+  if (gr->cancel)
+  {
+    ret = false;
+  }
+  else if (gr->num_retries > 0)
+  {
+    gr->num_retries --;
+
+    *first = gr->retries[gr->num_retries][0];
+    *last  = gr->retries[gr->num_retries][1];
+  }
+  else if (gr->next <= gr->last)
+  {
+    *first = gr->next;
+
+    if (gr->chunk && (gr->last - gr->next) >= gr->chunk)
+      *last = gr->next + gr->chunk - 1;
+    else
+      *last = gr->last;
+
+    gr->next = *last + 1;
+  }
+  else
+  {
+    ret = false;
+  }
+
+  cupsMutexUnlock(&gr->mutex);
+
+  return (ret);
+}
+
+
+/*
+ * 'cups_get_copy()' - Copy response data to the file.
+ *
+ * Data before "*first" or after "last" is discarded, and "*first" is updated
+ * to the next byte that is needed.
+ */
+
+static bool				/* O - `true` on success, `false` on write error */
+cups_get_copy(_cups_getrange_t *gr,	/* I  - Range data */
+              http_t           *http,	/* I  - HTTP connection */
+              off_t            pos,	/* I  - Offset of response data */
+              off_t            *first,	/* IO - First byte needed */
+              off_t            last)	/* I  - Last byte needed or -1 for all */
+{
+  ssize_t	bytes;			/* Bytes read */
+  off_t		skip;			/* Bytes to skip */
+  char		buffer[32768];		/* Copy buffer */
+
+
+  while ((last < 0 || *first <= last) && (bytes = httpRead(http, buffer, sizeof(buffer))) > 0)
+  {
+    if (pos + bytes > *first)
+    {
+      skip = *first > pos ? *first - pos : 0;
+
+      if (last >= 0 && pos + bytes > last + 1)
+        bytes = (ssize_t)(last + 1 - pos);
+
+      if (!cups_get_write(gr->fd, buffer + skip, (size_t)(bytes - skip), pos + skip))
+        return (false);
+
+      *first = pos + bytes;
+    }
+
+    pos += bytes;
+  }
+
+  return (true);
+}
+
+
+/*
+ * 'cups_get_range()' - Get a range of bytes, resuming as needed.
+ */
+
+static http_status_t			/* O  - HTTP status */
+cups_get_range(_cups_getrange_t *gr,	/* I  - Range data */
+               http_t           *http,	/* I  - HTTP connection */
+               off_t            *first,	/* IO - First byte */
+               off_t            last,	/* I  - Last byte */
+               bool             can_auth)/* I  - Allow authentication? */
+{
+  http_status_t	status = HTTP_STATUS_OK;/* HTTP status from server */
+  int		tries = 0;		/* Tries without progress */
+  off_t		before;			/* First byte before request */
+  long long	cr_first;		/* First byte from Content-Range */
+
+
+  while (*first <= last)
+  {
+    if (tries >= _CUPS_GET_RETRIES)
+      return (HTTP_STATUS_ERROR);
+
+    if (httpGetState(http) != HTTP_STATE_WAITING)
+    {
+     /*
+      * Connection dropped, reconnect to continue...
+      */
+
+      DEBUG_printf(("2cups_get_range: Resuming at " CUPS_LLFMT ".", CUPS_LLCAST *first));
+
+      if (!httpReconnect(http, 30000, NULL))
+        return (HTTP_STATUS_ERROR);
+    }
+
+    before = *first;
+    status = cups_get_request(http, gr->resource, *first, last, gr->validator[0] ? gr->validator : NULL, can_auth);
+
+    if (status == HTTP_STATUS_PARTIAL_CONTENT)
+    {
+      if (sscanf(httpGetField(http, HTTP_FIELD_CONTENT_RANGE), "bytes " CUPS_LLFMT "-", &cr_first) != 1 || cr_first > *first)
+      {
+        httpFlush(http);
+        return (HTTP_STATUS_ERROR);
+      }
+
+      if (!cups_get_copy(gr, http, (off_t)cr_first, first, last))
+      {
+        httpFlush(http);
+        return (HTTP_STATUS_ERROR);
+      }
+    }
+    else if (status == HTTP_STATUS_OK)
+    {
+     /*
+      * The resource changed or the server no longer supports ranges...
+      */
+
+      httpFlush(http);
+      return (HTTP_STATUS_PRECONDITION_FAILED);
+    }
+    else if (status == HTTP_STATUS_ERROR)
+    {
+      if (!httpReconnect(http, 30000, NULL))
+        return (HTTP_STATUS_ERROR);
+    }
+    else
+    {
+      httpFlush(http);
+      return (status);
+    }
+
+    if (*first > before)
+      tries = 0;
+    else
+      tries ++;
+  }
+
+  return (HTTP_STATUS_OK);
+}
+
+
+/*
+ * 'cups_get_request()' - Send a GET request and wait for the response.
+ *
+ * A "first" value of -1 requests the whole resource, otherwise bytes "first"
+ * through "last" (or the end of the resource when "last" is -1) are requested.
+ */
+
+static http_status_t			/* O - HTTP status */
+cups_get_request(
+    http_t     *http,			/* I - HTTP connection */
+    const char *resource,		/* I - Resource name */
+    off_t      first,			/* I - First byte or -1 for all */
+    off_t      last,			/* I - Last byte or -1 for the rest */
+    const char *validator,		/* I - If-Range value or `NULL` */
+    bool       can_auth)		/* I - Allow authentication? */
+{
+  http_status_t	status;			/* HTTP status from server */
+  char		if_modified_since[HTTP_MAX_VALUE],
+					/* If-Modified-Since header */
+		range[256];		/* Range header */
+  int		new_auth = 0;		/* Using new auth information? */
+  int		digest;			/* Are we using Digest authentication? */
+
+
+  cupsCopyString(if_modified_since, httpGetField(http, HTTP_FIELD_IF_MODIFIED_SINCE),
+          sizeof(if_modified_since));
+
+  do
+  {
+    if (!_cups_strcasecmp(httpGetField(http, HTTP_FIELD_CONNECTION), "close"))
+    {
+      httpClearFields(http);
+      if (!httpReconnect(http, 30000, NULL))
+      {
+	status = HTTP_STATUS_ERROR;
+	break;
+      }
+    }
+
+    httpClearFields(http);
+    httpSetField(http, HTTP_FIELD_IF_MODIFIED_SINCE, if_modified_since);
+
+    if (first >= 0)
+    {
+      if (last >= 0)
+        snprintf(range, sizeof(range), "bytes=" CUPS_LLFMT "-" CUPS_LLFMT, CUPS_LLCAST first, CUPS_LLCAST last);
+      else
+        snprintf(range, sizeof(range), "bytes=" CUPS_LLFMT "-", CUPS_LLCAST first);
+
+      httpSetField(http, HTTP_FIELD_RANGE, range);
+      httpSetField(http, HTTP_FIELD_IF_RANGE, validator);
+    }
+
+    digest = http->authstring && !strncmp(http->authstring, "Digest ", 7);
+
+    if (digest && !new_auth)
+    {
+     /*
+      * Update the Digest authentication string...
+      */
+
+      _httpSetDigestAuthString(http, http->nextnonce, "GET", resource);
+    }
+
+    httpSetField(http, HTTP_FIELD_AUTHORIZATION, http->authstring);
+
+    if (!httpWriteRequest(http, "GET", resource))
+    {
+      if (httpReconnect(http, 30000, NULL))
+      {
+        status = can_auth ? HTTP_STATUS_UNAUTHORIZED : HTTP_STATUS_ERROR;
+        continue;
+      }
+      else
+      {
+        status = HTTP_STATUS_ERROR;
+	break;
+      }
+    }
+
+    new_auth = 0;
+
+    while ((status = httpUpdate(http)) == HTTP_STATUS_CONTINUE);
+
+    if (status == HTTP_STATUS_UNAUTHORIZED && can_auth)
+    {
+     /*
+      * Flush any error message...
+      */
+
+      httpFlush(http);
+
+     /*
+      * See if we can do authentication...
+      */
+
+      new_auth = 1;
+
+      if (cupsDoAuthentication(http, "GET", resource))
+      {
+        status = HTTP_STATUS_CUPS_AUTHORIZATION_CANCELED;
+        break;
+      }
+
+      if (!httpReconnect(http, 30000, NULL))
+      {
+        status = HTTP_STATUS_ERROR;
+        break;
+      }
+
+      continue;
+    }
+#ifdef HAVE_TLS
+    else if (status == HTTP_STATUS_UPGRADE_REQUIRED)
+    {
+      /* Flush any error message... */
+      httpFlush(http);
+
+      /* Reconnect... */
+      if (!httpReconnect(http, 30000, NULL))
+      {
+        status = HTTP_STATUS_ERROR;
+        break;
+      }
+
+      /* Upgrade with encryption... */
+      httpSetEncryption(http, HTTP_ENCRYPTION_REQUIRED);
+
+      /* Try again, this time with encryption enabled... */
+      continue;
+    }
+#endif /* HAVE_TLS */
+  }
+  while ((status == HTTP_STATUS_UNAUTHORIZED && can_auth) || status == HTTP_STATUS_UPGRADE_REQUIRED);
+
+  return (status);
+}
+
+
+/*
+ * 'cups_get_thread()' - Get ranges using a separate connection.
+ */
+
+static void *				/* O - Thread exit status (unused) */
+cups_get_thread(_cups_getrange_t *gr)	/* I - Range data */
+{
+  http_t	*http;			/* HTTP connection */
+  off_t		first,			/* First byte */
+		last;			/* Last byte */
+
+
+  if ((http = httpConnect(gr->host, gr->port, NULL, AF_UNSPEC, gr->encryption, true, 30000, NULL)) == NULL)
+    return (NULL);
+
+ /*
+  * Digest authentication needs a nonce from the server, so only reuse other
+  * kinds of authorization.  Ranges that cannot be retrieved here are left for
+  * the main connection...
+  */
+
+  if (gr->authstring[0] && strncmp(gr->authstring, "Digest ", 7))
+    httpSetAuthString(http, gr->authstring, NULL);
+
+  while (cups_get_chunk(gr, &first, &last))
+  {
+    if (cups_get_range(gr, http, &first, last, false) != HTTP_STATUS_OK)
+    {
+      cupsMutexLock(&gr->mutex);
+      gr->retries[gr->num_retries][0] = first;
+      gr->retries[gr->num_retries][1] = last;
+      gr->num_retries ++;
+      cupsMutexUnlock(&gr->mutex);
+      break;
+    }
+  }
+
+  httpClose(http);
+
+  return (NULL);
+}
+
+
+/*
+ * 'cups_get_write()' - Write data at an offset in a file.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+cups_get_write(int        fd,		/* I - File descriptor */
+               const char *buffer,	/* I - Buffer */
+               size_t     bytes,	/* I - Number of bytes */
+               off_t      offset)	/* I - Offset in file */
+{
+  ssize_t	written;		/* Bytes written */
+
+
+  while (bytes > 0)
+  {
+#ifdef _WIN32
+    if (lseek(fd, offset, SEEK_SET) < 0 && errno != ESPIPE)
+      return (false);
+
+    written = write(fd, buffer, (unsigned)bytes);
+#else
+    if ((written = pwrite(fd, buffer, bytes, offset)) < 0 && errno == ESPIPE)
+      written = write(fd, buffer, bytes);
+#endif /* _WIN32 */
+
+    if (written < 0)
+    {
+      if (errno == EINTR || errno == EAGAIN)
+        continue;
+
+      return (false);
+    }
+
+    buffer += written;
+    bytes  -= (size_t)written;
+    offset += written;
+  }
+
+  return (true);
+}
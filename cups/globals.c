@@ -374,6 +374,13 @@ cups_globals_free(_cups_globals_t *cg)	// I - Pointer to global data
   cupsFileClose(cg->stdio_files[2]);
 
   free(cg->raster_error.start);
+
+  _cupsStatsRelease(cg->stats);
+
+#ifdef DEBUG
+  _cups_debug_trace_release(cg->debug_trace);
+#endif // DEBUG
+
   free(cg);
 }
 
@@ -26,9 +26,132 @@
 #endif /* _WIN32 */
 
 
+/*
+ * Local constants...
+ */
+
+#define _HTTP_CONNECT_DELAY	250	/* Default connection attempt delay in milliseconds */
+#define _HTTP_CONNECT_MAX	32	/* Maximum number of remembered addresses */
+#define _HTTP_CONNECT_TTL	600	/* Seconds to remember a successful address */
+#define _HTTP_DNS_MAX		128	/* Maximum number of cached lookups */
+#define _HTTP_DNS_NEGATIVE_TTL	10	/* Default seconds to remember failed lookups */
+#define _HTTP_DNS_TTL		60	/* Default seconds to remember lookups */
+
+
+/*
+ * Local types...
+ */
+
+typedef struct _http_dns_s		/**** Cached address lookup ****/
+{
+  char		*hostname,		/* Hostname */
+		*service;		/* Service name or port number */
+  int		family;			/* Address family */
+  time_t	expires;		/* Expiration time */
+  int		error;			/* getaddrinfo() error, if any */
+  http_addrlist_t *addrlist;		/* Addresses */
+} _http_dns_t;
+
+typedef struct _http_resolve_s		/**** Asynchronous address lookup ****/
+{
+  char		*hostname,		/* Hostname */
+		*service;		/* Service name or port number */
+  int		family;			/* Address family */
+  http_addrlist_cb_t cb;		/* Callback */
+  void		*cb_data;		/* Callback data */
+} _http_resolve_t;
+
+typedef struct _http_winner_s		/**** Successful connection ****/
+{
+  http_addr_t	addr;			/* Address and port */
+  time_t	time;			/* Time of connection */
+} _http_winner_t;
+
+
+/*
+ * Local globals...
+ */
+
+static cups_mutex_t	http_connect_mutex = CUPS_MUTEX_INITIALIZER;
+					/* Mutex for connection data */
+static int		http_connect_delay = _HTTP_CONNECT_DELAY;
+					/* Connection attempt delay */
+static int		http_num_winners = 0;
+					/* Number of successful addresses */
+static _http_winner_t	http_winners[_HTTP_CONNECT_MAX];
+					/* Successful addresses, most recent first */
+static cups_mutex_t	http_dns_mutex = CUPS_MUTEX_INITIALIZER;
+					/* Mutex for lookup cache */
+static cups_array_t	*http_dns = NULL;
+					/* Cached lookups */
+static int		http_dns_ttl = _HTTP_DNS_TTL,
+					/* Time-to-live for lookups */
+			http_dns_negative_ttl = _HTTP_DNS_NEGATIVE_TTL;
+					/* Time-to-live for failed lookups */
+
+
+/*
+ * Local functions...
+ */
+
+static void		http_add_winner(http_addr_t *addr);
+static int		http_compare_dns(_http_dns_t *a, _http_dns_t *b, void *data);
+static void		http_free_dns(_http_dns_t *dns, void *data);
+static bool		http_get_dns(const char *hostname, int family, const char *service, http_addrlist_t **addrlist, int *error);
+static long long	http_get_msec(void);
+static void		http_put_dns(const char *hostname, int family, const char *service, http_addrlist_t *addrlist, int error);
+static void		*http_resolve_thread(_http_resolve_t *resolve);
+static int		http_sort_addrs(http_addrlist_t *addrlist, http_addrlist_t **order);
+static int		http_start_connect(http_addrlist_t *addr, int *fd);
+
+
+/*
+ * 'httpAddrClearCache()' - Clear cached address lookups.
+ *
+ * This function removes the cached addresses for "hostname", or all cached
+ * addresses when "hostname" is `NULL`, so that the next call to
+ * @link httpAddrGetList@ looks them up again.
+ */
+
+void
+httpAddrClearCache(
+    const char *hostname)		/* I - Hostname or `NULL` for all */
+{
+  _http_dns_t	*dns;			/* Current entry */
+
+
+  DEBUG_printf(("httpAddrClearCache(hostname=\"%s\")", hostname));
+
+  cupsMutexLock(&http_dns_mutex);
+
+  if (!hostname)
+  {
+    cupsArrayDelete(http_dns);
+    http_dns = NULL;
+  }
+  else
+  {
+    for (dns = (_http_dns_t *)cupsArrayGetFirst(http_dns); dns; dns = (_http_dns_t *)cupsArrayGetNext(http_dns))
+    {
+      if (!_cups_strcasecmp(dns->hostname, hostname))
+        cupsArrayRemove(http_dns, dns);
+    }
+  }
+
+  cupsMutexUnlock(&http_dns_mutex);
+}
+
+
 /*
  * 'httpAddrConnect()' - Connect to any of the addresses in the list with a
  *                       timeout and optional cancel.
+ *
+ * Connection attempts are made using the "Happy Eyeballs" algorithm from
+ * RFC 8305: the address that last connected successfully is tried first,
+ * followed by the remaining addresses alternating between address families.
+ * A new attempt is started whenever the previous one fails or after the
+ * connection attempt delay set with @link httpAddrSetConnectDelay@, and the
+ * first attempt to succeed is used.
  */
 
 http_addrlist_t *			/* O - Connected address or NULL on failure */
@@ -38,19 +161,23 @@ httpAddrConnect(
     int             msec,		/* I - Timeout in milliseconds */
     int             *cancel)		/* I - Pointer to "cancel" variable */
 {
-  int			val;		/* Socket option value */
-#ifndef _WIN32
-  int			i, j,		/* Looping vars */
-			flags,		/* Socket flags */
-			result;		/* Result from select() or poll() */
-#endif /* !_WIN32 */
-  int			remaining;	/* Remaining timeout */
-  int			nfds,		/* Number of file descriptors */
-			fds[100];	/* Socket file descriptors */
-  http_addrlist_t	*addrs[100];	/* Addresses */
-#ifdef O_NONBLOCK
-  struct pollfd		pfds[100];	/* Polled file descriptors */
-#endif /* O_NONBLOCK */
+  int			i,		/* Looping var */
+			count,		/* Number of addresses */
+			next,		/* Next address to try */
+			nfds,		/* Number of pending connections */
+			*fds,		/* Pending sockets */
+			delay,		/* Connection attempt delay */
+			result,		/* Result from poll() */
+			timeout,	/* Timeout for poll() */
+			error = 0;	/* Error code */
+  http_addrlist_t	*current,	/* Current address */
+			*connaddr = NULL,/* Connected address */
+			**order,	/* Addresses in connection order */
+			**addrs;	/* Pending addresses */
+  struct pollfd		*pfds;		/* Polled file descriptors */
+  long long		curtime,	/* Current time */
+			endtime,	/* Timeout time */
+			nexttime;	/* Time for next attempt */
 #ifdef DEBUG
 #  ifndef _WIN32
   socklen_t		len;		/* Length of value */
@@ -60,7 +187,7 @@ httpAddrConnect(
 #endif /* DEBUG */
 
 
-  DEBUG_printf(("httpAddrConnect2(addrlist=%p, sock=%p, msec=%d, cancel=%p)", (void *)addrlist, (void *)sock, msec, (void *)cancel));
+  DEBUG_printf(("httpAddrConnect(addrlist=%p, sock=%p, msec=%d, cancel=%p)", (void *)addrlist, (void *)sock, msec, (void *)cancel));
 
   if (!sock)
   {
@@ -78,285 +205,224 @@ httpAddrConnect(
     msec = INT_MAX;
 
  /*
-  * Loop through each address until we connect or run out of addresses...
+  * Allocate memory for the connection attempts...
   */
 
-  nfds      = 0;
-  remaining = msec;
+  for (count = 0, current = addrlist; current; current = current->next)
+    count ++;
 
-  while (remaining > 0)
+  if (count == 0)
   {
-    if (cancel && *cancel)
-    {
-      while (nfds > 0)
-      {
-        nfds --;
-	httpAddrClose(NULL, fds[nfds]);
-      }
-
-      return (NULL);
-    }
-
-    if (addrlist && nfds < (int)(sizeof(fds) / sizeof(fds[0])))
-    {
-     /*
-      * Create the socket...
-      */
-
-      DEBUG_printf(("2httpAddrConnect: Trying %s:%d...", httpAddrGetString(&(addrlist->addr), temp, sizeof(temp)), httpAddrGetPort(&(addrlist->addr))));
-
-      if ((fds[nfds] = (int)socket(httpAddrGetFamily(&(addrlist->addr)), SOCK_STREAM, 0)) < 0)
-      {
-       /*
-	* Don't abort yet, as this could just be an issue with the local
-	* system not being configured with IPv4/IPv6/domain socket enabled.
-	*
-	* Just skip this address...
-	*/
-
-        addrlist = addrlist->next;
-	continue;
-      }
-
-     /*
-      * Set options...
-      */
-
-      val = 1;
-      if (setsockopt(fds[nfds], SOL_SOCKET, SO_REUSEADDR, CUPS_SOCAST &val, sizeof(val)))
-	DEBUG_printf(("httpAddrConnect: setsockopt(SO_REUSEADDR) failed - %s", strerror(errno)));
+#ifdef _WIN32
+    _cupsSetError(IPP_STATUS_ERROR_SERVICE_UNAVAILABLE, "Connection failed", 0);
+#else
+    errno = EHOSTDOWN;
+    _cupsSetError(IPP_STATUS_ERROR_SERVICE_UNAVAILABLE, strerror(errno), 0);
+#endif /* _WIN32 */
 
-#ifdef SO_REUSEPORT
-      val = 1;
-      if (setsockopt(fds[nfds], SOL_SOCKET, SO_REUSEPORT, CUPS_SOCAST &val, sizeof(val)))
-	DEBUG_printf(("httpAddrConnect: setsockopt(SO_REUSEPORT) failed - %s", strerror(errno)));
-#endif /* SO_REUSEPORT */
+    return (NULL);
+  }
 
-#ifdef SO_NOSIGPIPE
-      val = 1;
-      if (setsockopt(fds[nfds], SOL_SOCKET, SO_NOSIGPIPE, CUPS_SOCAST &val, sizeof(val)))
-	DEBUG_printf(("httpAddrConnect: setsockopt(SO_NOSIGPIPE) failed - %s", strerror(errno)));
-#endif /* SO_NOSIGPIPE */
+  order = calloc((size_t)count * 2, sizeof(http_addrlist_t *));
+  fds   = calloc((size_t)count, sizeof(int));
+  pfds  = calloc((size_t)count, sizeof(struct pollfd));
 
-     /*
-      * Using TCP_NODELAY improves responsiveness, especially on systems
-      * with a slow loopback interface...
-      */
+  if (!order || !fds || !pfds)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    free(order);
+    free(fds);
+    free(pfds);
+    return (NULL);
+  }
 
-      val = 1;
-      if (setsockopt(fds[nfds], IPPROTO_TCP, TCP_NODELAY, CUPS_SOCAST &val, sizeof(val)))
-	DEBUG_printf(("httpAddrConnect: setsockopt(TCP_NODELAY) failed - %s", strerror(errno)));
+  addrs = order + count;
+  count = http_sort_addrs(addrlist, order);
 
-#ifdef FD_CLOEXEC
-     /*
-      * Close this socket when starting another process...
-      */
+  cupsMutexLock(&http_connect_mutex);
+  delay = http_connect_delay;
+  cupsMutexUnlock(&http_connect_mutex);
 
-      if (fcntl(fds[nfds], F_SETFD, FD_CLOEXEC))
-	DEBUG_printf(("httpAddrConnect: fcntl(F_SETFD, FD_CLOEXEC) failed - %s", strerror(errno)));
-#endif /* FD_CLOEXEC */
-
-#ifdef O_NONBLOCK
-     /*
-      * Do an asynchronous connect by setting the socket non-blocking...
-      */
+ /*
+  * Start connection attempts until one succeeds or we run out of time or
+  * addresses...
+  */
 
-      DEBUG_printf(("httpAddrConnect: Setting non-blocking connect()"));
+  next     = 0;
+  nfds     = 0;
+  curtime  = http_get_msec();
+  endtime  = curtime + msec;
+  nexttime = curtime;
 
-      flags = fcntl(fds[nfds], F_GETFL, 0);
-      if (fcntl(fds[nfds], F_SETFL, flags | O_NONBLOCK))
-	DEBUG_printf(("httpAddrConnect: fcntl(F_SETFL, O_NONBLOCK) failed - %s", strerror(errno)));
-#endif /* O_NONBLOCK */
+  while ((curtime = http_get_msec()) < endtime)
+  {
+    if (cancel && *cancel)
+    {
+      DEBUG_puts("1httpAddrConnect: Canceled connect()");
+      break;
+    }
 
+    if (next < count && (nfds == 0 || curtime >= nexttime))
+    {
      /*
-      * Then connect...
+      * Start the next connection attempt...
       */
 
-      if (!connect(fds[nfds], &(addrlist->addr.addr), (socklen_t)httpAddrGetLength(&(addrlist->addr))))
+      if ((result = http_start_connect(order[next], fds + nfds)) > 0)
       {
-	DEBUG_printf(("1httpAddrConnect: Connected to %s:%d...", httpAddrGetString(&(addrlist->addr), temp, sizeof(temp)), httpAddrGetPort(&(addrlist->addr))));
-
-#ifdef O_NONBLOCK
-	if (fcntl(fds[nfds], F_SETFL, flags))
-	  DEBUG_printf(("httpAddrConnect: fcntl(F_SETFL, 0) failed - %s", strerror(errno)));
-#endif /* O_NONBLOCK */
-
-	*sock = fds[nfds];
-
-	while (nfds > 0)
-	{
-	  nfds --;
-	  httpAddrClose(NULL, fds[nfds]);
-	}
-
-	return (addrlist);
+        *sock    = fds[nfds];
+        connaddr = order[next];
+        break;
       }
-
-#ifdef _WIN32
-      if (WSAGetLastError() != WSAEINPROGRESS && WSAGetLastError() != WSAEWOULDBLOCK)
-#else
-      if (errno != EINPROGRESS && errno != EWOULDBLOCK)
-#endif /* _WIN32 */
+      else if (result == 0)
       {
-	DEBUG_printf(("1httpAddrConnect: Unable to connect to %s:%d: %s", httpAddrGetString(&(addrlist->addr), temp, sizeof(temp)), httpAddrGetPort(&(addrlist->addr)), strerror(errno)));
-	httpAddrClose(NULL, fds[nfds]);
-	addrlist = addrlist->next;
-	continue;
+        addrs[nfds ++] = order[next];
+        nexttime       = curtime + delay;
       }
 
-#ifndef _WIN32
-      if (fcntl(fds[nfds], F_SETFL, flags))
-	DEBUG_printf(("httpAddrConnect: fcntl(F_SETFL, 0) failed - %s", strerror(errno)));
-#endif /* !_WIN32 */
-
-      addrs[nfds] = addrlist;
-      nfds ++;
-      addrlist = addrlist->next;
+      next ++;
+      continue;
     }
 
-    if (!addrlist && nfds == 0)
+    if (nfds == 0)
     {
+     /*
+      * No more addresses to try...
+      */
+
 #ifdef _WIN32
-      errno = WSAEHOSTDOWN;
+      error = WSAEHOSTDOWN;
 #else
-      errno = EHOSTDOWN;
-#endif // _WIN32
+      error = EHOSTDOWN;
+#endif /* _WIN32 */
       break;
     }
 
+#ifdef O_NONBLOCK
    /*
-    * See if we can connect to any of the addresses so far...
+    * Wait for a pending connection to finish or for the next attempt...
     */
 
-#ifdef O_NONBLOCK
-    DEBUG_puts("1httpAddrConnect: Finishing async connect()");
-
-    do
-    {
-      if (cancel && *cancel)
-      {
-       /*
-	* Close this socket and return...
-	*/
-
-	DEBUG_puts("1httpAddrConnect: Canceled connect()");
-
-	while (nfds > 0)
-	{
-	  nfds --;
-	  httpAddrClose(NULL, fds[nfds]);
-	}
+    if (endtime - curtime > INT_MAX)
+      timeout = INT_MAX;
+    else
+      timeout = (int)(endtime - curtime);
 
-	*sock = -1;
+    if (next < count && (nexttime - curtime) < timeout)
+      timeout = (int)(nexttime - curtime);
 
-	return (NULL);
-      }
+    if (cancel && timeout > 100)
+      timeout = 100;
 
-      for (i = 0; i < nfds; i ++)
-      {
-	pfds[i].fd     = fds[i];
-	pfds[i].events = POLLIN | POLLOUT;
-      }
+    for (i = 0; i < nfds; i ++)
+    {
+      pfds[i].fd      = fds[i];
+      pfds[i].events  = POLLIN | POLLOUT;
+      pfds[i].revents = 0;
+    }
 
-      result = poll(pfds, (nfds_t)nfds, addrlist ? 100 : remaining > 250 ? 250 : remaining);
+    result = poll(pfds, (nfds_t)nfds, timeout);
 
-      DEBUG_printf(("1httpAddrConnect: poll() returned %d (%d)", result, errno));
-    }
-#  ifdef _WIN32
-    while (result < 0 && (WSAGetLastError() == WSAEINTR || WSAGetLastError() == WSAEWOULDBLOCK));
-#  else
-    while (result < 0 && (errno == EINTR || errno == EAGAIN));
-#  endif /* _WIN32 */
+    DEBUG_printf(("1httpAddrConnect: poll() returned %d (%d)", result, errno));
 
-    if (result > 0)
+    for (i = 0; i < nfds && result > 0; i ++)
     {
-      http_addrlist_t *connaddr = NULL;	/* Connected address, if any */
+      DEBUG_printf(("2httpAddrConnect: pfds[%d].revents=%x", i, pfds[i].revents));
 
-      for (i = 0; i < nfds; i ++)
+      if (pfds[i].revents && !(pfds[i].revents & (POLLERR | POLLHUP)))
       {
-	DEBUG_printf(("pfds[%d].revents=%x\n", i, pfds[i].revents));
-	if (pfds[i].revents && !(pfds[i].revents & (POLLERR | POLLHUP)))
-	{
-	  *sock    = fds[i];
-	  connaddr = addrs[i];
+	*sock    = fds[i];
+	connaddr = addrs[i];
 
 #  ifdef DEBUG
-	  len   = sizeof(peer);
-	  if (!getpeername(fds[i], (struct sockaddr *)&peer, &len))
-	    DEBUG_printf(("1httpAddrConnect: Connected to %s:%d...", httpAddrGetString(&peer, temp, sizeof(temp)), httpAddrGetPort(&peer)));
+	len = sizeof(peer);
+	if (!getpeername(fds[i], (struct sockaddr *)&peer, &len))
+	  DEBUG_printf(("1httpAddrConnect: Connected to %s:%d...", httpAddrGetString(&peer, temp, sizeof(temp)), httpAddrGetPort(&peer)));
 #  endif /* DEBUG */
 
-          break;
-	}
-	else if (pfds[i].revents & (POLLERR | POLLHUP))
-        {
+	break;
+      }
+      else if (pfds[i].revents & (POLLERR | POLLHUP))
+      {
 #  ifdef __sun
-          // Solaris incorrectly returns errors when you poll() a socket that is
-          // still connecting.  This check prevents us from removing the socket
-          // from the pool if the "error" is EINPROGRESS...
-          int		sockerr;	// Current error on socket
-          socklen_t	socklen = sizeof(sockerr);
+	// Solaris incorrectly returns errors when you poll() a socket that is
+	// still connecting.  This check prevents us from removing the socket
+	// from the pool if the "error" is EINPROGRESS...
+	int		sockerr;	// Current error on socket
+	socklen_t	socklen = sizeof(sockerr);
 					// Size of error variable
 
-          if (!getsockopt(fds[i], SOL_SOCKET, SO_ERROR, &sockerr, &socklen) && (!sockerr || sockerr == EINPROGRESS))
-            continue;			// Not an error
+	if (!getsockopt(fds[i], SOL_SOCKET, SO_ERROR, &sockerr, &socklen) && (!sockerr || sockerr == EINPROGRESS))
+	  continue;			// Not an error
 #  endif // __sun
 
-         /*
-          * Error on socket, remove from the "pool"...
-          */
-
-	  httpAddrClose(NULL, fds[i]);
-          nfds --;
-          if (i < nfds)
-          {
-            memmove(fds + i, fds + i + 1, (size_t)(nfds - i) * (sizeof(fds[0])));
-            memmove(addrs + i, addrs + i + 1, (size_t)(nfds - i) * (sizeof(addrs[0])));
-          }
-          i --;
-        }
-      }
-
-      if (connaddr)
-      {
        /*
-        * Connected on one address, close all of the other sockets we have so
-        * far and return...
-        */
+	* Error on socket, remove it and start the next attempt right away...
+	*/
 
-        for (j = 0; j < i; j ++)
-          httpAddrClose(NULL, fds[j]);
+	DEBUG_printf(("1httpAddrConnect: Unable to connect to %s:%d.", httpAddrGetString(&(addrs[i]->addr), temp, sizeof(temp)), httpAddrGetPort(&(addrs[i]->addr))));
 
-        for (j ++; j < nfds; j ++)
-          httpAddrClose(NULL, fds[j]);
+	httpAddrClose(NULL, fds[i]);
+	nfds --;
+	if (i < nfds)
+	{
+	  memmove(fds + i, fds + i + 1, (size_t)(nfds - i) * (sizeof(fds[0])));
+	  memmove(addrs + i, addrs + i + 1, (size_t)(nfds - i) * (sizeof(addrs[0])));
+	  memmove(pfds + i, pfds + i + 1, (size_t)(nfds - i) * (sizeof(pfds[0])));
+	}
+	i --;
 
-        return (connaddr);
+	nexttime = curtime;
       }
     }
+
+    if (connaddr)
+      break;
 #endif /* O_NONBLOCK */
+  }
 
-    if (addrlist)
-      remaining -= 100;
+ /*
+  * Close any other pending connections...
+  */
+
+  if (!connaddr && !error)
+  {
+    if (cancel && *cancel)
+      *sock = -1;
     else
-      remaining -= 250;
+      error = ETIMEDOUT;
   }
 
-  if (remaining <= 0)
-    errno = ETIMEDOUT;
+  for (i = 0; i < nfds; i ++)
+  {
+    if (!connaddr || fds[i] != *sock)
+      httpAddrClose(NULL, fds[i]);
+  }
+
+  free(order);
+  free(fds);
+  free(pfds);
 
-  while (nfds > 0)
+  if (connaddr)
   {
-    nfds --;
-    httpAddrClose(NULL, fds[nfds]);
+   /*
+    * Remember the address for next time...
+    */
+
+    http_add_winner(&connaddr->addr);
   }
+  else if (error)
+  {
+    errno = error;
 
 #ifdef _WIN32
-  _cupsSetError(IPP_STATUS_ERROR_SERVICE_UNAVAILABLE, "Connection failed", 0);
+    _cupsSetError(IPP_STATUS_ERROR_SERVICE_UNAVAILABLE, "Connection failed", 0);
 #else
-  _cupsSetError(IPP_STATUS_ERROR_SERVICE_UNAVAILABLE, strerror(errno), 0);
+    _cupsSetError(IPP_STATUS_ERROR_SERVICE_UNAVAILABLE, strerror(errno), 0);
 #endif /* _WIN32 */
+  }
 
-  return (NULL);
+  return (connaddr);
 }
 
 
@@ -569,7 +635,24 @@ httpAddrGetList(const char *hostname,	/* I - Hostname, IP address, or NULL for p
       }
     }
 
-    if ((error = getaddrinfo(hostname, service, &hints, &results)) == 0)
+    if (hostname && http_get_dns(hostname, family, service, &first, &error))
+    {
+     /*
+      * Use the cached lookup...
+      */
+
+      for (addr = first; addr && addr->next; addr = addr->next);
+
+      if (error)
+      {
+#  ifdef _WIN32 /* Really, Microsoft?!? */
+	_cupsSetError(IPP_STATUS_ERROR_INTERNAL, gai_strerrorA(error), 0);
+#  else
+	_cupsSetError(IPP_STATUS_ERROR_INTERNAL, gai_strerror(error), 0);
+#  endif /* _WIN32 */
+      }
+    }
+    else if ((error = getaddrinfo(hostname, service, &hints, &results)) == 0)
     {
      /*
       * Copy the results to our own address list structure...
@@ -612,15 +695,20 @@ httpAddrGetList(const char *hostname,	/* I - Hostname, IP address, or NULL for p
 	}
 
      /*
-      * Free the results from getaddrinfo()...
+      * Free the results from getaddrinfo() and cache our copy...
       */
 
       freeaddrinfo(results);
+
+      if (hostname && first)
+        http_put_dns(hostname, family, service, first, 0);
     }
     else
     {
       if (error == EAI_FAIL)
         cg->need_res_init = 1;
+      else if (hostname && error == EAI_NONAME)
+        http_put_dns(hostname, family, service, NULL, error);
 
 #  ifdef _WIN32 /* Really, Microsoft?!? */
       _cupsSetError(IPP_STATUS_ERROR_INTERNAL, gai_strerrorA(error), 0);
@@ -795,3 +883,589 @@ httpAddrGetList(const char *hostname,	/* I - Hostname, IP address, or NULL for p
 
   return (first);
 }
+
+/*
+ * 'httpAddrGetListAsync()' - Get a list of addresses for a hostname in the
+ *                            background.
+ *
+ * This function looks up the addresses for "hostname" on a separate thread
+ * and then calls "cb" with the resulting list of addresses, or `NULL` on
+ * error.  The callback must free the list using @link httpAddrFreeList@ and
+ * can use @link cupsLastErrorString@ to get the reason for a failure.
+ *
+ * If the addresses are cached, the callback is called before this function
+ * returns.
+ */
+
+bool					/* O - `true` if the lookup was started, `false` on error */
+httpAddrGetListAsync(
+    const char         *hostname,	/* I - Hostname, IP address, or `NULL` for passive listen address */
+    int                family,		/* I - Address family or `AF_UNSPEC` */
+    const char         *service,	/* I - Service name or port number */
+    http_addrlist_cb_t cb,		/* I - Callback function */
+    void               *cb_data)	/* I - Callback data */
+{
+  http_addrlist_t	*addrlist;	/* Cached addresses */
+  int			error;		/* Cached error */
+  _http_resolve_t	*resolve;	/* Lookup data */
+  cups_thread_t		thread;		/* Lookup thread */
+
+
+  DEBUG_printf(("httpAddrGetListAsync(hostname=\"%s\", family=%d, service=\"%s\", cb=%p, cb_data=%p)", hostname, family, service, (void *)cb, cb_data));
+
+  if (!cb)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (false);
+  }
+
+ /*
+  * Use cached addresses immediately...
+  */
+
+  if (hostname && http_get_dns(hostname, family, service, &addrlist, &error) && !error)
+  {
+    (cb)(cb_data, addrlist);
+    return (true);
+  }
+
+ /*
+  * Otherwise start a thread to do the lookup...
+  */
+
+  if ((resolve = (_http_resolve_t *)calloc(1, sizeof(_http_resolve_t))) == NULL)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    return (false);
+  }
+
+  resolve->hostname = hostname ? strdup(hostname) : NULL;
+  resolve->service  = service ? strdup(service) : NULL;
+  resolve->family   = family;
+  resolve->cb       = cb;
+  resolve->cb_data  = cb_data;
+
+  if ((hostname && !resolve->hostname) || (service && !resolve->service))
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    goto error;
+  }
+
+  if ((thread = cupsThreadCreate((cups_thread_func_t)http_resolve_thread, resolve)) == CUPS_THREAD_INVALID)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, _("Unable to create thread."), 1);
+    goto error;
+  }
+
+  cupsThreadDetach(thread);
+
+  return (true);
+
+ /*
+  * If we get here something went wrong...
+  */
+
+  error:
+
+  free(resolve->hostname);
+  free(resolve->service);
+  free(resolve);
+
+  return (false);
+}
+
+
+/*
+ * 'httpAddrSetCacheTTL()' - Set how long address lookups are cached.
+ *
+ * This function sets the number of seconds that successful and failed
+ * @link httpAddrGetList@ lookups are cached.  A "ttl" value of `0` disables
+ * (and clears) the cache, and a "negative_ttl" value of `0` disables the
+ * caching of failed lookups.  The defaults are 60 and 10 seconds,
+ * respectively.
+ */
+
+void
+httpAddrSetCacheTTL(
+    int ttl,				/* I - Time-to-live in seconds or `0` to disable */
+    int negative_ttl)			/* I - Time-to-live for failed lookups in seconds or `0` to disable */
+{
+  DEBUG_printf(("httpAddrSetCacheTTL(ttl=%d, negative_ttl=%d)", ttl, negative_ttl));
+
+  cupsMutexLock(&http_dns_mutex);
+
+  http_dns_negative_ttl = negative_ttl > 0 ? negative_ttl : 0;
+
+  if ((http_dns_ttl = ttl) <= 0)
+  {
+    http_dns_ttl          = 0;
+    http_dns_negative_ttl = 0;
+
+    cupsArrayDelete(http_dns);
+    http_dns = NULL;
+  }
+
+  cupsMutexUnlock(&http_dns_mutex);
+}
+
+
+/*
+ * 'httpAddrSetConnectDelay()' - Set the delay between connection attempts.
+ *
+ * This function sets the number of milliseconds @link httpAddrConnect@ waits
+ * for a connection attempt to succeed before starting an attempt with the
+ * next address.  A value of `0` restores the default delay of 250
+ * milliseconds.  Values are limited to the range of 10 to 2000 milliseconds.
+ */
+
+void
+httpAddrSetConnectDelay(int msec)	/* I - Delay in milliseconds or `0` for the default */
+{
+  if (msec <= 0)
+    msec = _HTTP_CONNECT_DELAY;
+  else if (msec < 10)
+    msec = 10;
+  else if (msec > 2000)
+    msec = 2000;
+
+  cupsMutexLock(&http_connect_mutex);
+  http_connect_delay = msec;
+  cupsMutexUnlock(&http_connect_mutex);
+}
+
+
+/*
+ * 'http_add_winner()' - Remember the address of a successful connection.
+ */
+
+static void
+http_add_winner(http_addr_t *addr)	/* I - Connected address */
+{
+  int	i;				/* Looping var */
+
+
+  cupsMutexLock(&http_connect_mutex);
+
+ /*
+  * Remove any existing entry and then add the address to the front...
+  */
+
+  for (i = 0; i < http_num_winners; i ++)
+  {
+    if (httpAddrIsEqual(&http_winners[i].addr, addr) && httpAddrGetPort(&http_winners[i].addr) == httpAddrGetPort(addr))
+      break;
+  }
+
+  if (i >= _HTTP_CONNECT_MAX)
+    i = _HTTP_CONNECT_MAX - 1;
+  else if (i >= http_num_winners)
+    http_num_winners ++;
+
+  if (i > 0)
+    memmove(http_winners + 1, http_winners, (size_t)i * sizeof(_http_winner_t));
+
+  http_winners[0].addr = *addr;
+  http_winners[0].time = time(NULL);
+
+  cupsMutexUnlock(&http_connect_mutex);
+}
+
+
+/*
+ * 'http_compare_dns()' - Compare two cached lookups.
+ */
+
+static int				/* O - Result of comparison */
+http_compare_dns(_http_dns_t *a,	/* I - First lookup */
+                 _http_dns_t *b,	/* I - Second lookup */
+                 void        *data)	/* I - Callback data (unused) */
+{
+  int	result;				/* Result of comparison */
+
+
+  (void)data;
+
+  if ((result = _cups_strcasecmp(a->hostname, b->hostname)) != 0)
+    return (result);
+  else if (a->family != b->family)
+    return (a->family - b->family);
+  else
+    return (strcmp(a->service ? a->service : "", b->service ? b->service : ""));
+}
+
+
+/*
+ * 'http_free_dns()' - Free a cached lookup.
+ */
+
+static void
+http_free_dns(_http_dns_t *dns,		/* I - Cached lookup */
+              void        *data)	/* I - Callback data (unused) */
+{
+  (void)data;
+
+  httpAddrFreeList(dns->addrlist);
+  free(dns->hostname);
+  free(dns->service);
+  free(dns);
+}
+
+
+/*
+ * 'http_get_dns()' - Get a cached lookup.
+ */
+
+static bool				/* O - `true` if cached, `false` otherwise */
+http_get_dns(const char      *hostname,	/* I - Hostname */
+             int             family,	/* I - Address family */
+             const char      *service,	/* I - Service name or port number */
+             http_addrlist_t **addrlist,/* O - Copy of cached addresses */
+             int             *error)	/* O - Cached getaddrinfo() error */
+{
+  _http_dns_t	key,			/* Search key */
+		*dns;			/* Matching entry */
+  bool		ret = false;		/* Return value */
+
+
+  *addrlist = NULL;
+  *error    = 0;
+
+  key.hostname = (char *)hostname;
+  key.family   = family;
+  key.service  = (char *)service;
+
+  cupsMutexLock(&http_dns_mutex);
+
+  if ((dns = (_http_dns_t *)cupsArrayFind(http_dns, &key)) != NULL)
+  {
+    if (dns->expires <= time(NULL))
+    {
+      /* Expired, remove it... */
+      cupsArrayRemove(http_dns, dns);
+    }
+    else if (dns->error)
+    {
+      /* Cached failure... */
+      *error = dns->error;
+      ret    = true;
+    }
+    else if ((*addrlist = httpAddrCopyList(dns->addrlist)) != NULL)
+    {
+      /* Cached addresses... */
+      ret = true;
+    }
+  }
+
+  cupsMutexUnlock(&http_dns_mutex);
+
+  DEBUG_printf(("4http_get_dns(hostname=\"%s\", family=%d, service=\"%s\", ...) = %s", hostname, family, service, ret ? "true" : "false"));
+
+  return (ret);
+}
+
+
+/*
+ * 'http_get_msec()' - Get the current time in milliseconds.
+ */
+
+static long long			/* O - Current time in milliseconds */
+http_get_msec(void)
+{
+  struct timeval	curtime;	/* Current time */
+
+
+  gettimeofday(&curtime, NULL);
+
+  return ((long long)curtime.tv_sec * 1000 + curtime.tv_usec / 1000);
+}
+
+
+/*
+ * 'http_put_dns()' - Cache a lookup.
+ */
+
+static void
+http_put_dns(const char      *hostname,	/* I - Hostname */
+             int             family,	/* I - Address family */
+             const char      *service,	/* I - Service name or port number */
+             http_addrlist_t *addrlist,	/* I - Addresses */
+             int             error)	/* I - getaddrinfo() error, if any */
+{
+  _http_dns_t	*dns,			/* New entry */
+		*current,		/* Current entry */
+		*oldest;		/* Entry expiring first */
+  int		ttl;			/* Time-to-live */
+
+
+  cupsMutexLock(&http_dns_mutex);
+
+  if ((ttl = error ? http_dns_negative_ttl : http_dns_ttl) <= 0)
+  {
+    cupsMutexUnlock(&http_dns_mutex);
+    return;
+  }
+
+  if (!http_dns)
+    http_dns = cupsArrayNew((cups_array_cb_t)http_compare_dns, NULL, NULL, 0, NULL, (cups_afree_cb_t)http_free_dns);
+
+ /*
+  * Make room for the new entry...
+  */
+
+  if ((dns = (_http_dns_t *)calloc(1, sizeof(_http_dns_t))) == NULL)
+    goto done;
+
+  dns->hostname = strdup(hostname);
+  dns->service  = service ? strdup(service) : NULL;
+  dns->family   = family;
+  dns->expires  = time(NULL) + ttl;
+  dns->error    = error;
+  dns->addrlist = addrlist ? httpAddrCopyList(addrlist) : NULL;
+
+  if (!dns->hostname || (service && !dns->service) || (addrlist && !dns->addrlist))
+  {
+    http_free_dns(dns, NULL);
+    goto done;
+  }
+
+  if ((current = (_http_dns_t *)cupsArrayFind(http_dns, dns)) != NULL)
+    cupsArrayRemove(http_dns, current);
+
+  if (cupsArrayGetCount(http_dns) >= _HTTP_DNS_MAX)
+  {
+    for (oldest = current = (_http_dns_t *)cupsArrayGetFirst(http_dns); current; current = (_http_dns_t *)cupsArrayGetNext(http_dns))
+    {
+      if (current->expires < oldest->expires)
+        oldest = current;
+    }
+
+    cupsArrayRemove(http_dns, oldest);
+  }
+
+  if (!cupsArrayAdd(http_dns, dns))
+    http_free_dns(dns, NULL);
+
+  done:
+
+  cupsMutexUnlock(&http_dns_mutex);
+}
+
+
+/*
+ * 'http_resolve_thread()' - Look up addresses in the background.
+ */
+
+static void *				/* O - Thread exit status (unused) */
+http_resolve_thread(
+    _http_resolve_t *resolve)		/* I - Lookup data */
+{
+  (resolve->cb)(resolve->cb_data, httpAddrGetList(resolve->hostname, resolve->family, resolve->service));
+
+  free(resolve->hostname);
+  free(resolve->service);
+  free(resolve);
+
+  return (NULL);
+}
+
+
+/*
+ * 'http_sort_addrs()' - Sort addresses in connection order.
+ *
+ * The most recently connected address is first, followed by the remaining
+ * addresses alternating between the first address family and the others.
+ */
+
+static int				/* O - Number of addresses */
+http_sort_addrs(
+    http_addrlist_t *addrlist,		/* I - List of addresses */
+    http_addrlist_t **order)		/* I - Array for sorted addresses */
+{
+  int			i,		/* Looping var */
+			count = 0,	/* Number of addresses */
+			family;		/* First address family */
+  http_addrlist_t	*first = NULL,	/* Most recently connected address */
+			*a,		/* Current address in first family */
+			*b;		/* Current address in other families */
+  time_t		curtime = time(NULL);
+					/* Current time */
+
+
+ /*
+  * Find the most recently connected address...
+  */
+
+  cupsMutexLock(&http_connect_mutex);
+
+  for (i = 0; i < http_num_winners && !first; i ++)
+  {
+    if ((curtime - http_winners[i].time) >= _HTTP_CONNECT_TTL)
+      break;
+
+    for (a = addrlist; a; a = a->next)
+    {
+      if (httpAddrIsEqual(&http_winners[i].addr, &a->addr) && httpAddrGetPort(&http_winners[i].addr) == httpAddrGetPort(&a->addr))
+      {
+        first = a;
+        break;
+      }
+    }
+  }
+
+  cupsMutexUnlock(&http_connect_mutex);
+
+  if (first)
+    order[count ++] = first;
+
+ /*
+  * Then interleave the address families...
+  */
+
+  family = httpAddrGetFamily(&addrlist->addr);
+
+  for (a = b = addrlist; a || b;)
+  {
+    while (a && (a == first || httpAddrGetFamily(&a->addr) != family))
+      a = a->next;
+
+    while (b && (b == first || httpAddrGetFamily(&b->addr) == family))
+      b = b->next;
+
+    if (a)
+    {
+      order[count ++] = a;
+      a = a->next;
+    }
+
+    if (b)
+    {
+      order[count ++] = b;
+      b = b->next;
+    }
+  }
+
+  return (count);
+}
+
+
+/*
+ * 'http_start_connect()' - Start a connection attempt.
+ */
+
+static int				/* O - 1 if connected, 0 if pending, -1 on error */
+http_start_connect(
+    http_addrlist_t *addr,		/* I - Address */
+    int             *fd)		/* O - Socket */
+{
+  int			val;		/* Socket option value */
+#ifdef O_NONBLOCK
+  int			flags;		/* Socket flags */
+#endif /* O_NONBLOCK */
+#ifdef DEBUG
+  char			temp[256];	/* Temporary address string */
+#endif /* DEBUG */
+
+
+ /*
+  * Create the socket...
+  */
+
+  DEBUG_printf(("2httpAddrConnect: Trying %s:%d...", httpAddrGetString(&(addr->addr), temp, sizeof(temp)), httpAddrGetPort(&(addr->addr))));
+
+  if ((*fd = (int)socket(httpAddrGetFamily(&(addr->addr)), SOCK_STREAM, 0)) < 0)
+  {
+   /*
+    * Don't abort yet, as this could just be an issue with the local
+    * system not being configured with IPv4/IPv6/domain socket enabled.
+    *
+    * Just skip this address...
+    */
+
+    return (-1);
+  }
+
+ /*
+  * Set options...
+  */
+
+  val = 1;
+  if (setsockopt(*fd, SOL_SOCKET, SO_REUSEADDR, CUPS_SOCAST &val, sizeof(val)))
+    DEBUG_printf(("httpAddrConnect: setsockopt(SO_REUSEADDR) failed - %s", strerror(errno)));
+
+#ifdef SO_REUSEPORT
+  val = 1;
+  if (setsockopt(*fd, SOL_SOCKET, SO_REUSEPORT, CUPS_SOCAST &val, sizeof(val)))
+    DEBUG_printf(("httpAddrConnect: setsockopt(SO_REUSEPORT) failed - %s", strerror(errno)));
+#endif /* SO_REUSEPORT */
+
+#ifdef SO_NOSIGPIPE
+  val = 1;
+  if (setsockopt(*fd, SOL_SOCKET, SO_NOSIGPIPE, CUPS_SOCAST &val, sizeof(val)))
+    DEBUG_printf(("httpAddrConnect: setsockopt(SO_NOSIGPIPE) failed - %s", strerror(errno)));
+#endif /* SO_NOSIGPIPE */
+
+ /*
+  * Using TCP_NODELAY improves responsiveness, especially on systems
+  * with a slow loopback interface...
+  */
+
+  val = 1;
+  if (setsockopt(*fd, IPPROTO_TCP, TCP_NODELAY, CUPS_SOCAST &val, sizeof(val)))
+    DEBUG_printf(("httpAddrConnect: setsockopt(TCP_NODELAY) failed - %s", strerror(errno)));
+
+#ifdef FD_CLOEXEC
+ /*
+  * Close this socket when starting another process...
+  */
+
+  if (fcntl(*fd, F_SETFD, FD_CLOEXEC))
+    DEBUG_printf(("httpAddrConnect: fcntl(F_SETFD, FD_CLOEXEC) failed - %s", strerror(errno)));
+#endif /* FD_CLOEXEC */
+
+#ifdef O_NONBLOCK
+ /*
+  * Do an asynchronous connect by setting the socket non-blocking...
+  */
+
+  DEBUG_printf(("httpAddrConnect: Setting non-blocking connect()"));
+
+  flags = fcntl(*fd, F_GETFL, 0);
+  if (fcntl(*fd, F_SETFL, flags | O_NONBLOCK))
+    DEBUG_printf(("httpAddrConnect: fcntl(F_SETFL, O_NONBLOCK) failed - %s", strerror(errno)));
+#endif /* O_NONBLOCK */
+
+ /*
+  * Then connect...
+  */
+
+  if (!connect(*fd, &(addr->addr.addr), (socklen_t)httpAddrGetLength(&(addr->addr))))
+  {
+    DEBUG_printf(("1httpAddrConnect: Connected to %s:%d...", httpAddrGetString(&(addr->addr), temp, sizeof(temp)), httpAddrGetPort(&(addr->addr))));
+
+#ifdef O_NONBLOCK
+    if (fcntl(*fd, F_SETFL, flags))
+      DEBUG_printf(("httpAddrConnect: fcntl(F_SETFL, 0) failed - %s", strerror(errno)));
+#endif /* O_NONBLOCK */
+
+    return (1);
+  }
+
+#ifdef _WIN32
+  if (WSAGetLastError() != WSAEINPROGRESS && WSAGetLastError() != WSAEWOULDBLOCK)
+#else
+  if (errno != EINPROGRESS && errno != EWOULDBLOCK)
+#endif /* _WIN32 */
+  {
+    DEBUG_printf(("1httpAddrConnect: Unable to connect to %s:%d: %s", httpAddrGetString(&(addr->addr), temp, sizeof(temp)), httpAddrGetPort(&(addr->addr)), strerror(errno)));
+    httpAddrClose(NULL, *fd);
+    *fd = -1;
+    return (-1);
+  }
+
+#ifdef O_NONBLOCK
+  if (fcntl(*fd, F_SETFL, flags))
+    DEBUG_printf(("httpAddrConnect: fcntl(F_SETFL, 0) failed - %s", strerror(errno)));
+#endif /* O_NONBLOCK */
+
+  return (0);
+}
@@ -0,0 +1,455 @@
+/*
+ * HTTP connection pool routines for CUPS.
+ *
+ * Copyright © 2022 by OpenPrinting.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ */
+
+/*
+ * Include necessary headers...
+ */
+
+#include "cups-private.h"
+#include "debug-internal.h"
+
+
+/*
+ * Local types...
+ */
+
+typedef struct _http_pool_host_s	/**** Connections for a host ****/
+{
+  char			*host;		/* Hostname */
+  int			port;		/* Port number */
+  http_encryption_t	encryption;	/* Type of encryption */
+  size_t		num_active;	/* Number of checked out connections */
+  cups_array_t		*idle;		/* Idle connections, oldest first */
+} _http_pool_host_t;
+
+typedef struct _http_pool_conn_s	/**** Checked out connection ****/
+{
+  http_t		*http;		/* Connection */
+  _http_pool_host_t	*host;		/* Host the connection belongs to */
+} _http_pool_conn_t;
+
+struct _http_pool_s			/**** HTTP connection pool ****/
+{
+  cups_mutex_t		mutex;		/* Mutex for pool */
+  cups_cond_t		cond;		/* Condition for returned connections */
+  size_t		max_per_host;	/* Maximum connections per host */
+  int			idle_timeout;	/* Idle timeout in seconds */
+  cups_array_t		*hosts,		/* Hosts */
+			*active;	/* Checked out connections */
+};
+
+
+/*
+ * Local functions...
+ */
+
+static int	http_compare_conns(_http_pool_conn_t *a, _http_pool_conn_t *b, void *data);
+static int	http_compare_hosts(_http_pool_host_t *a, _http_pool_host_t *b, void *data);
+static void	http_free_host(_http_pool_host_t *h, void *data);
+static void	http_reap_idle(http_pool_t *pool, time_t curtime);
+
+
+/*
+ * 'httpPoolDelete()' - Close all idle connections and free a connection pool.
+ *
+ * All connections must be returned with @link httpPoolPut@ before the pool is
+ * deleted.
+ */
+
+void
+httpPoolDelete(http_pool_t *pool)	/* I - Connection pool */
+{
+  _http_pool_conn_t	*conn;		/* Checked out connection */
+
+
+  if (!pool)
+    return;
+
+  for (conn = (_http_pool_conn_t *)cupsArrayGetFirst(pool->active); conn; conn = (_http_pool_conn_t *)cupsArrayGetNext(pool->active))
+    DEBUG_printf(("httpPoolDelete: Connection %p to \"%s:%d\" was not returned.", (void *)conn->http, conn->host->host, conn->host->port));
+
+  cupsArrayDelete(pool->active);
+  cupsArrayDelete(pool->hosts);
+
+  cupsCondDestroy(&pool->cond);
+  cupsMutexDestroy(&pool->mutex);
+
+  free(pool);
+}
+
+
+/*
+ * 'httpPoolGet()' - Check out a connection to a host from a connection pool.
+ *
+ * This function returns an idle keep-alive connection to the named host, port,
+ * and encryption if one is available, otherwise a new connection is made.  When
+ * the maximum number of connections to the host are already checked out, this
+ * function waits up to "msec" milliseconds for one to be returned.
+ *
+ * The returned connection can be used with any of the HTTP and IPP request
+ * functions such as @link cupsDoRequest@, @link cupsGetFd@, and
+ * @link cupsPutFd@, and must be returned with @link httpPoolPut@ when the
+ * request is complete.
+ */
+
+http_t *				/* O - HTTP connection or `NULL` on error */
+httpPoolGet(
+    http_pool_t       *pool,		/* I - Connection pool */
+    const char        *host,		/* I - Host to connect to */
+    int               port,		/* I - Port number */
+    http_encryption_t encryption,	/* I - Type of encryption to use */
+    int               msec,		/* I - Timeout in milliseconds, -1 for no timeout */
+    int               *cancel)		/* I - Pointer to "cancel" variable */
+{
+  _http_pool_host_t	key,		/* Search key */
+			*h;		/* Host */
+  _http_pool_conn_t	*conn;		/* Checked out connection */
+  http_t		*http = NULL;	/* HTTP connection */
+  bool			reused = false;	/* Reused an idle connection? */
+  time_t		endtime;	/* End time for wait */
+
+
+  DEBUG_printf(("httpPoolGet(pool=%p, host=\"%s\", port=%d, encryption=%d, msec=%d, cancel=%p)", (void *)pool, host, port, encryption, msec, (void *)cancel));
+
+  if (!pool || !host || port <= 0)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (NULL);
+  }
+
+  endtime = msec < 0 ? 0 : time(NULL) + (msec + 999) / 1000;
+
+  cupsMutexLock(&pool->mutex);
+
+  http_reap_idle(pool, time(NULL));
+
+ /*
+  * Find or add the host...
+  */
+
+  key.host       = (char *)host;
+  key.port       = port;
+  key.encryption = encryption;
+
+  if ((h = (_http_pool_host_t *)cupsArrayFind(pool->hosts, &key)) == NULL)
+  {
+    if ((h = (_http_pool_host_t *)calloc(1, sizeof(_http_pool_host_t))) == NULL || (h->host = strdup(host)) == NULL || (h->idle = cupsArrayNew(NULL, NULL, NULL, 0, NULL, NULL)) == NULL)
+    {
+      if (h)
+      {
+        free(h->host);
+        free(h);
+      }
+
+      cupsMutexUnlock(&pool->mutex);
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+      return (NULL);
+    }
+
+    h->port       = port;
+    h->encryption = encryption;
+
+    cupsArrayAdd(pool->hosts, h);
+  }
+
+ /*
+  * Wait for an idle connection or a free slot...
+  */
+
+  while (cupsArrayGetCount(h->idle) == 0 && h->num_active >= pool->max_per_host)
+  {
+    if ((cancel && *cancel) || (endtime && time(NULL) >= endtime))
+    {
+      DEBUG_puts("1httpPoolGet: Timed out waiting for a connection.");
+      cupsMutexUnlock(&pool->mutex);
+      _cupsSetError(IPP_STATUS_ERROR_SERVICE_UNAVAILABLE, _("Timed out waiting for a connection."), 1);
+      return (NULL);
+    }
+
+    cupsCondWait(&pool->cond, &pool->mutex, 0.25);
+  }
+
+  if ((http = (http_t *)cupsArrayGetLast(h->idle)) != NULL)
+  {
+    cupsArrayRemove(h->idle, http);
+    reused = true;
+  }
+
+  h->num_active ++;
+
+  cupsMutexUnlock(&pool->mutex);
+
+ /*
+  * Make sure an idle connection is still open, or make a new connection...
+  */
+
+  if (reused)
+  {
+    if (httpWait(http, 0))
+    {
+     /*
+      * Server closed the connection (or sent something unexpected) while it
+      * was idle, reconnect...
+      */
+
+      DEBUG_printf(("2httpPoolGet: Reconnecting stale connection %p.", (void *)http));
+
+      httpClearFields(http);
+
+      if (!httpReconnect(http, msec < 0 ? 30000 : msec, cancel))
+      {
+        httpClose(http);
+        http = NULL;
+      }
+    }
+  }
+  else
+  {
+    http = httpConnect(host, port, NULL, AF_UNSPEC, encryption, true, msec < 0 ? 30000 : msec, cancel);
+  }
+
+  cupsMutexLock(&pool->mutex);
+
+  if (http && (conn = (_http_pool_conn_t *)malloc(sizeof(_http_pool_conn_t))) != NULL)
+  {
+    conn->http = http;
+    conn->host = h;
+
+    cupsArrayAdd(pool->active, conn);
+  }
+  else
+  {
+    if (http)
+    {
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+      httpClose(http);
+      http = NULL;
+    }
+
+    h->num_active --;
+    cupsCondBroadcast(&pool->cond);
+  }
+
+  cupsMutexUnlock(&pool->mutex);
+
+  DEBUG_printf(("1httpPoolGet: Returning %p (%s).", (void *)http, reused ? "reused" : "new"));
+
+  return (http);
+}
+
+
+/*
+ * 'httpPoolNew()' - Create a new connection pool.
+ *
+ * The "max_per_host" argument specifies the maximum number of connections to
+ * each host, port, and encryption combination.  Connections that stay idle
+ * in the pool for more than "idle_timeout" seconds are closed.
+ */
+
+http_pool_t *				/* O - Connection pool or `NULL` on error */
+httpPoolNew(size_t max_per_host,	/* I - Maximum connections per host (`0` for default) */
+            int    idle_timeout)	/* I - Idle timeout in seconds (`0` for default) */
+{
+  http_pool_t	*pool;			/* Connection pool */
+
+
+  if ((pool = (http_pool_t *)calloc(1, sizeof(http_pool_t))) == NULL)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    return (NULL);
+  }
+
+  cupsMutexInit(&pool->mutex);
+  cupsCondInit(&pool->cond);
+
+  pool->max_per_host = max_per_host > 0 ? max_per_host : 4;
+  pool->idle_timeout = idle_timeout > 0 ? idle_timeout : 30;
+  pool->hosts        = cupsArrayNew((cups_array_cb_t)http_compare_hosts, NULL, NULL, 0, NULL, (cups_afree_cb_t)http_free_host);
+  pool->active       = cupsArrayNew((cups_array_cb_t)http_compare_conns, NULL, NULL, 0, NULL, (cups_afree_cb_t)free);
+
+  if (!pool->hosts || !pool->active)
+  {
+    httpPoolDelete(pool);
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(ENOMEM), 0);
+    return (NULL);
+  }
+
+  return (pool);
+}
+
+
+/*
+ * 'httpPoolPut()' - Return a connection to a connection pool.
+ *
+ * The connection is kept open for reuse if the last request completed and the
+ * server did not send "Connection: close", otherwise it is closed.
+ */
+
+void
+httpPoolPut(http_pool_t *pool,		/* I - Connection pool */
+            http_t      *http)		/* I - HTTP connection from @link httpPoolGet@ */
+{
+  _http_pool_conn_t	key,		/* Search key */
+			*conn;		/* Checked out connection */
+  _http_pool_host_t	*h;		/* Host */
+  bool			keep;		/* Keep the connection? */
+
+
+  DEBUG_printf(("httpPoolPut(pool=%p, http=%p)", (void *)pool, (void *)http));
+
+  if (!pool || !http)
+    return;
+
+ /*
+  * Only keep connections that are idle and reusable...
+  */
+
+  if (http->state == HTTP_STATE_GET_SEND || http->state == HTTP_STATE_POST_SEND)
+    httpFlush(http);
+
+  keep = http->fd >= 0 && http->state == HTTP_STATE_WAITING && _cups_strcasecmp(httpGetField(http, HTTP_FIELD_CONNECTION), "close");
+
+  cupsMutexLock(&pool->mutex);
+
+  key.http = http;
+
+  if ((conn = (_http_pool_conn_t *)cupsArrayFind(pool->active, &key)) == NULL)
+  {
+    DEBUG_puts("1httpPoolPut: Connection is not from this pool.");
+    cupsMutexUnlock(&pool->mutex);
+    return;
+  }
+
+  h = conn->host;
+
+  cupsArrayRemove(pool->active, conn);
+
+  h->num_active --;
+
+  if (keep)
+  {
+    httpClearFields(http);
+    cupsArrayAdd(h->idle, http);
+    http = NULL;
+  }
+
+  http_reap_idle(pool, time(NULL));
+
+  cupsCondBroadcast(&pool->cond);
+  cupsMutexUnlock(&pool->mutex);
+
+  if (http)
+  {
+    DEBUG_printf(("2httpPoolPut: Closing connection %p.", (void *)http));
+    httpClose(http);
+  }
+}
+
+
+/*
+ * 'http_compare_conns()' - Compare two checked out connections.
+ */
+
+static int				/* O - Result of comparison */
+http_compare_conns(
+    _http_pool_conn_t *a,		/* I - First connection */
+    _http_pool_conn_t *b,		/* I - Second connection */
+    void              *data)		/* I - Callback data (unused) */
+{
+  (void)data;
+
+  if (a->http < b->http)
+    return (-1);
+  else if (a->http > b->http)
+    return (1);
+  else
+    return (0);
+}
+
+
+/*
+ * 'http_compare_hosts()' - Compare two hosts.
+ */
+
+static int				/* O - Result of comparison */
+http_compare_hosts(
+    _http_pool_host_t *a,		/* I - First host */
+    _http_pool_host_t *b,		/* I - Second host */
+    void              *data)		/* I - Callback data (unused) */
+{
+  int	result;				/* Result of comparison */
+
+
+  (void)data;
+
+  if ((result = _cups_strcasecmp(a->host, b->host)) == 0)
+  {
+    if ((result = a->port - b->port) == 0)
+      result = (int)a->encryption - (int)b->encryption;
+  }
+
+  return (result);
+}
+
+
+/*
+ * 'http_free_host()' - Close idle connections and free a host.
+ */
+
+static void
+http_free_host(_http_pool_host_t *h,	/* I - Host */
+               void              *data)	/* I - Callback data (unused) */
+{
+  http_t	*http;			/* Idle connection */
+
+
+  (void)data;
+
+  for (http = (http_t *)cupsArrayGetFirst(h->idle); http; http = (http_t *)cupsArrayGetNext(h->idle))
+    httpClose(http);
+
+  cupsArrayDelete(h->idle);
+  free(h->host);
+  free(h);
+}
+
+
+/*
+ * 'http_reap_idle()' - Close connections that have been idle too long.
+ *
+ * The pool mutex must be held by the caller.
+ */
+
+static void
+http_reap_idle(http_pool_t *pool,	/* I - Connection pool */
+               time_t      curtime)	/* I - Current time */
+{
+  _http_pool_host_t	*h;		/* Current host */
+  http_t		*http;		/* Current connection */
+
+
+  for (h = (_http_pool_host_t *)cupsArrayGetFirst(pool->hosts); h; h = (_http_pool_host_t *)cupsArrayGetNext(pool->hosts))
+  {
+   /*
+    * Idle connections are added in order, so stop at the first connection
+    * that is still fresh...
+    */
+
+    while ((http = (http_t *)cupsArrayGetFirst(h->idle)) != NULL && (curtime - http->activity) >= pool->idle_timeout)
+    {
+      DEBUG_printf(("2http_reap_idle: Closing idle connection %p to \"%s:%d\".", (void *)http, h->host, h->port));
+
+      cupsArrayRemove(h->idle, http);
+      httpClose(http);
+    }
+
+    if (cupsArrayGetCount(h->idle) == 0 && h->num_active == 0)
+      cupsArrayRemove(pool->hosts, h);
+  }
+}
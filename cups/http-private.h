@@ -51,6 +51,8 @@ extern "C" {
  */
 
 #  define _HTTP_MAX_SBUFFER	65536	/* Size of (de)compression buffer */
+#  define _HTTP_MAX_BUFSIZE	4194304	/* Maximum size of I/O buffers */
+#  define _HTTP_MAX_SENDFILE	4194304	/* Maximum size of each sendfile() chunk */
 
 #  define _HTTP_TLS_NONE	0	/* No TLS options */
 #  define _HTTP_TLS_ALLOW_RC4	1	/* Allow RC4 cipher suites */
@@ -128,8 +130,9 @@ struct _http_s				/**** HTTP connection structure ****/
   http_encoding_t	data_encoding;	/* Chunked or not */
   off_t			data_remaining;	/* Number of bytes left */
   int			used;		/* Number of bytes used in buffer */
-  char			buffer[HTTP_MAX_BUFFER];
-					/* Buffer for incoming data */
+  int			rskip;		/* Bytes consumed at start of buffer */
+  char			*buffer;	/* Buffer for incoming data */
+  size_t		bufsize;	/* Size of incoming data buffer */
   char			algorithm[65],	/* Algorithm from WWW-Authenticate */
 			nextnonce[HTTP_MAX_VALUE],
 					/* Next nonce value from Authentication-Info */
@@ -143,9 +146,10 @@ struct _http_s				/**** HTTP connection structure ****/
   http_tls_t		tls;		/* TLS state information */
   http_tls_credentials_t tls_credentials;
   bool			tls_upgrade;	/* `true` if we are doing an upgrade */
-  char			wbuffer[HTTP_MAX_BUFFER];
-					/* Buffer for outgoing data */
+  char			*wbuffer;	/* Buffer for outgoing data */
+  size_t		wbufsize;	/* Size of outgoing data buffer */
   int			wused;		/* Write buffer bytes used */
+  int			wraw;		/* Write buffer bytes of unframed request header */
 					/* TLS credentials */
   http_timeout_cb_t	timeout_cb;	/* Timeout callback */
   void			*timeout_data;	/* User data pointer */
@@ -1523,6 +1523,7 @@ httpResolveURI(
     time_t		domain_time,	// Domain lookup time, if any
 			end_time;	// End time for resolve
     cups_dnssd_t	*dnssd;		// DNS-SD context
+    size_t		events = 0;	// Number of DNS-SD callbacks seen
     uint32_t		if_index;	// Interface index
     char		name[256],	// Service instance name
 			regtype[256],	// Registration type
@@ -1583,10 +1584,10 @@ httpResolveURI(
 	domain_time = end_time;
       }
 
-      // Sleep 1/4 second to allow time for resolve...
-      usleep(250000);
+      // Wait up to 1/4 second for the resolve...
+      events = cupsDNSSDWait(dnssd, events, 250);
 
-      if (resolved_uri[0])
+      if (resolved_uri[0] || (cb && !(*cb)(cb_data)))
         break;
     }
 
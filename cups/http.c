@@ -25,14 +25,30 @@
 #  include <sys/time.h>
 #  include <sys/resource.h>
 #endif // _WIN32
+#include <sys/stat.h>
+#ifdef HAVE_SYS_SENDFILE_H
+#  include <sys/sendfile.h>
+#endif // HAVE_SYS_SENDFILE_H
 #include <zlib.h>
 
 
+/*
+ * Local types...
+ */
+
+typedef struct _http_iovec_s		// Gathered write buffer
+{
+  const char		*data;		// Pointer to data
+  size_t		length;		// Length of data
+} _http_iovec_t;
+
+
 /*
  * Local functions...
  */
 
 static void		http_add_field(http_t *http, http_field_t field, const char *value, bool append);
+static void		http_compact_buffer(http_t *http);
 static void		http_content_coding_finish(http_t *http);
 static void		http_content_coding_start(http_t *http, const char *value);
 static http_t		*http_create(const char *host, int port, http_addrlist_t *addrlist, int family, http_encryption_t encryption, bool blocking, _http_mode_t mode);
@@ -43,14 +59,22 @@ static void		http_free_credential(http_credential_t *c);
 static ssize_t		http_read(http_t *http, char *buffer, size_t length);
 static ssize_t		http_read_buffered(http_t *http, char *buffer, size_t length);
 static ssize_t		http_read_chunk(http_t *http, char *buffer, size_t length);
+static bool		http_read_chunk_length(http_t *http);
+static ssize_t		http_read_direct(http_t *http, const char **data, size_t length);
+static void		http_read_done(http_t *http, ssize_t bytes);
 static bool		http_send(http_t *http, http_state_t request, const char *uri);
+#ifdef HAVE_SYS_SENDFILE_H
+static ssize_t		http_sendfile(http_t *http, int fd, size_t length);
+#endif // HAVE_SYS_SENDFILE_H
 static ssize_t		http_write(http_t *http, const char *buffer, size_t length);
-static ssize_t		http_write_chunk(http_t *http, const char *buffer, size_t length);
+static ssize_t		http_write_chunk(http_t *http, const char *buffer, size_t length, bool last);
+static ssize_t		http_writev(http_t *http, _http_iovec_t *iov, int iovcnt);
 static off_t		http_set_length(http_t *http);
 static void		http_set_timeout(int fd, double timeout);
 static void		http_set_wait(http_t *http);
 
 #ifdef HAVE_TLS
+static bool		http_tls_start(http_t *http);
 static bool		http_tls_upgrade(http_t *http);
 #endif // HAVE_TLS
 
@@ -393,6 +417,8 @@ httpClose(http_t *http)			// I - HTTP connection
   free(http->fields[HTTP_FIELD_HOST]);
   free(http->authstring);
   free(http->cookie);
+  free(http->buffer);
+  free(http->wbuffer);
 
   free(http);
 }
@@ -542,7 +568,7 @@ httpSetEncryption(
 
     http->encryption = e;
     if (e != HTTP_ENCRYPTION_IF_REQUESTED && !http->tls)
-      return (_httpTLSStart(http));
+      return (http_tls_start(http));
     else
       return (true);
   }
@@ -678,11 +704,12 @@ httpFlushWrite(http_t *http)		// I - HTTP connection
   }
 
   if (http->data_encoding == HTTP_ENCODING_CHUNKED)
-    bytes = http_write_chunk(http, http->wbuffer, (size_t)http->wused);
+    bytes = http_write_chunk(http, http->wbuffer + http->wraw, (size_t)(http->wused - http->wraw), false);
   else
     bytes = http_write(http, http->wbuffer, (size_t)http->wused);
 
   http->wused = 0;
+  http->wraw  = 0;
 
   DEBUG_printf(("1httpFlushWrite: Returning %d, errno=%d.", (int)bytes, errno));
 
@@ -1067,6 +1094,8 @@ httpGets(http_t *http,			// I - HTTP connection
   lineend     = line + length - 1;
   eol         = 0;
 
+  http_compact_buffer(http);
+
   while (lineptr < lineend)
   {
    /*
@@ -1099,7 +1128,7 @@ httpGets(http_t *http,			// I - HTTP connection
         return (NULL);
       }
 
-      bytes = http_read(http, http->buffer + http->used, (size_t)(HTTP_MAX_BUFFER - http->used));
+      bytes = http_read(http, http->buffer + http->used, http->bufsize - (size_t)http->used);
 
       DEBUG_printf(("4httpGets: read " CUPS_LLFMT " bytes.", CUPS_LLCAST bytes));
 
@@ -1546,6 +1575,8 @@ httpPeek(http_t *http,			// I - HTTP connection
   else if (length > (size_t)http->data_remaining)
     length = (size_t)http->data_remaining;
 
+  http_compact_buffer(http);
+
   if (http->used == 0 &&
       (http->coding == _HTTP_CODING_IDENTITY ||
        (http->coding >= _HTTP_CODING_GUNZIP && ((z_stream *)http->stream)->avail_in == 0)))
@@ -1567,8 +1598,8 @@ httpPeek(http_t *http,			// I - HTTP connection
       }
     }
 
-    if ((size_t)http->data_remaining > sizeof(http->buffer))
-      buflen = sizeof(http->buffer);
+    if ((size_t)http->data_remaining > http->bufsize)
+      buflen = (ssize_t)http->bufsize;
     else
       buflen = (ssize_t)http->data_remaining;
 
@@ -1909,26 +1940,85 @@ httpRead(http_t *http,			// I - HTTP connection
     }
   }
 
-  if ((http->coding == _HTTP_CODING_IDENTITY ||
-       (http->coding >= _HTTP_CODING_GUNZIP && ((z_stream *)http->stream)->avail_in == 0)) &&
-      ((http->data_remaining <= 0 &&
-        http->data_encoding == HTTP_ENCODING_LENGTH) ||
-       (http->data_encoding == HTTP_ENCODING_CHUNKED && bytes == 0)))
+  http_read_done(http, bytes);
+
+  return (bytes);
+}
+
+
+/*
+ * 'httpReadBuffer()' - Read data from a HTTP connection without copying.
+ *
+ * This function reads up to "length" bytes of content and sets "data" to point
+ * at them in the connection's input buffer, avoiding the copy made by
+ * @link httpRead@.  The data remains valid until the next read from the
+ * connection.  Use @link httpSetBufferSize@ to control the maximum amount of
+ * data returned by each call.
+ *
+ * Compressed content cannot be read with this function - use
+ * @link httpRead@ when @link httpGetContentEncoding@ returns a value.
+ */
+
+ssize_t					// O - Number of bytes read, 0 at end, or -1 on error
+httpReadBuffer(http_t     *http,	// I - HTTP connection
+               const char **data,	// O - Pointer to data
+               size_t     length)	// I - Maximum number of bytes
+{
+  ssize_t	bytes;			// Bytes read
+
+
+  DEBUG_printf(("httpReadBuffer(http=%p, data=%p, length=" CUPS_LLFMT ") coding=%d data_encoding=%d data_remaining=" CUPS_LLFMT, (void *)http, (void *)data, CUPS_LLCAST length, http ? http->coding : 0, http ? http->data_encoding : 0, CUPS_LLCAST (http ? http->data_remaining : -1)));
+
+  if (data)
+    *data = NULL;
+
+  if (!http || !data)
+    return (-1);
+
+  http->activity = time(NULL);
+  http->error    = 0;
+
+  if (length <= 0)
+    return (0);
+
+  if (http->coding != _HTTP_CODING_IDENTITY)
   {
-    if (http->coding >= _HTTP_CODING_GUNZIP)
-      http_content_coding_finish(http);
+    DEBUG_puts("1httpReadBuffer: Content coding not supported.");
+    http->error = EINVAL;
+    return (-1);
+  }
 
-    if (http->state == HTTP_STATE_LOCK_RECV || http->state == HTTP_STATE_POST_RECV || http->state == HTTP_STATE_PROPFIND_RECV || http->state == HTTP_STATE_PROPPATCH_RECV)
-      http->state ++;
-    else if (http->state == HTTP_STATE_COPY_SEND || http->state == HTTP_STATE_DELETE_SEND || http->state == HTTP_STATE_GET_SEND || http->state == HTTP_STATE_LOCK_SEND || http->state == HTTP_STATE_MOVE_SEND || http->state == HTTP_STATE_POST_SEND || http->state == HTTP_STATE_PROPFIND_SEND || http->state == HTTP_STATE_PROPPATCH_SEND)
-      http->state = HTTP_STATE_WAITING;
-    else
-      http->state = HTTP_STATE_STATUS;
+  if (http->data_remaining == 0 && http->data_encoding == HTTP_ENCODING_CHUNKED && !http_read_chunk_length(http))
+  {
+    bytes = 0;
+  }
+  else if (http->data_remaining <= 0)
+  {
+   /*
+    * No more data to read...
+    */
 
-    DEBUG_printf(("1httpRead: End of content, set state to %s.",
-		  httpStateString(http->state)));
+    bytes = 0;
+
+    if (http->data_encoding != HTTP_ENCODING_CHUNKED)
+      return (0);
+  }
+  else
+  {
+    if (length > (size_t)http->data_remaining)
+      length = (size_t)http->data_remaining;
+
+   /*
+    * The blank line that follows a chunk is skipped when reading the next
+    * chunk length so that the returned data stays in the buffer...
+    */
+
+    if ((bytes = http_read_direct(http, data, length)) > 0)
+      http->data_remaining -= bytes;
   }
 
+  http_read_done(http, bytes);
+
   return (bytes);
 }
 
@@ -2158,9 +2248,11 @@ httpReconnect(http_t *http,		// I - HTTP connection
   http->keep_alive      = HTTP_KEEPALIVE_OFF;
   http->data_encoding   = HTTP_ENCODING_FIELDS;
   http->used            = 0;
+  http->rskip           = 0;
   http->data_remaining  = 0;
   http->hostaddr        = NULL;
   http->wused           = 0;
+  http->wraw            = 0;
 
  /*
   * Connect to the server...
@@ -2197,6 +2289,9 @@ httpReconnect(http_t *http,		// I - HTTP connection
   http->hostaddr = &(addr->addr);
   http->error    = 0;
 
+  if (_cups_stats_enabled)
+    _cupsStatsAddIO(_CUPS_STATS_HTTP_CONNECT, 1, 0, 0);
+
 #ifdef HAVE_TLS
   if (http->encryption == HTTP_ENCRYPTION_ALWAYS)
   {
@@ -2204,7 +2299,7 @@ httpReconnect(http_t *http,		// I - HTTP connection
     * Always do encryption via SSL.
     */
 
-    if (!_httpTLSStart(http))
+    if (!http_tls_start(http))
     {
       httpAddrClose(NULL, http->fd);
       http->fd = -1;
@@ -2274,6 +2369,81 @@ httpSetAuthString(http_t     *http,	// I - HTTP connection
 }
 
 
+/*
+ * 'httpSetBufferSize()' - Set the size of the input and output buffers.
+ *
+ * This function sets the sizes of the buffers used for reading and writing
+ * data on a HTTP connection.  Larger buffers reduce the number of system calls
+ * and TLS records needed to transfer large documents.  A size of `0` keeps the
+ * current buffer size.  Sizes are limited to between `HTTP_MAX_BUFFER` and 4
+ * megabytes.
+ *
+ * Pending output is flushed before the output buffer is resized.  The input
+ * buffer cannot be made smaller than the amount of unread data it contains.
+ */
+
+bool					// O - `true` on success, `false` on error
+httpSetBufferSize(http_t *http,		// I - HTTP connection
+                  size_t rsize,		// I - Input buffer size in bytes or `0` for no change
+                  size_t wsize)		// I - Output buffer size in bytes or `0` for no change
+{
+  char	*buffer;			// New buffer
+
+
+  DEBUG_printf(("httpSetBufferSize(http=%p, rsize=%u, wsize=%u)", (void *)http, (unsigned)rsize, (unsigned)wsize));
+
+  if (!http)
+    return (false);
+
+  if (rsize > 0 && rsize < HTTP_MAX_BUFFER)
+    rsize = HTTP_MAX_BUFFER;
+  else if (rsize > _HTTP_MAX_BUFSIZE)
+    rsize = _HTTP_MAX_BUFSIZE;
+
+  if (wsize > 0 && wsize < HTTP_MAX_BUFFER)
+    wsize = HTTP_MAX_BUFFER;
+  else if (wsize > _HTTP_MAX_BUFSIZE)
+    wsize = _HTTP_MAX_BUFSIZE;
+
+  if (rsize > 0 && rsize != http->bufsize)
+  {
+    http_compact_buffer(http);
+
+    if ((size_t)http->used > rsize)
+    {
+      DEBUG_puts("1httpSetBufferSize: Too much unread data for new input buffer size.");
+      return (false);
+    }
+
+    if ((buffer = realloc(http->buffer, rsize)) == NULL)
+    {
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+      return (false);
+    }
+
+    http->buffer  = buffer;
+    http->bufsize = rsize;
+  }
+
+  if (wsize > 0 && wsize != http->wbufsize)
+  {
+    if (http->wused)
+      httpFlushWrite(http);
+
+    if ((buffer = realloc(http->wbuffer, wsize)) == NULL)
+    {
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+      return (false);
+    }
+
+    http->wbuffer  = buffer;
+    http->wbufsize = wsize;
+  }
+
+  return (true);
+}
+
+
 /*
  * 'httpSetCredentials()' - Set the credentials associated with an encrypted
  *			    connection.
@@ -2541,7 +2711,7 @@ _httpUpdate(http_t        *http,	// I - HTTP connection
 #ifdef HAVE_TLS
     if (http->status == HTTP_STATUS_SWITCHING_PROTOCOLS && !http->tls)
     {
-      if (!_httpTLSStart(http))
+      if (!http_tls_start(http))
       {
         httpAddrClose(NULL, http->fd);
         http->fd = -1;
@@ -2690,6 +2860,7 @@ http_status_t				// O - HTTP status
 httpUpdate(http_t *http)		// I - HTTP connection
 {
   http_status_t	status;			// Request status
+  double	start;			// Start time for statistics
 
 
   DEBUG_printf(("httpUpdate(http=%p), state=%s", (void *)http, httpStateString(http->state)));
@@ -2717,7 +2888,18 @@ httpUpdate(http_t *http)		// I - HTTP connection
   * Grab all of the lines we can from the connection...
   */
 
-  while (_httpUpdate(http, &status));
+  if (!_cups_stats_enabled)
+  {
+    while (_httpUpdate(http, &status));
+  }
+  else
+  {
+    start = _cupsStatsGetTime();
+
+    while (_httpUpdate(http, &status));
+
+    _cupsStatsAddTime(_CUPS_STATS_HTTP_UPDATE, start);
+  }
 
  /*
   * See if there was an error...
@@ -2809,6 +2991,10 @@ bool					// O - `true` when data is available, `false` otherwise
 httpWait(http_t *http,			// I - HTTP connection
          int    msec)			// I - Milliseconds to wait
 {
+  bool		ret;			// Return value
+  double	start;			// Start time for statistics
+
+
   // First see if there is data in the buffer...
   DEBUG_printf(("2httpWait(http=%p, msec=%d)", (void *)http, msec));
 
@@ -2843,7 +3029,15 @@ httpWait(http_t *http,			// I - HTTP connection
   * If not, check the SSL/TLS buffers and do a select() on the connection...
   */
 
-  return (_httpWait(http, msec, 1));
+  if (!_cups_stats_enabled)
+    return (_httpWait(http, msec, 1));
+
+  start = _cupsStatsGetTime();
+  ret   = _httpWait(http, msec, 1);
+
+  _cupsStatsAddTime(_CUPS_STATS_HTTP_WAIT, start);
+
+  return (ret);
 }
 
 
@@ -2912,7 +3106,7 @@ httpWrite(http_t     *http,		// I - HTTP connection
         DEBUG_printf(("1httpWrite: Writing intermediate chunk, len=%d", (int)slen));
 
 	if (slen > 0 && http->data_encoding == HTTP_ENCODING_CHUNKED)
-	  sret = http_write_chunk(http, (char *)http->sbuffer, slen);
+	  sret = http_write_chunk(http, (char *)http->sbuffer, slen, false);
 	else if (slen > 0)
 	  sret = http_write(http, (char *)http->sbuffer, slen);
 	else
@@ -2933,7 +3127,7 @@ httpWrite(http_t     *http,		// I - HTTP connection
   }
   else if (length > 0)
   {
-    if (http->wused && (length + (size_t)http->wused) > sizeof(http->wbuffer))
+    if (http->wused && (length + (size_t)http->wused) > http->wbufsize)
     {
       DEBUG_printf(("2httpWrite: Flushing buffer (wused=%d, length="
                     CUPS_LLFMT ")", http->wused, CUPS_LLCAST length));
@@ -2941,7 +3135,7 @@ httpWrite(http_t     *http,		// I - HTTP connection
       httpFlushWrite(http);
     }
 
-    if ((length + (size_t)http->wused) <= sizeof(http->wbuffer) && length < sizeof(http->wbuffer))
+    if ((length + (size_t)http->wused) <= http->wbufsize && length < http->wbufsize)
     {
      /*
       * Write to buffer...
@@ -2964,7 +3158,7 @@ httpWrite(http_t     *http,		// I - HTTP connection
                     CUPS_LLCAST length));
 
       if (http->data_encoding == HTTP_ENCODING_CHUNKED)
-	bytes = (ssize_t)http_write_chunk(http, buffer, length);
+	bytes = (ssize_t)http_write_chunk(http, buffer, length, false);
       else
 	bytes = (ssize_t)http_write(http, buffer, length);
 
@@ -2993,7 +3187,7 @@ httpWrite(http_t     *http,		// I - HTTP connection
     if (http->coding == _HTTP_CODING_GZIP || http->coding == _HTTP_CODING_DEFLATE)
       http_content_coding_finish(http);
 
-    if (http->wused)
+    if (http->wused && http->data_encoding != HTTP_ENCODING_CHUNKED)
     {
       if (httpFlushWrite(http) < 0)
         return (-1);
@@ -3002,10 +3196,18 @@ httpWrite(http_t     *http,		// I - HTTP connection
     if (http->data_encoding == HTTP_ENCODING_CHUNKED)
     {
      /*
-      * Send a 0-length chunk at the end of the request...
+      * Send any buffered data with a 0-length chunk at the end of the
+      * request...
       */
 
-      http_write(http, "0\r\n\r\n", 5);
+      ssize_t sret = http_write_chunk(http, http->wbuffer + http->wraw, (size_t)(http->wused - http->wraw), true);
+					// Bytes written
+
+      http->wused = 0;
+      http->wraw  = 0;
+
+      if (sret < 0)
+        return (-1);
 
      /*
       * Reset the data state...
@@ -3032,6 +3234,143 @@ httpWrite(http_t     *http,		// I - HTTP connection
 }
 
 
+//
+// 'httpWriteFd()' - Write data from a file to a HTTP connection.
+//
+// This function writes up to "length" bytes from the file descriptor "fd",
+// starting at its current position, or everything up to the end of the file
+// when "length" is `0`.  When the connection is not encrypted, no content
+// coding is used, and "fd" is a regular file, the data is sent directly from
+// the file to the socket without copying it, otherwise it is written using
+// @link httpWrite@.
+//
+// As with @link httpWrite@, the content ends once the Content-Length has been
+// written; chunked content is ended with `httpWrite(http, "", 0)`.
+//
+
+off_t					// O - Number of bytes written or `-1` on error
+httpWriteFd(http_t *http,		// I - HTTP connection
+            int    fd,			// I - File descriptor
+            off_t  length)		// I - Maximum number of bytes or `0` for the rest of the file
+{
+  off_t		total = 0;		// Total bytes written
+  size_t	count;			// Bytes to read
+  ssize_t	bytes;			// Bytes read
+  char		buffer[32768];		// Copy buffer
+#ifdef HAVE_SYS_SENDFILE_H
+  struct stat	fileinfo;		// File information
+  off_t		pos;			// Current file position
+#endif // HAVE_SYS_SENDFILE_H
+
+
+  DEBUG_printf(("httpWriteFd(http=%p, fd=%d, length=" CUPS_LLFMT ")", (void *)http, fd, CUPS_LLCAST length));
+
+  if (!http || fd < 0 || length < 0)
+  {
+    DEBUG_puts("1httpWriteFd: Returning -1 due to bad input.");
+    return (-1);
+  }
+
+  http->activity = time(NULL);
+
+#ifdef HAVE_SYS_SENDFILE_H
+  if (http->coding == _HTTP_CODING_IDENTITY && !http->tls && (http->data_encoding == HTTP_ENCODING_LENGTH || http->data_encoding == HTTP_ENCODING_CHUNKED) && !fstat(fd, &fileinfo) && S_ISREG(fileinfo.st_mode) && (pos = lseek(fd, 0, SEEK_CUR)) >= 0)
+  {
+    char	header[32];		// Chunk header
+
+   /*
+    * Send directly from the file, after any buffered data...
+    */
+
+    if (length == 0 || length > (fileinfo.st_size - pos))
+      length = pos < fileinfo.st_size ? fileinfo.st_size - pos : 0;
+
+    if (http->data_encoding == HTTP_ENCODING_LENGTH && length > http->data_remaining)
+      length = http->data_remaining;
+
+    if (http->wused && httpFlushWrite(http) < 0)
+      return (-1);
+
+    while (total < length)
+    {
+      if ((length - total) > _HTTP_MAX_SENDFILE)
+        count = _HTTP_MAX_SENDFILE;
+      else
+        count = (size_t)(length - total);
+
+      if (http->data_encoding == HTTP_ENCODING_CHUNKED)
+      {
+        // Send the previous chunk's trailer and this chunk's header...
+        snprintf(header, sizeof(header), "%s%x\r\n", total > 0 ? "\r\n" : "", (unsigned)count);
+
+        if (http_write(http, header, strlen(header)) < 0)
+          return (-1);
+      }
+
+      if (http_sendfile(http, fd, count) < 0)
+        return (-1);
+
+      total += (off_t)count;
+    }
+
+    if (http->data_encoding == HTTP_ENCODING_CHUNKED)
+    {
+      if (total > 0 && http_write(http, "\r\n", 2) < 0)
+        return (-1);
+    }
+    else if (total > 0 && (http->data_remaining -= total) == 0)
+    {
+      // Finish the content...
+      if (httpWrite(http, "", 0) < 0)
+        return (-1);
+    }
+
+    DEBUG_printf(("1httpWriteFd: Returning " CUPS_LLFMT ".", CUPS_LLCAST total));
+
+    return (total);
+  }
+#endif // HAVE_SYS_SENDFILE_H
+
+ /*
+  * Otherwise copy the file...
+  */
+
+  while (length == 0 || total < length)
+  {
+    if (length > 0 && (length - total) < (off_t)sizeof(buffer))
+      count = (size_t)(length - total);
+    else
+      count = sizeof(buffer);
+
+#ifdef _WIN32
+    if ((bytes = (ssize_t)read(fd, buffer, (unsigned)count)) < 0)
+#else
+    if ((bytes = read(fd, buffer, count)) < 0)
+#endif // _WIN32
+    {
+      if (errno == EINTR || errno == EAGAIN)
+        continue;
+
+      http->error = errno;
+      return (-1);
+    }
+    else if (bytes == 0)
+    {
+      break;
+    }
+
+    if (httpWrite(http, buffer, (size_t)bytes) < 0)
+      return (-1);
+
+    total += bytes;
+  }
+
+  DEBUG_printf(("1httpWriteFd: Returning " CUPS_LLFMT ".", CUPS_LLCAST total));
+
+  return (total);
+}
+
+
 //
 // 'httpWriteRequest()' - Write a HTTP request.
 //
@@ -3370,6 +3709,23 @@ http_add_field(http_t       *http,	// I - HTTP connection
 }
 
 
+/*
+ * 'http_compact_buffer()' - Move unread data to the start of the input buffer.
+ */
+
+static void
+http_compact_buffer(http_t *http)	// I - HTTP connection
+{
+  if (http->rskip > 0)
+  {
+    if (http->used > 0)
+      memmove(http->buffer, http->buffer + http->rskip, (size_t)http->used);
+
+    http->rskip = 0;
+  }
+}
+
+
 /*
  * 'http_content_coding_finish()' - Finish doing any content encoding.
  */
@@ -3403,7 +3759,7 @@ http_content_coding_finish(
 	    DEBUG_printf(("1http_content_coding_finish: Writing trailing chunk, len=%d", (int)bytes));
 
 	    if (http->data_encoding == HTTP_ENCODING_CHUNKED)
-	      http_write_chunk(http, (char *)http->sbuffer, bytes);
+	      http_write_chunk(http, (char *)http->sbuffer, bytes, false);
 	    else
 	      http_write(http, (char *)http->sbuffer, bytes);
           }
@@ -3655,6 +4011,15 @@ http_create(
     return (NULL);
   }
 
+  if ((http->buffer = malloc(HTTP_MAX_BUFFER)) == NULL || (http->wbuffer = malloc(HTTP_MAX_BUFFER)) == NULL)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    httpAddrFreeList(myaddrlist);
+    free(http->buffer);
+    free(http);
+    return (NULL);
+  }
+
  /*
   * Initialize the HTTP data...
   */
@@ -3666,6 +4031,8 @@ http_create(
   http->fd       = -1;
   http->status   = HTTP_STATUS_CONTINUE;
   http->version  = HTTP_VERSION_1_1;
+  http->bufsize  = HTTP_MAX_BUFFER;
+  http->wbufsize = HTTP_MAX_BUFFER;
 
   if (host)
     cupsCopyString(http->hostname, host, sizeof(http->hostname));
@@ -3838,6 +4205,9 @@ http_read(http_t *http,			// I - HTTP connection
   }
   while (bytes < 0);
 
+  if (_cups_stats_enabled)
+    _cupsStatsAddIO(_CUPS_STATS_HTTP_READ, 1, (size_t)bytes, 0);
+
   DEBUG_printf(("8http_read: Read " CUPS_LLFMT " bytes into buffer.", CUPS_LLCAST bytes));
 #ifdef DEBUG
   if (bytes > 0)
@@ -3870,6 +4240,8 @@ http_read_buffered(http_t *http,	// I - HTTP connection
 
   DEBUG_printf(("7http_read_buffered(http=%p, buffer=%p, length=" CUPS_LLFMT ") used=%d", (void *)http, (void *)buffer, CUPS_LLCAST length, http->used));
 
+  http_compact_buffer(http);
+
   if (http->used > 0)
   {
     if (length > (size_t)http->used)
@@ -3907,57 +4279,147 @@ http_read_chunk(http_t *http,		// I - HTTP connection
 {
   DEBUG_printf(("7http_read_chunk(http=%p, buffer=%p, length=" CUPS_LLFMT ")", (void *)http, (void *)buffer, CUPS_LLCAST length));
 
+  if (http->data_remaining <= 0 && !http_read_chunk_length(http))
+    return (0);
+
+  DEBUG_printf(("8http_read_chunk: data_remaining=" CUPS_LLFMT,
+                CUPS_LLCAST http->data_remaining));
+
   if (http->data_remaining <= 0)
-  {
-    char	len[32];		// Length string
+    return (0);
+  else if (length > (size_t)http->data_remaining)
+    length = (size_t)http->data_remaining;
 
-    if (!httpGets(http, len, sizeof(len)))
-    {
-      DEBUG_puts("8http_read_chunk: Could not get chunk length.");
-      return (0);
-    }
+  return (http_read_buffered(http, buffer, length));
+}
 
-    if (!len[0])
-    {
-      DEBUG_puts("8http_read_chunk: Blank chunk length, trying again...");
-      if (!httpGets(http, len, sizeof(len)))
-      {
-	DEBUG_puts("8http_read_chunk: Could not get chunk length.");
-	return (0);
-      }
-    }
 
-    http->data_remaining = strtoll(len, NULL, 16);
+/*
+ * 'http_read_chunk_length()' - Read and validate the length of the next chunk.
+ */
 
-    if (http->data_remaining < 0)
-    {
-      DEBUG_printf(("8http_read_chunk: Negative chunk length \"%s\" ("
-                    CUPS_LLFMT ")", len, CUPS_LLCAST http->data_remaining));
-      return (0);
-    }
+static bool				// O - `true` on success, `false` on error
+http_read_chunk_length(http_t *http)	// I - HTTP connection
+{
+  char	len[32];			// Length string
 
-    DEBUG_printf(("8http_read_chunk: Got chunk length \"%s\" (" CUPS_LLFMT ")",
-                  len, CUPS_LLCAST http->data_remaining));
 
-    if (http->data_remaining == 0)
-    {
-     /*
-      * 0-length chunk, grab trailing blank line...
-      */
+  if (!httpGets(http, len, sizeof(len)))
+  {
+    DEBUG_puts("8http_read_chunk_length: Could not get chunk length.");
+    return (false);
+  }
 
-      httpGets(http, len, sizeof(len));
+  if (!len[0])
+  {
+    DEBUG_puts("8http_read_chunk_length: Blank chunk length, trying again...");
+    if (!httpGets(http, len, sizeof(len)))
+    {
+      DEBUG_puts("8http_read_chunk_length: Could not get chunk length.");
+      return (false);
     }
   }
 
-  DEBUG_printf(("8http_read_chunk: data_remaining=" CUPS_LLFMT,
-                CUPS_LLCAST http->data_remaining));
+  http->data_remaining = strtoll(len, NULL, 16);
 
-  if (http->data_remaining <= 0)
-    return (0);
-  else if (length > (size_t)http->data_remaining)
-    length = (size_t)http->data_remaining;
+  if (http->data_remaining < 0)
+  {
+    DEBUG_printf(("8http_read_chunk_length: Negative chunk length \"%s\" ("
+		  CUPS_LLFMT ")", len, CUPS_LLCAST http->data_remaining));
+    return (false);
+  }
 
-  return (http_read_buffered(http, buffer, length));
+  DEBUG_printf(("8http_read_chunk_length: Got chunk length \"%s\" (" CUPS_LLFMT ")",
+		len, CUPS_LLCAST http->data_remaining));
+
+  if (http->data_remaining == 0)
+  {
+   /*
+    * 0-length chunk, grab trailing blank line...
+    */
+
+    httpGets(http, len, sizeof(len));
+  }
+
+  return (true);
+}
+
+
+/*
+ * 'http_read_direct()' - Do a buffered read without copying the data.
+ *
+ * This function returns a pointer into the HTTP input buffer, filling it from
+ * the socket as needed.  The data remains valid until the next read from the
+ * connection.
+ */
+
+static ssize_t				// O - Number of bytes read or -1 on error
+http_read_direct(http_t     *http,	// I - HTTP connection
+                 const char **data,	// O - Pointer to data
+                 size_t     length)	// I - Maximum bytes to read
+{
+  ssize_t	bytes;			// Bytes read
+
+
+  DEBUG_printf(("7http_read_direct(http=%p, data=%p, length=" CUPS_LLFMT ") used=%d", (void *)http, (void *)data, CUPS_LLCAST length, http->used));
+
+  if (http->used == 0)
+  {
+    http->rskip = 0;
+
+    if (length > http->bufsize)
+      length = http->bufsize;
+
+    if ((bytes = http_read(http, http->buffer, length)) <= 0)
+      return (bytes);
+
+    http->used = (int)bytes;
+  }
+
+  if (length > (size_t)http->used)
+    length = (size_t)http->used;
+
+  DEBUG_printf(("8http_read_direct: Returning %d bytes from input buffer.", (int)length));
+
+ /*
+  * Consume the data but leave it in place; the next read compacts the buffer...
+  */
+
+  *data       = http->buffer + http->rskip;
+  http->rskip += (int)length;
+  http->used  -= (int)length;
+
+  return ((ssize_t)length);
+}
+
+
+/*
+ * 'http_read_done()' - Update the connection state after reading content.
+ */
+
+static void
+http_read_done(http_t  *http,		// I - HTTP connection
+               ssize_t bytes)		// I - Bytes read
+{
+  if ((http->coding == _HTTP_CODING_IDENTITY ||
+       (http->coding >= _HTTP_CODING_GUNZIP && ((z_stream *)http->stream)->avail_in == 0)) &&
+      ((http->data_remaining <= 0 &&
+        http->data_encoding == HTTP_ENCODING_LENGTH) ||
+       (http->data_encoding == HTTP_ENCODING_CHUNKED && bytes == 0)))
+  {
+    if (http->coding >= _HTTP_CODING_GUNZIP)
+      http_content_coding_finish(http);
+
+    if (http->state == HTTP_STATE_LOCK_RECV || http->state == HTTP_STATE_POST_RECV || http->state == HTTP_STATE_PROPFIND_RECV || http->state == HTTP_STATE_PROPPATCH_RECV)
+      http->state ++;
+    else if (http->state == HTTP_STATE_COPY_SEND || http->state == HTTP_STATE_DELETE_SEND || http->state == HTTP_STATE_GET_SEND || http->state == HTTP_STATE_LOCK_SEND || http->state == HTTP_STATE_MOVE_SEND || http->state == HTTP_STATE_POST_SEND || http->state == HTTP_STATE_PROPFIND_SEND || http->state == HTTP_STATE_PROPPATCH_SEND)
+      http->state = HTTP_STATE_WAITING;
+    else
+      http->state = HTTP_STATE_STATUS;
+
+    DEBUG_printf(("1http_read_done: End of content, set state to %s.",
+		  httpStateString(http->state)));
+  }
 }
 
 
@@ -4146,10 +4608,24 @@ http_send(http_t       *http,		// I - HTTP connection
     return (false);
   }
 
-  if (httpFlushWrite(http) < 0)
-    return (false);
-
   http_set_length(http);
+
+  if (http->data_encoding == HTTP_ENCODING_FIELDS || (http->data_encoding == HTTP_ENCODING_LENGTH && http->data_remaining <= 0))
+  {
+    if (httpFlushWrite(http) < 0)
+      return (false);
+  }
+  else
+  {
+   /*
+    * Keep the request header in the write buffer so that it is sent along
+    * with the first part of the request content.  httpUpdate and httpWait
+    * flush it when waiting for a "100 Continue" response...
+    */
+
+    http->wraw = http->wused;
+  }
+
   httpClearFields(http);
 
  /*
@@ -4166,6 +4642,72 @@ http_send(http_t       *http,		// I - HTTP connection
 }
 
 
+#ifdef HAVE_SYS_SENDFILE_H
+/*
+ * 'http_sendfile()' - Send data from a file to a HTTP connection.
+ */
+
+static ssize_t				// O - Number of bytes written or -1 on error
+http_sendfile(http_t *http,		// I - HTTP connection
+              int    fd,		// I - File descriptor
+              size_t length)		// I - Number of bytes to send
+{
+  size_t	total = 0;		// Total bytes sent
+  ssize_t	bytes;			// Bytes sent
+  struct pollfd	pfd;			// Polled file descriptor
+  int		nfds;			// Result from poll()
+
+
+  DEBUG_printf(("7http_sendfile(http=%p, fd=%d, length=" CUPS_LLFMT ")", (void *)http, fd, CUPS_LLCAST length));
+
+  http->error = 0;
+
+  while (total < length)
+  {
+    if ((bytes = sendfile(http->fd, fd, NULL, length - total)) < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      else if (errno == EWOULDBLOCK || errno == EAGAIN)
+      {
+        // Wait for the socket to become writable...
+        pfd.fd     = http->fd;
+        pfd.events = POLLOUT;
+
+        if ((nfds = poll(&pfd, 1, http->wait_value > 0 ? http->wait_value : 10000)) > 0 || (nfds < 0 && errno == EINTR) || (nfds == 0 && http->timeout_cb && (*http->timeout_cb)(http, http->timeout_data)))
+          continue;
+
+        http->error = nfds == 0 ? EWOULDBLOCK : errno;
+      }
+      else
+      {
+        http->error = errno;
+      }
+
+      DEBUG_printf(("8http_sendfile: error writing data (%s).", strerror(http->error)));
+
+      return (-1);
+    }
+    else if (bytes == 0)
+    {
+      // File was truncated...
+      http->error = EIO;
+      return (-1);
+    }
+
+    if (_cups_stats_enabled)
+      _cupsStatsAddIO(_CUPS_STATS_HTTP_WRITE, 1, (size_t)bytes, 0);
+
+    total += (size_t)bytes;
+  }
+
+  return ((ssize_t)total);
+}
+#endif // HAVE_SYS_SENDFILE_H
+
+
 /*
  * 'http_set_length()' - Set the data_encoding and data_remaining values.
  */
@@ -4256,6 +4798,29 @@ http_set_wait(http_t *http)		// I - HTTP connection
 
 
 #ifdef HAVE_TLS
+//
+// 'http_tls_start()' - Start TLS on a connection, timing the handshake.
+//
+
+static bool				// O - `true` on success, `false` on failure
+http_tls_start(http_t *http)		// I - HTTP connection
+{
+  bool		ret;			// Return value
+  double	start;			// Start time for statistics
+
+
+  if (!_cups_stats_enabled)
+    return (_httpTLSStart(http));
+
+  start = _cupsStatsGetTime();
+  ret   = _httpTLSStart(http);
+
+  _cupsStatsAddTime(_CUPS_STATS_TLS_HANDSHAKE, start);
+
+  return (ret);
+}
+
+
 /*
  * 'http_tls_upgrade()' - Force upgrade to TLS encryption.
  */
@@ -4335,17 +4900,130 @@ http_write(http_t     *http,		// I - HTTP connection
            const char *buffer,		// I - Buffer for data
 	   size_t     length)		// I - Number of bytes to write
 {
+  _http_iovec_t	iov;			// Buffer to write
+
+
+  DEBUG_printf(("7http_write(http=%p, buffer=%p, length=" CUPS_LLFMT ")", (void *)http, (void *)buffer, CUPS_LLCAST length));
+
+  iov.data   = buffer;
+  iov.length = length;
+
+  return (http_writev(http, &iov, 1));
+}
+
+
+/*
+ * 'http_write_chunk()' - Write a chunked buffer.
+ *
+ * The chunk header, data, and trailer are sent together with any request
+ * header still in the write buffer and, if "last" is `true`, the 0-length
+ * chunk that ends the content.
+ */
+
+static ssize_t				// O - Number bytes written
+http_write_chunk(http_t     *http,	// I - HTTP connection
+                 const char *buffer,	// I - Buffer to write
+		 size_t     length,	// I - Length of buffer
+		 bool       last)	// I - Write the final 0-length chunk?
+{
+  char		header[16];		// Chunk header
+  _http_iovec_t	iov[5];			// Buffers to write
+  int		iovcnt = 0;		// Number of buffers
+
+
+  DEBUG_printf(("7http_write_chunk(http=%p, buffer=%p, length=" CUPS_LLFMT ", last=%s)", (void *)http, (void *)buffer, CUPS_LLCAST length, last ? "true" : "false"));
+
+ /*
+  * Gather the pending request header, chunk header, data, and trailer...
+  */
+
+  if (http->wraw > 0)
+  {
+    iov[iovcnt].data   = http->wbuffer;
+    iov[iovcnt].length = (size_t)http->wraw;
+    iovcnt ++;
+  }
+
+  if (length > 0)
+  {
+    snprintf(header, sizeof(header), "%x\r\n", (unsigned)length);
+
+    iov[iovcnt].data   = header;
+    iov[iovcnt].length = strlen(header);
+    iovcnt ++;
+
+    iov[iovcnt].data   = buffer;
+    iov[iovcnt].length = length;
+    iovcnt ++;
+
+    iov[iovcnt].data   = "\r\n";
+    iov[iovcnt].length = 2;
+    iovcnt ++;
+  }
+
+  if (last)
+  {
+    iov[iovcnt].data   = "0\r\n\r\n";
+    iov[iovcnt].length = 5;
+    iovcnt ++;
+  }
+
+  if (iovcnt == 0)
+    return (0);
+
+  if (http_writev(http, iov, iovcnt) < 0)
+  {
+    DEBUG_puts("8http_write_chunk: http_writev failed.");
+    return (-1);
+  }
+
+  http->wraw = 0;
+
+  return ((ssize_t)length);
+}
+
+
+/*
+ * 'http_writev()' - Write multiple buffers to a HTTP connection.
+ *
+ * The buffers are gathered into a single system call (or TLS record) when
+ * possible.  The iovec array is updated as data is written.
+ */
+
+static ssize_t				// O - Number of bytes written
+http_writev(http_t        *http,	// I - HTTP connection
+            _http_iovec_t *iov,		// I - Buffers to write
+            int           iovcnt)	// I - Number of buffers
+{
+  int		i;			// Looping var
+  size_t	length;			// Bytes remaining to write
   ssize_t	tbytes,			// Total bytes sent
 		bytes;			// Bytes sent
+#ifdef HAVE_TLS
+  char		temp[16384];		// Temporary buffer for TLS record
+#endif // HAVE_TLS
 
 
-  DEBUG_printf(("7http_write(http=%p, buffer=%p, length=" CUPS_LLFMT ")", (void *)http, (void *)buffer, CUPS_LLCAST length));
+  DEBUG_printf(("7http_writev(http=%p, iov=%p, iovcnt=%d)", (void *)http, (void *)iov, iovcnt));
   http->error = 0;
   tbytes      = 0;
 
+  for (i = 0, length = 0; i < iovcnt; i ++)
+    length += iov[i].length;
+
   while (length > 0)
   {
-    DEBUG_printf(("8http_write: About to write %d bytes.", (int)length));
+    DEBUG_printf(("8http_writev: About to write %d bytes.", (int)length));
+
+   /*
+    * Skip empty buffers...
+    */
+
+    while (iovcnt > 0 && iov->length == 0)
+    {
+      iov ++;
+      iovcnt --;
+    }
 
     if (http->timeout_value > 0.0)
     {
@@ -4388,12 +5066,54 @@ http_write(http_t     *http,		// I - HTTP connection
 
 #ifdef HAVE_TLS
     if (http->tls)
-      bytes = _httpTLSWrite(http, buffer, (int)length);
+    {
+      if (iovcnt > 1 && length <= sizeof(temp))
+      {
+       /*
+        * Copy small buffers so they go out in a single TLS record...
+        */
+
+        char	*tempptr;		// Pointer into temporary buffer
+
+        for (i = 0, tempptr = temp; i < iovcnt; i ++)
+        {
+          memcpy(tempptr, iov[i].data, iov[i].length);
+          tempptr += iov[i].length;
+        }
+
+        bytes = _httpTLSWrite(http, temp, (int)length);
+      }
+      else
+        bytes = _httpTLSWrite(http, iov->data, (int)iov->length);
+    }
     else
 #endif // HAVE_TLS
-    bytes = send(http->fd, buffer, length, 0);
+#ifdef _WIN32
+    bytes = send(http->fd, iov->data, (int)iov->length, 0);
+#else
+    if (iovcnt > 1)
+    {
+      struct iovec	vec[8];		// Vector for sendmsg()
+      struct msghdr	msg;		// Message for sendmsg()
 
-    DEBUG_printf(("8http_write: Write of " CUPS_LLFMT " bytes returned " CUPS_LLFMT ".", CUPS_LLCAST length, CUPS_LLCAST bytes));
+      memset(&msg, 0, sizeof(msg));
+
+      for (i = 0; i < iovcnt && i < (int)(sizeof(vec) / sizeof(vec[0])); i ++)
+      {
+        vec[i].iov_base = (void *)iov[i].data;
+        vec[i].iov_len  = iov[i].length;
+      }
+
+      msg.msg_iov    = vec;
+      msg.msg_iovlen = (size_t)i;
+
+      bytes = sendmsg(http->fd, &msg, 0);
+    }
+    else
+      bytes = send(http->fd, iov->data, iov->length, 0);
+#endif // _WIN32
+
+    DEBUG_printf(("8http_writev: Write of " CUPS_LLFMT " bytes returned " CUPS_LLFMT ".", CUPS_LLCAST length, CUPS_LLCAST bytes));
 
     if (bytes < 0)
     {
@@ -4433,63 +5153,47 @@ http_write(http_t     *http,		// I - HTTP connection
       }
 #endif // _WIN32
 
-      DEBUG_printf(("8http_write: error writing data (%s).", strerror(http->error)));
+      DEBUG_printf(("8http_writev: error writing data (%s).", strerror(http->error)));
 
       return (-1);
     }
 
-    buffer += bytes;
+    if (_cups_stats_enabled)
+      _cupsStatsAddIO(_CUPS_STATS_HTTP_WRITE, 1, (size_t)bytes, 0);
+
     tbytes += bytes;
     length -= (size_t)bytes;
-  }
 
+   /*
+    * Advance past the data that was written...
+    */
+
+    while (bytes > 0 && iovcnt > 0)
+    {
+      if ((size_t)bytes >= iov->length)
+      {
 #ifdef DEBUG
-  http_debug_hex("http_write", buffer - tbytes, (int)tbytes);
+        http_debug_hex("http_writev", iov->data, (int)iov->length);
 #endif // DEBUG
 
-  DEBUG_printf(("8http_write: Returning " CUPS_LLFMT ".", CUPS_LLCAST tbytes));
-
-  return (tbytes);
-}
-
-
-/*
- * 'http_write_chunk()' - Write a chunked buffer.
- */
-
-static ssize_t				// O - Number bytes written
-http_write_chunk(http_t     *http,	// I - HTTP connection
-                 const char *buffer,	// I - Buffer to write
-		 size_t        length)	// I - Length of buffer
-{
-  char		header[16];		// Chunk header
-  ssize_t	bytes;			// Bytes written
-
-
-  DEBUG_printf(("7http_write_chunk(http=%p, buffer=%p, length=" CUPS_LLFMT ")", (void *)http, (void *)buffer, CUPS_LLCAST length));
-
- /*
-  * Write the chunk header, data, and trailer.
-  */
-
-  snprintf(header, sizeof(header), "%x\r\n", (unsigned)length);
-  if (http_write(http, header, strlen(header)) < 0)
-  {
-    DEBUG_puts("8http_write_chunk: http_write of length failed.");
-    return (-1);
-  }
+        bytes -= (ssize_t)iov->length;
+        iov ++;
+        iovcnt --;
+      }
+      else
+      {
+#ifdef DEBUG
+        http_debug_hex("http_writev", iov->data, (int)bytes);
+#endif // DEBUG
 
-  if ((bytes = http_write(http, buffer, length)) < 0)
-  {
-    DEBUG_puts("8http_write_chunk: http_write of buffer failed.");
-    return (-1);
+        iov->data   += bytes;
+        iov->length -= (size_t)bytes;
+        bytes       = 0;
+      }
+    }
   }
 
-  if (http_write(http, "\r\n", 2) < 0)
-  {
-    DEBUG_puts("8http_write_chunk: http_write of CR LF failed.");
-    return (-1);
-  }
+  DEBUG_printf(("8http_writev: Returning " CUPS_LLFMT ".", CUPS_LLCAST tbytes));
 
-  return (bytes);
+  return (tbytes);
 }
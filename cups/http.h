@@ -415,12 +415,16 @@ typedef struct http_addrlist_s		// Socket address list, which is used to enumera
 
 typedef struct _http_s http_t;		// HTTP connection type
 
+typedef struct _http_pool_s http_pool_t;// HTTP connection pool type
+
 typedef struct http_credential_s	// HTTP credential data @exclude all@
 {
   void		*data;			// Pointer to credential data
   size_t	datalen;		// Credential length
 } http_credential_t;
 
+typedef void (*http_addrlist_cb_t)(void *cb_data, http_addrlist_t *addrlist);
+					// @link httpAddrGetListAsync@ callback
 typedef bool (*http_resolve_cb_t)(void *data);
 					// @link httpResolveURI@ callback
 typedef bool (*http_timeout_cb_t)(http_t *http, void *user_data);
@@ -433,6 +437,7 @@ typedef bool (*http_timeout_cb_t)(http_t *http, void *user_data);
 
 extern http_t		*httpAcceptConnection(int fd, bool blocking) _CUPS_PUBLIC;
 extern bool		httpAddCredential(cups_array_t *credentials, const void *data, size_t datalen) _CUPS_PUBLIC;
+extern void		httpAddrClearCache(const char *hostname) _CUPS_PUBLIC;
 extern bool		httpAddrClose(http_addr_t *addr, int fd) _CUPS_PUBLIC;
 extern http_addrlist_t	*httpAddrConnect(http_addrlist_t *addrlist, int *sock, int msec, int *cancel) _CUPS_PUBLIC;
 extern http_addrlist_t	*httpAddrCopyList(http_addrlist_t *src) _CUPS_PUBLIC;
@@ -440,6 +445,7 @@ extern void		httpAddrFreeList(http_addrlist_t *addrlist) _CUPS_PUBLIC;
 extern int		httpAddrGetFamily(http_addr_t *addr) _CUPS_PUBLIC;
 extern size_t		httpAddrGetLength(const http_addr_t *addr) _CUPS_PUBLIC;
 extern http_addrlist_t	*httpAddrGetList(const char *hostname, int family, const char *service) _CUPS_PUBLIC;
+extern bool		httpAddrGetListAsync(const char *hostname, int family, const char *service, http_addrlist_cb_t cb, void *cb_data) _CUPS_PUBLIC;
 extern int		httpAddrGetPort(http_addr_t *addr) _CUPS_PUBLIC;
 extern char		*httpAddrGetString(const http_addr_t *addr, char *s, size_t slen) _CUPS_PUBLIC;
 extern bool		httpAddrIsAny(const http_addr_t *addr) _CUPS_PUBLIC;
@@ -447,6 +453,8 @@ extern bool		httpAddrIsEqual(const http_addr_t *addr1, const http_addr_t *addr2)
 extern bool		httpAddrIsLocalhost(const http_addr_t *addr) _CUPS_PUBLIC;
 extern int		httpAddrListen(http_addr_t *addr, int port) _CUPS_PUBLIC;
 extern char		*httpAddrLookup(const http_addr_t *addr, char *name, size_t namelen) _CUPS_PUBLIC;
+extern void		httpAddrSetCacheTTL(int ttl, int negative_ttl) _CUPS_PUBLIC;
+extern void		httpAddrSetConnectDelay(int msec) _CUPS_PUBLIC;
 extern void		httpAddrSetPort(http_addr_t *addr, int port) _CUPS_PUBLIC;
 extern http_uri_status_t httpAssembleURI(http_uri_coding_t encoding, char *uri, size_t urilen, const char *scheme, const char *username, const char *host, int port, const char *resource) _CUPS_PUBLIC;
 extern http_uri_status_t httpAssembleURIf(http_uri_coding_t encoding, char *uri, size_t urilen, const char *scheme, const char *username, const char *host, int port, const char *resourcef, ...) _CUPS_FORMAT(8, 9) _CUPS_PUBLIC;
@@ -498,8 +506,13 @@ extern bool		httpIsChunked(http_t *http) _CUPS_PUBLIC;
 extern bool		httpIsEncrypted(http_t *http) _CUPS_PUBLIC;
 extern bool		httpLoadCredentials(const char *path, cups_array_t **credentials, const char *common_name) _CUPS_PUBLIC;
 extern ssize_t		httpPeek(http_t *http, char *buffer, size_t length) _CUPS_PUBLIC;
+extern void		httpPoolDelete(http_pool_t *pool) _CUPS_PUBLIC;
+extern http_t		*httpPoolGet(http_pool_t *pool, const char *host, int port, http_encryption_t encryption, int msec, int *cancel) _CUPS_PUBLIC;
+extern http_pool_t	*httpPoolNew(size_t max_per_host, int idle_timeout) _CUPS_PUBLIC;
+extern void		httpPoolPut(http_pool_t *pool, http_t *http) _CUPS_PUBLIC;
 extern ssize_t		httpPrintf(http_t *http, const char *format, ...) _CUPS_FORMAT(2, 3) _CUPS_PUBLIC;
 extern ssize_t		httpRead(http_t *http, char *buffer, size_t length) _CUPS_PUBLIC;
+extern ssize_t		httpReadBuffer(http_t *http, const char **data, size_t length) _CUPS_PUBLIC;
 extern http_state_t	httpReadRequest(http_t *http, char *resource, size_t resourcelen) _CUPS_PUBLIC;
 extern bool		httpReconnect(http_t *http, int msec, int *cancel) _CUPS_PUBLIC;
 extern const char	*httpResolveHostname(http_t *http, char *buffer, size_t bufsize) _CUPS_PUBLIC;
@@ -508,6 +521,7 @@ extern bool		httpSaveCredentials(const char *path, cups_array_t *credentials, co
 extern http_uri_status_t httpSeparateURI(http_uri_coding_t decoding, const char *uri, char *scheme, size_t schemelen, char *username, size_t usernamelen, char *host, size_t hostlen, int *port, char *resource, size_t resourcelen) _CUPS_PUBLIC;
 extern void		httpSetAuthString(http_t *http, const char *scheme, const char *data) _CUPS_PUBLIC;
 extern void		httpSetBlocking(http_t *http, bool b) _CUPS_PUBLIC;
+extern bool		httpSetBufferSize(http_t *http, size_t rsize, size_t wsize) _CUPS_PUBLIC;
 extern void		httpSetCookie(http_t *http, const char *cookie) _CUPS_PUBLIC;
 extern bool		httpSetCredentials(http_t *http, cups_array_t *certs) _CUPS_PUBLIC;
 extern void		httpSetDefaultField(http_t *http, http_field_t field, const char *value) _CUPS_PUBLIC;
@@ -524,6 +538,7 @@ extern http_status_t	httpUpdate(http_t *http) _CUPS_PUBLIC;
 extern const char	*httpURIStatusString(http_uri_status_t status) _CUPS_PUBLIC;
 extern bool		httpWait(http_t *http, int msec) _CUPS_PUBLIC;
 extern ssize_t		httpWrite(http_t *http, const char *buffer, size_t length) _CUPS_PUBLIC;
+extern off_t		httpWriteFd(http_t *http, int fd, off_t length) _CUPS_PUBLIC;
 extern bool		httpWriteRequest(http_t *http, const char *method, const char *uri);
 extern bool		httpWriteResponse(http_t *http, http_status_t status) _CUPS_PUBLIC;
 
@@ -10,13 +10,36 @@
 //
 
 #include "cups-private.h"
+#include "file-private.h"
 #include "debug-internal.h"
+#include <sys/stat.h>
 
 
 //
 // Private structures...
 //
 
+typedef struct _ipp_ftoken_s		// Cached token
+{
+  size_t		offset;		// Offset of token string
+  int			linenum;	// Line number after token
+} _ipp_ftoken_t;
+
+typedef struct _ipp_fcache_s		// Cached tokens for a file
+{
+  char			*filename;	// Filename
+  time_t		mtime;		// Modification time of file
+  off_t			size;		// Size of file
+  int			linenum,	// Line number at end of file
+			users;		// Number of files using the tokens
+  size_t		num_tokens,	// Number of tokens
+			alloc_tokens;	// Allocated tokens
+  _ipp_ftoken_t		*tokens;	// Tokens
+  size_t		datalen,	// Length of token strings
+			alloc_data;	// Allocated length of token strings
+  char			*data;		// Token strings
+} _ipp_fcache_t;
+
 struct _ipp_file_s			// IPP data file
 {
   ipp_file_t		*parent;	// Parent data file, if any
@@ -38,6 +61,24 @@ struct _ipp_file_s			// IPP data file
   void			*cb_data;	// Callback data
   char			*buffer;	// Output buffer
   size_t		alloc_buffer;	// Size of output buffer
+  cups_array_t		*cache;		// Token cache for child files, if enabled
+  cups_array_t		*ccache;	// Token cache for this file
+  _ipp_fcache_t		*ctokens;	// Cached tokens being read or recorded
+  bool			crecord;	// Recording tokens?
+  size_t		ctoken,		// Current cached token
+			save_token;	// Saved cached token
+};
+
+
+//
+// Local globals...
+//
+
+static const char	ipp_token_delims[256] =
+{					// Characters that end unquoted token text
+  ['\t'] = 1, ['\n'] = 1, ['\v'] = 1, ['\f'] = 1, ['\r'] = 1, [' '] = 1,
+  ['\"'] = 1, ['#'] = 1, ['\''] = 1, [','] = 1, ['\\'] = 1, ['{'] = 1,
+  ['}'] = 1
 };
 
 
@@ -45,8 +86,13 @@ struct _ipp_file_s			// IPP data file
 // Local functions...
 //
 
+static bool	cache_token(ipp_file_t *file, const char *token);
+static int	compare_cache(_ipp_fcache_t *a, _ipp_fcache_t *b, void *data);
 static bool	expand_buffer(ipp_file_t *file, size_t buffer_size);
+static void	finish_cache(ipp_file_t *file);
+static void	free_cache(_ipp_fcache_t *c);
 static bool	parse_value(ipp_file_t *file, ipp_t *ipp, ipp_attribute_t **attr, size_t element);
+static bool	read_token(ipp_file_t *file, char *token, size_t tokensize);
 static bool	report_error(ipp_file_t *file, const char *message, ...) _CUPS_FORMAT(2,3);
 static bool	write_string(ipp_file_t *file, const char *s, size_t len);
 
@@ -70,6 +116,21 @@ ippFileClose(ipp_file_t *file)		// I - IPP data file
   if ((ret = cupsFileClose(file->fp)) == false)
     _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
 
+  if (file->ctokens)
+  {
+    // Release the cached tokens, discarding tokens that were only partially
+    // recorded...
+    if (file->crecord)
+      free_cache(file->ctokens);
+    else
+      file->ctokens->users --;
+
+    file->ctokens = NULL;
+    file->ccache  = NULL;
+    file->crecord = false;
+    file->ctoken  = 0;
+  }
+
   free(file->filename);
 
   file->fp       = NULL;
@@ -104,6 +165,7 @@ ippFileDelete(ipp_file_t *file)		// I - IPP data file
   }
 
   cupsFreeOptions(file->num_vars, file->vars);
+  cupsArrayDelete(file->cache);
   free(file->buffer);
   free(file);
 
@@ -370,20 +432,70 @@ ippFileOpen(ipp_file_t *file,		// I - IPP data file
     return (false);
   }
 
-  // Try opening the file...
-  if ((fp = cupsFileOpen(filename, mode)) == NULL)
+  // Try opening the file, mapping files for reading into memory...
+  if ((fp = cupsFileOpen(filename, *mode == 'r' ? "rm" : mode)) == NULL)
   {
     _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
     return (false);
   }
 
-  // Save the file information and return...
+  // Save the file information...
   file->fp       = fp;
   file->filename = strdup(filename);
   file->mode     = *mode;
   file->column   = 0;
   file->linenum  = 1;
 
+  if (*mode == 'r')
+  {
+    // Use the token cache from the nearest parent that has one...
+    ipp_file_t		*parent;	// Parent file
+    struct stat		fileinfo;	// File information
+    _ipp_fcache_t	key,		// Search key
+			*c;		// Cached tokens
+
+    for (parent = file; parent && !parent->cache; parent = parent->parent);
+
+    if (parent && !fstat(cupsFileNumber(fp), &fileinfo))
+    {
+      key.filename = (char *)filename;
+
+      if ((c = (_ipp_fcache_t *)cupsArrayFind(parent->cache, &key)) != NULL && c->users == 0 && (c->mtime != fileinfo.st_mtime || c->size != fileinfo.st_size))
+      {
+        // File has changed, discard the cached tokens...
+        cupsArrayRemove(parent->cache, c);
+        c = NULL;
+      }
+
+      if (c && c->mtime == fileinfo.st_mtime && c->size == fileinfo.st_size)
+      {
+        // Read the cached tokens...
+        DEBUG_printf(("1ippFileOpen: Using %u cached tokens for \"%s\".", (unsigned)c->num_tokens, filename));
+
+        c->users ++;
+
+        file->ctokens = c;
+      }
+      else if (!c && (c = (_ipp_fcache_t *)calloc(1, sizeof(_ipp_fcache_t))) != NULL)
+      {
+        // Record the tokens as they are read...
+        if ((c->filename = strdup(filename)) != NULL)
+        {
+          c->mtime = fileinfo.st_mtime;
+          c->size  = fileinfo.st_size;
+
+          file->ctokens = c;
+          file->ccache  = parent->cache;
+          file->crecord = true;
+        }
+        else
+        {
+          free(c);
+        }
+      }
+    }
+  }
+
   return (true);
 }
 
@@ -760,10 +872,8 @@ ippFileReadToken(ipp_file_t *file,	// I - IPP data file
                  char       *token,	// I - Token buffer
                  size_t     tokensize)	// I - Size of token buffer
 {
-  int	ch,				// Character from file
-	quote = 0;			// Quoting character
-  char	*tokptr = token,		// Pointer into token buffer
-	*tokend = token + tokensize - 1;// End of token buffer
+  _ipp_ftoken_t	*t;			// Cached token
+  size_t	len;			// Length of cached token
 
 
   // Range check input...
@@ -777,161 +887,60 @@ ippFileReadToken(ipp_file_t *file,	// I - IPP data file
     return (false);
   }
 
-  // Skip whitespace and comments...
-  DEBUG_printf(("1ippFileReadToken: linenum=%d, pos=%ld", file->linenum, (long)cupsFileTell(file->fp)));
-
-  while ((ch = cupsFileGetChar(file->fp)) != EOF)
+  if (file->ctokens && !file->crecord)
   {
-    if (_cups_isspace(ch))
+    // Return the next cached token...
+    if (file->ctoken >= file->ctokens->num_tokens)
     {
-      // Whitespace...
-      if (ch == '\n')
-      {
-        file->linenum ++;
-        DEBUG_printf(("1ippFileReadToken: LF in leading whitespace, linenum=%d, pos=%ld", file->linenum, (long)cupsFileTell(file->fp)));
-      }
+      DEBUG_puts("1ippFileReadToken: EOF");
+      file->linenum = file->ctokens->linenum;
+      *token        = '\0';
+      return (false);
     }
-    else if (ch == '#')
-    {
-      // Comment...
-      DEBUG_puts("1ippFileReadToken: Skipping comment in leading whitespace...");
 
-      while ((ch = cupsFileGetChar(file->fp)) != EOF)
-      {
-        if (ch == '\n')
-          break;
-      }
+    t             = file->ctokens->tokens + file->ctoken ++;
+    file->linenum = t->linenum;
 
-      if (ch == '\n')
-      {
-        file->linenum ++;
-        DEBUG_printf(("1ippFileReadToken: LF at end of comment, linenum=%d, pos=%ld", file->linenum, (long)cupsFileTell(file->fp)));
-      }
-      else
-        break;
+    if ((len = strlen(file->ctokens->data + t->offset)) >= tokensize)
+    {
+      cupsCopyString(token, file->ctokens->data + t->offset, tokensize);
+      DEBUG_printf(("1ippFileReadToken: Too long: \"%s\".", token));
+      return (false);
     }
-    else
-      break;
-  }
 
-  if (ch == EOF)
-  {
-    DEBUG_puts("1ippFileReadToken: EOF");
-    return (false);
+    memcpy(token, file->ctokens->data + t->offset, len + 1);
+    DEBUG_printf(("1ippFileReadToken: Returning cached \"%s\".", token));
+    return (true);
   }
 
-  // Read a token...
-  while (ch != EOF)
+  if (read_token(file, token, tokensize))
   {
-    if (ch == '\n')
+    if (file->crecord && !cache_token(file, token))
     {
-      file->linenum ++;
-      DEBUG_printf(("1ippFileReadToken: LF in token, linenum=%d, pos=%ld", file->linenum, (long)cupsFileTell(file->fp)));
+      // Stop recording if we run out of memory...
+      free_cache(file->ctokens);
+      file->ctokens = NULL;
+      file->crecord = false;
     }
 
-    if (ch == quote)
-    {
-      // End of quoted text...
-      *tokptr = '\0';
-      DEBUG_printf(("1ippFileReadToken: Returning \"%s\" at closing quote.", token));
-      return (true);
-    }
-    else if (!quote && _cups_isspace(ch))
-    {
-      // End of unquoted text...
-      *tokptr = '\0';
-      DEBUG_printf(("1ippFileReadToken: Returning \"%s\" before whitespace.", token));
-      return (true);
-    }
-    else if (!quote && (ch == '\'' || ch == '\"'))
-    {
-      // Start of quoted text or regular expression...
-      quote = ch;
-
-      DEBUG_printf(("1ippFileReadToken: Start of quoted string, quote=%c, pos=%ld", quote, (long)cupsFileTell(file->fp)));
-    }
-    else if (!quote && ch == '#')
-    {
-      // Start of comment...
-      cupsFileSeek(file->fp, cupsFileTell(file->fp) - 1);
-      *tokptr = '\0';
-      DEBUG_printf(("1ippFileReadToken: Returning \"%s\" before comment.", token));
-      return (true);
-    }
-    else if (!quote && (ch == '{' || ch == '}' || ch == ','))
+    return (true);
+  }
+  else if (file->crecord)
+  {
+    // Save the recorded tokens at the end of the file, otherwise discard them...
+    if (cupsFileEOF(file->fp))
     {
-      // Delimiter...
-      if (tokptr > token)
-      {
-        // Return the preceding token first...
-	cupsFileSeek(file->fp, cupsFileTell(file->fp) - 1);
-      }
-      else
-      {
-        // Return this delimiter by itself...
-        *tokptr++ = (char)ch;
-      }
-
-      *tokptr = '\0';
-      DEBUG_printf(("1ippFileReadToken: Returning \"%s\".", token));
-      return (true);
+      finish_cache(file);
     }
     else
     {
-      if (ch == '\\')
-      {
-        // Quoted character...
-        DEBUG_printf(("1ippFileReadToken: Quoted character at pos=%ld", (long)cupsFileTell(file->fp)));
-
-        if ((ch = cupsFileGetChar(file->fp)) == EOF)
-        {
-	  *token = '\0';
-	  DEBUG_puts("1ippFileReadToken: EOF");
-	  return (false);
-	}
-	else if (ch == '\n')
-	{
-	  file->linenum ++;
-	  DEBUG_printf(("1ippFileReadToken: quoted LF, linenum=%d, pos=%ld", file->linenum, (long)cupsFileTell(file->fp)));
-	}
-	else if (ch == 'a')
-	  ch = '\a';
-	else if (ch == 'b')
-	  ch = '\b';
-	else if (ch == 'f')
-	  ch = '\f';
-	else if (ch == 'n')
-	  ch = '\n';
-	else if (ch == 'r')
-	  ch = '\r';
-	else if (ch == 't')
-	  ch = '\t';
-	else if (ch == 'v')
-	  ch = '\v';
-      }
-
-      if (tokptr < tokend)
-      {
-        // Add to current token...
-	*tokptr++ = (char)ch;
-      }
-      else
-      {
-        // Token too long...
-	*tokptr = '\0';
-	DEBUG_printf(("1ippFileReadToken: Too long: \"%s\".", token));
-	return (false);
-      }
+      free_cache(file->ctokens);
+      file->ctokens = NULL;
+      file->crecord = false;
     }
-
-    // Get the next character...
-    ch = cupsFileGetChar(file->fp);
   }
 
-  *tokptr = '\0';
-  DEBUG_printf(("1ippFileReadToken: Returning \"%s\" at EOF.", token));
-
-  return (tokptr > token);
+  return (false);
 }
 
 
@@ -949,9 +958,24 @@ ippFileRestorePosition(ipp_file_t *file)// I - IPP data file
   if (!file || file->mode != 'r' || file->save_line == 0)
     return (false);
 
-  // Seek back to the saved position...
-  if (cupsFileSeek(file->fp, file->save_pos) != file->save_pos)
-    return (false);
+  if (file->ctokens && !file->crecord)
+  {
+    // Go back to the saved cached token...
+    file->ctoken = file->save_token;
+  }
+  else
+  {
+    // Seek back to the saved position...
+    if (cupsFileSeek(file->fp, file->save_pos) != file->save_pos)
+      return (false);
+
+    if (file->crecord && file->save_token < file->ctokens->num_tokens)
+    {
+      // Discard recorded tokens that will be read again...
+      file->ctokens->datalen    = file->ctokens->tokens[file->save_token].offset;
+      file->ctokens->num_tokens = file->save_token;
+    }
+  }
 
   file->linenum   = file->save_line;
   file->save_pos  = 0;
@@ -979,6 +1003,11 @@ ippFileSavePosition(ipp_file_t *file)	// I - IPP data file
   file->save_pos  = cupsFileTell(file->fp);
   file->save_line = file->linenum;
 
+  if (file->crecord)
+    file->save_token = file->ctokens->num_tokens;
+  else
+    file->save_token = file->ctoken;
+
   return (true);
 }
 
@@ -1004,6 +1033,50 @@ ippFileSetAttributes(ipp_file_t *file,	// I - IPP data file
 }
 
 
+//
+// 'ippFileSetCache()' - Enable or disable token caching for an IPP data file.
+//
+// This function enables or disables caching of the tokens that are read from
+// files opened with this IPP data file object and any objects created with it
+// as the parent.  The tokens from a file are recorded the first time it is
+// read to the end, and later reads of the same unchanged file return the
+// recorded tokens without reading and parsing the file again.  This speeds up
+// repeated includes and repeated runs of the same files.
+//
+// Caching cannot be disabled while files are reading cached tokens.
+//
+
+bool					// O - `true` on success, `false` otherwise
+ippFileSetCache(ipp_file_t *file,	// I - IPP data file
+                bool       cache)	// I - `true` to cache tokens, `false` otherwise
+{
+  _ipp_fcache_t	*c;			// Cached tokens
+
+
+  if (!file)
+    return (false);
+
+  if (cache)
+  {
+    if (!file->cache && (file->cache = cupsArrayNew((cups_array_cb_t)compare_cache, NULL, NULL, 0, NULL, (cups_afree_cb_t)free_cache)) == NULL)
+      return (false);
+  }
+  else if (file->cache)
+  {
+    for (c = (_ipp_fcache_t *)cupsArrayGetFirst(file->cache); c; c = (_ipp_fcache_t *)cupsArrayGetNext(file->cache))
+    {
+      if (c->users > 0)
+        return (false);
+    }
+
+    cupsArrayDelete(file->cache);
+    file->cache = NULL;
+  }
+
+  return (true);
+}
+
+
 //
 // 'ippFileSetGroupTag()' - Set the group tag for an IPP data file.
 //
@@ -1524,6 +1597,73 @@ ippFileWriteTokenf(ipp_file_t *file,	// I - IPP data file
 }
 
 
+//
+// 'cache_token()' - Add a token to the recorded tokens for a file.
+//
+
+static bool				// O - `true` on success, `false` on error
+cache_token(ipp_file_t *file,		// I - IPP data file
+            const char *token)		// I - Token
+{
+  _ipp_fcache_t	*c = file->ctokens;	// Recorded tokens
+  size_t	len = strlen(token) + 1;// Length of token with nul
+
+
+  if (c->num_tokens >= c->alloc_tokens)
+  {
+    _ipp_ftoken_t	*temp;		// New tokens
+    size_t		alloc_tokens = c->alloc_tokens ? 2 * c->alloc_tokens : 256;
+					// New allocation
+
+    if ((temp = realloc(c->tokens, alloc_tokens * sizeof(_ipp_ftoken_t))) == NULL)
+      return (false);
+
+    c->tokens       = temp;
+    c->alloc_tokens = alloc_tokens;
+  }
+
+  if ((c->datalen + len) > c->alloc_data)
+  {
+    char	*temp;			// New token strings
+    size_t	alloc_data = c->alloc_data ? 2 * c->alloc_data : 4096;
+					// New allocation
+
+    while ((c->datalen + len) > alloc_data)
+      alloc_data *= 2;
+
+    if ((temp = realloc(c->data, alloc_data)) == NULL)
+      return (false);
+
+    c->data       = temp;
+    c->alloc_data = alloc_data;
+  }
+
+  c->tokens[c->num_tokens].offset  = c->datalen;
+  c->tokens[c->num_tokens].linenum = file->linenum;
+  c->num_tokens ++;
+
+  memcpy(c->data + c->datalen, token, len);
+  c->datalen += len;
+
+  return (true);
+}
+
+
+//
+// 'compare_cache()' - Compare the filenames of two sets of cached tokens.
+//
+
+static int				// O - Result of comparison
+compare_cache(_ipp_fcache_t *a,		// I - First cached tokens
+              _ipp_fcache_t *b,		// I - Second cached tokens
+              void          *data)	// I - Callback data (unused)
+{
+  (void)data;
+
+  return (strcmp(a->filename, b->filename));
+}
+
+
 //
 // 'expand_buffer()' - Expand the output buffer of the IPP data file as needed.
 //
@@ -1551,6 +1691,53 @@ expand_buffer(ipp_file_t *file,		// I - IPP data file
 }
 
 
+//
+// 'finish_cache()' - Add the recorded tokens for a file to the token cache.
+//
+// After this the remaining reads come from the (now exhausted) cached tokens.
+//
+
+static void
+finish_cache(ipp_file_t *file)		// I - IPP data file
+{
+  _ipp_fcache_t	*c = file->ctokens;	// Recorded tokens
+
+
+  file->crecord = false;
+
+  if (cupsArrayFind(file->ccache, c))
+  {
+    // Another file already cached these tokens...
+    free_cache(c);
+    file->ctokens = NULL;
+    return;
+  }
+
+  DEBUG_printf(("4finish_cache: Caching %u tokens for \"%s\".", (unsigned)c->num_tokens, c->filename));
+
+  c->linenum = file->linenum;
+  c->users   = 1;
+
+  cupsArrayAdd(file->ccache, c);
+
+  file->ctoken = c->num_tokens;
+}
+
+
+//
+// 'free_cache()' - Free cached tokens.
+//
+
+static void
+free_cache(_ipp_fcache_t *c)		// I - Cached tokens
+{
+  free(c->filename);
+  free(c->tokens);
+  free(c->data);
+  free(c);
+}
+
+
 //
 // 'parse_value()' - Parse an IPP value.
 //
@@ -1821,6 +2008,255 @@ parse_value(ipp_file_t      *file,	// I  - IPP data file
 }
 
 
+//
+// 'read_token()' - Read a token from an IPP data file.
+//
+// The token is read directly from the file buffer, copying runs of characters
+// that do not need any special handling.
+//
+
+static bool				// O - `true` on success, `false` on error
+read_token(ipp_file_t *file,		// I - IPP data file
+           char       *token,		// I - Token buffer
+           size_t     tokensize)	// I - Size of token buffer
+{
+  const char	*buf,			// Start of buffered data
+		*bufptr,		// Pointer into buffered data
+		*bufend,		// End of buffered data
+		*run;			// End of run of token characters
+  size_t	bytes,			// Bytes of buffered data
+		len;			// Length of run
+  int		ch,			// Current character
+		quote = 0;		// Quoting character
+  bool		comment = false,	// In a comment?
+		escape = false;		// After a backslash?
+  char		*tokptr = token,	// Pointer into token buffer
+		*tokend = token + tokensize - 1;// End of token buffer
+
+
+  // Skip whitespace and comments...
+  DEBUG_printf(("1ippFileReadToken: linenum=%d, pos=%ld", file->linenum, (long)cupsFileTell(file->fp)));
+
+  do
+  {
+    if ((buf = _cupsFilePeekBuffer(file->fp, &bytes)) == NULL)
+    {
+      DEBUG_puts("1ippFileReadToken: EOF");
+      return (false);
+    }
+
+    for (bufptr = buf, bufend = buf + bytes; bufptr < bufend;)
+    {
+      if (comment)
+      {
+        // Skip to the end of the comment...
+        if ((run = memchr(bufptr, '\n', (size_t)(bufend - bufptr))) == NULL)
+        {
+          bufptr = bufend;
+          break;
+        }
+
+        bufptr  = run + 1;
+        comment = false;
+
+        file->linenum ++;
+        DEBUG_printf(("1ippFileReadToken: LF at end of comment, linenum=%d", file->linenum));
+      }
+      else if (*bufptr == '\n')
+      {
+        bufptr ++;
+
+        file->linenum ++;
+        DEBUG_printf(("1ippFileReadToken: LF in leading whitespace, linenum=%d", file->linenum));
+      }
+      else if (_cups_isspace(*bufptr))
+      {
+        bufptr ++;
+      }
+      else if (*bufptr == '#')
+      {
+        DEBUG_puts("1ippFileReadToken: Skipping comment in leading whitespace...");
+        bufptr ++;
+        comment = true;
+      }
+      else
+      {
+        break;
+      }
+    }
+
+    _cupsFileSkip(file->fp, (size_t)(bufptr - buf));
+  }
+  while (bufptr >= bufend);
+
+  // Read a token...
+  for (;;)
+  {
+    if ((buf = _cupsFilePeekBuffer(file->fp, &bytes)) == NULL)
+      break;
+
+    for (bufptr = buf, bufend = buf + bytes; bufptr < bufend;)
+    {
+      ch = *bufptr & 255;
+
+      if (escape)
+      {
+        // Quoted character...
+        escape = false;
+
+        if (ch == '\n')
+        {
+	  file->linenum ++;
+	  DEBUG_printf(("1ippFileReadToken: quoted LF, linenum=%d", file->linenum));
+        }
+	else if (ch == 'a')
+	  ch = '\a';
+	else if (ch == 'b')
+	  ch = '\b';
+	else if (ch == 'f')
+	  ch = '\f';
+	else if (ch == 'n')
+	  ch = '\n';
+	else if (ch == 'r')
+	  ch = '\r';
+	else if (ch == 't')
+	  ch = '\t';
+	else if (ch == 'v')
+	  ch = '\v';
+
+        bufptr ++;
+
+        if (tokptr >= tokend)
+          goto too_long;
+
+        *tokptr++ = (char)ch;
+        continue;
+      }
+      else if (ch == '\\')
+      {
+        DEBUG_printf(("1ippFileReadToken: Quoted character at pos=%ld", (long)(cupsFileTell(file->fp) + (bufptr - buf))));
+        bufptr ++;
+        escape = true;
+        continue;
+      }
+      else if (quote)
+      {
+        if (ch == quote)
+        {
+          // End of quoted text...
+          _cupsFileSkip(file->fp, (size_t)(bufptr + 1 - buf));
+          *tokptr = '\0';
+          DEBUG_printf(("1ippFileReadToken: Returning \"%s\" at closing quote.", token));
+          return (true);
+        }
+        else if (ch == '\n')
+        {
+          file->linenum ++;
+          DEBUG_printf(("1ippFileReadToken: LF in token, linenum=%d", file->linenum));
+          run = bufptr + 1;
+        }
+        else
+        {
+          // Find the end of the quoted text in the buffer...
+          for (run = bufptr + 1; run < bufend && *run != quote && *run != '\\' && *run != '\n'; run ++);
+        }
+      }
+      else if (_cups_isspace(ch))
+      {
+        // End of unquoted text...
+        if (ch == '\n')
+        {
+          file->linenum ++;
+          DEBUG_printf(("1ippFileReadToken: LF in token, linenum=%d", file->linenum));
+        }
+
+        _cupsFileSkip(file->fp, (size_t)(bufptr + 1 - buf));
+        *tokptr = '\0';
+        DEBUG_printf(("1ippFileReadToken: Returning \"%s\" before whitespace.", token));
+        return (true);
+      }
+      else if (ch == '\'' || ch == '\"')
+      {
+        // Start of quoted text or regular expression...
+        quote = ch;
+        bufptr ++;
+        DEBUG_printf(("1ippFileReadToken: Start of quoted string, quote=%c", quote));
+        continue;
+      }
+      else if (ch == '#')
+      {
+        // Start of comment...
+        _cupsFileSkip(file->fp, (size_t)(bufptr - buf));
+        *tokptr = '\0';
+        DEBUG_printf(("1ippFileReadToken: Returning \"%s\" before comment.", token));
+        return (true);
+      }
+      else if (ch == '{' || ch == '}' || ch == ',')
+      {
+        // Delimiter...
+        if (tokptr == token)
+        {
+          // Return this delimiter by itself...
+          *tokptr++ = (char)ch;
+          bufptr ++;
+        }
+
+        _cupsFileSkip(file->fp, (size_t)(bufptr - buf));
+        *tokptr = '\0';
+        DEBUG_printf(("1ippFileReadToken: Returning \"%s\".", token));
+        return (true);
+      }
+      else
+      {
+        // Find the end of the unquoted text in the buffer...
+        for (run = bufptr + 1; run < bufend && !ipp_token_delims[*run & 255]; run ++);
+      }
+
+      // Add the run of characters to the token...
+      if ((len = (size_t)(run - bufptr)) > (size_t)(tokend - tokptr))
+      {
+        // Copy the characters that fit and consume the first one that does
+        // not...
+        len = (size_t)(tokend - tokptr);
+
+        memcpy(tokptr, bufptr, len);
+        tokptr += len;
+        bufptr += len + 1;
+
+        goto too_long;
+      }
+
+      memcpy(tokptr, bufptr, len);
+      tokptr += len;
+      bufptr = run;
+    }
+
+    _cupsFileSkip(file->fp, (size_t)(bufptr - buf));
+  }
+
+  if (escape)
+  {
+    *token = '\0';
+    DEBUG_puts("1ippFileReadToken: EOF");
+    return (false);
+  }
+
+  *tokptr = '\0';
+  DEBUG_printf(("1ippFileReadToken: Returning \"%s\" at EOF.", token));
+
+  return (tokptr > token);
+
+  // Token too long...
+  too_long:
+
+  _cupsFileSkip(file->fp, (size_t)(bufptr - buf));
+  *tokptr = '\0';
+  DEBUG_printf(("1ippFileReadToken: Too long: \"%s\".", token));
+
+  return (false);
+}
+
+
 //
 // 'report_error()' - Report an error.
 //
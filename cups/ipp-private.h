@@ -23,12 +23,44 @@ extern "C" {
 
 #  define IPP_BUF_SIZE	(IPP_MAX_LENGTH + 2)
 					// Size of buffer
+#  define _IPP_ARENA_ALIGN	16	// Alignment of arena allocations
+#  define _IPP_ARENA_SIZE	16384	// Size of arena blocks
+#  define _IPP_INDEX_MIN	8	// Minimum attributes for name index
 
 
 //
 // Structures...
 //
 
+typedef struct _ipp_arena_block_s	// Arena memory block
+{
+  struct _ipp_arena_block_s *next;	// Next block
+  size_t	size,			// Size of block
+		used;			// Bytes used in block
+  char		*data;			// Aligned start of data
+  char		buffer[1];		// Data buffer
+} _ipp_arena_block_t;
+
+typedef struct _ipp_arena_s		// Message arena
+{
+  size_t		use;		// Use count (messages in arena)
+  _ipp_arena_block_t	*blocks;	// Memory blocks, current first
+} _ipp_arena_t;
+
+typedef struct _ipp_index_entry_s	// Attribute name index entry
+{
+  unsigned		hash;		// Hash of name
+  ipp_attribute_t	*attr,		// First attribute with name
+			*prev;		// Attribute before it, if any
+} _ipp_index_entry_t;
+
+typedef struct _ipp_index_s		// Attribute name index
+{
+  size_t		count,		// Number of names
+			size;		// Number of entries (power of 2)
+  _ipp_index_entry_t	entries[1];	// Entries
+} _ipp_index_t;
+
 typedef union _ipp_request_u		// Request Header
 {
   struct				// Any Header
@@ -102,6 +134,7 @@ struct _ipp_attribute_s			// IPP attribute
   ipp_tag_t	group_tag,		// Job/Printer/Operation group tag
 		value_tag;		// What type of value is it?
   char		*name;			// Name of attribute
+  bool		in_arena;		// Allocated from the message arena?
   size_t	num_values;		// Number of values
   _ipp_value_t	values[1];		// Values
 };
@@ -119,6 +152,8 @@ struct _ipp_s				// IPP Request/Response/Notification
   size_t		use;		// Use count
   bool			atend;		// At end of list?
   size_t		curindex;	// Current attribute index for hierarchical search
+  _ipp_arena_t		*arena;		// Memory arena, if any
+  _ipp_index_t		*index;		// Attribute name index, if any
 };
 
 typedef struct _ipp_option_s		// Attribute mapping data
@@ -139,7 +174,9 @@ typedef struct _ipp_option_s		// Attribute mapping data
 #ifdef DEBUG
 extern const char	*_ippCheckOptions(void) _CUPS_PRIVATE;
 #endif // DEBUG
+extern cups_array_t	*_ippCreateKeywordArray(void) _CUPS_PRIVATE;
 extern _ipp_option_t	*_ippFindOption(const char *name) _CUPS_PRIVATE;
+extern void		_ippSeedStrings(void) _CUPS_PRIVATE;
 
 
 #  ifdef __cplusplus
@@ -21,19 +21,42 @@
 #endif // _WIN32
 
 
+/*
+ * Local types...
+ */
+
+typedef struct _ipp_stats_io_s		// I/O callback wrapper for statistics
+{
+  void		*context;		// Original callback context
+  ipp_io_cb_t	cb;			// Original callback function
+  size_t	bytes;			// Number of bytes read/written
+} _ipp_stats_io_t;
+
+
 /*
  * Local functions...
  */
 
 static ipp_attribute_t	*ipp_add_attr(ipp_t *ipp, const char *name, ipp_tag_t group_tag, ipp_tag_t value_tag, size_t num_values);
+static void		*ipp_arena_alloc(_ipp_arena_t *arena, size_t size);
+static void		ipp_arena_release(_ipp_arena_t *arena);
+static size_t		ipp_count_attrs(ipp_t *ipp);
 static void		ipp_free_values(ipp_attribute_t *attr, size_t element, size_t count);
 static char		*ipp_get_code(const char *locale, char *buffer, size_t bufsize) _CUPS_NONNULL(1,2);
+static void		ipp_index_add(ipp_t *ipp, ipp_attribute_t *attr, ipp_attribute_t *prev);
+static _ipp_index_entry_t *ipp_index_find(ipp_t *ipp, const char *name, bool *indexed);
+static void		ipp_index_free(ipp_t *ipp);
+static unsigned		ipp_index_hash(const char *name);
 static char		*ipp_lang_code(const char *locale, char *buffer, size_t bufsize) _CUPS_NONNULL(1,2);
 static size_t		ipp_length(ipp_t *ipp, int collection);
+static ipp_t		*ipp_new(_ipp_arena_t *arena);
 static ssize_t		ipp_read_http(http_t *http, ipp_uchar_t *buffer, size_t length);
 static ssize_t		ipp_read_file(int *fd, ipp_uchar_t *buffer, size_t length);
 static void		ipp_set_error(ipp_status_t status, const char *format, ...);
+static ssize_t		ipp_stats_io(_ipp_stats_io_t *sio, ipp_uchar_t *buffer, size_t length);
 static _ipp_value_t	*ipp_set_value(ipp_t *ipp, ipp_attribute_t **attr, size_t element);
+static char		*ipp_str_alloc(ipp_t *ipp, const char *s);
+static void		ipp_str_free(ipp_attribute_t *attr, char *s);
 static ssize_t		ipp_write_file(int *fd, ipp_uchar_t *buffer, size_t length);
 
 
@@ -914,19 +937,19 @@ ippAddString(ipp_t      *ipp,		// I - IPP message
   else
   {
     if (language)
-      attr->values[0].string.language = _cupsStrAlloc(ipp_lang_code(language, code,
+      attr->values[0].string.language = ipp_str_alloc(ipp, ipp_lang_code(language, code,
 						      sizeof(code)));
 
     if (value)
     {
       if (value_tag == IPP_TAG_CHARSET)
-	attr->values[0].string.text = _cupsStrAlloc(ipp_get_code(value, code,
+	attr->values[0].string.text = ipp_str_alloc(ipp, ipp_get_code(value, code,
 								 sizeof(code)));
       else if (value_tag == IPP_TAG_LANGUAGE)
-	attr->values[0].string.text = _cupsStrAlloc(ipp_lang_code(value, code,
+	attr->values[0].string.text = ipp_str_alloc(ipp, ipp_lang_code(value, code,
 								  sizeof(code)));
       else
-	attr->values[0].string.text = _cupsStrAlloc(value);
+	attr->values[0].string.text = ipp_str_alloc(ipp, value);
     }
   }
 
@@ -1257,7 +1280,7 @@ ippAddStrings(
         if ((int)value_tag & IPP_TAG_CUPS_CONST)
           value->string.language = (char *)language;
         else
-          value->string.language = _cupsStrAlloc(ipp_lang_code(language, code,
+          value->string.language = ipp_str_alloc(ipp, ipp_lang_code(language, code,
                                                                sizeof(code)));
       }
       else
@@ -1269,11 +1292,11 @@ ippAddStrings(
       if ((int)value_tag & IPP_TAG_CUPS_CONST)
         value->string.text = (char *)*values++;
       else if (value_tag == IPP_TAG_CHARSET)
-	value->string.text = _cupsStrAlloc(ipp_get_code(*values++, code, sizeof(code)));
+	value->string.text = ipp_str_alloc(ipp, ipp_get_code(*values++, code, sizeof(code)));
       else if (value_tag == IPP_TAG_LANGUAGE)
-	value->string.text = _cupsStrAlloc(ipp_lang_code(*values++, code, sizeof(code)));
+	value->string.text = ipp_str_alloc(ipp, ipp_lang_code(*values++, code, sizeof(code)));
       else
-	value->string.text = _cupsStrAlloc(*values++);
+	value->string.text = ipp_str_alloc(ipp, *values++);
     }
   }
 
@@ -1486,7 +1509,7 @@ ippCopyAttribute(
 	{
 	  // Otherwise do a normal reference counted copy...
 	  for (i = srcattr->num_values, srcval = srcattr->values, dstval = dstattr->values; i > 0; i --, srcval ++, dstval ++)
-	    dstval->string.text = _cupsStrAlloc(srcval->string.text);
+	    dstval->string.text = ipp_str_alloc(dst, srcval->string.text);
 	}
         break;
 
@@ -1506,11 +1529,11 @@ ippCopyAttribute(
 	  for (i = srcattr->num_values, srcval = srcattr->values, dstval = dstattr->values; i > 0; i --, srcval ++, dstval ++)
 	  {
 	    if (srcval == srcattr->values)
-              dstval->string.language = _cupsStrAlloc(srcval->string.language);
+              dstval->string.language = ipp_str_alloc(dst, srcval->string.language);
 	    else
               dstval->string.language = dstattr->values[0].string.language;
 
-	    dstval->string.text = _cupsStrAlloc(srcval->string.text);
+	    dstval->string.text = ipp_str_alloc(dst, srcval->string.text);
           }
         }
         break;
@@ -1683,13 +1706,21 @@ ippDelete(ipp_t *ipp)			// I - IPP message
 
     ipp_free_values(attr, 0, attr->num_values);
 
+    if (attr->in_arena)
+      continue;
+
     if (attr->name)
       _cupsStrFree(attr->name);
 
     free(attr);
   }
 
-  free(ipp);
+  ipp_index_free(ipp);
+
+  if (ipp->arena)
+    ipp_arena_release(ipp->arena);
+  else
+    free(ipp);
 }
 
 
@@ -1740,6 +1771,7 @@ ippDeleteAttribute(
 	if (current == ipp->last)
 	  ipp->last = prev;
 
+        ipp_index_free(ipp);
         break;
       }
 
@@ -1753,6 +1785,9 @@ ippDeleteAttribute(
 
   ipp_free_values(attr, 0, attr->num_values);
 
+  if (attr->in_arena)
+    return;				// Freed with the message arena
+
   if (attr->name)
     _cupsStrFree(attr->name);
 
@@ -1845,6 +1880,8 @@ ippFindNextAttribute(ipp_t      *ipp,	// I - IPP message
   ipp_tag_t		value_tag;	// Value tag
   char			parent[1024],	// Parent attribute name
 			*child = NULL;	// Child attribute name
+  _ipp_index_entry_t	*entry;		// Name index entry
+  bool			indexed;	// Is the message indexed?
 
 
   DEBUG_printf(("2ippFindNextAttribute(ipp=%p, name=\"%s\", type=%02x(%s))", (void *)ipp, name, type, ippTagString(type)));
@@ -1879,7 +1916,10 @@ ippFindNextAttribute(ipp_t      *ipp,	// I - IPP message
 
         ipp->curindex ++;
         if (ipp->curindex < ipp->current->num_values && ipp->current->values[ipp->curindex].collection)
+        {
           ipp->current->values[ipp->curindex].collection->current = NULL;
+          ipp->current->values[ipp->curindex].collection->atend   = false;
+        }
       }
 
       ipp->prev     = ipp->current;
@@ -1895,9 +1935,20 @@ ippFindNextAttribute(ipp_t      *ipp,	// I - IPP message
 
     if (!ipp->current)
     {
+      // Start with the first attribute with the parent name...
       ipp->prev     = NULL;
       ipp->current  = ipp->attrs;
       ipp->curindex = 0;
+
+      if ((entry = ipp_index_find(ipp, parent, &indexed)) != NULL)
+      {
+        ipp->prev    = entry->prev;
+        ipp->current = entry->attr;
+      }
+      else if (indexed)
+      {
+        ipp->current = NULL;
+      }
     }
 
     name = parent;
@@ -1910,8 +1961,19 @@ ippFindNextAttribute(ipp_t      *ipp,	// I - IPP message
   }
   else
   {
+    // Start with the first attribute with this name...
     ipp->prev = NULL;
     attr      = ipp->attrs;
+
+    if ((entry = ipp_index_find(ipp, name, &indexed)) != NULL)
+    {
+      ipp->prev = entry->prev;
+      attr      = entry->attr;
+    }
+    else if (indexed)
+    {
+      attr = NULL;
+    }
   }
 
   for (; attr != NULL; ipp->prev = attr, attr = attr->next)
@@ -2462,28 +2524,12 @@ ippLength(ipp_t *ipp)			// I - IPP message
 ipp_t *					// O - New IPP message
 ippNew(void)
 {
-  ipp_t			*temp;		// New IPP message
-  _cups_globals_t	*cg = _cupsGlobals();
-					// Global data
+  ipp_t	*temp;				// New IPP message
 
 
   DEBUG_puts("ippNew()");
 
-  if ((temp = (ipp_t *)calloc(1, sizeof(ipp_t))) != NULL)
-  {
-   /*
-    * Set default version - usually 2.0...
-    */
-
-    DEBUG_printf(("4debug_alloc: %p IPP message", (void *)temp));
-
-    if (cg->server_version == 0)
-      _cupsSetDefaults();
-
-    temp->request.any.version[0] = (ipp_uchar_t)(cg->server_version / 10);
-    temp->request.any.version[1] = (ipp_uchar_t)(cg->server_version % 10);
-    temp->use                    = 1;
-  }
+  temp = ipp_new(NULL);
 
   DEBUG_printf(("1ippNew: Returning %p", (void *)temp));
 
@@ -2578,10 +2624,10 @@ ippNewResponse(ipp_t *request)		// I - IPP request message
     return (NULL);
 
  /*
-  * Create a new IPP message...
+  * Create a new IPP message, using a memory arena if the request does...
   */
 
-  if ((response = ippNew()) == NULL)
+  if ((response = request->arena ? ippNewWithArena() : ippNew()) == NULL)
     return (NULL);
 
  /*
@@ -2657,6 +2703,42 @@ ippNewResponse(ipp_t *request)		// I - IPP request message
 }
 
 
+//
+// 'ippNewWithArena()' - Allocate a new IPP message using a memory arena.
+//
+// This function creates a new IPP message whose attributes, values, and
+// strings are allocated from a per-message memory arena.  This greatly reduces
+// the number of memory allocations needed to build or read a large message,
+// and all of the memory is released at once by @link ippDelete@.  Collection
+// values read into the message and responses created with
+// @link ippNewResponse@ share the arena.
+//
+// Memory used by attributes or values that are deleted or replaced is not
+// reclaimed until the message is deleted, so arena messages are best suited
+// for messages that are read or built once and not modified extensively.
+//
+
+ipp_t *					// O - New IPP message
+ippNewWithArena(void)
+{
+  _ipp_arena_t	*arena;			// Memory arena
+  ipp_t		*temp;			// New IPP message
+
+
+  DEBUG_puts("ippNewWithArena()");
+
+  if ((arena = (_ipp_arena_t *)calloc(1, sizeof(_ipp_arena_t))) == NULL)
+    return (NULL);
+
+  if ((temp = ipp_new(arena)) == NULL)
+    ipp_arena_release(arena);
+
+  DEBUG_printf(("1ippNewWithArena: Returning %p", (void *)temp));
+
+  return (temp);
+}
+
+
 /*
  * 'ippRead()' - Read data for an IPP message from a HTTP connection.
  */
@@ -2719,6 +2801,29 @@ ippReadIO(void        *src,		// I - Data source
   if (!src || !ipp)
     return (IPP_STATE_ERROR);
 
+  if (_cups_stats_enabled && !parent && cb != (ipp_io_cb_t)ipp_stats_io)
+  {
+   /*
+    * Count the bytes and attributes in the message...
+    */
+
+    _ipp_stats_io_t	sio;		// Statistics wrapper
+    ipp_state_t		state,		// Current state
+			prev = ipp->state;
+					// Previous state
+
+    sio.context = src;
+    sio.cb      = cb;
+    sio.bytes   = 0;
+
+    if ((state = ippReadIO(&sio, (ipp_io_cb_t)ipp_stats_io, blocking, NULL, ipp)) == IPP_STATE_DATA && prev != IPP_STATE_DATA)
+      _cupsStatsAddIO(_CUPS_STATS_IPP_READ, 1, sio.bytes, ipp_count_attrs(ipp));
+    else
+      _cupsStatsAddIO(_CUPS_STATS_IPP_READ, 0, sio.bytes, 0);
+
+    return (state);
+  }
+
   if ((buffer = (unsigned char *)_cupsBufferGet(IPP_BUF_SIZE)) == NULL)
   {
     DEBUG_puts("1ippReadIO: Unable to get read buffer.");
@@ -3168,7 +3273,7 @@ ippReadIO(void        *src,		// I - Data source
 		}
 
 		buffer[n] = '\0';
-		value->string.text = _cupsStrAlloc((char *)buffer);
+		value->string.text = ipp_str_alloc(ipp, (char *)buffer);
 		DEBUG_printf(("2ippReadIO: value=\"%s\"", value->string.text));
 	        break;
 
@@ -3295,7 +3400,7 @@ ippReadIO(void        *src,		// I - Data source
 		memcpy(string, bufptr + 2, (size_t)n);
 		string[n] = '\0';
 
-		value->string.language = _cupsStrAlloc((char *)string);
+		value->string.language = ipp_str_alloc(ipp, (char *)string);
 
                 bufptr += 2 + n;
 		n = (bufptr[0] << 8) | bufptr[1];
@@ -3309,7 +3414,7 @@ ippReadIO(void        *src,		// I - Data source
 		}
 
 		bufptr[2 + n] = '\0';
-                value->string.text = _cupsStrAlloc((char *)bufptr + 2);
+                value->string.text = ipp_str_alloc(ipp, (char *)bufptr + 2);
 	        break;
 
             case IPP_TAG_BEGIN_COLLECTION :
@@ -3317,7 +3422,7 @@ ippReadIO(void        *src,		// I - Data source
 	        * Oh, boy, here comes a collection value, so read it...
 		*/
 
-                value->collection = ippNew();
+                value->collection = ipp_new(ipp->arena);
 
                 if (n > 0)
 		{
@@ -3377,7 +3482,9 @@ ippReadIO(void        *src,		// I - Data source
 		}
 
 		buffer[n] = '\0';
-		attr->name = _cupsStrAlloc((char *)buffer);
+		attr->name = ipp_str_alloc(ipp, (char *)buffer);
+
+		ipp_index_free(ipp);
 
                /*
 	        * Since collection members are encoded differently than
@@ -3658,12 +3765,13 @@ ippSetName(ipp_t           *ipp,	// I  - IPP message
     return (false);
 
   // Set the value and return...
-  if ((temp = _cupsStrAlloc(name)) != NULL)
+  if ((temp = ipp_str_alloc(ipp, name)) != NULL)
   {
-    if ((*attr)->name)
-      _cupsStrFree((*attr)->name);
+    ipp_str_free(*attr, (*attr)->name);
 
     (*attr)->name = temp;
+
+    ipp_index_free(ipp);
   }
 
   return (temp != NULL);
@@ -3955,10 +4063,9 @@ ippSetString(ipp_t           *ipp,	// I  - IPP message
     {
       value->string.text = (char *)strvalue;
     }
-    else if ((temp = _cupsStrAlloc(strvalue)) != NULL)
+    else if ((temp = ipp_str_alloc(ipp, strvalue)) != NULL)
     {
-      if (value->string.text)
-        _cupsStrFree(value->string.text);
+      ipp_str_free(*attr, value->string.text);
 
       value->string.text = temp;
     }
@@ -4232,13 +4339,13 @@ ippSetValueTag(
             !strcmp(ipp->attrs->next->name, "attributes-natural-language") && (ipp->attrs->next->value_tag & IPP_TAG_CUPS_MASK) == IPP_TAG_LANGUAGE)
         {
           // Use the language code from the IPP message...
-	  (*attr)->values[0].string.language = _cupsStrAlloc(ipp->attrs->next->values[0].string.text);
+	  (*attr)->values[0].string.language = ipp_str_alloc(ipp, ipp->attrs->next->values[0].string.text);
         }
         else
         {
           // Otherwise, use the language code corresponding to the locale...
 	  language = cupsLangDefault();
-	  (*attr)->values[0].string.language = _cupsStrAlloc(ipp_lang_code(cupsLangGetName(language), code, sizeof(code)));
+	  (*attr)->values[0].string.language = ipp_str_alloc(ipp, ipp_lang_code(cupsLangGetName(language), code, sizeof(code)));
         }
 
         for (i = (*attr)->num_values - 1, value = (*attr)->values + 1; i > 0; i --, value ++)
@@ -4248,7 +4355,7 @@ ippSetValueTag(
         {
           // Make copies of all values...
 	  for (i = (*attr)->num_values, value = (*attr)->values; i > 0; i --, value ++)
-	    value->string.text = _cupsStrAlloc(value->string.text);
+	    value->string.text = ipp_str_alloc(ipp, value->string.text);
         }
 
         (*attr)->value_tag = IPP_TAG_NAMELANG;
@@ -4927,6 +5034,29 @@ ippWriteIO(void        *dst,		// I - Destination
   if (!dst || !ipp)
     return (IPP_STATE_ERROR);
 
+  if (_cups_stats_enabled && !parent && cb != (ipp_io_cb_t)ipp_stats_io)
+  {
+   /*
+    * Count the bytes and attributes in the message...
+    */
+
+    _ipp_stats_io_t	sio;		// Statistics wrapper
+    ipp_state_t		state,		// Current state
+			prev = ipp->state;
+					// Previous state
+
+    sio.context = dst;
+    sio.cb      = cb;
+    sio.bytes   = 0;
+
+    if ((state = ippWriteIO(&sio, (ipp_io_cb_t)ipp_stats_io, blocking, NULL, ipp)) == IPP_STATE_DATA && prev != IPP_STATE_DATA)
+      _cupsStatsAddIO(_CUPS_STATS_IPP_WRITE, 1, sio.bytes, ipp_count_attrs(ipp));
+    else
+      _cupsStatsAddIO(_CUPS_STATS_IPP_WRITE, 0, sio.bytes, 0);
+
+    return (state);
+  }
+
   if ((buffer = (unsigned char *)_cupsBufferGet(IPP_BUF_SIZE)) == NULL)
   {
     DEBUG_puts("1ippWriteIO: Unable to get write buffer");
@@ -5829,8 +5959,10 @@ ipp_add_attr(ipp_t      *ipp,		// I - IPP message
   else
     alloc_values = (num_values + IPP_MAX_VALUES - 1) & (size_t)~(IPP_MAX_VALUES - 1);
 
-  attr = calloc(sizeof(ipp_attribute_t) +
-                (size_t)(alloc_values - 1) * sizeof(_ipp_value_t), 1);
+  if (ipp->arena)
+    attr = ipp_arena_alloc(ipp->arena, sizeof(ipp_attribute_t) + (size_t)(alloc_values - 1) * sizeof(_ipp_value_t));
+  else
+    attr = calloc(sizeof(ipp_attribute_t) + (size_t)(alloc_values - 1) * sizeof(_ipp_value_t), 1);
 
   if (attr)
   {
@@ -5840,8 +5972,10 @@ ipp_add_attr(ipp_t      *ipp,		// I - IPP message
 
     DEBUG_printf(("4debug_alloc: %p %s %s%s (%u values)", (void *)attr, name, num_values > 1 ? "1setOf " : "", ippTagString(value_tag), (unsigned)num_values));
 
+    attr->in_arena = ipp->arena != NULL;
+
     if (name)
-      attr->name = _cupsStrAlloc(name);
+      attr->name = ipp_str_alloc(ipp, name);
 
     attr->group_tag  = group_tag;
     attr->value_tag  = value_tag;
@@ -5858,6 +5992,8 @@ ipp_add_attr(ipp_t      *ipp,		// I - IPP message
 
     ipp->prev = ipp->last;
     ipp->last = ipp->current = attr;
+
+    ipp_index_add(ipp, attr, ipp->prev);
   }
 
   DEBUG_printf(("5ipp_add_attr: Returning %p", (void *)attr));
@@ -5866,6 +6002,104 @@ ipp_add_attr(ipp_t      *ipp,		// I - IPP message
 }
 
 
+//
+// 'ipp_arena_alloc()' - Allocate zeroed memory from a message arena.
+//
+
+static void *				// O - Memory or `NULL` on error
+ipp_arena_alloc(_ipp_arena_t *arena,	// I - Memory arena
+                size_t       size)	// I - Number of bytes
+{
+  _ipp_arena_block_t	*block;		// Current block
+  size_t		bsize;		// Size of new block
+  void			*ptr;		// Allocated memory
+
+
+  size = (size + _IPP_ARENA_ALIGN - 1) & (size_t)~(_IPP_ARENA_ALIGN - 1);
+
+  if ((block = arena->blocks) == NULL || (block->size - block->used) < size)
+  {
+    // Allocate a new block, using a dedicated block for large requests...
+    if ((bsize = size) < _IPP_ARENA_SIZE)
+      bsize = _IPP_ARENA_SIZE;
+
+    if ((block = calloc(1, sizeof(_ipp_arena_block_t) + bsize + _IPP_ARENA_ALIGN)) == NULL)
+      return (NULL);
+
+    block->size = bsize;
+    block->data = (char *)(((uintptr_t)block->buffer + _IPP_ARENA_ALIGN - 1) & ~(uintptr_t)(_IPP_ARENA_ALIGN - 1));
+
+    if (!arena->blocks || bsize == _IPP_ARENA_SIZE)
+    {
+      // Make this the current block...
+      block->next   = arena->blocks;
+      arena->blocks = block;
+    }
+    else
+    {
+      // Keep the current block for small allocations...
+      block->next          = arena->blocks->next;
+      arena->blocks->next = block;
+    }
+  }
+
+  ptr         = block->data + block->used;
+  block->used += size;
+
+  return (ptr);
+}
+
+
+//
+// 'ipp_arena_release()' - Release a reference to a message arena.
+//
+
+static void
+ipp_arena_release(_ipp_arena_t *arena)	// I - Memory arena
+{
+  _ipp_arena_block_t	*block,		// Current block
+			*next;		// Next block
+
+
+  if (arena->use > 0)
+    arena->use --;
+
+  if (arena->use > 0)
+    return;
+
+  DEBUG_printf(("4debug_free: %p IPP arena", (void *)arena));
+
+  for (block = arena->blocks; block; block = next)
+  {
+    next = block->next;
+    free(block);
+  }
+
+  free(arena);
+}
+
+
+/*
+ * 'ipp_count_attrs()' - Count the attributes in a message, skipping separators.
+ */
+
+static size_t				// O - Number of attributes
+ipp_count_attrs(ipp_t *ipp)		// I - IPP message
+{
+  size_t		count = 0;	// Number of attributes
+  ipp_attribute_t	*attr;		// Current attribute
+
+
+  for (attr = ipp->attrs; attr; attr = attr->next)
+  {
+    if (attr->name)
+      count ++;
+  }
+
+  return (count);
+}
+
+
 /*
  * 'ipp_free_values()' - Free attribute values.
  */
@@ -5893,7 +6127,7 @@ ipp_free_values(ipp_attribute_t *attr,	// I - Attribute to free values from
       case IPP_TAG_NAMELANG :
 	  if (element == 0 && count == attr->num_values && attr->values[0].string.language)
 	  {
-	    _cupsStrFree(attr->values[0].string.language);
+	    ipp_str_free(attr, attr->values[0].string.language);
 	    attr->values[0].string.language = NULL;
 	  }
 	  // Fall through to other string values
@@ -5911,7 +6145,7 @@ ipp_free_values(ipp_attribute_t *attr,	// I - Attribute to free values from
 	       i > 0;
 	       i --, value ++)
 	  {
-	    _cupsStrFree(value->string.text);
+	    ipp_str_free(attr, value->string.text);
 	    value->string.text = NULL;
 	  }
 	  break;
@@ -6007,6 +6241,145 @@ ipp_get_code(const char *value,		// I - Locale/charset string
 }
 
 
+/*
+ * 'ipp_index_add()' - Add an attribute to the name index.
+ *
+ * Only the first attribute with a given name is indexed.  If the index is
+ * getting full it is freed and then rebuilt by the next lookup.
+ */
+
+static void
+ipp_index_add(ipp_t           *ipp,	// I - IPP message
+              ipp_attribute_t *attr,	// I - Attribute
+              ipp_attribute_t *prev)	// I - Previous attribute or `NULL`
+{
+  _ipp_index_t	*index = ipp->index;	// Name index
+  unsigned	hash;			// Hash of name
+  size_t	i,			// Looping var
+		mask;			// Mask for entries
+
+
+  if (!index || !attr->name)
+    return;
+
+  if ((index->count + 1) > (index->size / 2))
+  {
+    ipp_index_free(ipp);
+    return;
+  }
+
+  hash = ipp_index_hash(attr->name);
+  mask = index->size - 1;
+
+  for (i = hash & mask; index->entries[i].attr; i = (i + 1) & mask)
+  {
+    if (index->entries[i].hash == hash && !_cups_strcasecmp(index->entries[i].attr->name, attr->name))
+      return;
+  }
+
+  index->entries[i].hash = hash;
+  index->entries[i].attr = attr;
+  index->entries[i].prev = prev;
+  index->count ++;
+}
+
+
+/*
+ * 'ipp_index_find()' - Find the first attribute with a name using the index.
+ *
+ * The index is built as needed.  Small messages and collections are not
+ * indexed, in which case "indexed" is set to `false`.
+ */
+
+static _ipp_index_entry_t *		// O - Index entry or `NULL` if not found
+ipp_index_find(ipp_t      *ipp,		// I - IPP message
+               const char *name,	// I - Attribute name
+               bool       *indexed)	// O - `true` if the message is indexed
+{
+  _ipp_index_t		*index;		// Name index
+  ipp_attribute_t	*attr,		// Current attribute
+			*prev;		// Previous attribute
+  size_t		i,		// Looping var
+			count,		// Number of attributes
+			mask,		// Mask for entries
+			size;		// Number of entries
+  unsigned		hash;		// Hash of name
+
+
+  if ((index = ipp->index) == NULL)
+  {
+    // Don't bother indexing small messages and collections...
+    for (count = 0, attr = ipp->attrs; attr; attr = attr->next)
+      count ++;
+
+    if (count < _IPP_INDEX_MIN)
+    {
+      *indexed = false;
+      return (NULL);
+    }
+
+    for (size = 16; size < (2 * count); size *= 2);
+
+    if ((index = calloc(1, sizeof(_ipp_index_t) + (size - 1) * sizeof(_ipp_index_entry_t))) == NULL)
+    {
+      *indexed = false;
+      return (NULL);
+    }
+
+    index->size = size;
+    ipp->index  = index;
+
+    for (prev = NULL, attr = ipp->attrs; attr; prev = attr, attr = attr->next)
+      ipp_index_add(ipp, attr, prev);
+  }
+
+  *indexed = true;
+
+  hash = ipp_index_hash(name);
+  mask = index->size - 1;
+
+  for (i = hash & mask; index->entries[i].attr; i = (i + 1) & mask)
+  {
+    if (index->entries[i].hash == hash && !_cups_strcasecmp(index->entries[i].attr->name, name))
+      return (index->entries + i);
+  }
+
+  return (NULL);
+}
+
+
+/*
+ * 'ipp_index_free()' - Free the name index after the attribute list changes.
+ */
+
+static void
+ipp_index_free(ipp_t *ipp)		// I - IPP message
+{
+  free(ipp->index);
+  ipp->index = NULL;
+}
+
+
+/*
+ * 'ipp_index_hash()' - Compute the case-insensitive hash of a name.
+ */
+
+static unsigned				// O - Hash value
+ipp_index_hash(const char *name)	// I - Attribute name
+{
+  unsigned	hash = 2166136261U;	// FNV-1a hash
+
+
+  for (; *name; name ++)
+  {
+    hash ^= (unsigned)_cups_tolower(*name);
+    hash *= 16777619U;
+  }
+
+  return (hash);
+}
+
+
 /*
  * 'ipp_lang_code()' - Convert a C locale name into an IPP language code.
  *
@@ -6188,6 +6561,52 @@ ipp_length(ipp_t *ipp,			// I - IPP message or collection
 }
 
 
+//
+// 'ipp_new()' - Allocate a new IPP message, optionally in a memory arena.
+//
+
+static ipp_t *				// O - New IPP message
+ipp_new(_ipp_arena_t *arena)		// I - Memory arena or `NULL` for none
+{
+  ipp_t			*temp;		// New IPP message
+  _cups_globals_t	*cg = _cupsGlobals();
+					// Global data
+
+
+  if (arena)
+    temp = (ipp_t *)ipp_arena_alloc(arena, sizeof(ipp_t));
+  else
+    temp = (ipp_t *)calloc(1, sizeof(ipp_t));
+
+  if (temp)
+  {
+   /*
+    * Set default version - usually 2.0...
+    */
+
+    DEBUG_printf(("4debug_alloc: %p IPP message", (void *)temp));
+
+    if (cg->server_version == 0)
+    {
+      _cupsSetDefaults();
+      _ippSeedStrings();
+    }
+
+    temp->request.any.version[0] = (ipp_uchar_t)(cg->server_version / 10);
+    temp->request.any.version[1] = (ipp_uchar_t)(cg->server_version % 10);
+    temp->use                    = 1;
+
+    if (arena)
+    {
+      temp->arena = arena;
+      arena->use ++;
+    }
+  }
+
+  return (temp);
+}
+
+
 /*
  * 'ipp_read_http()' - Semi-blocking read on a HTTP connection...
  */
@@ -6330,7 +6749,8 @@ ipp_set_value(ipp_t           *ipp,	// IO - IPP message
   ipp_attribute_t	*temp,		// New attribute pointer
 			*current,	// Current attribute in list
 			*prev;		// Previous attribute in list
-  size_t		alloc_values;	// Allocated values
+  size_t		alloc_values,	// Allocated values
+			old_values;	// Previously allocated values
 
 
  /*
@@ -6357,6 +6777,8 @@ ipp_set_value(ipp_t           *ipp,	// IO - IPP message
   * values when num_values > 1.
   */
 
+  old_values = alloc_values;
+
   if (alloc_values < IPP_MAX_VALUES)
     alloc_values = IPP_MAX_VALUES;
   else
@@ -6368,7 +6790,16 @@ ipp_set_value(ipp_t           *ipp,	// IO - IPP message
   * Reallocate memory...
   */
 
-  if ((temp = realloc(temp, sizeof(ipp_attribute_t) + (size_t)(alloc_values - 1) * sizeof(_ipp_value_t))) == NULL)
+  if (temp->in_arena)
+  {
+    // Arena memory can't be resized, so copy to a new (larger) allocation...
+    if ((temp = ipp_arena_alloc(ipp->arena, sizeof(ipp_attribute_t) + (size_t)(alloc_values - 1) * sizeof(_ipp_value_t))) != NULL)
+      memcpy(temp, *attr, sizeof(ipp_attribute_t) + (size_t)(old_values - 1) * sizeof(_ipp_value_t));
+  }
+  else
+    temp = realloc(temp, sizeof(ipp_attribute_t) + (size_t)(alloc_values - 1) * sizeof(_ipp_value_t));
+
+  if (!temp)
   {
     _cupsSetHTTPError(HTTP_STATUS_ERROR);
     DEBUG_puts("4ipp_set_value: Unable to resize attribute.");
@@ -6435,6 +6866,8 @@ ipp_set_value(ipp_t           *ipp,	// IO - IPP message
     if (ipp->last == *attr)
       ipp->last = temp;
 
+    ipp_index_free(ipp);
+
     *attr = temp;
   }
 
@@ -6449,6 +6882,68 @@ ipp_set_value(ipp_t           *ipp,	// IO - IPP message
 }
 
 
+//
+// 'ipp_stats_io()' - Count the bytes read or written by an IO callback.
+//
+
+static ssize_t				// O - Number of bytes or -1 on error
+ipp_stats_io(_ipp_stats_io_t *sio,	// I - Statistics wrapper
+             ipp_uchar_t     *buffer,	// I - Buffer
+             size_t          length)	// I - Number of bytes
+{
+  ssize_t	bytes;			// Number of bytes read/written
+
+
+  if ((bytes = (sio->cb)(sio->context, buffer, length)) > 0)
+    sio->bytes += (size_t)bytes;
+
+  return (bytes);
+}
+
+
+//
+// 'ipp_str_alloc()' - Allocate a string for a message.
+//
+// Strings for arena messages are copied into the arena, otherwise they are
+// allocated from the global string pool.
+//
+
+static char *				// O - String or `NULL`
+ipp_str_alloc(ipp_t      *ipp,		// I - IPP message
+              const char *s)		// I - String
+{
+  size_t	len;			// Length of string
+  char		*temp;			// New string
+
+
+  if (!s)
+    return (NULL);
+
+  if (!ipp->arena)
+    return (_cupsStrAlloc(s));
+
+  len = strlen(s) + 1;
+
+  if ((temp = ipp_arena_alloc(ipp->arena, len)) != NULL)
+    memcpy(temp, s, len);
+
+  return (temp);
+}
+
+
+//
+// 'ipp_str_free()' - Free a string allocated for an attribute.
+//
+
+static void
+ipp_str_free(ipp_attribute_t *attr,	// I - Attribute
+             char            *s)	// I - String
+{
+  if (s && !attr->in_arena)
+    _cupsStrFree(s);
+}
+
+
 /*
  * 'ipp_write_file()' - Write IPP data to a file.
  */
@@ -587,6 +587,7 @@ extern bool		ippFileReadToken(ipp_file_t *file, char *token, size_t tokensize) _
 extern bool		ippFileRestorePosition(ipp_file_t *file) _CUPS_PUBLIC;
 extern bool		ippFileSavePosition(ipp_file_t *file) _CUPS_PUBLIC;
 extern bool		ippFileSetAttributes(ipp_file_t *file, ipp_t *attrs) _CUPS_PUBLIC;
+extern bool		ippFileSetCache(ipp_file_t *file, bool cache) _CUPS_PUBLIC;
 extern bool		ippFileSetGroupTag(ipp_file_t *file, ipp_tag_t group_tag) _CUPS_PUBLIC;
 extern bool		ippFileSetVar(ipp_file_t *file, const char *name, const char *value) _CUPS_PUBLIC;
 extern bool		ippFileSetVarf(ipp_file_t *file, const char *name, const char *value, ...) _CUPS_FORMAT(3,4) _CUPS_PUBLIC;
@@ -624,6 +625,7 @@ extern size_t		ippLength(ipp_t *ipp) _CUPS_PUBLIC;
 extern ipp_t		*ippNew(void) _CUPS_PUBLIC;
 extern ipp_t		*ippNewRequest(ipp_op_t op) _CUPS_PUBLIC;
 extern ipp_t		*ippNewResponse(ipp_t *request) _CUPS_PUBLIC;
+extern ipp_t		*ippNewWithArena(void) _CUPS_PUBLIC;
 
 extern const char	*ippOpString(ipp_op_t op) _CUPS_PUBLIC;
 extern ipp_op_t		ippOpValue(const char *name) _CUPS_PUBLIC;
@@ -9,16 +9,40 @@
 
 #include "cups-private.h"
 #include "json.h"
-#include <sys/stat.h>
+
+
+//
+// Local constants...
+//
+
+#define _CUPS_JSON_ARENA_SIZE	65536	// Minimum size of arena blocks
+#define _CUPS_JSON_INDEX_MIN	16	// Minimum number of children to index
 
 
 //
 // Private types...
 //
 
+typedef struct _cups_jarena_s		// Memory arena for loaded nodes
+{
+  struct _cups_jarena_s	*next;		// Next (older) block
+  size_t	used,			// Bytes used in block
+		size;			// Size of block
+  double	data[];			// Block data (aligned)
+} _cups_jarena_t;
+
+typedef struct _cups_jindex_s		// Array/object child index
+{
+  size_t	count;			// Number of children
+  cups_json_t	**children;		// Children in order
+  size_t	hashsize;		// Size of key hash table (power of 2)
+  cups_json_t	**hash;			// Key hash table (objects only)
+} _cups_jindex_t;
+
 struct _cups_json_s			// JSON node
 {
   cups_jtype_t	type;			// Node type
+  bool		in_arena;		// Allocated from an arena?
   cups_json_t	*parent,		// Parent node, if any
 		*sibling;		// Next sibling node, if any
   union
@@ -27,6 +51,48 @@ struct _cups_json_s			// JSON node
     double	number;			// Number value
     char	*string;		// String value
   }		value;			// Value, if any
+  _cups_jindex_t *index;		// Child index, if any
+  _cups_jarena_t *arena;		// Memory arena (root node only)
+};
+
+struct _cups_jframe_s			// JSON stream container
+{
+  cups_jtype_t	type;			// Container type
+  size_t	count;			// Number of keys and values
+};
+
+struct _cups_jreader_s			// JSON stream reader
+{
+  cups_json_cb_t cb;			// Read callback
+  void		*cb_data;		// Callback data
+  char		buffer[8192],		// Read buffer
+		*bufptr,		// Pointer into buffer
+		*bufend;		// End of buffer
+  bool		eof,			// End of input?
+		error,			// Error seen?
+		done;			// Root value complete?
+  cups_jtoken_t	token;			// Last token
+  struct _cups_jframe_s	*frames;	// Open containers
+  size_t	num_frames,		// Number of open containers
+		alloc_frames;		// Allocated containers
+  char		*string;		// Key/string value
+  size_t	strsize;		// Allocated size of string
+  double	number;			// Number value
+  struct lconv	*loc;			// Locale data
+};
+
+struct _cups_jwriter_s			// JSON stream writer
+{
+  cups_json_cb_t cb;			// Write callback
+  void		*cb_data;		// Callback data
+  char		buffer[8192];		// Write buffer
+  size_t	used;			// Bytes used in buffer
+  bool		error,			// Error seen?
+		done;			// Root value complete?
+  struct _cups_jframe_s	*frames;	// Open containers
+  size_t	num_frames,		// Number of open containers
+		alloc_frames;		// Allocated containers
+  struct lconv	*loc;			// Locale data
 };
 
 
@@ -35,6 +101,27 @@ struct _cups_json_s			// JSON node
 //
 
 static void	free_json(cups_json_t *json);
+static bool	json_add_char(cups_jreader_t *jr, size_t *len, int ch);
+static void	*json_arena_alloc(_cups_jarena_t **arena, size_t bytes);
+static void	json_arena_free(_cups_jarena_t *arena);
+static bool	json_fill(cups_jreader_t *jr);
+static int	json_getc(cups_jreader_t *jr);
+static size_t	json_hash(const char *key);
+static _cups_jindex_t *json_index(cups_json_t *json);
+static cups_json_t *json_new(_cups_jarena_t **arena, cups_json_t *parent, cups_json_t *after, cups_jtype_t type);
+static cups_json_t *json_new_string(_cups_jarena_t **arena, cups_json_t *parent, cups_json_t *after, cups_jtype_t type, const char *value);
+static cups_json_t *json_new_token(cups_jreader_t *jr, _cups_jarena_t **arena, cups_json_t *parent, cups_json_t *after);
+static int	json_peek(cups_jreader_t *jr);
+static int	json_peek_char(cups_jreader_t *jr);
+static bool	json_push(struct _cups_jframe_s **frames, size_t *num_frames, size_t *alloc_frames, cups_jtype_t type);
+static ssize_t	json_read_file(cups_file_t *fp, char *buffer, size_t bytes);
+static ssize_t	json_read_http(http_t *http, char *buffer, size_t bytes);
+static bool	json_read_string(cups_jreader_t *jr);
+static bool	json_write_data(cups_jwriter_t *jw, const char *data, size_t bytes);
+static ssize_t	json_write_file(cups_file_t *fp, char *buffer, size_t bytes);
+static ssize_t	json_write_http(http_t *http, char *buffer, size_t bytes);
+static bool	json_write_sep(cups_jwriter_t *jw, bool is_key);
+static bool	json_write_string(cups_jwriter_t *jw, const char *s);
 
 
 //
@@ -55,6 +142,9 @@ cupsJSONDelete(cups_json_t *json)	// I - JSON node
   // Remove the node from its parent...
   if (json->parent)
   {
+    free(json->parent->index);
+    json->parent->index = NULL;
+
     if ((child = json->parent->value.child) == json)
     {
       // This is the first child of the parent...
@@ -127,22 +217,43 @@ cupsJSONDelete(cups_json_t *json)	// I - JSON node
 //
 // 'cupsJSONFind()' - Find the value(s) associated with a given key.
 //
+// Large objects are indexed on first use so that subsequent lookups do not
+// need to search the list of keys.
+//
 
 cups_json_t *				// O - JSON value or `NULL`
 cupsJSONFind(cups_json_t *json,		// I - JSON object node
              const char  *key)		// I - Object key
 {
   cups_json_t	*current;		// Current child node
+  size_t	n,			// Number of children searched
+		mask;			// Hash table mask
 
 
   // Range check input...
-  if (!json || json->type != CUPS_JTYPE_OBJECT)
+  if (!json || json->type != CUPS_JTYPE_OBJECT || !key)
     return (NULL);
 
-  // Search for the named key...
-  for (current = json->value.child; current; current = current->sibling)
+  if (!json->index)
+  {
+    // Search for the named key...
+    for (current = json->value.child, n = 0; current; current = current->sibling, n ++)
+    {
+      if (current->type == CUPS_JTYPE_KEY && !strcmp(key, current->value.string))
+        break;
+    }
+
+    // Use the list for small objects...
+    if (n < _CUPS_JSON_INDEX_MIN || !json_index(json))
+      return (current ? current->sibling : NULL);
+  }
+
+  // Look up the key in the hash table...
+  mask = json->index->hashsize - 1;
+
+  for (n = json_hash(key) & mask; (current = json->index->hash[n]) != NULL; n = (n + 1) & mask)
   {
-    if (current->type == CUPS_JTYPE_KEY && !strcmp(key, current->value.string))
+    if (!strcmp(key, current->value.string))
       return (current->sibling);
   }
 
@@ -166,6 +277,10 @@ cupsJSONGetChild(cups_json_t *json,	// I - JSON array or object node
   if (!json || (json->type != CUPS_JTYPE_ARRAY && json->type != CUPS_JTYPE_OBJECT))
     return (NULL);
 
+  // Use the index for large arrays and objects...
+  if (json->index || (n >= _CUPS_JSON_INDEX_MIN && json_index(json)))
+    return (n < json->index->count ? json->index->children[n] : NULL);
+
   // Search for the Nth child...
   for (current = json->value.child; n > 0 && current; current = current->sibling)
     n --;
@@ -189,6 +304,10 @@ cupsJSONGetCount(cups_json_t *json)	// I - JSON array or object node
   if (!json || (json->type != CUPS_JTYPE_ARRAY && json->type != CUPS_JTYPE_OBJECT))
     return (0);
 
+  // Use the index, if any...
+  if (json->index)
+    return (json->index->count);
+
   // Count the child nodes...
   for (current = json->value.child, n = 0; current; current = current->sibling)
     n ++;
@@ -280,11 +399,10 @@ cupsJSONGetType(cups_json_t *json)	// I - JSON node
 cups_json_t *				// O - Root JSON object node
 cupsJSONLoadFile(const char *filename)	// I - JSON filename
 {
-  cups_json_t	*json;			// Root JSON object node
-  int		fd;			// JSON file
-  struct stat	fileinfo;		// JSON file information
-  char		*s;			// Allocated string containing JSON file
-  ssize_t	bytes;			// Bytes read
+  cups_json_t	*json = NULL;		// Root JSON object node
+  int		fd;			// JSON file descriptor
+  cups_file_t	*fp;			// JSON file
+  cups_jreader_t *jr;			// JSON stream reader
 
 
   // Range check input...
@@ -297,45 +415,28 @@ cupsJSONLoadFile(const char *filename)	// I - JSON filename
     _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
     return (NULL);
   }
-  else if (fstat(fd, &fileinfo))
-  {
-    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
-    close(fd);
-    return (NULL);
-  }
-  else if (fileinfo.st_size > 16777216)
-  {
-    // Don't support JSON files over 16MiB
-    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, _("JSON file too large."), 1);
-    close(fd);
-    return (NULL);
-  }
-
-  // Allocate memory for the JSON file...
-  if ((s = malloc((size_t)fileinfo.st_size + 1)) == NULL)
+  else if ((fp = cupsFileOpenFd(fd, "r")) == NULL)
   {
     _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
     close(fd);
     return (NULL);
   }
 
-  // Read the file into the allocated string...
-  if ((bytes = read(fd, s, (size_t)fileinfo.st_size)) < 0)
+  // Read the root object from the file...
+  if ((jr = cupsJSONReaderNewFile(fp)) != NULL)
   {
-    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
-    close(fd);
-    free(s);
-    return (NULL);
-  }
+    cups_jtoken_t token = cupsJSONReaderNext(jr);
+					// First token
 
-  s[bytes] = '\0';
-  close(fd);
+    if (token == CUPS_JTOKEN_OBJECT_START)
+      json = cupsJSONReaderLoad(jr);
+    else if (token != CUPS_JTOKEN_ERROR)
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, _("Invalid JSON data."), 1);
 
-  // Load the resulting string
-  json = cupsJSONLoadString(s);
+    cupsJSONReaderDelete(jr);
+  }
 
-  // Free the string and return...
-  free(s);
+  cupsFileClose(fp);
 
   return (json);
 }
@@ -354,6 +455,7 @@ cupsJSONLoadString(const char *s)	// I - JSON string
 		*current;		// Current node
   size_t	count;			// Number of children
   struct lconv	*loc;			// Locale data
+  _cups_jarena_t *arena = NULL;		// Memory arena
   static const char *sep = ",]} \n\r\t";// Separator chars
 
 
@@ -367,13 +469,15 @@ cupsJSONLoadString(const char *s)	// I - JSON string
     return (NULL);
   }
 
-  // Create the root node...
-  if ((json = cupsJSONNew(NULL, NULL, CUPS_JTYPE_OBJECT)) == NULL)
+  // Create the root node, which owns the memory arena for the whole tree...
+  if ((json = json_new(&arena, NULL, NULL, CUPS_JTYPE_OBJECT)) == NULL)
   {
     DEBUG_puts("2cupsJSONLoadString: Unable to create root object.");
     return (NULL);
   }
 
+  json->arena = arena;
+
   // Parse until we get to the end...
   parent = json;
   count  = 0;
@@ -493,18 +597,17 @@ cupsJSONLoadString(const char *s)	// I - JSON string
 
       // Allocate and copy the string over...
       if (parent->type == CUPS_JTYPE_OBJECT && !(count & 1))
-        current = cupsJSONNew(parent, prev, CUPS_JTYPE_KEY);
+        current = json_new(&json->arena, parent, prev, CUPS_JTYPE_KEY);
       else
-        current = cupsJSONNew(parent, prev, CUPS_JTYPE_STRING);
+        current = json_new(&json->arena, parent, prev, CUPS_JTYPE_STRING);
 
       if (!current)
       {
 	DEBUG_puts("2cupsJSONLoadString: Unable to allocate key/string node.");
         goto error;
       }
-      else if ((current->value.string = malloc(len)) == NULL)
+      else if ((current->value.string = json_arena_alloc(&json->arena, len)) == NULL)
       {
-        _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
         goto error;
       }
 
@@ -602,7 +705,7 @@ cupsJSONLoadString(const char *s)	// I - JSON string
     else if (strchr("0123456789-", *s))
     {
       // Number
-      if ((current = cupsJSONNew(parent, prev, CUPS_JTYPE_NUMBER)) == NULL)
+      if ((current = json_new(&json->arena, parent, prev, CUPS_JTYPE_NUMBER)) == NULL)
         goto error;
 
       current->value.number = _cupsStrScand(s, (char **)&s, loc);
@@ -614,7 +717,7 @@ cupsJSONLoadString(const char *s)	// I - JSON string
     else if (*s == '{')
     {
       // Start object
-      if ((parent = cupsJSONNew(parent, prev, CUPS_JTYPE_OBJECT)) == NULL)
+      if ((parent = json_new(&json->arena, parent, prev, CUPS_JTYPE_OBJECT)) == NULL)
       {
         DEBUG_puts("2cupsJSONLoadString: Unable to allocate object.");
         goto error;
@@ -648,7 +751,7 @@ cupsJSONLoadString(const char *s)	// I - JSON string
     else if (*s == '[')
     {
       // Start array
-      if ((parent = cupsJSONNew(parent, prev, CUPS_JTYPE_ARRAY)) == NULL)
+      if ((parent = json_new(&json->arena, parent, prev, CUPS_JTYPE_ARRAY)) == NULL)
       {
         DEBUG_puts("2cupsJSONLoadString: Unable to allocate array.");
         goto error;
@@ -680,7 +783,7 @@ cupsJSONLoadString(const char *s)	// I - JSON string
     else if (!strncmp(s, "null", 4) && strchr(sep, s[4]))
     {
       // null value
-      if ((prev = cupsJSONNew(parent, prev, CUPS_JTYPE_NULL)) == NULL)
+      if ((prev = json_new(&json->arena, parent, prev, CUPS_JTYPE_NULL)) == NULL)
       {
         DEBUG_puts("2cupsJSONLoadString: Unable to allocate null value.");
         goto error;
@@ -694,7 +797,7 @@ cupsJSONLoadString(const char *s)	// I - JSON string
     else if (!strncmp(s, "false", 5) && strchr(sep, s[5]))
     {
       // false value
-      if ((prev = cupsJSONNew(parent, prev, CUPS_JTYPE_FALSE)) == NULL)
+      if ((prev = json_new(&json->arena, parent, prev, CUPS_JTYPE_FALSE)) == NULL)
       {
         DEBUG_puts("2cupsJSONLoadString: Unable to allocate false value.");
         goto error;
@@ -708,7 +811,7 @@ cupsJSONLoadString(const char *s)	// I - JSON string
     else if (!strncmp(s, "true", 4) && strchr(sep, s[4]))
     {
       // true value
-      if ((prev = cupsJSONNew(parent, prev, CUPS_JTYPE_TRUE)) == NULL)
+      if ((prev = json_new(&json->arena, parent, prev, CUPS_JTYPE_TRUE)) == NULL)
       {
         DEBUG_puts("2cupsJSONLoadString: Unable to allocate true value.");
         goto error;
@@ -762,47 +865,7 @@ cupsJSONNew(cups_json_t  *parent,	// I - Parent JSON node or `NULL` for a root n
             cups_json_t  *after,	// I - Previous sibling node or `NULL` to append to the end
             cups_jtype_t type)		// I - JSON node type
 {
-  cups_json_t	*node;			// JSON node
-
-
-  // Range check input...
-  if (parent && parent->type != CUPS_JTYPE_ARRAY && parent->type != CUPS_JTYPE_OBJECT)
-    return (NULL);
-
-  // Allocate the node...
-  if ((node = calloc(1, sizeof(cups_json_t))) != NULL)
-  {
-    node->parent = parent;
-    node->type   = type;
-
-    if (parent)
-    {
-      // Add node to parent...
-      cups_json_t	*current;	// Current child node
-
-      if (after)
-      {
-        // Append after the specified sibling...
-        node->sibling  = after->sibling;
-        after->sibling = node;
-      }
-      else if ((current = parent->value.child) != NULL)
-      {
-        // Find the last child...
-	while (current && current->sibling)
-	  current = current->sibling;
-
-	current->sibling = node;
-      }
-      else
-      {
-        // This is the first child...
-	parent->value.child = node;
-      }
-    }
-  }
-
-  return (node);
+  return (json_new(NULL, parent, after, type));
 }
 
 
@@ -815,19 +878,7 @@ cupsJSONNewKey(cups_json_t *parent,	// I - Parent JSON node or `NULL` for a root
 	       cups_json_t  *after,	// I - Previous sibling node or `NULL` to append to the end
                const char  *value)	// I - Key string
 {
-  cups_json_t	*node;			// JSON node
-  char		*s = strdup(value);	// Key string
-
-
-  if (!s)
-    return (NULL);
-
-  if ((node = cupsJSONNew(parent, after, CUPS_JTYPE_KEY)) != NULL)
-    node->value.string = s;
-  else
-    free(s);
-
-  return (node);
+  return (json_new_string(NULL, parent, after, CUPS_JTYPE_KEY, value));
 }
 
 
@@ -859,328 +910,1917 @@ cupsJSONNewString(cups_json_t *parent,	// I - Parent JSON node or `NULL` for a r
 		  cups_json_t  *after,	// I - Previous sibling node or `NULL` to append to the end
 		  const char  *value)	// I - String value
 {
-  cups_json_t	*node;			// JSON node
-  char		*s = strdup(value);	// String value
+  return (json_new_string(NULL, parent, after, CUPS_JTYPE_STRING, value));
+}
 
 
-  if (!s)
-    return (NULL);
+//
+// 'cupsJSONReaderDelete()' - Free a JSON stream reader.
+//
+// This function frees the memory used by a JSON stream reader.  The underlying
+// file or HTTP connection is not closed.
+//
 
-  if ((node = cupsJSONNew(parent, after, CUPS_JTYPE_STRING)) != NULL)
-    node->value.string = s;
-  else
-    free(s);
+void
+cupsJSONReaderDelete(
+    cups_jreader_t *jr)			// I - JSON stream reader
+{
+  if (!jr)
+    return;
 
-  return (node);
+  free(jr->frames);
+  free(jr->string);
+  free(jr);
 }
 
 
 //
-// 'cupsJSONSaveFile()' - Save a JSON node tree to a file.
+// 'cupsJSONReaderGetDepth()' - Get the current nesting depth of a JSON stream reader.
 //
 
-bool					// O - `true` on success, `false` on failure
-cupsJSONSaveFile(cups_json_t *json,	// I - JSON root node
-                 const char  *filename)	// I - JSON filename
+size_t					// O - Number of open arrays and objects
+cupsJSONReaderGetDepth(
+    cups_jreader_t *jr)			// I - JSON stream reader
 {
-  char	*s;				// JSON string
-  int	fd;				// JSON file
-
+  return (jr ? jr->num_frames : 0);
+}
 
-  DEBUG_printf(("cupsJSONSaveFile(json=%p, filename=\"%s\")", (void *)json, filename));
 
-  // Get the JSON as a string...
-  if ((s = cupsJSONSaveString(json)) == NULL)
-    return (false);
+//
+// 'cupsJSONReaderGetNumber()' - Get the value of the last number token.
+//
 
-  // Create the file...
-  if ((fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666)) < 0)
-  {
-    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
-    free(s);
-    return (false);
-  }
+double					// O - Number value
+cupsJSONReaderGetNumber(
+    cups_jreader_t *jr)			// I - JSON stream reader
+{
+  return (jr && jr->token == CUPS_JTOKEN_NUMBER ? jr->number : 0.0);
+}
 
-  if (write(fd, s, strlen(s)) < 0)
-  {
-    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
-    close(fd);
-    unlink(filename);
-    free(s);
-    return (false);
-  }
 
-  close(fd);
-  free(s);
+//
+// 'cupsJSONReaderGetString()' - Get the value of the last key or string token.
+//
+// The returned string is only valid until the next call to
+// @link cupsJSONReaderNext@.
+//
 
-  return (true);
+const char *				// O - String value
+cupsJSONReaderGetString(
+    cups_jreader_t *jr)			// I - JSON stream reader
+{
+  return (jr && (jr->token == CUPS_JTOKEN_KEY || jr->token == CUPS_JTOKEN_STRING) ? jr->string : NULL);
 }
 
 
 //
-// 'cupsJSONSaveString()' - Save a JSON node tree to a string.
+// 'cupsJSONReaderLoad()' - Load the current value of a JSON stream reader.
 //
-// This function saves a JSON node tree to an allocated string.  The resulting
-// string must be freed using the `free` function.
+// This function creates a JSON node tree for the value returned by the last
+// call to @link cupsJSONReaderNext@.  If the value is an array or object, the
+// reader is advanced to the end of it.  The returned tree must be freed using
+// the @link cupsJSONDelete@ function.
 //
 
-char *					// O - JSON string or `NULL` on error
-cupsJSONSaveString(cups_json_t *json)	// I - JSON root node
+cups_json_t *				// O - JSON node tree or `NULL` on error
+cupsJSONReaderLoad(cups_jreader_t *jr)	// I - JSON stream reader
 {
-  cups_json_t	*current;		// Current node
-  size_t	length;			// Length of JSON data as a string
-  char		*s,			// JSON string
-		*ptr;			// Pointer into string
-  const char	*value;			// Pointer into string value
-  struct lconv	*loc;			// Locale data
-
+  cups_json_t	*json,			// JSON node tree
+		*parent,		// Current parent node
+		*prev = NULL,		// Previous node
+		*current;		// Current node
+  size_t	depth;			// Starting depth
+  cups_jtoken_t	token;			// Current token
+  _cups_jarena_t *arena = NULL;		// Memory arena
 
-  DEBUG_printf(("cupsJSONSaveString(json=%p)", (void *)json));
 
   // Range check input...
-  if (!json)
-  {
-    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
-    DEBUG_puts("3cupsJSONSaveString: Returning NULL.");
+  if (!jr || jr->error)
     return (NULL);
-  }
-
-  // Figure out the necessary space needed in the string
-  current = json;
-  length  = 1;				// nul
 
-  while (current)
+  // Create the node for the current value, which owns the memory arena for
+  // the whole tree...
+  if ((json = json_new_token(jr, &arena, NULL, NULL)) == NULL)
   {
-    if (current->parent && current->parent->value.child != current)
-      length ++;			// Comma or colon separator
-
-    switch (current->type)
-    {
-      case CUPS_JTYPE_NULL :
-      case CUPS_JTYPE_TRUE :
-          length += 4;
-          break;
+    json_arena_free(arena);
+    return (NULL);
+  }
 
-      case CUPS_JTYPE_FALSE :
-          length += 5;
-          break;
+  json->arena = arena;
 
-      case CUPS_JTYPE_ARRAY :
-      case CUPS_JTYPE_OBJECT :
-          length += 2;			// Brackets/braces
-          break;
+  if (jr->token != CUPS_JTOKEN_ARRAY_START && jr->token != CUPS_JTOKEN_OBJECT_START)
+    return (json);
 
-      case CUPS_JTYPE_NUMBER :
-          length += 32;
-          break;
+  // Read the array/object...
+  depth  = jr->num_frames;
+  parent = json;
 
-      case CUPS_JTYPE_KEY :
-      case CUPS_JTYPE_STRING :
-          length += 2;			// Quotes
-          for (value = current->value.string; *value; value ++)
-          {
-	    if (strchr("\\\"\b\f\n\r\t", *value))
-	      length += 2;		// Simple escaped char
-            else if ((*value & 255) < ' ')
-              length += 6;		// Worst case for control char
-	    else
-	      length ++;		// Literal char
-          }
-          break;
+  while (jr->num_frames >= depth)
+  {
+    if ((token = cupsJSONReaderNext(jr)) == CUPS_JTOKEN_ERROR)
+    {
+      cupsJSONDelete(json);
+      return (NULL);
     }
-
-    // Get next node...
-    if ((current->type == CUPS_JTYPE_ARRAY || current->type == CUPS_JTYPE_OBJECT) && current->value.child)
+    else if (token == CUPS_JTOKEN_ARRAY_END || token == CUPS_JTOKEN_OBJECT_END)
     {
-      // Descend
-      current = current->value.child;
+      // Ascend...
+      prev   = parent;
+      parent = parent->parent;
     }
-    else if (current->sibling)
+    else if ((current = json_new_token(jr, &json->arena, parent, prev)) == NULL)
     {
-      // Visit silbling
-      current = current->sibling;
+      cupsJSONDelete(json);
+      return (NULL);
+    }
+    else if (token == CUPS_JTOKEN_ARRAY_START || token == CUPS_JTOKEN_OBJECT_START)
+    {
+      // Descend...
+      parent = current;
+      prev   = NULL;
     }
     else
     {
-      // Ascend and continue...
-      current = current->parent;
-      while (current)
-      {
-        if (current->sibling)
-	{
-	  current = current->sibling;
-	  break;
-	}
-	else
-        {
-          current = current->parent;
-	}
-      }
+      prev = current;
     }
   }
 
-  DEBUG_printf(("2cupsJSONSaveString: length=%u", (unsigned)length));
+  return (json);
+}
 
-  // Allocate memory and fill it up...
-  if ((s = malloc(length)) == NULL)
+
+//
+// 'cupsJSONReaderNew()' - Create a JSON stream reader using a callback.
+//
+// This function creates a JSON stream reader that reads data using the
+// specified callback.  The callback returns the number of bytes read, `0` at
+// the end of the data, or `-1` on error.
+//
+
+cups_jreader_t *			// O - JSON stream reader or `NULL` on error
+cupsJSONReaderNew(cups_json_cb_t cb,	// I - Read callback
+                  void           *cb_data)
+					// I - Callback data
+{
+  cups_jreader_t	*jr;		// JSON stream reader
+
+
+  // Range check input...
+  if (!cb)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (NULL);
+  }
+
+  // Allocate memory...
+  if ((jr = calloc(1, sizeof(cups_jreader_t))) == NULL)
   {
     _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
-    DEBUG_puts("3cupsJSONSaveString: Returning NULL.");
     return (NULL);
   }
 
-  current = json;
-  ptr     = s;
-  loc     = localeconv();
+  jr->cb      = cb;
+  jr->cb_data = cb_data;
+  jr->bufptr  = jr->buffer;
+  jr->bufend  = jr->buffer;
+  jr->loc     = localeconv();
 
-  while (current)
+  return (jr);
+}
+
+
+//
+// 'cupsJSONReaderNewFile()' - Create a JSON stream reader for a file.
+//
+
+cups_jreader_t *			// O - JSON stream reader or `NULL` on error
+cupsJSONReaderNewFile(cups_file_t *fp)	// I - File to read from
+{
+  if (!fp)
   {
-    if (current->parent && current->parent->value.child != current)
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (NULL);
+  }
+
+  return (cupsJSONReaderNew((cups_json_cb_t)json_read_file, fp));
+}
+
+
+//
+// 'cupsJSONReaderNewHTTP()' - Create a JSON stream reader for a HTTP connection.
+//
+// This function creates a JSON stream reader for the message body of a HTTP
+// request or response.
+//
+
+cups_jreader_t *			// O - JSON stream reader or `NULL` on error
+cupsJSONReaderNewHTTP(http_t *http)	// I - HTTP connection
+{
+  if (!http)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (NULL);
+  }
+
+  return (cupsJSONReaderNew((cups_json_cb_t)json_read_http, http));
+}
+
+
+//
+// 'cupsJSONReaderNext()' - Read the next token from a JSON stream reader.
+//
+// This function reads the next token from a JSON stream.  Only the current
+// key or string value and the nesting of open arrays and objects are kept in
+// memory, so documents of any size can be processed.
+//
+// `CUPS_JTOKEN_EOF` is returned once the root value has been read, and
+// `CUPS_JTOKEN_ERROR` is returned for invalid JSON data and read errors.
+//
+
+cups_jtoken_t				// O - Token
+cupsJSONReaderNext(cups_jreader_t *jr)	// I - JSON stream reader
+{
+  int			ch;		// Current character
+  struct _cups_jframe_s	*frame;		// Current array/object
+  bool			is_key = false;	// Reading an object key?
+  size_t		len;		// Length of token
+
+
+  // Range check input...
+  if (!jr)
+    return (CUPS_JTOKEN_ERROR);
+  else if (jr->error)
+    return (jr->token = CUPS_JTOKEN_ERROR);
+  else if (jr->done)
+    return (jr->token = CUPS_JTOKEN_EOF);
+
+  if ((ch = json_peek(jr)) < 0)
+  {
+    DEBUG_puts("2cupsJSONReaderNext: Unexpected end of data.");
+    goto invalid;
+  }
+
+  if (jr->num_frames > 0)
+  {
+    // Handle separators and the end of the current array/object...
+    frame = jr->frames + jr->num_frames - 1;
+
+    if (frame->type == CUPS_JTYPE_OBJECT && (frame->count & 1))
     {
-      // Add separator
-      if (current->type == CUPS_JTYPE_KEY || current->parent->type == CUPS_JTYPE_ARRAY)
-        *ptr++ = ',';
-      else
-        *ptr++ = ':';
+      // Need a colon between the key and value...
+      if (ch != ':')
+      {
+	DEBUG_puts("2cupsJSONReaderNext: Missing colon.");
+	goto invalid;
+      }
+
+      jr->bufptr ++;
+      ch = json_peek(jr);
     }
+    else if ((frame->type == CUPS_JTYPE_OBJECT && ch == '}') || (frame->type == CUPS_JTYPE_ARRAY && ch == ']'))
+    {
+      // End of array/object...
+      jr->bufptr ++;
 
-    switch (current->type)
+      if (-- jr->num_frames == 0)
+        jr->done = true;
+
+      return (jr->token = ch == '}' ? CUPS_JTOKEN_OBJECT_END : CUPS_JTOKEN_ARRAY_END);
+    }
+    else if (frame->count > 0)
     {
-      case CUPS_JTYPE_NULL :
-          memcpy(ptr, "null", 4);
-          ptr += 4;
-          break;
+      // Need a comma between values...
+      if (ch != ',')
+      {
+	DEBUG_puts("2cupsJSONReaderNext: Missing comma.");
+	goto invalid;
+      }
 
-      case CUPS_JTYPE_TRUE :
-          memcpy(ptr, "true", 4);
-          ptr += 4;
-          break;
+      jr->bufptr ++;
+      ch = json_peek(jr);
+    }
 
-      case CUPS_JTYPE_FALSE :
-          memcpy(ptr, "false", 5);
-          ptr += 5;
-          break;
+    is_key = frame->type == CUPS_JTYPE_OBJECT && !(frame->count & 1);
 
-      case CUPS_JTYPE_ARRAY :
-          *ptr++ = '[';
-          break;
+    if (is_key && ch != '\"')
+    {
+      DEBUG_puts("2cupsJSONReaderNext: Missing key string.");
+      goto invalid;
+    }
 
-      case CUPS_JTYPE_OBJECT :
-          *ptr++ = '{';
-          break;
+    frame->count ++;
+  }
 
-      case CUPS_JTYPE_NUMBER :
-          _cupsStrFormatd(ptr, s + length, current->value.number, loc);
-          ptr += strlen(ptr);
-          break;
+  // Parse the key/value...
+  if (ch == '\"')
+  {
+    // String
+    jr->bufptr ++;
 
-      case CUPS_JTYPE_KEY :
-      case CUPS_JTYPE_STRING :
-          *ptr++ = '\"';
+    if (!json_read_string(jr))
+      goto invalid;
 
-          for (value = current->value.string; *value; value ++)
-          {
-            // Quote/escape as needed...
-	    if (*value == '\\' || *value == '\"')
-	    {
-	      *ptr++ = '\\';
-	      *ptr++ = *value;
-	    }
-	    else if (*value == '\b')
-	    {
-	      *ptr++ = '\\';
-	      *ptr++ = 'b';
-	    }
-	    else if (*value == '\f')
-	    {
-	      *ptr++ = '\\';
-	      *ptr++ = 'f';
-	    }
-	    else if (*value == '\n')
-	    {
-	      *ptr++ = '\\';
-	      *ptr++ = 'n';
-	    }
-	    else if (*value == '\r')
-	    {
-	      *ptr++ = '\\';
-	      *ptr++ = 'r';
-	    }
-	    else if (*value == '\t')
-	    {
-	      *ptr++ = '\\';
-	      *ptr++ = 't';
-	    }
-            if ((*value & 255) < ' ')
-            {
-              snprintf(ptr, length - (size_t)(ptr - s), "\\u%04x", *value);
-              ptr += 6;
-	    }
-	    else
-	    {
-	      *ptr++ = *value;
-	    }
-          }
+    jr->token = is_key ? CUPS_JTOKEN_KEY : CUPS_JTOKEN_STRING;
+  }
+  else if (ch == '{' || ch == '[')
+  {
+    // Start array/object
+    jr->bufptr ++;
 
-          *ptr++ = '\"';
-          break;
+    if (!json_push(&jr->frames, &jr->num_frames, &jr->alloc_frames, ch == '{' ? CUPS_JTYPE_OBJECT : CUPS_JTYPE_ARRAY))
+    {
+      jr->error = true;
+      return (jr->token = CUPS_JTOKEN_ERROR);
     }
 
-    // Get next node...
-    if ((current->type == CUPS_JTYPE_ARRAY || current->type == CUPS_JTYPE_OBJECT) && current->value.child)
+    return (jr->token = ch == '{' ? CUPS_JTOKEN_OBJECT_START : CUPS_JTOKEN_ARRAY_START);
+  }
+  else if (ch >= 0 && strchr("0123456789-", ch))
+  {
+    // Number
+    char	*end;			// End of number
+
+    for (len = 0; ch >= 0 && strchr("0123456789+-.eE", ch); jr->bufptr ++, ch = json_peek_char(jr))
     {
-      // Descend
-      current = current->value.child;
+      if (!json_add_char(jr, &len, ch))
+        return (jr->token = CUPS_JTOKEN_ERROR);
     }
-    else if (current->sibling)
+
+    if (!json_add_char(jr, &len, '\0'))
+      return (jr->token = CUPS_JTOKEN_ERROR);
+
+    jr->number = _cupsStrScand(jr->string, &end, jr->loc);
+
+    if (*end || !isdigit(jr->string[len - 2] & 255))
     {
-      // Visit silbling
-      current = current->sibling;
+      DEBUG_printf(("2cupsJSONReaderNext: Bad number '%s'.", jr->string));
+      goto invalid;
     }
-    else if ((current = current->parent) != NULL)
+
+    jr->token = CUPS_JTOKEN_NUMBER;
+  }
+  else if (ch >= 'a' && ch <= 'z')
+  {
+    // null, false, or true
+    for (len = 0; ch >= 'a' && ch <= 'z' && len < 6; jr->bufptr ++, ch = json_peek_char(jr))
     {
-      // Ascend and continue...
-      if (current->type == CUPS_JTYPE_ARRAY)
-        *ptr++ = ']';
-      else
-        *ptr++ = '}';
+      if (!json_add_char(jr, &len, ch))
+        return (jr->token = CUPS_JTOKEN_ERROR);
+    }
 
-      while (current)
-      {
-        if (current->sibling)
-	{
-	  current = current->sibling;
-	  break;
-	}
-	else if ((current = current->parent) != NULL)
-	{
-	  if (current->type == CUPS_JTYPE_ARRAY)
-	    *ptr++ = ']';
-	  else
-	    *ptr++ = '}';
-	}
-      }
+    if (!json_add_char(jr, &len, '\0'))
+      return (jr->token = CUPS_JTOKEN_ERROR);
+
+    if (!strcmp(jr->string, "null"))
+    {
+      jr->token = CUPS_JTOKEN_NULL;
+    }
+    else if (!strcmp(jr->string, "false"))
+    {
+      jr->token = CUPS_JTOKEN_FALSE;
+    }
+    else if (!strcmp(jr->string, "true"))
+    {
+      jr->token = CUPS_JTOKEN_TRUE;
+    }
+    else
+    {
+      DEBUG_printf(("2cupsJSONReaderNext: Unexpected '%s'.", jr->string));
+      goto invalid;
     }
   }
+  else
+  {
+    // Something else we don't understand...
+    DEBUG_printf(("2cupsJSONReaderNext: Unexpected character 0x%02x.", ch));
+    goto invalid;
+  }
 
-  *ptr = '\0';
+  if (jr->num_frames == 0)
+    jr->done = true;
 
-  DEBUG_printf(("3cupsJSONSaveString: Returning \"%s\".", s));
+  return (jr->token);
 
-  return (s);
+  // If we get here we saw something we didn't understand...
+  invalid:
+
+  if (!jr->error)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, _("Invalid JSON data."), 1);
+    jr->error = true;
+  }
+
+  return (jr->token = CUPS_JTOKEN_ERROR);
 }
 
 
 //
-// 'free_json()' - Free the JSON node.
+// 'cupsJSONReaderSkip()' - Skip the current array or object in a JSON stream reader.
+//
+// This function skips the rest of the array or object started by the last
+// token returned by @link cupsJSONReaderNext@.  Nothing is skipped for other
+// tokens.
 //
 
-static void
-free_json(cups_json_t *json)		// I - JSON node
+bool					// O - `true` on success, `false` on error
+cupsJSONReaderSkip(cups_jreader_t *jr)	// I - JSON stream reader
+{
+  size_t	depth;			// Starting depth
+
+
+  // Range check input...
+  if (!jr || jr->error)
+    return (false);
+
+  if (jr->token != CUPS_JTOKEN_ARRAY_START && jr->token != CUPS_JTOKEN_OBJECT_START)
+    return (true);
+
+  // Read until we are back at the original depth...
+  for (depth = jr->num_frames; jr->num_frames >= depth;)
+  {
+    if (cupsJSONReaderNext(jr) == CUPS_JTOKEN_ERROR)
+      return (false);
+  }
+
+  return (true);
+}
+
+
+//
+// 'cupsJSONSaveFile()' - Save a JSON node tree to a file.
+//
+
+bool					// O - `true` on success, `false` on failure
+cupsJSONSaveFile(cups_json_t *json,	// I - JSON root node
+                 const char  *filename)	// I - JSON filename
 {
-  if (json->type == CUPS_JTYPE_KEY || json->type == CUPS_JTYPE_STRING)
-    free(json->value.string);
+  int		fd;			// JSON file descriptor
+  cups_file_t	*fp;			// JSON file
+  cups_jwriter_t *jw;			// JSON stream writer
+  bool		ret = false;		// Return value
+
+
+  DEBUG_printf(("cupsJSONSaveFile(json=%p, filename=\"%s\")", (void *)json, filename));
+
+  // Range check input...
+  if (!json || !filename)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (false);
+  }
+
+  // Create the file...
+  if ((fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666)) < 0)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    return (false);
+  }
+  else if ((fp = cupsFileOpenFd(fd, "w")) == NULL)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    close(fd);
+    unlink(filename);
+    return (false);
+  }
 
-  free(json);
+  // Write the JSON data without building it in memory first...
+  if ((jw = cupsJSONWriterNewFile(fp)) != NULL)
+  {
+    ret = cupsJSONWriterAddJSON(jw, json);
+    ret = cupsJSONWriterDelete(jw) && ret;
+  }
+
+  if (!cupsFileClose(fp) && ret)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    ret = false;
+  }
+
+  if (!ret)
+    unlink(filename);
+
+  return (ret);
 }
 
+
+//
+// 'cupsJSONSaveString()' - Save a JSON node tree to a string.
+//
+// This function saves a JSON node tree to an allocated string.  The resulting
+// string must be freed using the `free` function.
+//
+
+char *					// O - JSON string or `NULL` on error
+cupsJSONSaveString(cups_json_t *json)	// I - JSON root node
+{
+  cups_json_t	*current;		// Current node
+  size_t	length;			// Length of JSON data as a string
+  char		*s,			// JSON string
+		*ptr;			// Pointer into string
+  const char	*value;			// Pointer into string value
+  struct lconv	*loc;			// Locale data
+
+
+  DEBUG_printf(("cupsJSONSaveString(json=%p)", (void *)json));
+
+  // Range check input...
+  if (!json)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    DEBUG_puts("3cupsJSONSaveString: Returning NULL.");
+    return (NULL);
+  }
+
+  // Figure out the necessary space needed in the string
+  current = json;
+  length  = 1;				// nul
+
+  while (current)
+  {
+    if (current->parent && current->parent->value.child != current)
+      length ++;			// Comma or colon separator
+
+    switch (current->type)
+    {
+      case CUPS_JTYPE_NULL :
+      case CUPS_JTYPE_TRUE :
+          length += 4;
+          break;
+
+      case CUPS_JTYPE_FALSE :
+          length += 5;
+          break;
+
+      case CUPS_JTYPE_ARRAY :
+      case CUPS_JTYPE_OBJECT :
+          length += 2;			// Brackets/braces
+          break;
+
+      case CUPS_JTYPE_NUMBER :
+          length += 32;
+          break;
+
+      case CUPS_JTYPE_KEY :
+      case CUPS_JTYPE_STRING :
+          length += 2;			// Quotes
+          for (value = current->value.string; *value; value ++)
+          {
+	    if (strchr("\\\"\b\f\n\r\t", *value))
+	      length += 2;		// Simple escaped char
+            else if ((*value & 255) < ' ')
+              length += 6;		// Worst case for control char
+	    else
+	      length ++;		// Literal char
+          }
+          break;
+    }
+
+    // Get next node...
+    if ((current->type == CUPS_JTYPE_ARRAY || current->type == CUPS_JTYPE_OBJECT) && current->value.child)
+    {
+      // Descend
+      current = current->value.child;
+    }
+    else if (current->sibling)
+    {
+      // Visit silbling
+      current = current->sibling;
+    }
+    else
+    {
+      // Ascend and continue...
+      current = current->parent;
+      while (current)
+      {
+        if (current->sibling)
+	{
+	  current = current->sibling;
+	  break;
+	}
+	else
+        {
+          current = current->parent;
+	}
+      }
+    }
+  }
+
+  DEBUG_printf(("2cupsJSONSaveString: length=%u", (unsigned)length));
+
+  // Allocate memory and fill it up...
+  if ((s = malloc(length)) == NULL)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    DEBUG_puts("3cupsJSONSaveString: Returning NULL.");
+    return (NULL);
+  }
+
+  current = json;
+  ptr     = s;
+  loc     = localeconv();
+
+  while (current)
+  {
+    if (current->parent && current->parent->value.child != current)
+    {
+      // Add separator
+      if (current->type == CUPS_JTYPE_KEY || current->parent->type == CUPS_JTYPE_ARRAY)
+        *ptr++ = ',';
+      else
+        *ptr++ = ':';
+    }
+
+    switch (current->type)
+    {
+      case CUPS_JTYPE_NULL :
+          memcpy(ptr, "null", 4);
+          ptr += 4;
+          break;
+
+      case CUPS_JTYPE_TRUE :
+          memcpy(ptr, "true", 4);
+          ptr += 4;
+          break;
+
+      case CUPS_JTYPE_FALSE :
+          memcpy(ptr, "false", 5);
+          ptr += 5;
+          break;
+
+      case CUPS_JTYPE_ARRAY :
+          *ptr++ = '[';
+          if (!current->value.child)
+            *ptr++ = ']';		// Empty array
+          break;
+
+      case CUPS_JTYPE_OBJECT :
+          *ptr++ = '{';
+          if (!current->value.child)
+            *ptr++ = '}';		// Empty object
+          break;
+
+      case CUPS_JTYPE_NUMBER :
+          _cupsStrFormatd(ptr, s + length, current->value.number, loc);
+          ptr += strlen(ptr);
+          break;
+
+      case CUPS_JTYPE_KEY :
+      case CUPS_JTYPE_STRING :
+          *ptr++ = '\"';
+
+          for (value = current->value.string; *value; value ++)
+          {
+            // Quote/escape as needed...
+	    if (*value == '\\' || *value == '\"')
+	    {
+	      *ptr++ = '\\';
+	      *ptr++ = *value;
+	    }
+	    else if (*value == '\b')
+	    {
+	      *ptr++ = '\\';
+	      *ptr++ = 'b';
+	    }
+	    else if (*value == '\f')
+	    {
+	      *ptr++ = '\\';
+	      *ptr++ = 'f';
+	    }
+	    else if (*value == '\n')
+	    {
+	      *ptr++ = '\\';
+	      *ptr++ = 'n';
+	    }
+	    else if (*value == '\r')
+	    {
+	      *ptr++ = '\\';
+	      *ptr++ = 'r';
+	    }
+	    else if (*value == '\t')
+	    {
+	      *ptr++ = '\\';
+	      *ptr++ = 't';
+	    }
+            else if ((*value & 255) < ' ')
+            {
+              snprintf(ptr, length - (size_t)(ptr - s), "\\u%04x", *value);
+              ptr += 6;
+	    }
+	    else
+	    {
+	      *ptr++ = *value;
+	    }
+          }
+
+          *ptr++ = '\"';
+          break;
+    }
+
+    // Get next node...
+    if ((current->type == CUPS_JTYPE_ARRAY || current->type == CUPS_JTYPE_OBJECT) && current->value.child)
+    {
+      // Descend
+      current = current->value.child;
+    }
+    else if (current->sibling)
+    {
+      // Visit silbling
+      current = current->sibling;
+    }
+    else if ((current = current->parent) != NULL)
+    {
+      // Ascend and continue...
+      if (current->type == CUPS_JTYPE_ARRAY)
+        *ptr++ = ']';
+      else
+        *ptr++ = '}';
+
+      while (current)
+      {
+        if (current->sibling)
+	{
+	  current = current->sibling;
+	  break;
+	}
+	else if ((current = current->parent) != NULL)
+	{
+	  if (current->type == CUPS_JTYPE_ARRAY)
+	    *ptr++ = ']';
+	  else
+	    *ptr++ = '}';
+	}
+      }
+    }
+  }
+
+  *ptr = '\0';
+
+  DEBUG_printf(("3cupsJSONSaveString: Returning \"%s\".", s));
+
+  return (s);
+}
+
+
+//
+// 'cupsJSONWriterAdd()' - Add a value to a JSON stream writer.
+//
+// This function adds a null, boolean, array, or object value.  Arrays and
+// objects are closed using the @link cupsJSONWriterEnd@ function.
+//
+
+bool					// O - `true` on success, `false` on error
+cupsJSONWriterAdd(cups_jwriter_t *jw,	// I - JSON stream writer
+                  cups_jtype_t   type)	// I - Value type - `CUPS_JTYPE_NULL`, `CUPS_JTYPE_FALSE`, `CUPS_JTYPE_TRUE`, `CUPS_JTYPE_ARRAY`, or `CUPS_JTYPE_OBJECT`
+{
+  // Range check input...
+  if (!jw || type == CUPS_JTYPE_NUMBER || type == CUPS_JTYPE_STRING || type == CUPS_JTYPE_KEY)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (false);
+  }
+
+  if (!json_write_sep(jw, false))
+    return (false);
+
+  switch (type)
+  {
+    case CUPS_JTYPE_NULL :
+        return (json_write_data(jw, "null", 4));
+
+    case CUPS_JTYPE_FALSE :
+        return (json_write_data(jw, "false", 5));
+
+    case CUPS_JTYPE_TRUE :
+        return (json_write_data(jw, "true", 4));
+
+    default :
+        if (!json_push(&jw->frames, &jw->num_frames, &jw->alloc_frames, type))
+        {
+          jw->error = true;
+          return (false);
+        }
+
+        return (json_write_data(jw, type == CUPS_JTYPE_ARRAY ? "[" : "{", 1));
+  }
+}
+
+
+//
+// 'cupsJSONWriterAddJSON()' - Add a JSON node tree to a JSON stream writer.
+//
+
+bool					// O - `true` on success, `false` on error
+cupsJSONWriterAddJSON(
+    cups_jwriter_t *jw,			// I - JSON stream writer
+    cups_json_t    *json)		// I - JSON node tree
+{
+  cups_json_t	*current;		// Current node
+  bool		ret = true;		// Return value
+
+
+  // Range check input...
+  if (!jw || !json)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (false);
+  }
+
+  // Write each node in turn...
+  current = json;
+
+  while (current && ret)
+  {
+    switch (current->type)
+    {
+      case CUPS_JTYPE_NUMBER :
+          ret = cupsJSONWriterAddNumber(jw, current->value.number);
+          break;
+
+      case CUPS_JTYPE_STRING :
+          ret = cupsJSONWriterAddString(jw, current->value.string);
+          break;
+
+      case CUPS_JTYPE_KEY :
+          ret = cupsJSONWriterAddKey(jw, current->value.string);
+          break;
+
+      default :
+          ret = cupsJSONWriterAdd(jw, current->type);
+          break;
+    }
+
+    // Get next node...
+    if ((current->type == CUPS_JTYPE_ARRAY || current->type == CUPS_JTYPE_OBJECT) && current->value.child)
+    {
+      // Descend
+      current = current->value.child;
+      continue;
+    }
+    else if (current->type == CUPS_JTYPE_ARRAY || current->type == CUPS_JTYPE_OBJECT)
+    {
+      // Close empty array/object
+      ret = ret && cupsJSONWriterEnd(jw);
+    }
+
+    // Visit sibling or ascend and continue...
+    while (current != json && !current->sibling && ret)
+    {
+      current = current->parent;
+      ret     = cupsJSONWriterEnd(jw);
+    }
+
+    current = current == json ? NULL : current->sibling;
+  }
+
+  return (ret);
+}
+
+
+//
+// 'cupsJSONWriterAddKey()' - Add an object key to a JSON stream writer.
+//
+
+bool					// O - `true` on success, `false` on error
+cupsJSONWriterAddKey(
+    cups_jwriter_t *jw,			// I - JSON stream writer
+    const char     *key)		// I - Key string
+{
+  // Range check input...
+  if (!jw || !key)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (false);
+  }
+
+  return (json_write_sep(jw, true) && json_write_string(jw, key));
+}
+
+
+//
+// 'cupsJSONWriterAddNumber()' - Add a number value to a JSON stream writer.
+//
+
+bool					// O - `true` on success, `false` on error
+cupsJSONWriterAddNumber(
+    cups_jwriter_t *jw,			// I - JSON stream writer
+    double         number)		// I - Number value
+{
+  char	temp[32];			// Number string
+
+
+  // Range check input...
+  if (!jw)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (false);
+  }
+
+  _cupsStrFormatd(temp, temp + sizeof(temp), number, jw->loc);
+
+  return (json_write_sep(jw, false) && json_write_data(jw, temp, strlen(temp)));
+}
+
+
+//
+// 'cupsJSONWriterAddString()' - Add a string value to a JSON stream writer.
+//
+
+bool					// O - `true` on success, `false` on error
+cupsJSONWriterAddString(
+    cups_jwriter_t *jw,			// I - JSON stream writer
+    const char     *s)			// I - String value
+{
+  // Range check input...
+  if (!jw || !s)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (false);
+  }
+
+  return (json_write_sep(jw, false) && json_write_string(jw, s));
+}
+
+
+//
+// 'cupsJSONWriterDelete()' - Flush and free a JSON stream writer.
+//
+// This function writes any buffered data and frees the memory used by a JSON
+// stream writer.  The underlying file or HTTP connection is not closed.
+//
+// `false` is returned if a write error occurred or the JSON data is
+// incomplete.
+//
+
+bool					// O - `true` on success, `false` on error
+cupsJSONWriterDelete(
+    cups_jwriter_t *jw)			// I - JSON stream writer
+{
+  bool	ret;				// Return value
+
+
+  if (!jw)
+    return (false);
+
+  if ((ret = cupsJSONWriterFlush(jw)) && (jw->num_frames > 0 || !jw->done))
+  {
+    // Unclosed array/object or no data...
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, _("Invalid JSON data."), 1);
+    ret = false;
+  }
+
+  free(jw->frames);
+  free(jw);
+
+  return (ret);
+}
+
+
+//
+// 'cupsJSONWriterEnd()' - End the current array or object in a JSON stream writer.
+//
+
+bool					// O - `true` on success, `false` on error
+cupsJSONWriterEnd(cups_jwriter_t *jw)	// I - JSON stream writer
+{
+  struct _cups_jframe_s	*frame;		// Current array/object
+
+
+  // Range check input...
+  if (!jw || jw->error)
+    return (false);
+
+  if (jw->num_frames == 0 || ((frame = jw->frames + jw->num_frames - 1)->type == CUPS_JTYPE_OBJECT && (frame->count & 1)))
+  {
+    // No array/object or key without a value...
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    jw->error = true;
+    return (false);
+  }
+
+  jw->num_frames --;
+
+  return (json_write_data(jw, frame->type == CUPS_JTYPE_ARRAY ? "]" : "}", 1));
+}
+
+
+//
+// 'cupsJSONWriterFlush()' - Write any buffered data for a JSON stream writer.
+//
+
+bool					// O - `true` on success, `false` on error
+cupsJSONWriterFlush(
+    cups_jwriter_t *jw)			// I - JSON stream writer
+{
+  char		*ptr;			// Pointer into buffer
+  ssize_t	bytes;			// Bytes written
+
+
+  // Range check input...
+  if (!jw || jw->error)
+    return (false);
+
+  // Write the buffered data...
+  for (ptr = jw->buffer; jw->used > 0; ptr += bytes, jw->used -= (size_t)bytes)
+  {
+    if ((bytes = (jw->cb)(jw->cb_data, ptr, jw->used)) <= 0)
+    {
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+      jw->error = true;
+      return (false);
+    }
+  }
+
+  return (true);
+}
+
+
+//
+// 'cupsJSONWriterNew()' - Create a JSON stream writer using a callback.
+//
+// This function creates a JSON stream writer that writes data using the
+// specified callback.  The callback returns the number of bytes written or
+// `-1` on error.
+//
+
+cups_jwriter_t *			// O - JSON stream writer or `NULL` on error
+cupsJSONWriterNew(cups_json_cb_t cb,	// I - Write callback
+                  void           *cb_data)
+					// I - Callback data
+{
+  cups_jwriter_t	*jw;		// JSON stream writer
+
+
+  // Range check input...
+  if (!cb)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (NULL);
+  }
+
+  // Allocate memory...
+  if ((jw = calloc(1, sizeof(cups_jwriter_t))) == NULL)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    return (NULL);
+  }
+
+  jw->cb      = cb;
+  jw->cb_data = cb_data;
+  jw->loc     = localeconv();
+
+  return (jw);
+}
+
+
+//
+// 'cupsJSONWriterNewFile()' - Create a JSON stream writer for a file.
+//
+
+cups_jwriter_t *			// O - JSON stream writer or `NULL` on error
+cupsJSONWriterNewFile(cups_file_t *fp)	// I - File to write to
+{
+  if (!fp)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (NULL);
+  }
+
+  return (cupsJSONWriterNew((cups_json_cb_t)json_write_file, fp));
+}
+
+
+//
+// 'cupsJSONWriterNewHTTP()' - Create a JSON stream writer for a HTTP connection.
+//
+// This function creates a JSON stream writer for the message body of a HTTP
+// request or response.  Call @link cupsJSONWriterFlush@ or
+// @link cupsJSONWriterDelete@ before finishing the message.
+//
+
+cups_jwriter_t *			// O - JSON stream writer or `NULL` on error
+cupsJSONWriterNewHTTP(http_t *http)	// I - HTTP connection
+{
+  if (!http)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    return (NULL);
+  }
+
+  return (cupsJSONWriterNew((cups_json_cb_t)json_write_http, http));
+}
+
+
+//
+// 'free_json()' - Free the JSON node.
+//
+
+static void
+free_json(cups_json_t *json)		// I - JSON node
+{
+  _cups_jarena_t	*arena = json->arena;
+					// Memory arena, if any
+
+
+  free(json->index);
+
+  // Nodes and strings in an arena are freed with the arena...
+  if (!json->in_arena)
+  {
+    if (json->type == CUPS_JTYPE_KEY || json->type == CUPS_JTYPE_STRING)
+      free(json->value.string);
+
+    free(json);
+  }
+
+  json_arena_free(arena);
+}
+
+
+//
+// 'json_add_char()' - Add a character to the current reader string.
+//
+
+static bool				// O - `true` on success, `false` on error
+json_add_char(cups_jreader_t *jr,	// I - JSON stream reader
+              size_t         *len,	// IO - Length of string
+              int            ch)	// I - Character to add
+{
+  if (*len >= jr->strsize)
+  {
+    // Grow the string buffer...
+    char	*temp;			// New string buffer
+    size_t	tempsize = jr->strsize ? 2 * jr->strsize : 256;
+					// New size
+
+    if ((temp = realloc(jr->string, tempsize)) == NULL)
+    {
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+      jr->error = true;
+      return (false);
+    }
+
+    jr->string  = temp;
+    jr->strsize = tempsize;
+  }
+
+  jr->string[(*len) ++] = (char)ch;
+
+  return (true);
+}
+
+
+//
+// 'json_arena_alloc()' - Allocate memory from an arena.
+//
+
+static void *				// O - Memory or `NULL` on error
+json_arena_alloc(
+    _cups_jarena_t **arena,		// IO - Memory arena
+    size_t         bytes)		// I - Number of bytes
+{
+  _cups_jarena_t	*block = *arena;// Current block
+  void			*ptr;		// Allocated memory
+
+
+  // Keep everything aligned for pointers and numbers...
+  bytes = (bytes + sizeof(double) - 1) & ~(sizeof(double) - 1);
+
+  if (!block || (block->size - block->used) < bytes)
+  {
+    // Allocate a new block...
+    size_t	size = bytes > _CUPS_JSON_ARENA_SIZE ? bytes : _CUPS_JSON_ARENA_SIZE;
+					// Size of block
+
+    if ((block = malloc(sizeof(_cups_jarena_t) + size)) == NULL)
+    {
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+      return (NULL);
+    }
+
+    block->used = 0;
+    block->size = size;
+
+    if (*arena && size > _CUPS_JSON_ARENA_SIZE)
+    {
+      // Put large allocations behind the current block so it can still be
+      // used...
+      block->next     = (*arena)->next;
+      (*arena)->next  = block;
+    }
+    else
+    {
+      block->next = *arena;
+      *arena      = block;
+    }
+  }
+
+  ptr         = (char *)block->data + block->used;
+  block->used += bytes;
+
+  return (ptr);
+}
+
+
+//
+// 'json_arena_free()' - Free all of the memory in an arena.
+//
+
+static void
+json_arena_free(_cups_jarena_t *arena)	// I - Memory arena
+{
+  _cups_jarena_t	*next;		// Next block
+
+
+  for (; arena; arena = next)
+  {
+    next = arena->next;
+    free(arena);
+  }
+}
+
+
+//
+// 'json_fill()' - Fill the reader buffer.
+//
+
+static bool				// O - `true` if data was read, `false` on end of data or error
+json_fill(cups_jreader_t *jr)		// I - JSON stream reader
+{
+  ssize_t	bytes;			// Bytes read
+
+
+  if (jr->eof || jr->error)
+    return (false);
+
+  if ((bytes = (jr->cb)(jr->cb_data, jr->buffer, sizeof(jr->buffer))) < 0)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    jr->error = true;
+    return (false);
+  }
+  else if (bytes == 0)
+  {
+    jr->eof = true;
+    return (false);
+  }
+
+  jr->bufptr = jr->buffer;
+  jr->bufend = jr->buffer + bytes;
+
+  return (true);
+}
+
+
+//
+// 'json_getc()' - Read a character from the reader buffer.
+//
+
+static int				// O - Character or `-1` on end of data or error
+json_getc(cups_jreader_t *jr)		// I - JSON stream reader
+{
+  if (jr->bufptr >= jr->bufend && !json_fill(jr))
+    return (-1);
+
+  return (*(jr->bufptr)++ & 255);
+}
+
+
+//
+// 'json_hash()' - Compute the hash of an object key.
+//
+
+static size_t				// O - Hash value
+json_hash(const char *key)		// I - Object key
+{
+  unsigned	hash = 2166136261U;	// FNV-1a hash
+
+
+  while (*key)
+  {
+    hash ^= (unsigned)(*key++ & 255);
+    hash *= 16777619U;
+  }
+
+  return (hash);
+}
+
+
+//
+// 'json_index()' - Build the child index for an array or object.
+//
+// The index is a vector of the children in order and, for objects, an open
+// addressing hash table of the keys.  It is discarded whenever a child is
+// added or removed.
+//
+
+static _cups_jindex_t *			// O - Index or `NULL` on error
+json_index(cups_json_t *json)		// I - JSON array or object node
+{
+  _cups_jindex_t	*index;		// Index
+  cups_json_t		*current;	// Current child node
+  size_t		count,		// Number of children
+			hashsize = 0,	// Size of hash table
+			mask,		// Hash table mask
+			h;		// Current hash table entry
+
+
+  // Count the children and size the hash table to at least twice the number
+  // of keys...
+  for (current = json->value.child, count = 0; current; current = current->sibling)
+    count ++;
+
+  if (json->type == CUPS_JTYPE_OBJECT)
+  {
+    for (hashsize = 16; hashsize < count; hashsize *= 2);
+  }
+
+  // Allocate the index with the child vector and hash table following it...
+  if ((index = calloc(1, sizeof(_cups_jindex_t) + (count + hashsize) * sizeof(cups_json_t *))) == NULL)
+    return (NULL);
+
+  index->count    = count;
+  index->children = (cups_json_t **)(index + 1);
+  index->hashsize = hashsize;
+  index->hash     = hashsize ? index->children + count : NULL;
+  mask            = hashsize - 1;
+
+  for (current = json->value.child, count = 0; current; current = current->sibling, count ++)
+  {
+    index->children[count] = current;
+
+    if (hashsize && current->type == CUPS_JTYPE_KEY)
+    {
+      // Add key, keeping the first of any duplicates...
+      for (h = json_hash(current->value.string) & mask; index->hash[h]; h = (h + 1) & mask)
+      {
+        if (!strcmp(index->hash[h]->value.string, current->value.string))
+          break;
+      }
+
+      if (!index->hash[h])
+        index->hash[h] = current;
+    }
+  }
+
+  json->index = index;
+
+  return (index);
+}
+
+
+//
+// 'json_new()' - Create a new JSON node.
+//
+
+static cups_json_t *			// O - JSON node
+json_new(_cups_jarena_t **arena,	// IO - Memory arena or `NULL` to use the heap
+         cups_json_t    *parent,	// I - Parent JSON node or `NULL` for a root node
+         cups_json_t    *after,		// I - Previous sibling node or `NULL` to append to the end
+         cups_jtype_t   type)		// I - JSON node type
+{
+  cups_json_t	*node;			// JSON node
+
+
+  // Range check input...
+  if (parent && parent->type != CUPS_JTYPE_ARRAY && parent->type != CUPS_JTYPE_OBJECT)
+    return (NULL);
+
+  // Allocate the node...
+  if (arena)
+  {
+    if ((node = json_arena_alloc(arena, sizeof(cups_json_t))) == NULL)
+      return (NULL);
+
+    memset(node, 0, sizeof(cups_json_t));
+    node->in_arena = true;
+  }
+  else if ((node = calloc(1, sizeof(cups_json_t))) == NULL)
+  {
+    return (NULL);
+  }
+
+  node->parent = parent;
+  node->type   = type;
+
+  if (parent)
+  {
+    // Add node to parent...
+    cups_json_t	*current;		// Current child node
+
+    free(parent->index);
+    parent->index = NULL;
+
+    if (after)
+    {
+      // Append after the specified sibling...
+      node->sibling  = after->sibling;
+      after->sibling = node;
+    }
+    else if ((current = parent->value.child) != NULL)
+    {
+      // Find the last child...
+      while (current && current->sibling)
+	current = current->sibling;
+
+      current->sibling = node;
+    }
+    else
+    {
+      // This is the first child...
+      parent->value.child = node;
+    }
+  }
+
+  return (node);
+}
+
+
+//
+// 'json_new_string()' - Create a new JSON key or string node.
+//
+
+static cups_json_t *			// O - JSON node
+json_new_string(
+    _cups_jarena_t **arena,		// IO - Memory arena or `NULL` to use the heap
+    cups_json_t    *parent,		// I - Parent JSON node or `NULL` for a root node
+    cups_json_t    *after,		// I - Previous sibling node or `NULL` to append to the end
+    cups_jtype_t   type,		// I - `CUPS_JTYPE_KEY` or `CUPS_JTYPE_STRING`
+    const char     *value)		// I - String value
+{
+  cups_json_t	*node;			// JSON node
+  char		*s;			// String value
+
+
+  // Copy the string...
+  if (arena)
+  {
+    size_t len = strlen(value) + 1;	// Length of string
+
+    if ((s = json_arena_alloc(arena, len)) != NULL)
+      memcpy(s, value, len);
+  }
+  else
+  {
+    s = strdup(value);
+  }
+
+  if (!s)
+    return (NULL);
+
+  // Create the node...
+  if ((node = json_new(arena, parent, after, type)) != NULL)
+    node->value.string = s;
+  else if (!arena)
+    free(s);
+
+  return (node);
+}
+
+
+//
+// 'json_new_token()' - Create a JSON node for the current reader token.
+//
+
+static cups_json_t *			// O - JSON node or `NULL` on error
+json_new_token(cups_jreader_t *jr,	// I - JSON stream reader
+               _cups_jarena_t **arena,	// IO - Memory arena
+               cups_json_t    *parent,	// I - Parent node or `NULL` for a root node
+               cups_json_t    *after)	// I - Previous sibling node or `NULL`
+{
+  cups_json_t	*node;			// JSON node
+
+
+  switch (jr->token)
+  {
+    case CUPS_JTOKEN_NULL :
+        node = json_new(arena, parent, after, CUPS_JTYPE_NULL);
+        break;
+
+    case CUPS_JTOKEN_FALSE :
+        node = json_new(arena, parent, after, CUPS_JTYPE_FALSE);
+        break;
+
+    case CUPS_JTOKEN_TRUE :
+        node = json_new(arena, parent, after, CUPS_JTYPE_TRUE);
+        break;
+
+    case CUPS_JTOKEN_NUMBER :
+        if ((node = json_new(arena, parent, after, CUPS_JTYPE_NUMBER)) != NULL)
+          node->value.number = jr->number;
+        break;
+
+    case CUPS_JTOKEN_STRING :
+        node = json_new_string(arena, parent, after, CUPS_JTYPE_STRING, jr->string);
+        break;
+
+    case CUPS_JTOKEN_KEY :
+        node = json_new_string(arena, parent, after, CUPS_JTYPE_KEY, jr->string);
+        break;
+
+    case CUPS_JTOKEN_ARRAY_START :
+        node = json_new(arena, parent, after, CUPS_JTYPE_ARRAY);
+        break;
+
+    case CUPS_JTOKEN_OBJECT_START :
+        node = json_new(arena, parent, after, CUPS_JTYPE_OBJECT);
+        break;
+
+    default :
+        // No value...
+        _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+        return (NULL);
+  }
+
+  if (!node)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+    jr->error = true;
+  }
+
+  return (node);
+}
+
+
+//
+// 'json_peek()' - Skip whitespace and peek at the next character.
+//
+
+static int				// O - Character or `-1` on end of data or error
+json_peek(cups_jreader_t *jr)		// I - JSON stream reader
+{
+  int	ch;				// Current character
+
+
+  while ((ch = json_peek_char(jr)) >= 0 && isspace(ch))
+    jr->bufptr ++;
+
+  return (ch);
+}
+
+
+//
+// 'json_peek_char()' - Peek at the next character.
+//
+
+static int				// O - Character or `-1` on end of data or error
+json_peek_char(cups_jreader_t *jr)	// I - JSON stream reader
+{
+  if (jr->bufptr >= jr->bufend && !json_fill(jr))
+    return (-1);
+
+  return (*(jr->bufptr) & 255);
+}
+
+
+//
+// 'json_push()' - Push an array or object on a container stack.
+//
+
+static bool				// O - `true` on success, `false` on error
+json_push(struct _cups_jframe_s **frames,// IO - Container stack
+          size_t                *num_frames,
+					// IO - Number of containers
+          size_t                *alloc_frames,
+					// IO - Allocated containers
+          cups_jtype_t          type)	// I - Container type
+{
+  if (*num_frames >= *alloc_frames)
+  {
+    // Grow the stack...
+    struct _cups_jframe_s *temp;	// New stack
+
+    if ((temp = realloc(*frames, (*alloc_frames + 16) * sizeof(struct _cups_jframe_s))) == NULL)
+    {
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(errno), 0);
+      return (false);
+    }
+
+    *frames       = temp;
+    *alloc_frames += 16;
+  }
+
+  (*frames)[*num_frames].type  = type;
+  (*frames)[*num_frames].count = 0;
+  (*num_frames) ++;
+
+  return (true);
+}
+
+
+//
+// 'json_read_file()' - Read JSON data from a file.
+//
+
+static ssize_t				// O - Number of bytes read or `-1` on error
+json_read_file(cups_file_t *fp,		// I - File
+               char        *buffer,	// I - Read buffer
+               size_t      bytes)	// I - Size of buffer
+{
+  return (cupsFileRead(fp, buffer, bytes));
+}
+
+
+//
+// 'json_read_http()' - Read JSON data from a HTTP connection.
+//
+
+static ssize_t				// O - Number of bytes read or `-1` on error
+json_read_http(http_t *http,		// I - HTTP connection
+               char   *buffer,		// I - Read buffer
+               size_t bytes)		// I - Size of buffer
+{
+  return (httpRead(http, buffer, bytes));
+}
+
+
+//
+// 'json_read_string()' - Read a quoted string.
+//
+// The opening quote has already been read.
+//
+
+static bool				// O - `true` on success, `false` on error
+json_read_string(cups_jreader_t *jr)	// I - JSON stream reader
+{
+  int		ch;			// Current character
+  size_t	len = 0;		// Length of string
+
+
+  while ((ch = json_getc(jr)) != '\"')
+  {
+    if (ch < 0)
+    {
+      // Missing close quote...
+      DEBUG_puts("2json_read_string: Missing close quote.");
+      return (false);
+    }
+    else if (ch == '\\')
+    {
+      // Copy quoted character...
+      switch (ch = json_getc(jr))
+      {
+        case '\\' :
+        case '\"' :
+        case '/' :
+            break;
+
+        case 'b' :
+            ch = '\b';
+            break;
+
+        case 'f' :
+            ch = '\f';
+            break;
+
+        case 'n' :
+            ch = '\n';
+            break;
+
+        case 'r' :
+            ch = '\r';
+            break;
+
+        case 't' :
+            ch = '\t';
+            break;
+
+        case 'u' :
+            {
+	      int	uch,		// Unicode character
+			digit;		// Current digit
+
+	      // Convert hex digits to a 16-bit Unicode character
+	      for (uch = 0, digit = 0; digit < 4; digit ++)
+	      {
+	        if ((ch = json_getc(jr)) < 0 || !isxdigit(ch))
+	        {
+		  DEBUG_puts("2json_read_string: Bad Unicode escape.");
+		  return (false);
+	        }
+
+	        uch <<= 4;
+		if (isdigit(ch))
+		  uch |= ch - '0';
+		else
+		  uch |= tolower(ch) - 'a' + 10;
+	      }
+
+	      // Convert 16-bit Unicode character to UTF-8...
+	      if (uch < 0x80)
+	      {
+	        // ASCII
+		ch = uch;
+	      }
+	      else if (uch < 0x800)
+	      {
+	        // 2-byte UTF-8
+		if (!json_add_char(jr, &len, 0xc0 | (uch >> 6)))
+		  return (false);
+
+		ch = 0x80 | (uch & 0x3f);
+	      }
+	      else
+	      {
+	        // 3-byte UTF-8
+		if (!json_add_char(jr, &len, 0xe0 | (uch >> 12)) || !json_add_char(jr, &len, 0x80 | ((uch >> 6) & 0x3f)))
+		  return (false);
+
+		ch = 0x80 | (uch & 0x3f);
+	      }
+            }
+            break;
+
+        default :
+	    DEBUG_printf(("2json_read_string: Bad escape '\\%c'.", ch));
+            return (false);
+      }
+    }
+    else if (ch < ' ')
+    {
+      // Control characters are not allowed in a string...
+      DEBUG_printf(("2json_read_string: Bad control character 0x%02x in string.", ch));
+      return (false);
+    }
+
+    if (!json_add_char(jr, &len, ch))
+      return (false);
+  }
+
+  return (json_add_char(jr, &len, '\0'));
+}
+
+
+//
+// 'json_write_data()' - Write data to the writer buffer.
+//
+
+static bool				// O - `true` on success, `false` on error
+json_write_data(cups_jwriter_t *jw,	// I - JSON stream writer
+                const char     *data,	// I - Data to write
+                size_t         bytes)	// I - Number of bytes
+{
+  size_t	count;			// Bytes to copy
+
+
+  while (bytes > 0)
+  {
+    if (jw->used >= sizeof(jw->buffer) && !cupsJSONWriterFlush(jw))
+      return (false);
+
+    if ((count = sizeof(jw->buffer) - jw->used) > bytes)
+      count = bytes;
+
+    memcpy(jw->buffer + jw->used, data, count);
+
+    jw->used += count;
+    data     += count;
+    bytes    -= count;
+  }
+
+  return (!jw->error);
+}
+
+
+//
+// 'json_write_file()' - Write JSON data to a file.
+//
+
+static ssize_t				// O - Number of bytes written or `-1` on error
+json_write_file(cups_file_t *fp,	// I - File
+                char        *buffer,	// I - Write buffer
+                size_t      bytes)	// I - Number of bytes
+{
+  return (cupsFileWrite(fp, buffer, bytes) ? (ssize_t)bytes : -1);
+}
+
+
+//
+// 'json_write_http()' - Write JSON data to a HTTP connection.
+//
+
+static ssize_t				// O - Number of bytes written or `-1` on error
+json_write_http(http_t *http,		// I - HTTP connection
+                char   *buffer,		// I - Write buffer
+                size_t bytes)		// I - Number of bytes
+{
+  return (httpWrite(http, buffer, bytes));
+}
+
+
+//
+// 'json_write_sep()' - Write the separator before a key or value.
+//
+
+static bool				// O - `true` on success, `false` on error
+json_write_sep(cups_jwriter_t *jw,	// I - JSON stream writer
+               bool           is_key)	// I - Writing an object key?
+{
+  struct _cups_jframe_s	*frame;		// Current array/object
+
+
+  if (jw->error)
+    return (false);
+
+  if (jw->num_frames == 0)
+  {
+    // Only one root value is allowed...
+    if (jw->done || is_key)
+      goto invalid;
+
+    jw->done = true;
+    return (true);
+  }
+
+  frame = jw->frames + jw->num_frames - 1;
+
+  if (frame->type == CUPS_JTYPE_OBJECT ? is_key == ((frame->count & 1) != 0) : is_key)
+  {
+    // Objects alternate between keys and values, arrays only have values...
+    goto invalid;
+  }
+
+  if (frame->count ++ == 0)
+    return (true);
+  else if (frame->type == CUPS_JTYPE_OBJECT && !is_key)
+    return (json_write_data(jw, ":", 1));
+  else
+    return (json_write_data(jw, ",", 1));
+
+  // If we get here the key or value is not allowed...
+  invalid:
+
+  _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+  jw->error = true;
+
+  return (false);
+}
+
+
+//
+// 'json_write_string()' - Write a quoted string.
+//
+
+static bool				// O - `true` on success, `false` on error
+json_write_string(cups_jwriter_t *jw,	// I - JSON stream writer
+                  const char     *s)	// I - String
+{
+  const char	*start;			// Start of literal characters
+  char		temp[7];		// Escaped character
+
+
+  if (!json_write_data(jw, "\"", 1))
+    return (false);
+
+  for (start = s; *s; s ++)
+  {
+    if (*s != '\\' && *s != '\"' && (*s & 255) >= ' ')
+      continue;
+
+    // Write literal characters and then the escaped character...
+    if (s > start && !json_write_data(jw, start, (size_t)(s - start)))
+      return (false);
+
+    start = s + 1;
+
+    switch (*s)
+    {
+      case '\\' :
+      case '\"' :
+          temp[0] = '\\';
+          temp[1] = *s;
+          temp[2] = '\0';
+          break;
+
+      case '\b' :
+          cupsCopyString(temp, "\\b", sizeof(temp));
+          break;
+
+      case '\f' :
+          cupsCopyString(temp, "\\f", sizeof(temp));
+          break;
+
+      case '\n' :
+          cupsCopyString(temp, "\\n", sizeof(temp));
+          break;
+
+      case '\r' :
+          cupsCopyString(temp, "\\r", sizeof(temp));
+          break;
+
+      case '\t' :
+          cupsCopyString(temp, "\\t", sizeof(temp));
+          break;
+      default :
+          snprintf(temp, sizeof(temp), "\\u%04x", *s);
+          break;
+    }
+
+    if (!json_write_data(jw, temp, strlen(temp)))
+      return (false);
+  }
+
+  if (s > start && !json_write_data(jw, start, (size_t)(s - start)))
+    return (false);
+
+  return (json_write_data(jw, "\"", 1));
+}
@@ -9,7 +9,8 @@
 
 #ifndef _CUPS_JSON_H_
 #  define _CUPS_JSON_H_
-#  include "base.h"
+#  include "file.h"
+#  include "http.h"
 #  ifdef __cplusplus
 extern "C" {
 #  endif /* __cplusplus */
@@ -31,7 +32,30 @@ typedef enum cups_jtype_e		// JSON node type
   CUPS_JTYPE_KEY			// Object key (string)
 } cups_jtype_t;
 
+typedef enum cups_jtoken_e		// JSON stream token
+{
+  CUPS_JTOKEN_ERROR = -1,		// Invalid JSON data or read error
+  CUPS_JTOKEN_EOF,			// End of JSON data
+  CUPS_JTOKEN_NULL,			// Null value
+  CUPS_JTOKEN_FALSE,			// Boolean false value
+  CUPS_JTOKEN_TRUE,			// Boolean true value
+  CUPS_JTOKEN_NUMBER,			// Number value
+  CUPS_JTOKEN_STRING,			// String value
+  CUPS_JTOKEN_KEY,			// Object key (string)
+  CUPS_JTOKEN_ARRAY_START,		// Start of array value
+  CUPS_JTOKEN_ARRAY_END,		// End of array value
+  CUPS_JTOKEN_OBJECT_START,		// Start of object value
+  CUPS_JTOKEN_OBJECT_END		// End of object value
+} cups_jtoken_t;
+
+typedef ssize_t (*cups_json_cb_t)(void *cb_data, char *buffer, size_t bytes);
+					// JSON stream read/write callback
+
 typedef struct _cups_json_s cups_json_t;// JSON node
+typedef struct _cups_jreader_s cups_jreader_t;
+					// JSON stream reader
+typedef struct _cups_jwriter_s cups_jwriter_t;
+					// JSON stream writer
 
 
 //
@@ -59,9 +83,32 @@ extern cups_json_t	*cupsJSONNewKey(cups_json_t *parent, cups_json_t *after, cons
 extern cups_json_t	*cupsJSONNewNumber(cups_json_t *parent, cups_json_t *after, double number) _CUPS_PUBLIC;
 extern cups_json_t	*cupsJSONNewString(cups_json_t *parent, cups_json_t *after, const char *value) _CUPS_PUBLIC;
 
+extern void		cupsJSONReaderDelete(cups_jreader_t *jr) _CUPS_PUBLIC;
+extern size_t		cupsJSONReaderGetDepth(cups_jreader_t *jr) _CUPS_PUBLIC;
+extern double		cupsJSONReaderGetNumber(cups_jreader_t *jr) _CUPS_PUBLIC;
+extern const char	*cupsJSONReaderGetString(cups_jreader_t *jr) _CUPS_PUBLIC;
+extern cups_json_t	*cupsJSONReaderLoad(cups_jreader_t *jr) _CUPS_PUBLIC;
+extern cups_jreader_t	*cupsJSONReaderNew(cups_json_cb_t cb, void *cb_data) _CUPS_PUBLIC;
+extern cups_jreader_t	*cupsJSONReaderNewFile(cups_file_t *fp) _CUPS_PUBLIC;
+extern cups_jreader_t	*cupsJSONReaderNewHTTP(http_t *http) _CUPS_PUBLIC;
+extern cups_jtoken_t	cupsJSONReaderNext(cups_jreader_t *jr) _CUPS_PUBLIC;
+extern bool		cupsJSONReaderSkip(cups_jreader_t *jr) _CUPS_PUBLIC;
+
 extern bool		cupsJSONSaveFile(cups_json_t *json, const char *filename) _CUPS_PUBLIC;
 extern char		*cupsJSONSaveString(cups_json_t *json) _CUPS_PUBLIC;
 
+extern bool		cupsJSONWriterAdd(cups_jwriter_t *jw, cups_jtype_t type) _CUPS_PUBLIC;
+extern bool		cupsJSONWriterAddJSON(cups_jwriter_t *jw, cups_json_t *json) _CUPS_PUBLIC;
+extern bool		cupsJSONWriterAddKey(cups_jwriter_t *jw, const char *key) _CUPS_PUBLIC;
+extern bool		cupsJSONWriterAddNumber(cups_jwriter_t *jw, double number) _CUPS_PUBLIC;
+extern bool		cupsJSONWriterAddString(cups_jwriter_t *jw, const char *s) _CUPS_PUBLIC;
+extern bool		cupsJSONWriterDelete(cups_jwriter_t *jw) _CUPS_PUBLIC;
+extern bool		cupsJSONWriterEnd(cups_jwriter_t *jw) _CUPS_PUBLIC;
+extern bool		cupsJSONWriterFlush(cups_jwriter_t *jw) _CUPS_PUBLIC;
+extern cups_jwriter_t	*cupsJSONWriterNew(cups_json_cb_t cb, void *cb_data) _CUPS_PUBLIC;
+extern cups_jwriter_t	*cupsJSONWriterNewFile(cups_file_t *fp) _CUPS_PUBLIC;
+extern cups_jwriter_t	*cupsJSONWriterNewHTTP(http_t *http) _CUPS_PUBLIC;
+
 
 #  ifdef __cplusplus
 }
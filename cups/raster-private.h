@@ -15,6 +15,7 @@
 #  include "cups.h"
 #  include "debug-private.h"
 #  include "string-private.h"
+#  include "thread.h"
 #  ifdef _WIN32
 #    include <io.h>
 #    include <winsock2.h>		// for htonl() definition
@@ -28,9 +29,39 @@ extern "C" {
 
 
 //
-// Structure...
+// Constants...
 //
 
+#  define _CUPS_RASTER_BAND_SIZE 262144	// Target size of a band in bytes
+
+typedef enum _cups_raster_bstate_e	// Band states
+{
+  _CUPS_RASTER_BAND_FREE,		// Band is empty or being filled
+  _CUPS_RASTER_BAND_QUEUED,		// Band is waiting for a thread
+  _CUPS_RASTER_BAND_BUSY,		// Band is being compressed
+  _CUPS_RASTER_BAND_DONE		// Band is compressed and ready to write
+} _cups_raster_bstate_t;
+
+
+//
+// Types and structures...
+//
+
+typedef size_t (*_cups_runfunc_t)(const unsigned char *pixels, size_t bpp, size_t count);
+					// Run detection function
+
+typedef struct _cups_raster_band_s	// Band of lines for compression threads
+{
+  _cups_raster_bstate_t	state;		// Band state
+  unsigned		num_lines,	// Number of lines in band
+			max_lines;	// Maximum number of lines in band
+  unsigned char		*lines;		// Repeat count and pixels for each line
+  size_t		linesize;	// Allocated size of lines
+  unsigned char		*output;	// Compressed data
+  size_t		outsize,	// Allocated size of compressed data
+			outused;	// Bytes of compressed data
+} _cups_raster_band_t;
+
 struct _cups_raster_s			// Raster stream data
 {
   unsigned		sync;		// Sync word from start of stream
@@ -56,6 +87,18 @@ struct _cups_raster_s			// Raster stream data
 			iocount;	// Number of bytes read/written
 #  endif // DEBUG
   unsigned		apple_page_count;// Apple raster page count
+  _cups_runfunc_t	literalfunc,	// Find end of literal run
+			repeatfunc;	// Find end of repeated run
+  int			num_threads;	// Number of compression threads
+  cups_thread_t		*threads;	// Compression threads
+  cups_mutex_t		band_mutex;	// Mutex for bands
+  cups_cond_t		band_cond;	// Condition for band state changes
+  int			num_bands,	// Number of bands
+			band_first,	// First band to write
+			band_current,	// Band being filled
+			band_pending;	// Number of bands queued or compressed
+  _cups_raster_band_t	*bands;		// Bands of lines
+  bool			band_stop;	// Stop the compression threads?
 };
 
 
@@ -67,6 +110,7 @@ extern void		_cupsRasterAddError(const char *f, ...) _CUPS_FORMAT(1,2) _CUPS_PRI
 extern void		_cupsRasterClearError(void) _CUPS_PRIVATE;
 extern const char	*_cupsRasterColorSpaceString(cups_cspace_t cspace) _CUPS_PRIVATE;
 extern cups_raster_t	*_cupsRasterNew(cups_raster_cb_t iocb, void *ctx, cups_raster_mode_t mode) _CUPS_PRIVATE;
+extern void		_cupsRasterSetSIMD(cups_raster_t *r, bool enable) _CUPS_PRIVATE;
 
 #  ifdef __cplusplus
 }
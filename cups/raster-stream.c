@@ -15,6 +15,16 @@
 
 #include "raster-private.h"
 #include "debug-internal.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#  include <immintrin.h>
+#  define CUPS_RASTER_SSE2 1
+#  if defined(__clang__) || __GNUC__ >= 5
+#    define CUPS_RASTER_AVX2 1
+#  endif // __clang__ || __GNUC__ >= 5
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define CUPS_RASTER_NEON 1
+#endif // __GNUC__ && (__x86_64__ || __i386__) && __SSE2__
 
 
 //
@@ -62,10 +72,37 @@ static const char * const cups_modes[] =
 // Local functions...
 //
 
+static bool	cups_raster_drain(cups_raster_t *r);
+static size_t	cups_raster_encode(cups_raster_t *r, unsigned repeat, const unsigned char *pixels, unsigned char *buffer);
+static void	cups_raster_expand(unsigned char *run, size_t bpp, size_t bytes);
 static ssize_t	cups_raster_io(cups_raster_t *r, unsigned char *buf, size_t bytes);
+#ifdef CUPS_RASTER_AVX2
+static size_t	cups_raster_literal_avx2(const unsigned char *pixels, size_t bpp, size_t count);
+#endif // CUPS_RASTER_AVX2
+#ifdef CUPS_RASTER_NEON
+static size_t	cups_raster_literal_neon(const unsigned char *pixels, size_t bpp, size_t count);
+#endif // CUPS_RASTER_NEON
+static size_t	cups_raster_literal_scalar(const unsigned char *pixels, size_t bpp, size_t count);
+#ifdef CUPS_RASTER_SSE2
+static size_t	cups_raster_literal_sse2(const unsigned char *pixels, size_t bpp, size_t count);
+#endif // CUPS_RASTER_SSE2
+static bool	cups_raster_queue(cups_raster_t *r);
 static ssize_t	cups_raster_read(cups_raster_t *r, unsigned char *buf, size_t bytes);
+#ifdef CUPS_RASTER_AVX2
+static size_t	cups_raster_repeat_avx2(const unsigned char *pixels, size_t bpp, size_t count);
+#endif // CUPS_RASTER_AVX2
+#ifdef CUPS_RASTER_NEON
+static size_t	cups_raster_repeat_neon(const unsigned char *pixels, size_t bpp, size_t count);
+#endif // CUPS_RASTER_NEON
+static size_t	cups_raster_repeat_scalar(const unsigned char *pixels, size_t bpp, size_t count);
+#ifdef CUPS_RASTER_SSE2
+static size_t	cups_raster_repeat_sse2(const unsigned char *pixels, size_t bpp, size_t count);
+#endif // CUPS_RASTER_SSE2
+static void	cups_raster_stop(cups_raster_t *r);
+static void	*cups_raster_thread(cups_raster_t *r);
 static int	cups_raster_update(cups_raster_t *r);
 static ssize_t	cups_raster_write(cups_raster_t *r, const unsigned char *pixels);
+static bool	cups_raster_write_band(cups_raster_t *r);
 static ssize_t	cups_read_fd(void *ctx, unsigned char *buf, size_t bytes);
 static void	cups_swap(unsigned char *buf, size_t bytes);
 static void	cups_swap_copy(unsigned char *dst, const unsigned char *src, size_t bytes);
@@ -167,6 +204,9 @@ cupsRasterClose(cups_raster_t *r)	// I - Stream to free
 {
   if (r != NULL)
   {
+    cups_raster_drain(r);
+    cups_raster_stop(r);
+
     free(r->buffer);
     free(r->pixels);
     free(r);
@@ -544,6 +584,8 @@ _cupsRasterNew(
   r->iocb = iocb;
   r->mode = mode;
 
+  _cupsRasterSetSIMD(r, true);
+
   if (mode == CUPS_RASTER_READ)
   {
     // Open for read - get sync word...
@@ -975,15 +1017,9 @@ cupsRasterReadPixels(
 	    return (0);
 	  }
 
-	  temp  += r->bpp;
-	  count -= r->bpp;
+	  cups_raster_expand(temp, r->bpp, count);
 
-	  while (count > 0)
-	  {
-	    memcpy(temp, temp - r->bpp, r->bpp);
-	    temp  += r->bpp;
-	    count -= r->bpp;
-          }
+	  temp += count;
 	}
       }
 
@@ -1039,6 +1075,116 @@ cupsRasterReadPixels(
 }
 
 
+//
+// '_cupsRasterSetSIMD()' - Select the run detection functions for a stream.
+//
+// When "enable" is `true`, the fastest SIMD implementation supported by the
+// current CPU is used.  Otherwise the portable scalar functions are used.  All
+// implementations produce identical output.
+//
+
+void
+_cupsRasterSetSIMD(cups_raster_t *r,	// I - Raster stream
+                   bool          enable)// I - `true` to use SIMD functions, `false` for scalar
+{
+  r->literalfunc = cups_raster_literal_scalar;
+  r->repeatfunc  = cups_raster_repeat_scalar;
+
+  if (!enable)
+    return;
+
+#ifdef CUPS_RASTER_AVX2
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2"))
+  {
+    r->literalfunc = cups_raster_literal_avx2;
+    r->repeatfunc  = cups_raster_repeat_avx2;
+    return;
+  }
+#endif // CUPS_RASTER_AVX2
+
+#ifdef CUPS_RASTER_SSE2
+  r->literalfunc = cups_raster_literal_sse2;
+  r->repeatfunc  = cups_raster_repeat_sse2;
+
+#elif defined(CUPS_RASTER_NEON)
+  r->literalfunc = cups_raster_literal_neon;
+  r->repeatfunc  = cups_raster_repeat_neon;
+#endif // CUPS_RASTER_SSE2
+}
+
+
+//
+// 'cupsRasterSetThreads()' - Set the number of compression threads for a
+//                            raster stream.
+//
+// This function sets the number of threads used to compress raster data in
+// the `CUPS_RASTER_WRITE_COMPRESSED`, `CUPS_RASTER_WRITE_PWG`, and
+// `CUPS_RASTER_WRITE_APPLE` modes.  Lines are collected into bands that are
+// compressed in parallel and then written in order, so the output is the same
+// as for single-threaded compression.  Each page is completely written before
+// @link cupsRasterWritePixels@ returns for its last line.
+//
+// A value of `0` (the default) compresses each line on the calling thread.
+//
+
+bool					// O - `true` on success, `false` on failure
+cupsRasterSetThreads(
+    cups_raster_t *r,			// I - Raster stream
+    int           num_threads)		// I - Number of threads or `0` for none
+{
+  bool	ret;				// Return value
+
+
+  DEBUG_printf(("cupsRasterSetThreads(r=%p, num_threads=%d)", (void *)r, num_threads));
+
+  if (r == NULL || r->mode == CUPS_RASTER_READ || num_threads < 0)
+    return (false);
+
+  if (num_threads > 256)
+    num_threads = 256;
+
+  // Write any pending bands and stop the current threads...
+  ret = cups_raster_drain(r);
+
+  cups_raster_stop(r);
+
+  if (num_threads == 0)
+    return (ret);
+
+  // Start the new threads...
+  if ((r->bands = calloc((size_t)(2 * num_threads), sizeof(_cups_raster_band_t))) == NULL || (r->threads = calloc((size_t)num_threads, sizeof(cups_thread_t))) == NULL)
+  {
+    _cupsRasterAddError("Unable to allocate memory for compression threads: %s", strerror(errno));
+    free(r->bands);
+    r->bands = NULL;
+    return (false);
+  }
+
+  cupsMutexInit(&r->band_mutex);
+  cupsCondInit(&r->band_cond);
+
+  r->num_bands    = 2 * num_threads;
+  r->band_first   = 0;
+  r->band_current = 0;
+  r->band_pending = 0;
+  r->band_stop    = false;
+
+  for (r->num_threads = 0; r->num_threads < num_threads; r->num_threads ++)
+  {
+    if ((r->threads[r->num_threads] = cupsThreadCreate((cups_thread_func_t)cups_raster_thread, r)) == CUPS_THREAD_INVALID)
+    {
+      _cupsRasterAddError("Unable to create compression thread: %s", strerror(errno));
+      cups_raster_stop(r);
+      return (false);
+    }
+  }
+
+  return (ret);
+}
+
+
 //
 // '_cupsRasterWriteHeader()' - Write a raster page header.
 //
@@ -1053,6 +1199,13 @@ cupsRasterWriteHeader(
   if (r == NULL || r->mode == CUPS_RASTER_READ)
     return (false);
 
+  // Write any lines that are still being compressed...
+  if (!cups_raster_drain(r))
+  {
+    DEBUG_puts("1cupsRasterWriteHeader: Unable to write pending lines, returning 0.");
+    return (false);
+  }
+
   DEBUG_printf(("1cupsRasterWriteHeader: cupsColorSpace=%s", _cupsRasterColorSpaceString(r->header.cupsColorSpace)));
   DEBUG_printf(("1cupsRasterWriteHeader: cupsBitsPerColor=%u", r->header.cupsBitsPerColor));
   DEBUG_printf(("1cupsRasterWriteHeader: cupsBitsPerPixel=%u", r->header.cupsBitsPerPixel));
@@ -1348,6 +1501,133 @@ cupsRasterWritePixels(
 }
 
 
+//
+// 'cups_raster_drain()' - Compress and write all pending bands.
+//
+
+static bool				// O - `true` on success, `false` on error
+cups_raster_drain(cups_raster_t *r)	// I - Raster stream
+{
+  bool	ret = true;			// Return value
+
+
+  if (r->num_threads == 0)
+    return (true);
+
+  if (r->bands[r->band_current].num_lines > 0)
+    ret = cups_raster_queue(r);
+
+  while (r->band_pending > 0)
+  {
+    if (!cups_raster_write_band(r))
+      ret = false;
+  }
+
+  return (ret);
+}
+
+
+//
+// 'cups_raster_encode()' - Compress a row of raster data...
+//
+
+static size_t				// O - Number of bytes of compressed data
+cups_raster_encode(
+    cups_raster_t       *r,		// I - Raster stream
+    unsigned            repeat,		// I - Row repeat count
+    const unsigned char *pixels,	// I - Pixel data to compress
+    unsigned char       *buffer)	// I - Output buffer
+{
+  const unsigned char	*ptr;		// Current pointer in sequence
+  unsigned char		*wptr;		// Pointer into write buffer
+  unsigned		bpp,		// Bytes per pixel
+			count,		// Count
+			remaining;	// Remaining pixels in line
+  _cups_copyfunc_t	cf;		// Copy function
+
+
+  // Determine whether we need to swap bytes...
+  if (r->swapped && (r->header.cupsBitsPerColor == 16 || r->header.cupsBitsPerPixel == 12 || r->header.cupsBitsPerPixel == 16))
+    cf = (_cups_copyfunc_t)cups_swap_copy;
+  else
+    cf = (_cups_copyfunc_t)memcpy;
+
+  // Write the row repeat count...
+  bpp     = r->bpp;
+  wptr    = buffer;
+  *wptr++ = (unsigned char)(repeat - 1);
+
+  // Write using a modified PackBits compression...
+  for (ptr = pixels, remaining = r->header.cupsBytesPerLine / bpp; remaining > 0; ptr += count * bpp, remaining -= count)
+  {
+    if (remaining == 1)
+    {
+      // Encode a single pixel at the end...
+      count   = 1;
+      *wptr++ = 0;
+      (*cf)(wptr, ptr, bpp);
+      wptr += bpp;
+    }
+    else if ((count = (unsigned)(*r->repeatfunc)(ptr, bpp, remaining > 128 ? 128 : remaining)) > 1)
+    {
+      // Encode a sequence of repeating pixels...
+      *wptr++ = (unsigned char)(count - 1);
+      (*cf)(wptr, ptr, bpp);
+      wptr += bpp;
+    }
+    else
+    {
+      // Encode a sequence of non-repeating pixels, including the last pixel
+      // in the line if there is room...
+      count = (unsigned)(*r->literalfunc)(ptr, bpp, remaining > 128 ? 128 : remaining - 1);
+
+      if (count == (remaining - 1) && count < 128)
+        count ++;
+
+      *wptr++ = (unsigned char)(257 - count);
+
+      (*cf)(wptr, ptr, count * bpp);
+      wptr += count * bpp;
+    }
+  }
+
+  return ((size_t)(wptr - buffer));
+}
+
+
+//
+// 'cups_raster_expand()' - Expand a repeated pixel to the length of the run.
+//
+// The first pixel of the run must already be stored at the start of "run".
+//
+
+static void
+cups_raster_expand(unsigned char *run,	// I - Start of run
+                   size_t        bpp,	// I - Bytes per pixel
+                   size_t        bytes)	// I - Number of bytes in run
+{
+  size_t	filled,			// Number of bytes filled so far
+		count;			// Number of bytes to copy
+
+
+  if (bpp == 1)
+  {
+    memset(run + 1, *run, bytes - 1);
+    return;
+  }
+
+  // Double the filled portion of the run until we reach the end - this uses
+  // O(log n) non-overlapping copies rather than one copy per pixel...
+  for (filled = bpp; filled < bytes; filled += count)
+  {
+    if ((count = bytes - filled) > filled)
+      count = filled;
+
+    memcpy(run + filled, run, count);
+  }
+}
+
+
 //
 // 'cups_raster_io()' - Read/write bytes from a context, handling interruptions.
 //
@@ -1388,6 +1668,218 @@ cups_raster_io(cups_raster_t *r,	// I - Raster stream
 }
 
 
+#ifdef CUPS_RASTER_AVX2
+//
+// 'cups_raster_literal_avx2()' - Find the end of a literal run using AVX2.
+//
+
+__attribute__((target("avx2")))
+static size_t				// O - Number of literal pixels
+cups_raster_literal_avx2(
+    const unsigned char *pixels,	// I - Start of run
+    size_t              bpp,		// I - Bytes per pixel
+    size_t              count)		// I - Maximum number of pixels
+{
+  size_t		i,		// Current pixel
+			j,		// Pixel in vector
+			ppv;		// Pixels per vector
+  unsigned		m,		// Equal bytes mask
+			pmask;		// Mask for one pixel
+  const unsigned char	*p;		// Pointer to current pixel
+
+
+  i = 1;
+  p = pixels + bpp;
+
+  if (bpp <= 16)
+  {
+    // Compare 32 bytes against the same bytes one pixel later, then look for a
+    // pixel whose bytes all match...
+    ppv   = 32 / bpp;
+    pmask = (1U << bpp) - 1;
+
+    for (; (i * bpp + 32) <= count * bpp; i += ppv, p += ppv * bpp)
+    {
+      m = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), _mm256_loadu_si256((const __m256i *)(p + bpp))));
+
+      if (!m)
+        continue;
+
+      for (j = 0; j < ppv; j ++, m >>= bpp)
+      {
+        if ((m & pmask) == pmask)
+          return (i + j);
+      }
+    }
+  }
+
+  for (; i < count; i ++, p += bpp)
+  {
+    if (!memcmp(p, p + bpp, bpp))
+      break;
+  }
+
+  return (i);
+}
+#endif // CUPS_RASTER_AVX2
+
+
+#ifdef CUPS_RASTER_NEON
+//
+// 'cups_raster_literal_neon()' - Find the end of a literal run using NEON.
+//
+
+static size_t				// O - Number of literal pixels
+cups_raster_literal_neon(
+    const unsigned char *pixels,	// I - Start of run
+    size_t              bpp,		// I - Bytes per pixel
+    size_t              count)		// I - Maximum number of pixels
+{
+  size_t		i,		// Current pixel
+			j,		// Pixel in vector
+			ppv;		// Pixels per vector
+  const unsigned char	*p;		// Pointer to current pixel
+
+
+  i = 1;
+  p = pixels + bpp;
+
+  if (bpp <= 16)
+  {
+    // Skip 16 bytes at a time while no byte matches the byte one pixel later...
+    ppv = 16 / bpp;
+
+    for (; (i * bpp + 16) <= count * bpp; i += ppv, p += ppv * bpp)
+    {
+      if (!vmaxvq_u8(vceqq_u8(vld1q_u8(p), vld1q_u8(p + bpp))))
+        continue;
+
+      for (j = 0; j < ppv; j ++)
+      {
+        if (!memcmp(p + j * bpp, p + (j + 1) * bpp, bpp))
+          return (i + j);
+      }
+    }
+  }
+
+  for (; i < count; i ++, p += bpp)
+  {
+    if (!memcmp(p, p + bpp, bpp))
+      break;
+  }
+
+  return (i);
+}
+#endif // CUPS_RASTER_NEON
+
+
+//
+// 'cups_raster_literal_scalar()' - Find the end of a literal run.
+//
+// Returns the index of the first pixel that is the same as the pixel after
+// it, or "count" if there is no such pixel.  The pixel at index "count" must
+// be readable.
+//
+
+static size_t				// O - Number of literal pixels
+cups_raster_literal_scalar(
+    const unsigned char *pixels,	// I - Start of run
+    size_t              bpp,		// I - Bytes per pixel
+    size_t              count)		// I - Maximum number of pixels
+{
+  size_t		i;		// Current pixel
+  const unsigned char	*p;		// Pointer to current pixel
+
+
+  for (i = 1, p = pixels + bpp; i < count; i ++, p += bpp)
+  {
+    if (!memcmp(p, p + bpp, bpp))
+      break;
+  }
+
+  return (i);
+}
+
+
+#ifdef CUPS_RASTER_SSE2
+//
+// 'cups_raster_literal_sse2()' - Find the end of a literal run using SSE2.
+//
+
+static size_t				// O - Number of literal pixels
+cups_raster_literal_sse2(
+    const unsigned char *pixels,	// I - Start of run
+    size_t              bpp,		// I - Bytes per pixel
+    size_t              count)		// I - Maximum number of pixels
+{
+  size_t		i,		// Current pixel
+			j,		// Pixel in vector
+			ppv;		// Pixels per vector
+  unsigned		m,		// Equal bytes mask
+			pmask;		// Mask for one pixel
+  const unsigned char	*p;		// Pointer to current pixel
+
+
+  i = 1;
+  p = pixels + bpp;
+
+  if (bpp <= 16)
+  {
+    // Compare 16 bytes against the same bytes one pixel later, then look for a
+    // pixel whose bytes all match...
+    ppv   = 16 / bpp;
+    pmask = (1U << bpp) - 1;
+
+    for (; (i * bpp + 16) <= count * bpp; i += ppv, p += ppv * bpp)
+    {
+      m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), _mm_loadu_si128((const __m128i *)(p + bpp))));
+
+      if (!m)
+        continue;
+
+      for (j = 0; j < ppv; j ++, m >>= bpp)
+      {
+        if ((m & pmask) == pmask)
+          return (i + j);
+      }
+    }
+  }
+
+  for (; i < count; i ++, p += bpp)
+  {
+    if (!memcmp(p, p + bpp, bpp))
+      break;
+  }
+
+  return (i);
+}
+#endif // CUPS_RASTER_SSE2
+
+
+//
+// 'cups_raster_queue()' - Queue the current band for the compression threads.
+//
+
+static bool				// O - `true` on success, `false` on error
+cups_raster_queue(cups_raster_t *r)	// I - Raster stream
+{
+  cupsMutexLock(&r->band_mutex);
+
+  r->bands[r->band_current].state = _CUPS_RASTER_BAND_QUEUED;
+  r->band_current = (r->band_current + 1) % r->num_bands;
+  r->band_pending ++;
+
+  cupsCondBroadcast(&r->band_cond);
+  cupsMutexUnlock(&r->band_mutex);
+
+  // Write the oldest band if we need its buffers for the next one...
+  if (r->band_pending == r->num_bands)
+    return (cups_raster_write_band(r));
+  else
+    return (true);
+}
+
+
 //
 // 'cups_raster_read()' - Read through the raster buffer.
 //
@@ -1516,6 +2008,226 @@ cups_raster_read(cups_raster_t *r,	// I - Raster stream
 }
 
 
+#ifdef CUPS_RASTER_AVX2
+//
+// 'cups_raster_repeat_avx2()' - Find the end of a repeated run using AVX2.
+//
+
+__attribute__((target("avx2")))
+static size_t				// O - Number of repeated pixels
+cups_raster_repeat_avx2(
+    const unsigned char *pixels,	// I - Start of run
+    size_t              bpp,		// I - Bytes per pixel
+    size_t              count)		// I - Maximum number of pixels
+{
+  size_t	i,			// Current byte
+		bytes;			// Number of bytes to compare
+  unsigned	m;			// Different bytes mask
+
+
+  // A run of N identical pixels is N - 1 pixels of bytes that are equal to the
+  // byte one pixel later, so find the first byte that differs...
+  for (i = 0, bytes = (count - 1) * bpp; (i + 32) <= bytes; i += 32)
+  {
+    if ((m = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(pixels + i)), _mm256_loadu_si256((const __m256i *)(pixels + i + bpp))))) != 0)
+      return ((i + (size_t)__builtin_ctz(m)) / bpp + 1);
+  }
+
+  while (i < bytes && pixels[i] == pixels[i + bpp])
+    i ++;
+
+  return (i / bpp + 1);
+}
+#endif // CUPS_RASTER_AVX2
+
+
+#ifdef CUPS_RASTER_NEON
+//
+// 'cups_raster_repeat_neon()' - Find the end of a repeated run using NEON.
+//
+
+static size_t				// O - Number of repeated pixels
+cups_raster_repeat_neon(
+    const unsigned char *pixels,	// I - Start of run
+    size_t              bpp,		// I - Bytes per pixel
+    size_t              count)		// I - Maximum number of pixels
+{
+  size_t	i,			// Current byte
+		bytes;			// Number of bytes to compare
+
+
+  // Skip 16 bytes at a time while all bytes match the byte one pixel later...
+  for (i = 0, bytes = (count - 1) * bpp; (i + 16) <= bytes; i += 16)
+  {
+    if (vminvq_u8(vceqq_u8(vld1q_u8(pixels + i), vld1q_u8(pixels + i + bpp))) != 0xff)
+      break;
+  }
+
+  while (i < bytes && pixels[i] == pixels[i + bpp])
+    i ++;
+
+  return (i / bpp + 1);
+}
+#endif // CUPS_RASTER_NEON
+
+
+//
+// 'cups_raster_repeat_scalar()' - Find the end of a repeated run.
+//
+// Returns the number of pixels, up to "count", that are the same as the first
+// pixel.
+//
+
+static size_t				// O - Number of repeated pixels
+cups_raster_repeat_scalar(
+    const unsigned char *pixels,	// I - Start of run
+    size_t              bpp,		// I - Bytes per pixel
+    size_t              count)		// I - Maximum number of pixels
+{
+  size_t		i;		// Current pixel
+  const unsigned char	*p;		// Pointer to current pixel
+
+
+  for (i = 1, p = pixels; i < count; i ++, p += bpp)
+  {
+    if (memcmp(p, p + bpp, bpp))
+      break;
+  }
+
+  return (i);
+}
+
+
+#ifdef CUPS_RASTER_SSE2
+//
+// 'cups_raster_repeat_sse2()' - Find the end of a repeated run using SSE2.
+//
+
+static size_t				// O - Number of repeated pixels
+cups_raster_repeat_sse2(
+    const unsigned char *pixels,	// I - Start of run
+    size_t              bpp,		// I - Bytes per pixel
+    size_t              count)		// I - Maximum number of pixels
+{
+  size_t	i,			// Current byte
+		bytes;			// Number of bytes to compare
+  unsigned	m;			// Different bytes mask
+
+
+  // A run of N identical pixels is N - 1 pixels of bytes that are equal to the
+  // byte one pixel later, so find the first byte that differs...
+  for (i = 0, bytes = (count - 1) * bpp; (i + 16) <= bytes; i += 16)
+  {
+    if ((m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(pixels + i)), _mm_loadu_si128((const __m128i *)(pixels + i + bpp)))) ^ 0xffff) != 0)
+      return ((i + (size_t)__builtin_ctz(m)) / bpp + 1);
+  }
+
+  while (i < bytes && pixels[i] == pixels[i + bpp])
+    i ++;
+
+  return (i / bpp + 1);
+}
+#endif // CUPS_RASTER_SSE2
+
+
+//
+// 'cups_raster_stop()' - Stop the compression threads and free the bands.
+//
+
+static void
+cups_raster_stop(cups_raster_t *r)	// I - Raster stream
+{
+  int	i;				// Looping var
+
+
+  if (!r->bands)
+    return;
+
+  cupsMutexLock(&r->band_mutex);
+  r->band_stop = true;
+  cupsCondBroadcast(&r->band_cond);
+  cupsMutexUnlock(&r->band_mutex);
+
+  for (i = 0; i < r->num_threads; i ++)
+    cupsThreadWait(r->threads[i]);
+
+  for (i = 0; i < r->num_bands; i ++)
+  {
+    free(r->bands[i].lines);
+    free(r->bands[i].output);
+  }
+
+  cupsCondDestroy(&r->band_cond);
+  cupsMutexDestroy(&r->band_mutex);
+
+  free(r->bands);
+  free(r->threads);
+
+  r->bands       = NULL;
+  r->threads     = NULL;
+  r->num_bands   = 0;
+  r->num_threads = 0;
+}
+
+
+//
+// 'cups_raster_thread()' - Compress bands of raster data.
+//
+
+static void *				// O - Thread exit status
+cups_raster_thread(cups_raster_t *r)	// I - Raster stream
+{
+  int			i;		// Looping var
+  _cups_raster_band_t	*b;		// Current band
+  unsigned		line;		// Current line
+  unsigned char		*lptr,		// Pointer into lines
+			*optr;		// Pointer into output
+
+
+  cupsMutexLock(&r->band_mutex);
+
+  while (!r->band_stop)
+  {
+    // Find the oldest band that needs to be compressed...
+    for (i = 0, b = NULL; i < r->band_pending; i ++)
+    {
+      b = r->bands + (r->band_first + i) % r->num_bands;
+
+      if (b->state == _CUPS_RASTER_BAND_QUEUED)
+        break;
+
+      b = NULL;
+    }
+
+    if (!b)
+    {
+      cupsCondWait(&r->band_cond, &r->band_mutex, 0.0);
+      continue;
+    }
+
+    // Compress the band without holding the lock...
+    b->state = _CUPS_RASTER_BAND_BUSY;
+
+    cupsMutexUnlock(&r->band_mutex);
+
+    for (line = 0, lptr = b->lines, optr = b->output; line < b->num_lines; line ++, lptr += r->header.cupsBytesPerLine + 1)
+      optr += cups_raster_encode(r, (unsigned)*lptr + 1, lptr + 1, optr);
+
+    b->outused = (size_t)(optr - b->output);
+
+    cupsMutexLock(&r->band_mutex);
+
+    b->state = _CUPS_RASTER_BAND_DONE;
+
+    cupsCondBroadcast(&r->band_cond);
+  }
+
+  cupsMutexUnlock(&r->band_mutex);
+
+  return (NULL);
+}
+
+
 //
 // 'cups_raster_update()' - Update the raster header and row count for the
 //                          current page.
@@ -1654,33 +2366,73 @@ cups_raster_write(
     cups_raster_t       *r,		// I - Raster stream
     const unsigned char *pixels)	// I - Pixel data to write
 {
-  const unsigned char	*start,		// Start of sequence
-			*ptr,		// Current pointer in sequence
-			*pend,		// End of raster buffer
-			*plast;		// Pointer to last pixel
+  size_t		count;		// Count
   unsigned char		*wptr;		// Pointer into write buffer
-  unsigned		bpp,		// Bytes per pixel
-			count;		// Count
-  _cups_copyfunc_t	cf;		// Copy function
 
 
   DEBUG_printf(("3cups_raster_write(r=%p, pixels=%p)", (void *)r, (void *)pixels));
 
-  // Determine whether we need to swap bytes...
-  if (r->swapped && (r->header.cupsBitsPerColor == 16 || r->header.cupsBitsPerPixel == 12 || r->header.cupsBitsPerPixel == 16))
+  if (r->num_threads > 0)
   {
-    DEBUG_puts("4cups_raster_write: Swapping bytes when writing.");
-    cf = (_cups_copyfunc_t)cups_swap_copy;
+    // Add the line to the current band for the compression threads...
+    _cups_raster_band_t	*b = r->bands + r->band_current;
+					// Current band
+    size_t		linesize = r->header.cupsBytesPerLine + 1;
+					// Size of line with repeat count
+
+    if (b->num_lines == 0)
+    {
+      // Size the band for the current page...
+      if ((b->max_lines = (unsigned)(_CUPS_RASTER_BAND_SIZE / linesize)) == 0)
+        b->max_lines = 1;
+
+      if ((count = b->max_lines * linesize) > b->linesize)
+      {
+        if ((wptr = realloc(b->lines, count)) == NULL)
+	{
+	  DEBUG_printf(("4cups_raster_write: Unable to allocate " CUPS_LLFMT " bytes for band: %s", CUPS_LLCAST count, strerror(errno)));
+	  return (-1);
+	}
+
+        b->lines    = wptr;
+        b->linesize = count;
+      }
+
+      if ((count = b->max_lines * (2 * linesize - 1)) > b->outsize)
+      {
+        if ((wptr = realloc(b->output, count)) == NULL)
+	{
+	  DEBUG_printf(("4cups_raster_write: Unable to allocate " CUPS_LLFMT " bytes for band: %s", CUPS_LLCAST count, strerror(errno)));
+	  return (-1);
+	}
+
+        b->output  = wptr;
+        b->outsize = count;
+      }
+    }
+
+    wptr    = b->lines + b->num_lines * linesize;
+    *wptr++ = (unsigned char)(r->count - 1);
+    memcpy(wptr, pixels, linesize - 1);
+
+    b->num_lines ++;
+
+    if (b->num_lines >= b->max_lines && !cups_raster_queue(r))
+      return (-1);
+
+    // Write everything at the end of the page...
+    if (r->remaining == 0 && !cups_raster_drain(r))
+      return (-1);
+
+    return ((ssize_t)linesize);
   }
-  else
-    cf = (_cups_copyfunc_t)memcpy;
 
   // Allocate a write buffer as needed...
   count = r->header.cupsBytesPerLine * 2;
   if (count < 65536)
     count = 65536;
 
-  if ((size_t)count > r->bufsize)
+  if (count > r->bufsize)
   {
     if (r->buffer)
       wptr = realloc(r->buffer, count);
@@ -1697,66 +2449,47 @@ cups_raster_write(
     r->bufsize = count;
   }
 
-  // Write the row repeat count...
-  bpp     = r->bpp;
-  pend    = pixels + r->header.cupsBytesPerLine;
-  plast   = pend - bpp;
-  wptr    = r->buffer;
-  *wptr++ = (unsigned char)(r->count - 1);
+  count = cups_raster_encode(r, r->count, pixels, r->buffer);
 
-  // Write using a modified PackBits compression...
-  for (ptr = pixels; ptr < pend;)
-  {
-    start = ptr;
-    ptr += bpp;
+  DEBUG_printf(("4cups_raster_write: Writing " CUPS_LLFMT " bytes.", CUPS_LLCAST count));
 
-    if (ptr == pend)
-    {
-      // Encode a single pixel at the end...
-      *wptr++ = 0;
-      (*cf)(wptr, start, bpp);
-      wptr += bpp;
-    }
-    else if (!memcmp(start, ptr, bpp))
-    {
-      // Encode a sequence of repeating pixels...
-      for (count = 2; count < 128 && ptr < plast; count ++, ptr += bpp)
-      {
-        if (memcmp(ptr, ptr + bpp, bpp))
-	  break;
-      }
+  return (cups_raster_io(r, r->buffer, count));
+}
 
-      *wptr++ = (unsigned char)(count - 1);
-      (*cf)(wptr, ptr, bpp);
-      wptr += bpp;
-      ptr  += bpp;
-    }
-    else
-    {
-      // Encode a sequence of non-repeating pixels...
-      for (count = 1; count < 128 && ptr < plast; count ++, ptr += bpp)
-      {
-        if (!memcmp(ptr, ptr + bpp, bpp))
-	  break;
-      }
 
-      if (ptr >= plast && count < 128)
-      {
-        count ++;
-	ptr += bpp;
-      }
+//
+// 'cups_raster_write_band()' - Write the oldest band once it is compressed.
+//
 
-      *wptr++ = (unsigned char)(257 - count);
+static bool				// O - `true` on success, `false` on error
+cups_raster_write_band(
+    cups_raster_t *r)			// I - Raster stream
+{
+  _cups_raster_band_t	*b;		// Band to write
+  bool			ret;		// Return value
 
-      count *= bpp;
-      (*cf)(wptr, start, count);
-      wptr += count;
-    }
-  }
 
-  DEBUG_printf(("4cups_raster_write: Writing " CUPS_LLFMT " bytes.", CUPS_LLCAST (wptr - r->buffer)));
+  b = r->bands + r->band_first;
+
+  cupsMutexLock(&r->band_mutex);
+  while (b->state != _CUPS_RASTER_BAND_DONE)
+    cupsCondWait(&r->band_cond, &r->band_mutex, 0.0);
+  cupsMutexUnlock(&r->band_mutex);
+
+  DEBUG_printf(("4cups_raster_write_band: Writing " CUPS_LLFMT " bytes for %u lines.", CUPS_LLCAST b->outused, b->num_lines));
+
+  ret = cups_raster_io(r, b->output, b->outused) == (ssize_t)b->outused;
+
+  cupsMutexLock(&r->band_mutex);
+
+  b->state      = _CUPS_RASTER_BAND_FREE;
+  b->num_lines  = 0;
+  r->band_first = (r->band_first + 1) % r->num_bands;
+  r->band_pending --;
+
+  cupsMutexUnlock(&r->band_mutex);
 
-  return (cups_raster_io(r, r->buffer, (size_t)(wptr - r->buffer)));
+  return (ret);
 }
 
 
@@ -361,6 +361,7 @@ extern cups_raster_t	*cupsRasterOpen(int fd, cups_raster_mode_t mode) _CUPS_PUBL
 extern cups_raster_t	*cupsRasterOpenIO(cups_raster_cb_t iocb, void *ctx, cups_raster_mode_t mode) _CUPS_PUBLIC;
 extern bool		cupsRasterReadHeader(cups_raster_t *r, cups_page_header_t *h) _CUPS_PUBLIC;
 extern unsigned		cupsRasterReadPixels(cups_raster_t *r, unsigned char *p, unsigned len) _CUPS_PUBLIC;
+extern bool		cupsRasterSetThreads(cups_raster_t *r, int num_threads) _CUPS_PUBLIC;
 extern bool		cupsRasterWriteHeader(cups_raster_t *r, cups_page_header_t *h) _CUPS_PUBLIC;
 extern unsigned		cupsRasterWritePixels(cups_raster_t *r, unsigned char *p, unsigned len) _CUPS_PUBLIC;
 
@@ -30,6 +30,13 @@
 #endif /* !MSG_DONTWAIT */
 
 
+/*
+ * Local functions...
+ */
+
+static http_status_t	cups_check_response(http_t *http);
+
+
 /*
  * 'cupsDoFileRequest()' - Do an IPP request with a file.
  *
@@ -105,6 +112,9 @@ cupsDoIORequest(http_t     *http,	/* I - Connection to server or `CUPS_HTTP_DEFA
   struct stat	fileinfo;		/* File information */
   ssize_t	bytes;			/* Number of bytes read/written */
   char		buffer[32768];		/* Output buffer */
+  bool		stats = _cups_stats_enabled;
+					/* Collect statistics? */
+  double	start;			/* Start time for statistics */
 
 
   DEBUG_printf(("cupsDoIORequest(http=%p, request=%p(%s), resource=\"%s\", infile=%d, outfile=%d)", (void *)http, (void *)request, request ? ippOpString(request->request.op.operation_id) : "?", resource, infile, outfile));
@@ -122,6 +132,8 @@ cupsDoIORequest(http_t     *http,	/* I - Connection to server or `CUPS_HTTP_DEFA
     return (NULL);
   }
 
+  start = stats ? _cupsStatsGetTime() : 0.0;
+
  /*
   * Get the default connection as needed...
   */
@@ -215,12 +227,7 @@ cupsDoIORequest(http_t     *http,	/* I - Connection to server or `CUPS_HTTP_DEFA
 #endif /* _WIN32 */
       lseek(infile, 0, SEEK_SET);
 
-      while ((bytes = read(infile, buffer, sizeof(buffer))) > 0)
-      {
-        if ((status = cupsWriteRequestData(http, buffer, (size_t)bytes))
-                != HTTP_STATUS_CONTINUE)
-	  break;
-      }
+      status = cupsWriteRequestFd(http, infile, 0);
     }
 
    /*
@@ -268,6 +275,9 @@ cupsDoIORequest(http_t     *http,	/* I - Connection to server or `CUPS_HTTP_DEFA
   * Delete the original request and return the response...
   */
 
+  if (stats)
+    _cupsStatsAddRequest(request->request.op.operation_id, start);
+
   ippDelete(request);
 
   return (response);
@@ -299,6 +309,9 @@ cupsDoRequest(http_t     *http,		/* I - Connection to server or `CUPS_HTTP_DEFAU
  * @link cupsSendRequest@. For requests that return additional data, use
  * @link cupsReadResponseData@ after getting a successful response,
  * otherwise call @link httpFlush@ to complete the response processing.
+ *
+ * Responses are normally created with @link ippNew@.  Call
+ * @link cupsSetResponseArena@ to read responses into arena messages instead.
  */
 
 ipp_t *					/* O - Response or `NULL` on HTTP error */
@@ -377,7 +390,10 @@ cupsGetResponse(http_t     *http,	/* I - Connection to server or `CUPS_HTTP_DEFA
     * Get the IPP response...
     */
 
-    response = ippNew();
+    if (_cupsGlobals()->response_arena)
+      response = ippNewWithArena();
+    else
+      response = ippNew();
 
     while ((state = ippRead(http, response)) != IPP_STATE_DATA)
       if (state == IPP_STATE_ERROR)
@@ -561,6 +577,7 @@ cupsSendRequest(http_t     *http,	/* I - Connection to server or `CUPS_HTTP_DEFA
   http_status_t		expect;		/* Expect: header to use */
   char			date[256];	/* Date: header value */
   int			digest;		/* Are we using Digest authentication? */
+  bool			retried = false;/* Retried after a write error? */
 
 
   DEBUG_printf(("cupsSendRequest(http=%p, request=%p(%s), resource=\"%s\", length=" CUPS_LLFMT ")", (void *)http, (void *)request, request ? ippOpString(request->request.op.operation_id) : "?", resource, CUPS_LLCAST length));
@@ -632,6 +649,22 @@ cupsSendRequest(http_t     *http,	/* I - Connection to server or `CUPS_HTTP_DEFA
     }
   }
 
+ /*
+  * Reconnect if the server closed an idle keep-alive connection, since the
+  * buffered request header will not fail until the IPP data is written...
+  */
+
+  if (http->state == HTTP_STATE_WAITING && httpWait(http, 0))
+  {
+    DEBUG_puts("2cupsSendRequest: Connection closed by server, reconnecting.");
+    httpClearFields(http);
+    if (!httpReconnect(http, 30000, NULL))
+    {
+      DEBUG_puts("1cupsSendRequest: Unable to reconnect.");
+      return (HTTP_STATUS_SERVICE_UNAVAILABLE);
+    }
+  }
+
  /*
   * Loop until we can send the request without authorization problems.
   */
@@ -719,7 +752,22 @@ cupsSendRequest(http_t     *http,	/* I - Connection to server or `CUPS_HTTP_DEFA
       if (!got_status || status < HTTP_STATUS_MULTIPLE_CHOICES)
       {
        /*
-        * No, something else went wrong.
+        * No, the connection may have been closed by the server after we
+        * checked it, so reconnect and try once more...
+	*/
+
+        if (!got_status && !retried)
+        {
+	  DEBUG_puts("2cupsSendRequest: IPP write failed, reconnecting.");
+
+          retried = true;
+
+	  if (httpReconnect(http, 30000, NULL))
+	    continue;
+        }
+
+       /*
+        * Something else went wrong.
 	*/
 
 	DEBUG_puts("1cupsSendRequest: Unable to send IPP request.");
@@ -847,6 +895,26 @@ cupsSendRequest(http_t     *http,	/* I - Connection to server or `CUPS_HTTP_DEFA
 }
 
 
+/*
+ * 'cupsSetResponseArena()' - Set whether IPP responses use a memory arena.
+ *
+ * This function controls whether @link cupsGetResponse@, and the
+ * @link cupsDoRequest@ family of functions that use it, read responses into
+ * arena messages created with @link ippNewWithArena@ for the current thread.
+ * Arena messages avoid many small allocations for large responses but keep
+ * all of their memory until they are deleted.  Arena responses are disabled
+ * by default.
+ */
+
+void
+cupsSetResponseArena(bool enable)	/* I - `true` to use arena responses, `false` to use `ippNew` */
+{
+  DEBUG_printf(("cupsSetResponseArena(enable=%s)", enable ? "true" : "false"));
+
+  _cupsGlobals()->response_arena = enable;
+}
+
+
 /*
  * 'cupsWriteRequestData()' - Write additional data after an IPP request.
  *
@@ -907,31 +975,119 @@ cupsWriteRequestData(
     * We've written something to the server, so check for response data...
     */
 
-    if (_httpWait(http, 0, 1))
+    return (cups_check_response(http));
+  }
+
+  DEBUG_puts("1cupsWriteRequestData: Returning HTTP_STATUS_CONTINUE.");
+  return (HTTP_STATUS_CONTINUE);
+}
+
+
+/*
+ * 'cupsWriteRequestFd()' - Write additional data from a file after an IPP
+ *                          request.
+ *
+ * This function is used after @link cupsSendRequest@ or
+ * @link cupsStartDocument@ to send up to "length" bytes from a file
+ * descriptor, or the rest of the file when "length" is `0`.  Regular files
+ * are sent without copying the data when the connection allows it - see
+ * @link httpWriteFd@.
+ */
+
+http_status_t				/* O - `HTTP_STATUS_CONTINUE` if OK or HTTP status on error */
+cupsWriteRequestFd(
+    http_t *http,			/* I - Connection to server or `CUPS_HTTP_DEFAULT` */
+    int    fd,				/* I - File descriptor */
+    off_t  length)			/* I - Number of bytes to write or `0` for the rest of the file */
+{
+  http_status_t	status = HTTP_STATUS_CONTINUE;
+					/* Status of write */
+  off_t		total = 0,		/* Total bytes written */
+		bytes;			/* Bytes written */
+
+
+ /*
+  * Get the default connection as needed...
+  */
+
+  DEBUG_printf(("cupsWriteRequestFd(http=%p, fd=%d, length=" CUPS_LLFMT ")", (void *)http, fd, CUPS_LLCAST length));
+
+  if (!http)
+  {
+    _cups_globals_t *cg = _cupsGlobals();
+					/* Pointer to library globals */
+
+    if ((http = cg->http) == NULL)
     {
-      http_status_t	status;		/* Status from _httpUpdate */
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, _("No active connection"), 1);
+      DEBUG_puts("1cupsWriteRequestFd: Returning HTTP_STATUS_ERROR.");
+      return (HTTP_STATUS_ERROR);
+    }
+  }
 
-      _httpUpdate(http, &status);
-      if (status >= HTTP_STATUS_MULTIPLE_CHOICES)
-      {
-        _cupsSetHTTPError(status);
+  if (fd < 0 || length < 0)
+  {
+    _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(EINVAL), 0);
+    DEBUG_puts("1cupsWriteRequestFd: Returning HTTP_STATUS_ERROR.");
+    return (HTTP_STATUS_ERROR);
+  }
 
-	do
-	{
-	  status = httpUpdate(http);
-	}
-	while (status != HTTP_STATUS_ERROR && http->state == HTTP_STATE_POST_RECV);
+ /*
+  * Write the file in pieces, checking for an early response from the server
+  * after each one...
+  */
+
+  while (length == 0 || total < length)
+  {
+    if ((bytes = httpWriteFd(http, fd, (length == 0 || (length - total) > _HTTP_MAX_SENDFILE) ? _HTTP_MAX_SENDFILE : length - total)) < 0)
+    {
+      DEBUG_puts("1cupsWriteRequestFd: Returning HTTP_STATUS_ERROR.");
+      _cupsSetError(IPP_STATUS_ERROR_INTERNAL, strerror(http->error), 0);
+      return (HTTP_STATUS_ERROR);
+    }
+    else if (bytes == 0)
+      break;
+
+    total += bytes;
+
+    if ((status = cups_check_response(http)) != HTTP_STATUS_CONTINUE)
+      break;
+  }
+
+  DEBUG_printf(("1cupsWriteRequestFd: Returning %d.", status));
+  return (status);
+}
+
+
+/*
+ * 'cups_check_response()' - Check for an early response from the server.
+ */
+
+static http_status_t			/* O - `HTTP_STATUS_CONTINUE` or HTTP status */
+cups_check_response(http_t *http)	/* I - Connection to server */
+{
+  http_status_t	status;			/* Status from _httpUpdate */
 
-        httpFlush(http);
-      }
 
-      DEBUG_printf(("1cupsWriteRequestData: Returning %d.\n", status));
-      return (status);
+  if (!_httpWait(http, 0, 1))
+    return (HTTP_STATUS_CONTINUE);
+
+  _httpUpdate(http, &status);
+  if (status >= HTTP_STATUS_MULTIPLE_CHOICES)
+  {
+    _cupsSetHTTPError(status);
+
+    do
+    {
+      status = httpUpdate(http);
     }
+    while (status != HTTP_STATUS_ERROR && http->state == HTTP_STATE_POST_RECV);
+
+    httpFlush(http);
   }
 
-  DEBUG_puts("1cupsWriteRequestData: Returning HTTP_STATUS_CONTINUE.");
-  return (HTTP_STATUS_CONTINUE);
+  DEBUG_printf(("2cups_check_response: Returning %d.", status));
+  return (status);
 }
 
 
@@ -0,0 +1,532 @@
+//
+// HTTP and IPP statistics for CUPS.
+//
+// Copyright © 2022 by OpenPrinting.
+//
+// Licensed under Apache License v2.0.  See the file "LICENSE" for more
+// information.
+//
+
+#include "cups-private.h"
+#include <math.h>
+
+
+//
+// Local constants...
+//
+
+#define _CUPS_STATS_BUCKETS	24	// Number of histogram buckets (1us to 8s)
+
+
+//
+// Local types...
+//
+
+typedef struct _cups_stats_hist_s	// Latency histogram
+{
+  size_t	count;			// Number of samples
+  double	total,			// Total time in seconds
+		max;			// Maximum time in seconds
+  size_t	buckets[_CUPS_STATS_BUCKETS];
+					// Samples less than 2^N microseconds
+} _cups_stats_hist_t;
+
+typedef struct _cups_stats_iocount_s	// I/O counters
+{
+  size_t	count,			// Number of calls/messages
+		bytes,			// Number of bytes
+		items;			// Number of attributes
+} _cups_stats_iocount_t;
+
+typedef struct _cups_stats_op_s		// Per-operation request histogram
+{
+  ipp_op_t	op;			// Operation code
+  _cups_stats_hist_t hist;		// Round-trip times
+} _cups_stats_op_t;
+
+struct _cups_stats_s			// Per-thread statistics
+{
+  struct _cups_stats_s *next;		// Next thread
+  cups_mutex_t	mutex;			// Mutex for counters
+  _cups_stats_iocount_t io[_CUPS_STATS_IO_MAX];
+					// I/O counters
+  _cups_stats_hist_t times[_CUPS_STATS_TIME_MAX];
+					// Latency histograms
+  cups_array_t	*ops;			// Request histograms by operation
+};
+
+
+//
+// Local functions...
+//
+
+static void		stats_add_hist(_cups_stats_hist_t *hist, double secs);
+static int		stats_compare_ops(_cups_stats_op_t *a, _cups_stats_op_t *b, void *data);
+static _cups_stats_t	*stats_get(void);
+static void		stats_json_hist(cups_json_t *parent, const char *key, _cups_stats_hist_t *hist);
+static void		stats_json_io(cups_json_t *parent, const char *count_key, const char *bytes_key, const char *items_key, _cups_stats_iocount_t *io);
+static void		stats_json_number(cups_json_t *parent, const char *key, double number);
+static void		stats_merge(_cups_stats_t *dst, _cups_stats_t *src);
+static void		stats_merge_hist(_cups_stats_hist_t *dst, _cups_stats_hist_t *src);
+static _cups_stats_op_t	*stats_op(_cups_stats_t *stats, ipp_op_t op);
+
+
+//
+// Local globals...
+//
+
+bool			_cups_stats_enabled = false;
+					// Are statistics being collected?
+static cups_mutex_t	stats_mutex = CUPS_MUTEX_INITIALIZER;
+					// Mutex for thread list
+static _cups_stats_t	*stats_threads = NULL;
+					// Statistics for active threads
+static _cups_stats_t	stats_retired;	// Statistics for finished threads
+
+
+//
+// 'cupsGetStatistics()' - Get HTTP and IPP statistics for all threads.
+//
+// This function returns a JSON object with the HTTP and IPP statistics that
+// have been collected since statistics were enabled with
+// @link cupsSetStatistics@.  The object has the following members:
+//
+// - "http": Object with "connections", "reads", "read_bytes", "writes", and
+//   "write_bytes" counters plus "update_usec", "wait_usec", and
+//   "tls_handshake_usec" histograms for @link httpUpdate@, @link httpWait@,
+//   and TLS handshakes.
+// - "ipp": Object with "reads", "read_bytes", "read_attributes", "writes",
+//   "write_bytes", and "write_attributes" counters for @link ippReadIO@ and
+//   @link ippWriteIO@.
+// - "requests": Object with a histogram of @link cupsDoRequest@ round-trip
+//   times for each operation, keyed by the operation name.
+//
+// Each histogram is an object with "count", "total", and "max" members in
+// microseconds and a "buckets" array where element N is the number of
+// samples that took less than 2^N microseconds (the last element also counts
+// longer samples).
+//
+// The returned object must be freed using @link cupsJSONDelete@.
+//
+
+cups_json_t *				// O - Statistics or `NULL` on error
+cupsGetStatistics(void)
+{
+  _cups_stats_t		total;		// Total for all threads
+  _cups_stats_t		*stats;		// Current thread
+  _cups_stats_op_t	*op;		// Current operation
+  cups_json_t		*json,		// Statistics object
+			*group;		// "http", "ipp", or "requests" object
+
+
+  // Add up the counters for all threads...
+  memset(&total, 0, sizeof(total));
+
+  cupsMutexLock(&stats_mutex);
+
+  stats_merge(&total, &stats_retired);
+
+  for (stats = stats_threads; stats; stats = stats->next)
+  {
+    cupsMutexLock(&stats->mutex);
+    stats_merge(&total, stats);
+    cupsMutexUnlock(&stats->mutex);
+  }
+
+  cupsMutexUnlock(&stats_mutex);
+
+  // Then convert them to JSON...
+  if ((json = cupsJSONNew(NULL, NULL, CUPS_JTYPE_OBJECT)) == NULL)
+  {
+    cupsArrayDelete(total.ops);
+    return (NULL);
+  }
+
+  group = cupsJSONNew(json, cupsJSONNewKey(json, NULL, "http"), CUPS_JTYPE_OBJECT);
+  stats_json_number(group, "connections", total.io[_CUPS_STATS_HTTP_CONNECT].count);
+  stats_json_io(group, "reads", "read_bytes", NULL, total.io + _CUPS_STATS_HTTP_READ);
+  stats_json_io(group, "writes", "write_bytes", NULL, total.io + _CUPS_STATS_HTTP_WRITE);
+  stats_json_hist(group, "update_usec", total.times + _CUPS_STATS_HTTP_UPDATE);
+  stats_json_hist(group, "wait_usec", total.times + _CUPS_STATS_HTTP_WAIT);
+  stats_json_hist(group, "tls_handshake_usec", total.times + _CUPS_STATS_TLS_HANDSHAKE);
+
+  group = cupsJSONNew(json, cupsJSONNewKey(json, NULL, "ipp"), CUPS_JTYPE_OBJECT);
+  stats_json_io(group, "reads", "read_bytes", "read_attributes", total.io + _CUPS_STATS_IPP_READ);
+  stats_json_io(group, "writes", "write_bytes", "write_attributes", total.io + _CUPS_STATS_IPP_WRITE);
+
+  group = cupsJSONNew(json, cupsJSONNewKey(json, NULL, "requests"), CUPS_JTYPE_OBJECT);
+  for (op = (_cups_stats_op_t *)cupsArrayGetFirst(total.ops); op; op = (_cups_stats_op_t *)cupsArrayGetNext(total.ops))
+    stats_json_hist(group, ippOpString(op->op), &op->hist);
+
+  cupsArrayDelete(total.ops);
+
+  return (json);
+}
+
+
+//
+// 'cupsSetStatistics()' - Enable or disable HTTP and IPP statistics.
+//
+// This function enables or disables the collection of HTTP and IPP statistics
+// for all threads.  Statistics are disabled by default and the counters are
+// kept until the program exits - use @link cupsGetStatistics@ to get the
+// current values.
+//
+
+void
+cupsSetStatistics(bool enable)		// I - `true` to collect statistics, `false` to stop
+{
+  _cups_stats_enabled = enable;
+}
+
+
+//
+// '_cupsStatsAddIO()' - Add to an I/O counter for the current thread.
+//
+
+void
+_cupsStatsAddIO(_cups_stats_io_t io,	// I - Counter
+                size_t           count,	// I - Number of calls/messages
+                size_t           bytes,	// I - Number of bytes
+                size_t           items)	// I - Number of attributes
+{
+  _cups_stats_t	*stats;			// Statistics for thread
+
+
+  if ((stats = stats_get()) == NULL)
+    return;
+
+  cupsMutexLock(&stats->mutex);
+  stats->io[io].count += count;
+  stats->io[io].bytes += bytes;
+  stats->io[io].items += items;
+  cupsMutexUnlock(&stats->mutex);
+}
+
+
+//
+// '_cupsStatsAddRequest()' - Add an IPP request round-trip time for the current thread.
+//
+
+void
+_cupsStatsAddRequest(ipp_op_t op,	// I - Operation code
+                     double   start)	// I - Start time from `_cupsStatsGetTime`
+{
+  double		secs = _cupsStatsGetTime() - start;
+					// Elapsed time
+  _cups_stats_t		*stats;		// Statistics for thread
+  _cups_stats_op_t	*sop;		// Operation histogram
+
+
+  if ((stats = stats_get()) == NULL)
+    return;
+
+  cupsMutexLock(&stats->mutex);
+  if ((sop = stats_op(stats, op)) != NULL)
+    stats_add_hist(&sop->hist, secs);
+  cupsMutexUnlock(&stats->mutex);
+}
+
+
+//
+// '_cupsStatsAddTime()' - Add an elapsed time for the current thread.
+//
+
+void
+_cupsStatsAddTime(_cups_stats_time_t t,	// I - Histogram
+                  double             start)
+					// I - Start time from `_cupsStatsGetTime`
+{
+  double	secs = _cupsStatsGetTime() - start;
+					// Elapsed time
+  _cups_stats_t	*stats;			// Statistics for thread
+
+
+  if ((stats = stats_get()) == NULL)
+    return;
+
+  cupsMutexLock(&stats->mutex);
+  stats_add_hist(stats->times + t, secs);
+  cupsMutexUnlock(&stats->mutex);
+}
+
+
+//
+// '_cupsStatsGetTime()' - Get the current time for latency measurements.
+//
+
+double					// O - Time in seconds
+_cupsStatsGetTime(void)
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec	curtime;	// Current time
+
+
+  clock_gettime(CLOCK_MONOTONIC, &curtime);
+
+  return ((double)curtime.tv_sec + 0.000000001 * curtime.tv_nsec);
+
+#else
+  struct timeval	curtime;	// Current time
+
+
+  gettimeofday(&curtime, NULL);
+
+  return ((double)curtime.tv_sec + 0.000001 * curtime.tv_usec);
+#endif // CLOCK_MONOTONIC
+}
+
+
+//
+// '_cupsStatsRelease()' - Retire the statistics for a thread.
+//
+// The counters are added to the totals for finished threads so that
+// @link cupsGetStatistics@ continues to report them.
+//
+
+void
+_cupsStatsRelease(_cups_stats_t *stats)	// I - Statistics for thread
+{
+  _cups_stats_t	**prev;			// Pointer to previous thread
+
+
+  if (!stats)
+    return;
+
+  cupsMutexLock(&stats_mutex);
+
+  for (prev = &stats_threads; *prev; prev = &((*prev)->next))
+  {
+    if (*prev == stats)
+    {
+      *prev = stats->next;
+      break;
+    }
+  }
+
+  stats_merge(&stats_retired, stats);
+
+  cupsMutexUnlock(&stats_mutex);
+
+  cupsArrayDelete(stats->ops);
+  cupsMutexDestroy(&stats->mutex);
+  free(stats);
+}
+
+
+//
+// 'stats_add_hist()' - Add a sample to a histogram.
+//
+
+static void
+stats_add_hist(_cups_stats_hist_t *hist,// I - Histogram
+               double             secs)	// I - Elapsed time in seconds
+{
+  size_t	bucket;			// Histogram bucket
+  double	usecs;			// Elapsed time in microseconds
+
+
+  if (secs < 0.0)
+    secs = 0.0;
+
+  for (bucket = 0, usecs = secs * 1000000.0; bucket < (_CUPS_STATS_BUCKETS - 1) && usecs >= (double)(1 << bucket); bucket ++);
+
+  hist->count ++;
+  hist->total += secs;
+  hist->buckets[bucket] ++;
+
+  if (secs > hist->max)
+    hist->max = secs;
+}
+
+
+//
+// 'stats_compare_ops()' - Compare two operation histograms.
+//
+
+static int				// O - Result of comparison
+stats_compare_ops(_cups_stats_op_t *a,	// I - First histogram
+                  _cups_stats_op_t *b,	// I - Second histogram
+                  void             *data)
+					// I - Callback data (unused)
+{
+  (void)data;
+
+  return ((int)a->op - (int)b->op);
+}
+
+
+//
+// 'stats_get()' - Get the statistics for the current thread.
+//
+
+static _cups_stats_t *			// O - Statistics or `NULL` on error
+stats_get(void)
+{
+  _cups_globals_t	*cg = _cupsGlobals();
+					// Global data
+
+
+  if (!cg->stats && (cg->stats = (_cups_stats_t *)calloc(1, sizeof(_cups_stats_t))) != NULL)
+  {
+    cupsMutexInit(&cg->stats->mutex);
+
+    cupsMutexLock(&stats_mutex);
+    cg->stats->next = stats_threads;
+    stats_threads   = cg->stats;
+    cupsMutexUnlock(&stats_mutex);
+  }
+
+  return (cg->stats);
+}
+
+
+//
+// 'stats_json_hist()' - Add a histogram to a JSON object.
+//
+
+static void
+stats_json_hist(
+    cups_json_t        *parent,		// I - Parent object
+    const char         *key,		// I - Key
+    _cups_stats_hist_t *hist)		// I - Histogram
+{
+  size_t	i,			// Looping var
+		count;			// Number of buckets to add
+  cups_json_t	*json,			// Histogram object
+		*buckets;		// Buckets array
+
+
+  json = cupsJSONNew(parent, cupsJSONNewKey(parent, NULL, key), CUPS_JTYPE_OBJECT);
+
+  stats_json_number(json, "count", hist->count);
+  stats_json_number(json, "total", floor(hist->total * 1000000.0));
+  stats_json_number(json, "max", floor(hist->max * 1000000.0));
+
+  // Trailing empty buckets are omitted...
+  for (count = _CUPS_STATS_BUCKETS; count > 0 && !hist->buckets[count - 1]; count --);
+
+  buckets = cupsJSONNew(json, cupsJSONNewKey(json, NULL, "buckets"), CUPS_JTYPE_ARRAY);
+
+  for (i = 0; i < count; i ++)
+    cupsJSONNewNumber(buckets, NULL, hist->buckets[i]);
+}
+
+
+//
+// 'stats_json_io()' - Add I/O counters to a JSON object.
+//
+
+static void
+stats_json_io(
+    cups_json_t           *parent,	// I - Parent object
+    const char            *count_key,	// I - Key for count
+    const char            *bytes_key,	// I - Key for bytes
+    const char            *items_key,	// I - Key for items or `NULL` for none
+    _cups_stats_iocount_t *io)		// I - Counters
+{
+  stats_json_number(parent, count_key, io->count);
+  stats_json_number(parent, bytes_key, io->bytes);
+
+  if (items_key)
+    stats_json_number(parent, items_key, io->items);
+}
+
+
+//
+// 'stats_json_number()' - Add a number to a JSON object.
+//
+
+static void
+stats_json_number(cups_json_t *parent,	// I - Parent object
+                  const char  *key,	// I - Key
+                  double      number)	// I - Value
+{
+  cupsJSONNewNumber(parent, cupsJSONNewKey(parent, NULL, key), number);
+}
+
+
+//
+// 'stats_merge()' - Add the counters from one statistics block to another.
+//
+
+static void
+stats_merge(_cups_stats_t *dst,		// I - Destination statistics
+            _cups_stats_t *src)		// I - Source statistics
+{
+  size_t		i;		// Looping var
+  _cups_stats_op_t	*sop,		// Source operation
+			*dop;		// Destination operation
+
+
+  for (i = 0; i < _CUPS_STATS_IO_MAX; i ++)
+  {
+    dst->io[i].count += src->io[i].count;
+    dst->io[i].bytes += src->io[i].bytes;
+    dst->io[i].items += src->io[i].items;
+  }
+
+  for (i = 0; i < _CUPS_STATS_TIME_MAX; i ++)
+    stats_merge_hist(dst->times + i, src->times + i);
+
+  for (sop = (_cups_stats_op_t *)cupsArrayGetFirst(src->ops); sop; sop = (_cups_stats_op_t *)cupsArrayGetNext(src->ops))
+  {
+    if ((dop = stats_op(dst, sop->op)) != NULL)
+      stats_merge_hist(&dop->hist, &sop->hist);
+  }
+}
+
+
+//
+// 'stats_merge_hist()' - Add one histogram to another.
+//
+
+static void
+stats_merge_hist(
+    _cups_stats_hist_t *dst,		// I - Destination histogram
+    _cups_stats_hist_t *src)		// I - Source histogram
+{
+  size_t	i;			// Looping var
+
+
+  dst->count += src->count;
+  dst->total += src->total;
+
+  if (src->max > dst->max)
+    dst->max = src->max;
+
+  for (i = 0; i < _CUPS_STATS_BUCKETS; i ++)
+    dst->buckets[i] += src->buckets[i];
+}
+
+
+//
+// 'stats_op()' - Find or add the histogram for an operation.
+//
+
+static _cups_stats_op_t *		// O - Operation histogram or `NULL` on error
+stats_op(_cups_stats_t *stats,		// I - Statistics
+         ipp_op_t      op)		// I - Operation code
+{
+  _cups_stats_op_t	key,		// Search key
+			*sop;		// Operation histogram
+
+
+  if (!stats->ops && (stats->ops = cupsArrayNew((cups_array_cb_t)stats_compare_ops, NULL, NULL, 0, NULL, (cups_afree_cb_t)free)) == NULL)
+    return (NULL);
+
+  key.op = op;
+
+  if ((sop = (_cups_stats_op_t *)cupsArrayFind(stats->ops, &key)) == NULL && (sop = (_cups_stats_op_t *)calloc(1, sizeof(_cups_stats_op_t))) != NULL)
+  {
+    sop->op = op;
+
+    if (!cupsArrayAdd(stats->ops, sop))
+    {
+      free(sop);
+      sop = NULL;
+    }
+  }
+
+  return (sop);
+}
@@ -13,6 +13,7 @@
 #  define _CUPS_STRING_PRIVATE_H_
 #  include "config.h"
 #  include "base.h"
+#  include "array.h"
 #  include <stdio.h>
 #  include <stdlib.h>
 #  include <stdarg.h>
@@ -31,12 +32,15 @@ extern "C" {
  */
 
 #  define _CUPS_STR_GUARD	0x12344321
+#  define _CUPS_STR_SHARDS	16	/* Number of string pool shards (power of 2) */
 
 typedef struct _cups_sp_item_s		/**** String Pool Item ****/
 {
 #  ifdef DEBUG_GUARDS
   unsigned int	guard;			/* Guard word */
 #  endif /* DEBUG_GUARDS */
+  struct _cups_sp_item_s *next;		/* Next item in hash bucket */
+  unsigned int	hash;			/* Hash of string */
   unsigned int	ref_count;		/* Reference count */
   char		str[1];			/* String */
 } _cups_sp_item_t;
@@ -128,6 +132,8 @@ extern char	*_cupsStrAlloc(const char *s) _CUPS_PRIVATE;
 extern void	_cupsStrFlush(void) _CUPS_PRIVATE;
 extern void	_cupsStrFree(const char *s) _CUPS_PRIVATE;
 extern char	*_cupsStrRetain(const char *s) _CUPS_PRIVATE;
+extern void	_cupsStrSeed(cups_array_t *strings) _CUPS_PRIVATE;
+extern size_t	_cupsStrShardStatistics(size_t shard, size_t *alloc_bytes, size_t *total_bytes) _CUPS_PRIVATE;
 extern size_t	_cupsStrStatistics(size_t *alloc_bytes, size_t *total_bytes) _CUPS_PRIVATE;
 extern char	*_cupsStrFormatd(char *buf, char *bufend, double number, struct lconv *loc) _CUPS_PRIVATE;
 extern double	_cupsStrScand(const char *buf, char **bufptr, struct lconv *loc) _CUPS_PRIVATE;
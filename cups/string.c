@@ -20,33 +20,56 @@
 #include <limits.h>
 
 
+/*
+ * Local types...
+ */
+
+typedef struct _cups_sp_shard_s		/**** String Pool Shard ****/
+{
+  cups_mutex_t		mutex;		/* Mutex to control access to shard */
+  size_t		num_items,	/* Number of strings in shard */
+			num_buckets;	/* Number of hash buckets */
+  _cups_sp_item_t	**buckets;	/* Hash buckets */
+} _cups_sp_shard_t;
+
+
 /*
  * Local globals...
  */
 
-static cups_mutex_t	sp_mutex = CUPS_MUTEX_INITIALIZER;
-					/* Mutex to control access to pool */
-static cups_array_t	*stringpool = NULL;
-					/* Global string pool */
+#define _CUPS_SP_SHARD_INIT { CUPS_MUTEX_INITIALIZER, 0, 0, NULL }
+
+static _cups_sp_shard_t	sp_shards[_CUPS_STR_SHARDS] =
+{					/* Global string pool */
+  _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT,
+  _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT,
+  _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT,
+  _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT, _CUPS_SP_SHARD_INIT
+};
 
 
 /*
  * Local functions...
  */
 
-static int	compare_sp_items(_cups_sp_item_t *a, _cups_sp_item_t *b);
+static _cups_sp_item_t	*sp_add(_cups_sp_shard_t *shard, const char *s, unsigned hash);
+static _cups_sp_item_t	*sp_find(_cups_sp_shard_t *shard, const char *s, unsigned hash);
+static unsigned		sp_hash(const char *s);
 
 
 /*
  * '_cupsStrAlloc()' - Allocate/reference a string.
+ *
+ * The pool is split into shards by the hash of the string so that threads
+ * working with different strings rarely contend for the same lock.
  */
 
 char *					/* O - String pointer */
 _cupsStrAlloc(const char *s)		/* I - String */
 {
-  size_t		slen;		/* Length of string */
-  _cups_sp_item_t	*item,		/* String pool item */
-			*key;		/* Search key */
+  unsigned		hash;		/* Hash of string */
+  _cups_sp_shard_t	*shard;		/* String pool shard */
+  _cups_sp_item_t	*item;		/* String pool item */
 
 
  /*
@@ -57,28 +80,19 @@ _cupsStrAlloc(const char *s)		/* I - String */
     return (NULL);
 
  /*
-  * Get the string pool...
+  * Get the string pool shard...
   */
 
-  cupsMutexLock(&sp_mutex);
-
-  if (!stringpool)
-    stringpool = cupsArrayNew((cups_array_cb_t)compare_sp_items, NULL, NULL, 0, NULL, NULL);
-
-  if (!stringpool)
-  {
-    cupsMutexUnlock(&sp_mutex);
+  hash  = sp_hash(s);
+  shard = sp_shards + (hash & (_CUPS_STR_SHARDS - 1));
 
-    return (NULL);
-  }
+  cupsMutexLock(&shard->mutex);
 
  /*
   * See if the string is already in the pool...
   */
 
-  key = (_cups_sp_item_t *)(s - offsetof(_cups_sp_item_t, str));
-
-  if ((item = (_cups_sp_item_t *)cupsArrayFind(stringpool, key)) != NULL)
+  if ((item = sp_find(shard, s, hash)) != NULL)
   {
    /*
     * Found it, return the cached string...
@@ -93,42 +107,20 @@ _cupsStrAlloc(const char *s)		/* I - String */
       abort();
 #endif /* DEBUG_GUARDS */
 
-    cupsMutexUnlock(&sp_mutex);
+    cupsMutexUnlock(&shard->mutex);
 
     return (item->str);
   }
 
  /*
-  * Not found, so allocate a new one...
+  * Not found, so add a new one...
   */
 
-  slen = strlen(s);
-  item = (_cups_sp_item_t *)calloc(1, sizeof(_cups_sp_item_t) + slen);
-  if (!item)
-  {
-    cupsMutexUnlock(&sp_mutex);
-
-    return (NULL);
-  }
+  item = sp_add(shard, s, hash);
 
-  item->ref_count = 1;
-  memcpy(item->str, s, slen + 1);
+  cupsMutexUnlock(&shard->mutex);
 
-#ifdef DEBUG_GUARDS
-  item->guard = _CUPS_STR_GUARD;
-
-  DEBUG_printf(("5_cupsStrAlloc: Created string %p(%s) for \"%s\", guard=%08x, ref_count=%d", item, item->str, s, item->guard, item->ref_count));
-#endif /* DEBUG_GUARDS */
-
- /*
-  * Add the string to the pool and return it...
-  */
-
-  cupsArrayAdd(stringpool, item);
-
-  cupsMutexUnlock(&sp_mutex);
-
-  return (item->str);
+  return (item ? item->str : NULL);
 }
 
 
@@ -227,20 +219,39 @@ cupsCopyString(char       *dst,		/* O - Destination string */
 void
 _cupsStrFlush(void)
 {
-  _cups_sp_item_t	*item;		/* Current item */
+  size_t		i;		/* Looping var */
+  _cups_sp_shard_t	*shard;		/* Current shard */
+  _cups_sp_item_t	**bucket,	/* Current bucket */
+			*item,		/* Current item */
+			*next;		/* Next item */
 
 
-  DEBUG_printf(("4_cupsStrFlush: %u strings in array", (unsigned)cupsArrayGetCount(stringpool)));
+  for (i = _CUPS_STR_SHARDS, shard = sp_shards; i > 0; i --, shard ++)
+  {
+    cupsMutexLock(&shard->mutex);
 
-  cupsMutexLock(&sp_mutex);
+    DEBUG_printf(("4_cupsStrFlush: %u strings in shard %u", (unsigned)shard->num_items, (unsigned)(shard - sp_shards)));
 
-  for (item = (_cups_sp_item_t *)cupsArrayGetFirst(stringpool); item; item = (_cups_sp_item_t *)cupsArrayGetNext(stringpool))
-    free(item);
+    if (shard->buckets)
+    {
+      for (bucket = shard->buckets; bucket < (shard->buckets + shard->num_buckets); bucket ++)
+      {
+        for (item = *bucket; item; item = next)
+        {
+          next = item->next;
+          free(item);
+        }
+      }
+
+      free(shard->buckets);
+    }
 
-  cupsArrayDelete(stringpool);
-  stringpool = NULL;
+    shard->num_items   = 0;
+    shard->num_buckets = 0;
+    shard->buckets     = NULL;
 
-  cupsMutexUnlock(&sp_mutex);
+    cupsMutexUnlock(&shard->mutex);
+  }
 }
 
 
@@ -331,7 +342,10 @@ _cupsStrFormatd(char         *buf,	/* I - String */
 void
 _cupsStrFree(const char *s)		/* I - String to free */
 {
-  _cups_sp_item_t	*item,		/* String pool item */
+  unsigned		hash;		/* Hash of string */
+  _cups_sp_shard_t	*shard;		/* String pool shard */
+  _cups_sp_item_t	**prev,		/* Pointer to previous item */
+			*item,		/* String pool item */
 			*key;		/* Search key */
 
 
@@ -342,55 +356,53 @@ _cupsStrFree(const char *s)		/* I - String to free */
   if (!s)
     return;
 
- /*
-  * Check the string pool...
-  *
-  * We don't need to lock the mutex yet, as we only want to know if
-  * the stringpool is initialized.  The rest of the code will still
-  * work if it is initialized before we lock...
-  */
-
-  if (!stringpool)
-    return;
-
  /*
   * See if the string is already in the pool...
   */
 
-  cupsMutexLock(&sp_mutex);
+  hash  = sp_hash(s);
+  shard = sp_shards + (hash & (_CUPS_STR_SHARDS - 1));
+  key   = (_cups_sp_item_t *)(s - offsetof(_cups_sp_item_t, str));
 
-  key = (_cups_sp_item_t *)(s - offsetof(_cups_sp_item_t, str));
+  cupsMutexLock(&shard->mutex);
 
-  if ((item = (_cups_sp_item_t *)cupsArrayFind(stringpool, key)) != NULL &&
-      item == key)
+  if (shard->buckets)
   {
-   /*
-    * Found it, dereference...
-    */
+    for (prev = shard->buckets + ((hash / _CUPS_STR_SHARDS) & (shard->num_buckets - 1)), item = *prev; item; prev = &item->next, item = item->next)
+    {
+      if (item != key)
+        continue;
+
+     /*
+      * Found it, dereference...
+      */
 
 #ifdef DEBUG_GUARDS
-    if (key->guard != _CUPS_STR_GUARD)
-    {
-      DEBUG_printf(("5_cupsStrFree: Freeing string %p(%s), guard=%08x, ref_count=%d", key, key->str, key->guard, key->ref_count));
-      abort();
-    }
+      if (key->guard != _CUPS_STR_GUARD)
+      {
+        DEBUG_printf(("5_cupsStrFree: Freeing string %p(%s), guard=%08x, ref_count=%d", key, key->str, key->guard, key->ref_count));
+        abort();
+      }
 #endif /* DEBUG_GUARDS */
 
-    item->ref_count --;
+      item->ref_count --;
 
-    if (!item->ref_count)
-    {
-     /*
-      * Remove and free...
-      */
+      if (!item->ref_count)
+      {
+       /*
+        * Remove and free...
+        */
 
-      cupsArrayRemove(stringpool, item);
+        *prev = item->next;
+        shard->num_items --;
 
-      free(item);
+        free(item);
+      }
+      break;
     }
   }
 
-  cupsMutexUnlock(&sp_mutex);
+  cupsMutexUnlock(&shard->mutex);
 }
 
 
@@ -421,11 +433,11 @@ _cupsStrRetain(const char *s)		/* I - String to retain */
     }
 #endif /* DEBUG_GUARDS */
 
-    cupsMutexLock(&sp_mutex);
+    cupsMutexLock(&sp_shards[item->hash & (_CUPS_STR_SHARDS - 1)].mutex);
 
     item->ref_count ++;
 
-    cupsMutexUnlock(&sp_mutex);
+    cupsMutexUnlock(&sp_shards[item->hash & (_CUPS_STR_SHARDS - 1)].mutex);
   }
 
   return ((char *)s);
@@ -571,42 +583,93 @@ _cupsStrScand(const char   *buf,	/* I - Pointer to number */
 
 
 /*
- * '_cupsStrStatistics()' - Return allocation statistics for string pool.
+ * '_cupsStrSeed()' - Add constant strings to the string pool.
+ *
+ * The strings are added with a reference held by the pool so that they stay
+ * allocated until the pool is flushed.
+ */
+
+void
+_cupsStrSeed(cups_array_t *strings)	/* I - Array of strings */
+{
+  const char		*s;		/* Current string */
+  unsigned		hash;		/* Hash of string */
+  _cups_sp_shard_t	*shard;		/* String pool shard */
+  _cups_sp_item_t	*item;		/* String pool item */
+
+
+  for (s = (const char *)cupsArrayGetFirst(strings); s; s = (const char *)cupsArrayGetNext(strings))
+  {
+    hash  = sp_hash(s);
+    shard = sp_shards + (hash & (_CUPS_STR_SHARDS - 1));
+
+    cupsMutexLock(&shard->mutex);
+
+    if ((item = sp_find(shard, s, hash)) != NULL)
+      item->ref_count ++;
+    else
+      sp_add(shard, s, hash);
+
+    cupsMutexUnlock(&shard->mutex);
+  }
+}
+
+
+/*
+ * '_cupsStrShardStatistics()' - Return allocation statistics for a string pool
+ *                               shard.
  */
 
 size_t					/* O - Number of strings */
-_cupsStrStatistics(size_t *alloc_bytes,	/* O - Allocated bytes */
-                   size_t *total_bytes)	/* O - Total string bytes */
+_cupsStrShardStatistics(
+    size_t shard,			/* I - Shard number (0 to _CUPS_STR_SHARDS - 1) */
+    size_t *alloc_bytes,		/* O - Allocated bytes */
+    size_t *total_bytes)		/* O - Total string bytes */
 {
   size_t		count,		/* Number of strings */
 			abytes,		/* Allocated string bytes */
 			tbytes,		/* Total string bytes */
 			len;		/* Length of string */
-  _cups_sp_item_t	*item;		/* Current item */
+  _cups_sp_shard_t	*sp;		/* String pool shard */
+  _cups_sp_item_t	**bucket,	/* Current bucket */
+			*item;		/* Current item */
 
 
+  if (alloc_bytes)
+    *alloc_bytes = 0;
+
+  if (total_bytes)
+    *total_bytes = 0;
+
+  if (shard >= _CUPS_STR_SHARDS)
+    return (0);
+
  /*
-  * Loop through strings in pool, counting everything up...
+  * Loop through strings in the shard, counting everything up...
   */
 
-  cupsMutexLock(&sp_mutex);
+  sp = sp_shards + shard;
 
-  for (count = 0, abytes = 0, tbytes = 0,
-           item = (_cups_sp_item_t *)cupsArrayGetFirst(stringpool);
-       item;
-       item = (_cups_sp_item_t *)cupsArrayGetNext(stringpool))
+  cupsMutexLock(&sp->mutex);
+
+  for (count = 0, abytes = 0, tbytes = 0, bucket = sp->buckets; bucket && bucket < (sp->buckets + sp->num_buckets); bucket ++)
   {
-   /*
-    * Count allocated memory, using a 64-bit aligned buffer as a basis.
-    */
+    for (item = *bucket; item; item = item->next)
+    {
+     /*
+      * Count allocated memory, using a 64-bit aligned buffer as a basis.
+      */
 
-    count  += item->ref_count;
-    len    = (strlen(item->str) + 8) & (size_t)~7;
-    abytes += sizeof(_cups_sp_item_t) + len;
-    tbytes += item->ref_count * len;
+      count  += item->ref_count;
+      len    = (strlen(item->str) + 8) & (size_t)~7;
+      abytes += sizeof(_cups_sp_item_t) + len;
+      tbytes += item->ref_count * len;
+    }
   }
 
-  cupsMutexUnlock(&sp_mutex);
+  abytes += sp->num_buckets * sizeof(_cups_sp_item_t *);
+
+  cupsMutexUnlock(&sp->mutex);
 
  /*
   * Return values...
@@ -622,6 +685,42 @@ _cupsStrStatistics(size_t *alloc_bytes,	/* O - Allocated bytes */
 }
 
 
+/*
+ * '_cupsStrStatistics()' - Return allocation statistics for string pool.
+ *
+ * The returned values are the sum of @code _cupsStrShardStatistics@ for all
+ * shards.  The count includes the strings added by @code _cupsStrSeed@.
+ */
+
+size_t					/* O - Number of strings */
+_cupsStrStatistics(size_t *alloc_bytes,	/* O - Allocated bytes */
+                   size_t *total_bytes)	/* O - Total string bytes */
+{
+  size_t	i,			/* Looping var */
+		count,			/* Number of strings */
+		abytes,			/* Allocated string bytes */
+		tbytes,			/* Total string bytes */
+		sabytes,		/* Allocated bytes for shard */
+		stbytes;		/* Total bytes for shard */
+
+
+  for (i = 0, count = 0, abytes = 0, tbytes = 0; i < _CUPS_STR_SHARDS; i ++)
+  {
+    count  += _cupsStrShardStatistics(i, &sabytes, &stbytes);
+    abytes += sabytes;
+    tbytes += stbytes;
+  }
+
+  if (alloc_bytes)
+    *alloc_bytes = abytes;
+
+  if (total_bytes)
+    *total_bytes = tbytes;
+
+  return (count);
+}
+
+
 /*
  * '_cups_strcpy()' - Copy a string allowing for overlapping strings.
  */
@@ -697,12 +796,133 @@ _cups_strncasecmp(const char *s,	/* I - First string */
 
 
 /*
- * 'compare_sp_items()' - Compare two string pool items...
+ * 'sp_add()' - Add a new string to a shard.
+ *
+ * The shard mutex must be held by the caller.
+ */
+
+static _cups_sp_item_t *		/* O - New item or `NULL` on error */
+sp_add(_cups_sp_shard_t *shard,		/* I - String pool shard */
+       const char       *s,		/* I - String */
+       unsigned         hash)		/* I - Hash of string */
+{
+  size_t		slen,		/* Length of string */
+			num_buckets;	/* New number of buckets */
+  _cups_sp_item_t	**buckets,	/* New buckets */
+			**bucket,	/* Current bucket */
+			*item,		/* Current item */
+			*next;		/* Next item */
+
+
+ /*
+  * Grow the hash table as needed to keep the chains short...
+  */
+
+  if (shard->num_items >= 2 * shard->num_buckets)
+  {
+    num_buckets = shard->num_buckets ? 2 * shard->num_buckets : 64;
+
+    if ((buckets = (_cups_sp_item_t **)calloc(num_buckets, sizeof(_cups_sp_item_t *))) != NULL)
+    {
+      if (shard->buckets)
+      {
+        for (bucket = shard->buckets; bucket < (shard->buckets + shard->num_buckets); bucket ++)
+        {
+          for (item = *bucket; item; item = next)
+          {
+            next = item->next;
+            item->next = buckets[(item->hash / _CUPS_STR_SHARDS) & (num_buckets - 1)];
+            buckets[(item->hash / _CUPS_STR_SHARDS) & (num_buckets - 1)] = item;
+          }
+        }
+
+        free(shard->buckets);
+      }
+
+      shard->buckets     = buckets;
+      shard->num_buckets = num_buckets;
+    }
+    else if (!shard->buckets)
+    {
+      return (NULL);
+    }
+  }
+
+ /*
+  * Allocate the new item...
+  */
+
+  slen = strlen(s);
+  if ((item = (_cups_sp_item_t *)calloc(1, sizeof(_cups_sp_item_t) + slen)) == NULL)
+    return (NULL);
+
+  item->hash      = hash;
+  item->ref_count = 1;
+  memcpy(item->str, s, slen + 1);
+
+#ifdef DEBUG_GUARDS
+  item->guard = _CUPS_STR_GUARD;
+
+  DEBUG_printf(("5sp_add: Created string %p(%s) for \"%s\", guard=%08x, ref_count=%d", item, item->str, s, item->guard, item->ref_count));
+#endif /* DEBUG_GUARDS */
+
+ /*
+  * Add the item to the shard and return it...
+  */
+
+  bucket     = shard->buckets + ((hash / _CUPS_STR_SHARDS) & (shard->num_buckets - 1));
+  item->next = *bucket;
+  *bucket    = item;
+
+  shard->num_items ++;
+
+  return (item);
+}
+
+
+/*
+ * 'sp_find()' - Find a string in a shard.
+ *
+ * The shard mutex must be held by the caller.
  */
 
-static int				/* O - Result of comparison */
-compare_sp_items(_cups_sp_item_t *a,	/* I - First item */
-                 _cups_sp_item_t *b)	/* I - Second item */
+static _cups_sp_item_t *		/* O - Matching item or `NULL` */
+sp_find(_cups_sp_shard_t *shard,	/* I - String pool shard */
+        const char       *s,		/* I - String */
+        unsigned         hash)		/* I - Hash of string */
 {
-  return (strcmp(a->str, b->str));
+  _cups_sp_item_t	*item;		/* Current item */
+
+
+  if (!shard->buckets)
+    return (NULL);
+
+  for (item = shard->buckets[(hash / _CUPS_STR_SHARDS) & (shard->num_buckets - 1)]; item; item = item->next)
+  {
+    if (item->hash == hash && !strcmp(item->str, s))
+      return (item);
+  }
+
+  return (NULL);
 }
+
+
+/*
+ * 'sp_hash()' - Compute the FNV-1a hash of a string.
+ */
+
+static unsigned				/* O - Hash value */
+sp_hash(const char *s)			/* I - String */
+{
+  unsigned	hash = 2166136261U;	/* Hash value */
+
+
+  while (*s)
+  {
+    hash ^= (unsigned char)*s++;
+    hash *= 16777619U;
+  }
+
+  return (hash);
+}
+
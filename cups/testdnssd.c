@@ -50,8 +50,10 @@ int					// O - Exit status
 main(int  argc,				// I - Number of command-line arguments
      char *argv[])			// I - Command-line arguments
 {
-  int			i,		// Looping var
-			ret = 0;	// Return value
+  int			ret = 0;	// Return value
+  size_t		events;		// Number of callbacks delivered
+  time_t		endtime;	// End time for callbacks
+  bool			got_all;	// Got all callbacks?
   cups_dnssd_t		*dnssd;		// DNS-SD context
   cups_dnssd_browse_t	*browse;	// DNS-SD browse request
 //  cups_dnssd_query_t	*query;		// DNS-SD query request
@@ -178,17 +180,17 @@ main(int  argc,				// I - Number of command-line arguments
 
     testBegin("Wait for callbacks");
 
-    for (i = 0; i < 30; i ++)
+    for (events = 0, endtime = time(NULL) + 30;;)
     {
-      if (testdata.service_count != 0 && testdata.browse_dnssd_count != 0 && testdata.browse_ipp_count != 0 && testdata.resolve_count != 0)
+      if ((got_all = testdata.service_count != 0 && testdata.browse_dnssd_count != 0 && testdata.browse_ipp_count != 0 && testdata.resolve_count != 0) == true || time(NULL) >= endtime)
         break;
 
       testProgress();
-      sleep(1);
+      events = cupsDNSSDWait(dnssd, events, 1000);
     }
 
-    testEndMessage(i < 30, "Bdnssd=%u Bipp=%u Q=%u R=%u S=%u", (unsigned)testdata.browse_dnssd_count, (unsigned)testdata.browse_ipp_count, (unsigned)testdata.query_count, (unsigned)testdata.resolve_count, (unsigned)testdata.service_count);
-    if (i >= 30)
+    testEndMessage(got_all, "Bdnssd=%u Bipp=%u Q=%u R=%u S=%u", (unsigned)testdata.browse_dnssd_count, (unsigned)testdata.browse_ipp_count, (unsigned)testdata.query_count, (unsigned)testdata.resolve_count, (unsigned)testdata.service_count);
+    if (!got_all)
       ret = 1;
 
     done:
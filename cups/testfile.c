@@ -35,7 +35,7 @@
 
 static int	count_lines(cups_file_t *fp);
 static int	random_tests(void);
-static int	read_write_tests(bool compression);
+static int	read_write_tests(bool compression, int threads);
 
 
 /*
@@ -63,13 +63,19 @@ main(int  argc,				/* I - Number of command-line arguments */
     * Do uncompressed file tests...
     */
 
-    status = read_write_tests(false);
+    status = read_write_tests(false, 0);
 
    /*
     * Do compressed file tests...
     */
 
-    status += read_write_tests(true);
+    status += read_write_tests(true, 0);
+
+   /*
+    * Do compressed file tests with compression threads...
+    */
+
+    status += read_write_tests(true, 4);
 
    /*
     * Do uncompressed random I/O tests...
@@ -364,7 +370,8 @@ random_tests(void)
 
  /*
   * Run 4 passes, each time appending to a data file and then reopening the
-  * file for reading to validate random records in the file.
+  * file for reading to validate random records in the file.  Odd passes map
+  * the file into memory.
   */
 
   for (status = 0, pass = 0; pass < 4; pass ++)
@@ -453,9 +460,9 @@ random_tests(void)
     * cupsFileOpen(read)
     */
 
-    testBegin("cupsFileOpen(read %d)", pass);
+    testBegin("cupsFileOpen(read%s %d)", (pass & 1) ? " mapped" : "", pass);
 
-    if ((fp = cupsFileOpen("testfile.dat", "r")) == NULL)
+    if ((fp = cupsFileOpen("testfile.dat", (pass & 1) ? "rm" : "r")) == NULL)
     {
       testEndMessage(false, "%s", strerror(errno));
       status ++;
@@ -541,7 +548,8 @@ random_tests(void)
  */
 
 static int				/* O - Status */
-read_write_tests(bool compression)	/* I - Use compression? */
+read_write_tests(bool compression,	/* I - Use compression? */
+                 int  threads)		/* I - Number of compression threads */
 {
   int		i, j;			/* Looping vars */
   cups_file_t	*fp;			/* File */
@@ -658,6 +666,41 @@ read_write_tests(bool compression)	/* I - Use compression? */
       status ++;
     }
 
+    if (threads > 0)
+    {
+     /*
+      * cupsFileSetBufferSize()
+      */
+
+      testBegin("cupsFileSetBufferSize(65536)");
+
+      if (cupsFileSetBufferSize(fp, 65536))
+      {
+        testEnd(true);
+      }
+      else
+      {
+	testEndMessage(false, "%s", strerror(errno));
+	status ++;
+      }
+
+     /*
+      * cupsFileSetThreads()
+      */
+
+      testBegin("cupsFileSetThreads(%d)", threads);
+
+      if (cupsFileSetThreads(fp, threads))
+      {
+        testEnd(true);
+      }
+      else
+      {
+	testEndMessage(false, "%s", strerror(errno));
+	status ++;
+      }
+    }
+
    /*
     * cupsFileWrite()
     */
@@ -745,6 +788,25 @@ read_write_tests(bool compression)	/* I - Use compression? */
   {
     testEnd(true);
 
+    if (threads > 0)
+    {
+     /*
+      * cupsFileSetBufferSize()
+      */
+
+      testBegin("cupsFileSetBufferSize(65536)");
+
+      if (cupsFileSetBufferSize(fp, 65536))
+      {
+        testEnd(true);
+      }
+      else
+      {
+	testEndMessage(false, "%s", strerror(errno));
+	status ++;
+      }
+    }
+
    /*
     * cupsFileGets()
     */
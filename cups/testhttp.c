@@ -15,6 +15,14 @@
 
 #include "cups-private.h"
 #include "test-internal.h"
+#include <sys/stat.h>
+
+
+/*
+ * Local constants...
+ */
+
+#define _CUPS_GET_TEST_CHUNK	1048576	/* Size of parallel range requests */
 
 
 /*
@@ -34,6 +42,38 @@ typedef struct uri_test_s		/**** URI test cases ****/
   http_uri_coding_t	assemble_coding;/* Coding for httpAssembleURI() */
 } uri_test_t;
 
+typedef struct async_test_s		/**** httpAddrGetListAsync test data ****/
+{
+  cups_mutex_t		mutex;		/* Mutex for data */
+  cups_cond_t		cond;		/* Condition for completion */
+  bool			done;		/* Lookup done? */
+  http_addrlist_t	*addrlist;	/* Addresses */
+} async_test_t;
+
+typedef struct range_test_s		/**** cupsGetFdRange test data ****/
+{
+  cups_mutex_t		mutex;		/* Mutex for data */
+  int			fd;		/* Listen socket */
+  bool			stop,		/* Stop the server? */
+			tls,		/* Require TLS? */
+			post_close;	/* Close the connection after a POST? */
+  int			drops,		/* Number of responses to drop */
+			requests,	/* Number of requests */
+			config_time;	/* printer-config-change-time value */
+  char			*data;		/* Resource data */
+  size_t		length;		/* Length of resource data */
+  char			*put;		/* PUT data */
+  size_t		put_length;	/* Length of PUT data */
+  size_t		num_clients;	/* Number of client threads */
+  cups_thread_t		clients[32];	/* Client threads */
+} range_test_t;
+
+typedef struct range_client_s		/**** cupsGetFdRange client data ****/
+{
+  range_test_t		*test;		/* Test data */
+  http_t		*http;		/* Client connection */
+} range_client_t;
+
 
 /*
  * Local globals...
@@ -210,6 +250,22 @@ static const char * const base64_tests[][2] =
 			};
 
 
+/*
+ * Local functions...
+ */
+
+static int	arena_test(http_t *http);
+static void	async_cb(async_test_t *data, http_addrlist_t *addrlist);
+static int	dest_cache_test(http_t *http, range_test_t *test, int port);
+static int	post_test(http_t *http, range_test_t *test);
+static void	*range_client(range_client_t *client);
+static void	*range_server(range_test_t *test);
+static int	range_test(http_t *http, range_test_t *test, off_t offset, off_t length, size_t num_connections);
+static int	read_buffer_test(http_t *http, range_test_t *test, const char *resource);
+static int	stats_test(http_t *http);
+static int	write_fd_test(http_t *http, range_test_t *test);
+
+
 /*
  * 'main()' - Main entry.
  */
@@ -430,6 +486,110 @@ main(int  argc,				/* I - Number of command-line arguments */
       testEnd(false);
     }
 
+   /*
+    * httpAddrGetList() cache
+    */
+
+    testBegin("httpAddrGetList(%s) cached", hostname);
+
+    if ((addrlist = httpAddrGetList(hostname, AF_UNSPEC, NULL)) != NULL)
+    {
+      http_addrlist_t	*cached;	/* Cached addresses */
+      int		count;		/* Number of addresses */
+
+
+      for (count = 0, addr = addrlist; addr; count ++, addr = addr->next);
+
+      cached = httpAddrGetList(hostname, AF_UNSPEC, NULL);
+
+      for (i = 0, addr = cached; addr; i ++, addr = addr->next);
+
+      if (i != count)
+      {
+        failures ++;
+        testEndMessage(false, "%d address(es) instead of %d", i, count);
+      }
+      else if (cached == addrlist)
+      {
+        failures ++;
+        testEndMessage(false, "same list returned twice");
+      }
+      else
+        testEnd(true);
+
+      httpAddrFreeList(addrlist);
+      httpAddrFreeList(cached);
+    }
+    else
+      testEndMessage(false, "ignored because lookup failed");
+
+    testBegin("httpAddrGetList(nonexistent.invalid)");
+
+    if ((addrlist = httpAddrGetList("nonexistent.invalid", AF_UNSPEC, NULL)) != NULL)
+    {
+      failures ++;
+      testEndMessage(false, "got addresses for invalid name");
+      httpAddrFreeList(addrlist);
+    }
+    else if ((addrlist = httpAddrGetList("nonexistent.invalid", AF_UNSPEC, NULL)) != NULL)
+    {
+      failures ++;
+      testEndMessage(false, "got addresses for invalid name on second lookup");
+      httpAddrFreeList(addrlist);
+    }
+    else
+      testEndMessage(true, "%s", cupsLastErrorString());
+
+    httpAddrClearCache("nonexistent.invalid");
+
+   /*
+    * httpAddrGetListAsync()
+    */
+
+    testBegin("httpAddrGetListAsync(localhost)");
+
+    {
+      async_test_t	data;		/* Callback data */
+
+
+      memset(&data, 0, sizeof(data));
+      cupsMutexInit(&data.mutex);
+      cupsCondInit(&data.cond);
+
+      httpAddrClearCache(NULL);
+
+      if (!httpAddrGetListAsync("localhost", AF_UNSPEC, "631", (http_addrlist_cb_t)async_cb, &data))
+      {
+        failures ++;
+        testEndMessage(false, "%s", cupsLastErrorString());
+      }
+      else
+      {
+        cupsMutexLock(&data.mutex);
+        for (i = 0; i < 30 && !data.done; i ++)
+          cupsCondWait(&data.cond, &data.mutex, 1.0);
+        cupsMutexUnlock(&data.mutex);
+
+        if (!data.done)
+        {
+          failures ++;
+          testEndMessage(false, "timed out");
+        }
+        else if (!data.addrlist)
+        {
+          failures ++;
+          testEndMessage(false, "no addresses");
+        }
+        else
+          testEnd(true);
+
+        httpAddrFreeList(data.addrlist);
+      }
+
+      cupsCondDestroy(&data.cond);
+      cupsMutexDestroy(&data.mutex);
+    }
+
    /*
     * Test httpSeparateURI()...
     */
@@ -529,419 +689,1692 @@ main(int  argc,				/* I - Number of command-line arguments */
     else
       testEndMessage(true, "%s", buffer);
 
-    return (failures);
-  }
-  else if (strstr(argv[1], "._tcp"))
-  {
    /*
-    * Test resolving an mDNS name.
+    * httpAddrConnect()
     */
 
-    char	resolved[1024];		/* Resolved URI */
+    testBegin("httpAddrConnect(unreachable, 127.0.0.1)");
 
+    if ((addrlist = httpAddrGetList("127.0.0.1", AF_INET, "0")) != NULL)
+    {
+      int		lfd = -1,	/* Listen socket */
+			sock;		/* Connected socket */
+      char		portstr[32];	/* Port number string */
+      http_addrlist_t	*connlist,	/* List of addresses to connect to */
+			*connaddr;	/* Connected address */
+      struct timeval	start,		/* Start time */
+			end;		/* End time */
+      int		elapsed;	/* Elapsed time in milliseconds */
+
+      for (port = 18731; port < 18831; port ++)
+      {
+        if ((lfd = httpAddrListen(&addrlist->addr, port)) >= 0)
+          break;
+      }
 
-    testBegin("httpResolveURI(%s, HTTP_RESOLVE_DEFAULT)", argv[1]);
+     /*
+      * The first address is a non-routable address that never answers...
+      */
 
-    if (!httpResolveURI(argv[1], resolved, sizeof(resolved), HTTP_RESOLVE_DEFAULT, NULL, NULL))
-    {
-      testEnd(false);
-      return (1);
-    }
-    else
-      testEndMessage(true, "%s", resolved);
+      snprintf(portstr, sizeof(portstr), "%d", port);
+      connlist = httpAddrGetList("10.255.255.1", AF_INET, portstr);
+      if (connlist)
+      {
+        connlist->next = httpAddrCopyList(addrlist);
+        httpAddrSetPort(&connlist->next->addr, port);
+      }
 
-    testBegin("httpResolveURI(%s, HTTP_RESOLVE_FQDN)", argv[1]);
+      httpAddrSetConnectDelay(500);
 
-    if (!httpResolveURI(argv[1], resolved, sizeof(resolved), HTTP_RESOLVE_FQDN, NULL, NULL))
-    {
-      testEnd(false);
-      return (1);
-    }
-    else if (strstr(resolved, ".local:"))
-    {
-      testEndMessage(false, "%s", resolved);
-      return (1);
-    }
-    else
-    {
-      testEndMessage(true, "%s", resolved);
-      return (0);
-    }
-  }
-  else if (!strcmp(argv[1], "-d") && argc == 3)
-  {
-    // Test httpDecode64
-    size_t	bufsize = sizeof(buffer);
-					// Output size
+      if (lfd < 0 || !connlist)
+      {
+        failures ++;
+        testEndMessage(false, "unable to listen on loopback");
+      }
+      else if ((connaddr = httpAddrConnect(connlist, &sock, 5000, NULL)) != connlist->next)
+      {
+        failures ++;
+        testEndMessage(false, "got %p, expected %p: %s", (void *)connaddr, (void *)connlist->next, cupsLastErrorString());
 
-    if (httpDecode64(buffer, &bufsize, argv[2], NULL))
-    {
-      fwrite(buffer, 1, bufsize, stdout);
-      return (0);
-    }
+        if (connaddr)
+          httpAddrClose(NULL, sock);
+      }
+      else
+      {
+        testEnd(true);
+        httpAddrClose(NULL, sock);
 
-    return (1);
-  }
-  else if (!strcmp(argv[1], "-e") && argc == 3)
-  {
-    // Test httpEncode64 for Base64
-    if (httpEncode64(buffer, sizeof(buffer), argv[2], strlen(argv[2]), false))
-    {
-      puts(buffer);
-      return (0);
-    }
+       /*
+        * The next connection should try the loopback address first...
+        */
 
-    return (1);
-  }
-  else if (!strcmp(argv[1], "-E") && argc == 3)
-  {
-    // Test httpEncode64 for Base64url
-    if (httpEncode64(buffer, sizeof(buffer), argv[2], strlen(argv[2]), true))
-    {
-      puts(buffer);
-      return (0);
-    }
+        testBegin("httpAddrConnect(unreachable, 127.0.0.1) again");
 
-    return (1);
-  }
-  else if (!strcmp(argv[1], "-u") && argc == 3)
-  {
-   /*
-    * Test URI separation...
-    */
+        gettimeofday(&start, NULL);
+        connaddr = httpAddrConnect(connlist, &sock, 5000, NULL);
+        gettimeofday(&end, NULL);
 
-    uri_status = httpSeparateURI(HTTP_URI_CODING_ALL, argv[2], scheme, sizeof(scheme), username, sizeof(username), hostname, sizeof(hostname), &port, resource, sizeof(resource));
-    printf("uri_status = %s\n", uri_status_strings[uri_status + 8]);
-    printf("scheme     = \"%s\"\n", scheme);
-    printf("username   = \"%s\"\n", username);
-    printf("hostname   = \"%s\"\n", hostname);
-    printf("port       = %d\n", port);
-    printf("resource   = \"%s\"\n", resource);
+        elapsed = (int)((end.tv_sec - start.tv_sec) * 1000 + (end.tv_usec - start.tv_usec) / 1000);
 
-    return (0);
-  }
+        if (connaddr != connlist->next)
+        {
+          failures ++;
+          testEndMessage(false, "got %p, expected %p: %s", (void *)connaddr, (void *)connlist->next, cupsLastErrorString());
+        }
+        else if (elapsed >= 250)
+        {
+          failures ++;
+          testEndMessage(false, "took %dms", elapsed);
+        }
+        else
+          testEndMessage(true, "%dms", elapsed);
 
- /*
-  * Test HTTP GET requests...
-  */
+        if (connaddr)
+          httpAddrClose(NULL, sock);
+      }
 
-  http = NULL;
-  out = stdout;
+      httpAddrSetConnectDelay(0);
 
-  for (i = 1; i < argc; i ++)
-  {
-    int new_auth;
+      if (lfd >= 0)
+        httpAddrClose(&addrlist->addr, lfd);
 
-    if (!strcmp(argv[i], "-o"))
+      httpAddrFreeList(connlist);
+      httpAddrFreeList(addrlist);
+    }
+    else
     {
-      i ++;
-      if (i >= argc)
-        break;
-
-      out = fopen(argv[i], "wb");
-      continue;
+      failures ++;
+      testEndMessage(false, "unable to lookup 127.0.0.1");
     }
 
-    httpSeparateURI(HTTP_URI_CODING_MOST, argv[i], scheme, sizeof(scheme),
-                    username, sizeof(username),
-                    hostname, sizeof(hostname), &port,
-		    resource, sizeof(resource));
+   /*
+    * cupsGetFdRange()
+    */
 
-    if (!_cups_strcasecmp(scheme, "https") || !_cups_strcasecmp(scheme, "ipps") ||
-        port == 443)
-      encryption = HTTP_ENCRYPTION_ALWAYS;
-    else
-      encryption = HTTP_ENCRYPTION_IF_REQUESTED;
+    testBegin("cupsGetFdRange()");
 
-    http = httpConnect(hostname, port, NULL, AF_UNSPEC, encryption, 1, 30000, NULL);
-    if (http == NULL)
+    if ((addrlist = httpAddrGetList("127.0.0.1", AF_INET, "0")) != NULL)
     {
-      perror(hostname);
-      continue;
-    }
+      range_test_t	test;		/* Test data */
+      cups_thread_t	server;		/* Server thread */
+      http_t		*rhttp;		/* Client connection */
+      int		fd;		/* Temporary file */
+      char		filename[1024];	/* Temporary filename */
 
-    if (httpIsEncrypted(http))
-    {
-      cups_array_t *creds;
-      char info[1024], expstr[256];
-      static const char *trusts[] = { "OK", "Invalid", "Changed", "Expired", "Renewed", "Unknown" };
-      if (!httpCopyCredentials(http, &creds))
-      {
-	cups_array_t *lcreds;
-        http_trust_t trust = httpCredentialsGetTrust(creds, hostname);
 
-        httpCredentialsString(creds, info, sizeof(info));
+      memset(&test, 0, sizeof(test));
+      cupsMutexInit(&test.mutex);
 
-	printf("Count: %u\n", (unsigned)cupsArrayGetCount(creds));
-        printf("Trust: %s\n", trusts[trust]);
-        printf("Expiration: %s\n", httpGetDateString(httpCredentialsGetExpiration(creds), expstr, sizeof(expstr)));
-        printf("IsValidName: %d\n", httpCredentialsAreValidForName(creds, hostname));
-        printf("String: \"%s\"\n", info);
+      test.length = 3 * _CUPS_GET_TEST_CHUNK + 12345;
+      test.data   = malloc(test.length);
+      test.put    = malloc(test.length);
 
-	printf("LoadCredentials: %s\n", httpLoadCredentials(NULL, &lcreds, hostname) ? "true" : "false");
-	httpCredentialsString(lcreds, info, sizeof(info));
-	printf("    Count: %u\n", (unsigned)cupsArrayGetCount(lcreds));
-	printf("    String: \"%s\"\n", info);
+      for (i = 0; i < (int)test.length; i ++)
+        test.data[i] = (char)(i ^ (i >> 8) ^ (i >> 16));
 
-        if (lcreds && cupsArrayGetCount(creds) == cupsArrayGetCount(lcreds))
+      for (port = 18631; port < 18731; port ++)
+      {
+        if ((test.fd = httpAddrListen(&addrlist->addr, port)) >= 0)
+          break;
+      }
+
+      if (test.fd < 0)
+      {
+        failures ++;
+        testEndMessage(false, "unable to listen on loopback");
+      }
+      else if ((server = cupsThreadCreate((cups_thread_func_t)range_server, &test)) == CUPS_THREAD_INVALID)
+      {
+        failures ++;
+        testEndMessage(false, "unable to create server thread");
+      }
+      else
+      {
+        if ((rhttp = httpConnect("127.0.0.1", port, NULL, AF_INET, HTTP_ENCRYPTION_IF_REQUESTED, true, 30000, NULL)) == NULL)
         {
-          http_credential_t	*cred, *lcred;
+          failures ++;
+          testEndMessage(false, "unable to connect: %s", cupsLastErrorString());
+        }
+        else
+        {
+          testEnd(true);
 
-          for (i = 1, cred = (http_credential_t *)cupsArrayGetFirst(creds), lcred = (http_credential_t *)cupsArrayGetFirst(lcreds);
-               cred && lcred;
-               i ++, cred = (http_credential_t *)cupsArrayGetNext(creds), lcred = (http_credential_t *)cupsArrayGetNext(lcreds))
+          testBegin("cupsGetFdRange(all)");
+          failures += range_test(rhttp, &test, 0, 0, 1);
+
+          testBegin("cupsGetFdRange(offset=1000, length=500000, dropped)");
+          test.drops = 1;
+          failures += range_test(rhttp, &test, 1000, 500000, 1);
+
+          testBegin("cupsGetFdRange(offset=100, 4 connections)");
+          failures += range_test(rhttp, &test, 100, 0, 4);
+
+          testBegin("cupsGetFdRange(offset=0, 4 connections, dropped)");
+          test.drops = 2;
+          failures += range_test(rhttp, &test, 0, 0, 4);
+
+          testBegin("cupsPutFd()");
+
+          if ((fd = cupsTempFd(NULL, NULL, filename, sizeof(filename))) < 0)
           {
-            if (cred->datalen != lcred->datalen)
-              printf("    Credential #%d: Different lengths (saved=%d, current=%d)\n", i, (int)cred->datalen, (int)lcred->datalen);
-            else if (memcmp(cred->data, lcred->data, cred->datalen))
-              printf("    Credential #%d: Different data\n", i);
+            failures ++;
+            testEndMessage(false, "unable to create temporary file: %s", strerror(errno));
+          }
+          else
+          {
+            if (write(fd, test.data, test.length) != (ssize_t)test.length)
+            {
+              failures ++;
+              testEndMessage(false, "unable to write temporary file: %s", strerror(errno));
+            }
+            else if ((status = cupsPutFd(rhttp, "/put", fd)) != HTTP_STATUS_CREATED)
+            {
+              failures ++;
+              testEndMessage(false, "%s", httpStatusString(status));
+            }
+            else if (test.put_length != test.length || memcmp(test.put, test.data, test.length))
+            {
+              failures ++;
+              testEndMessage(false, "got %u bytes, expected %u", (unsigned)test.put_length, (unsigned)test.length);
+            }
             else
-              printf("    Credential #%d: Matches\n", i);
+              testEnd(true);
+
+            close(fd);
+            unlink(filename);
           }
+
+          testBegin("httpReadBuffer(Content-Length)");
+          failures += read_buffer_test(rhttp, &test, "/test");
+
+          testBegin("httpReadBuffer(chunked)");
+          failures += read_buffer_test(rhttp, &test, "/chunked");
+
+          testBegin("cupsDoRequest(server closed keep-alive)");
+          failures += post_test(rhttp, &test);
+
+          testBegin("cupsCopyDestInfo(cached)");
+          failures += dest_cache_test(rhttp, &test, port);
+
+          testBegin("cupsGetStatistics(loopback)");
+          failures += stats_test(rhttp);
+
+          testBegin("cupsSetResponseArena");
+          failures += arena_test(rhttp);
+
+          testBegin("cupsWriteRequestFd(Content-Length)");
+          failures += write_fd_test(rhttp, &test);
+
+          httpClose(rhttp);
         }
 
-        if (trust != HTTP_TRUST_OK)
-	{
-	  printf("SaveCredentials: %s\n", httpSaveCredentials(NULL, creds, hostname) ? "true" : "false");
-	  trust = httpCredentialsGetTrust(creds, hostname);
-	  printf("New Trust: %s\n", trusts[trust]);
-	}
+       /*
+        * Wake up the server thread so it can stop...
+        */
 
-        httpFreeCredentials(creds);
+        cupsMutexLock(&test.mutex);
+        test.stop = true;
+        cupsMutexUnlock(&test.mutex);
+
+        httpClose(httpConnect("127.0.0.1", port, NULL, AF_INET, HTTP_ENCRYPTION_IF_REQUESTED, true, 1000, NULL));
+        cupsThreadWait(server);
       }
-      else
-        puts("No credentials!");
+
+      if (test.fd >= 0)
+        httpAddrClose(&addrlist->addr, test.fd);
+
+      free(test.data);
+      free(test.put);
+      cupsMutexDestroy(&test.mutex);
+      httpAddrFreeList(addrlist);
+    }
+    else
+    {
+      failures ++;
+      testEndMessage(false, "unable to lookup 127.0.0.1");
     }
 
-    printf("Checking file \"%s\"...\n", resource);
+   /*
+    * httpPoolGet()/httpPoolPut()
+    */
 
-    new_auth = 0;
+    testBegin("httpPoolGet()/httpPoolPut()");
 
-    do
+    if ((addrlist = httpAddrGetList("127.0.0.1", AF_INET, "0")) != NULL)
     {
-      if (!_cups_strcasecmp(httpGetField(http, HTTP_FIELD_CONNECTION), "close"))
+      int		lfd = -1;	/* Listen socket */
+      http_pool_t	*pool;		/* Connection pool */
+      http_t		*http1,		/* First connection */
+			*http2,		/* Second connection */
+			*http3;		/* Third connection */
+
+      for (port = 18631; port < 18731; port ++)
       {
-	httpClearFields(http);
-	if (!httpReconnect(http, 30000, NULL))
-	{
-          status = HTTP_STATUS_ERROR;
+        if ((lfd = httpAddrListen(&addrlist->addr, port)) >= 0)
           break;
-	}
       }
 
-      if (http->authstring && !strncmp(http->authstring, "Digest ", 7) && !new_auth)
-        _httpSetDigestAuthString(http, http->nextnonce, "HEAD", resource);
-
-      httpClearFields(http);
-      httpSetField(http, HTTP_FIELD_AUTHORIZATION, httpGetAuthString(http));
-      httpSetField(http, HTTP_FIELD_ACCEPT_LANGUAGE, "en");
-
-      if (httpWriteRequest(http, "HEAD", resource))
+      if (lfd < 0)
       {
-        if (httpReconnect(http, 30000, NULL))
+        failures ++;
+        testEndMessage(false, "unable to listen on loopback");
+      }
+      else
+      {
+        pool  = httpPoolNew(2, 30);
+        http1 = httpPoolGet(pool, "127.0.0.1", port, HTTP_ENCRYPTION_IF_REQUESTED, 1000, NULL);
+        http2 = httpPoolGet(pool, "127.0.0.1", port, HTTP_ENCRYPTION_IF_REQUESTED, 1000, NULL);
+        http3 = httpPoolGet(pool, "127.0.0.1", port, HTTP_ENCRYPTION_IF_REQUESTED, 100, NULL);
+
+        if (!http1 || !http2 || http1 == http2)
         {
-          status = HTTP_STATUS_UNAUTHORIZED;
-          continue;
+          failures ++;
+          testEndMessage(false, "unable to get two connections: %s", cupsLastErrorString());
+        }
+        else if (http3)
+        {
+          failures ++;
+          testEndMessage(false, "got a third connection");
         }
         else
         {
-          status = HTTP_STATUS_ERROR;
-          break;
+          httpPoolPut(pool, http1);
+
+          if ((http3 = httpPoolGet(pool, "127.0.0.1", port, HTTP_ENCRYPTION_IF_REQUESTED, 100, NULL)) != http1)
+          {
+            failures ++;
+            testEndMessage(false, "connection not reused");
+          }
+          else
+            testEnd(true);
         }
-      }
 
-      while ((status = httpUpdate(http)) == HTTP_STATUS_CONTINUE);
+        httpPoolPut(pool, http1);
+        httpPoolPut(pool, http2);
+        httpPoolPut(pool, http3);
+        httpPoolDelete(pool);
 
-      new_auth = 0;
+        httpAddrClose(&addrlist->addr, lfd);
+      }
 
-      if (status == HTTP_STATUS_UNAUTHORIZED)
-      {
-       /*
-	* Flush any error message...
-	*/
+      httpAddrFreeList(addrlist);
+    }
+    else
+    {
+      failures ++;
+      testEndMessage(false, "unable to lookup 127.0.0.1");
+    }
 
-	httpFlush(http);
+#ifdef HAVE_TLS
+   /*
+    * httpConnect(HTTP_ENCRYPTION_ALWAYS) session resumption
+    */
 
-       /*
-	* See if we can do authentication...
-	*/
+    testBegin("httpConnect(HTTP_ENCRYPTION_ALWAYS)");
 
-        new_auth = 1;
+    if ((addrlist = httpAddrGetList("127.0.0.1", AF_INET, "0")) != NULL)
+    {
+      range_test_t	test;		/* Test data */
+      cups_thread_t	server = CUPS_THREAD_INVALID;
+					/* Server thread */
+      http_t		*thttp;		/* Client connection */
+      int		fd;		/* Temporary file */
+      char		tlsdir[1024],	/* Temporary credentials directory */
+			filename[1024];	/* Credentials filename */
+      bool		resumed = false;/* Was the session resumed? */
+
+
+      memset(&test, 0, sizeof(test));
+      cupsMutexInit(&test.mutex);
+
+      test.tls    = true;
+      test.length = 1024;
+      test.data   = calloc(1, test.length);
+      test.fd     = -1;
+      tlsdir[0]   = '\0';
+
+      if ((fd = cupsTempFd(NULL, NULL, tlsdir, sizeof(tlsdir))) >= 0)
+      {
+        close(fd);
+        unlink(tlsdir);
 
-	if (cupsDoAuthentication(http, "HEAD", resource))
-	{
-	  status = HTTP_STATUS_CUPS_AUTHORIZATION_CANCELED;
-	  break;
-	}
+        if (mkdir(tlsdir, 0700))
+          tlsdir[0] = '\0';
+      }
 
-	if (!httpReconnect(http, 30000, NULL))
-	{
-	  status = HTTP_STATUS_ERROR;
-	  break;
-	}
+      for (port = 18731; port < 18831; port ++)
+      {
+        if ((test.fd = httpAddrListen(&addrlist->addr, port)) >= 0)
+          break;
+      }
 
-	continue;
+      if (!tlsdir[0])
+      {
+        failures ++;
+        testEndMessage(false, "unable to create credentials directory: %s", strerror(errno));
       }
-#ifdef HAVE_TLS
-      else if (status == HTTP_STATUS_UPGRADE_REQUIRED)
+      else if (test.fd < 0)
       {
-	/* Flush any error message... */
-	httpFlush(http);
-
-	/* Reconnect... */
-	if (!httpReconnect(http, 30000, NULL))
-	{
-	  status = HTTP_STATUS_ERROR;
-	  break;
-	}
-
-	/* Upgrade with encryption... */
-	httpSetEncryption(http, HTTP_ENCRYPTION_REQUIRED);
-
-	/* Try again, this time with encryption enabled... */
-	continue;
+        failures ++;
+        testEndMessage(false, "unable to listen on loopback");
       }
-#endif /* HAVE_TLS */
-    }
-    while (status == HTTP_STATUS_UNAUTHORIZED ||
-           status == HTTP_STATUS_UPGRADE_REQUIRED);
-
-    if (status == HTTP_STATUS_OK)
-      puts("HEAD OK:");
-    else
-      printf("HEAD failed with status %d...\n", status);
+      else if (!cupsSetServerCredentials(tlsdir, "localhost", 1))
+      {
+        failures ++;
+        testEndMessage(false, "unable to set server credentials: %s", cupsLastErrorString());
+      }
+      else if ((server = cupsThreadCreate((cups_thread_func_t)range_server, &test)) == CUPS_THREAD_INVALID)
+      {
+        failures ++;
+        testEndMessage(false, "unable to create server thread");
+      }
+      else
+      {
+        for (i = 0; i < 2; i ++)
+        {
+          if ((thttp = httpConnect("127.0.0.1", port, NULL, AF_INET, HTTP_ENCRYPTION_ALWAYS, true, 30000, NULL)) == NULL)
+            break;
 
-    encoding = httpGetContentEncoding(http);
+          if (i == 1)
+          {
+#  ifdef HAVE_OPENSSL
+            resumed = SSL_session_reused(thttp->tls) != 0;
+#  else
+            resumed = gnutls_session_is_resumed(thttp->tls) != 0;
+#  endif // HAVE_OPENSSL
+          }
 
-    printf("Requesting file \"%s\" (Accept-Encoding: %s)...\n", resource,
-           encoding ? encoding : "identity");
+         /*
+          * Do a GET so that any TLS 1.3 session tickets are received before
+          * the connection is closed and the session is saved...
+          */
 
-    new_auth = 0;
+          httpClearFields(thttp);
+          httpSetField(thttp, HTTP_FIELD_HOST, "127.0.0.1");
 
-    do
-    {
-      if (!_cups_strcasecmp(httpGetField(http, HTTP_FIELD_CONNECTION), "close"))
-      {
-	httpClearFields(http);
-	if (!httpReconnect(http, 30000, NULL))
-	{
-          status = HTTP_STATUS_ERROR;
-          break;
-	}
-      }
+          if (httpWriteRequest(thttp, "GET", "/"))
+          {
+            while ((status = httpUpdate(thttp)) == HTTP_STATUS_CONTINUE);
 
-      if (http->authstring && !strncmp(http->authstring, "Digest ", 7) && !new_auth)
-        _httpSetDigestAuthString(http, http->nextnonce, "GET", resource);
+            httpFlush(thttp);
+          }
 
-      httpClearFields(http);
-      httpSetField(http, HTTP_FIELD_AUTHORIZATION, httpGetAuthString(http));
-      httpSetField(http, HTTP_FIELD_ACCEPT_LANGUAGE, "en");
-      httpSetField(http, HTTP_FIELD_ACCEPT_ENCODING, encoding);
+          httpClose(thttp);
+        }
 
-      if (httpWriteRequest(http, "GET", resource))
-      {
-        if (httpReconnect(http, 30000, NULL))
+        if (i < 2)
         {
-          status = HTTP_STATUS_UNAUTHORIZED;
-          continue;
+          failures ++;
+          testEndMessage(false, "unable to connect: %s", cupsLastErrorString());
         }
-        else
+        else if (!resumed)
         {
-          status = HTTP_STATUS_ERROR;
-          break;
+          failures ++;
+          testEndMessage(false, "session not resumed");
         }
-      }
-
-      while ((status = httpUpdate(http)) == HTTP_STATUS_CONTINUE);
-
-      new_auth = 0;
-
-      if (status == HTTP_STATUS_UNAUTHORIZED)
-      {
-       /*
-	* Flush any error message...
-	*/
-
-	httpFlush(http);
+        else
+          testEnd(true);
 
        /*
-	* See if we can do authentication...
-	*/
+        * Wake up the server thread so it can stop...
+        */
 
-        new_auth = 1;
+        cupsMutexLock(&test.mutex);
+        test.stop = true;
+        cupsMutexUnlock(&test.mutex);
 
-	if (cupsDoAuthentication(http, "GET", resource))
-	{
-	  status = HTTP_STATUS_CUPS_AUTHORIZATION_CANCELED;
-	  break;
-	}
+        httpClose(httpConnect("127.0.0.1", port, NULL, AF_INET, HTTP_ENCRYPTION_IF_REQUESTED, true, 1000, NULL));
+        cupsThreadWait(server);
+      }
 
-	if (!httpReconnect(http, 30000, NULL))
-	{
-	  status = HTTP_STATUS_ERROR;
-	  break;
-	}
+      if (test.fd >= 0)
+        httpAddrClose(&addrlist->addr, test.fd);
 
-	continue;
-      }
-#ifdef HAVE_TLS
-      else if (status == HTTP_STATUS_UPGRADE_REQUIRED)
+      if (tlsdir[0])
       {
-	/* Flush any error message... */
-	httpFlush(http);
+        snprintf(filename, sizeof(filename), "%s/localhost.crt", tlsdir);
+        unlink(filename);
+        snprintf(filename, sizeof(filename), "%s/localhost.key", tlsdir);
+        unlink(filename);
+        rmdir(tlsdir);
+      }
 
-	/* Reconnect... */
-	if (!httpReconnect(http, 30000, NULL))
-	{
-	  status = HTTP_STATUS_ERROR;
-	  break;
-	}
+      free(test.data);
+      cupsMutexDestroy(&test.mutex);
+      httpAddrFreeList(addrlist);
+    }
+    else
+    {
+      failures ++;
+      testEndMessage(false, "unable to lookup 127.0.0.1");
+    }
+#endif // HAVE_TLS
 
-	/* Upgrade with encryption... */
-	httpSetEncryption(http, HTTP_ENCRYPTION_REQUIRED);
+    return (failures);
+  }
+  else if (strstr(argv[1], "._tcp"))
+  {
+   /*
+    * Test resolving an mDNS name.
+    */
 
-	/* Try again, this time with encryption enabled... */
-	continue;
-      }
-#endif /* HAVE_TLS */
-    }
-    while (status == HTTP_STATUS_UNAUTHORIZED || status == HTTP_STATUS_UPGRADE_REQUIRED);
+    char	resolved[1024];		/* Resolved URI */
 
-    if (status == HTTP_STATUS_OK)
-      puts("GET OK:");
-    else
-      printf("GET failed with status %d...\n", status);
 
-    start  = time(NULL);
-    length = httpGetLength(http);
-    total  = 0;
+    testBegin("httpResolveURI(%s, HTTP_RESOLVE_DEFAULT)", argv[1]);
+
+    if (!httpResolveURI(argv[1], resolved, sizeof(resolved), HTTP_RESOLVE_DEFAULT, NULL, NULL))
+    {
+      testEnd(false);
+      return (1);
+    }
+    else
+      testEndMessage(true, "%s", resolved);
+
+    testBegin("httpResolveURI(%s, HTTP_RESOLVE_FQDN)", argv[1]);
+
+    if (!httpResolveURI(argv[1], resolved, sizeof(resolved), HTTP_RESOLVE_FQDN, NULL, NULL))
+    {
+      testEnd(false);
+      return (1);
+    }
+    else if (strstr(resolved, ".local:"))
+    {
+      testEndMessage(false, "%s", resolved);
+      return (1);
+    }
+    else
+    {
+      testEndMessage(true, "%s", resolved);
+      return (0);
+    }
+  }
+  else if (!strcmp(argv[1], "-d") && argc == 3)
+  {
+    // Test httpDecode64
+    size_t	bufsize = sizeof(buffer);
+					// Output size
+
+    if (httpDecode64(buffer, &bufsize, argv[2], NULL))
+    {
+      fwrite(buffer, 1, bufsize, stdout);
+      return (0);
+    }
+
+    return (1);
+  }
+  else if (!strcmp(argv[1], "-e") && argc == 3)
+  {
+    // Test httpEncode64 for Base64
+    if (httpEncode64(buffer, sizeof(buffer), argv[2], strlen(argv[2]), false))
+    {
+      puts(buffer);
+      return (0);
+    }
+
+    return (1);
+  }
+  else if (!strcmp(argv[1], "-E") && argc == 3)
+  {
+    // Test httpEncode64 for Base64url
+    if (httpEncode64(buffer, sizeof(buffer), argv[2], strlen(argv[2]), true))
+    {
+      puts(buffer);
+      return (0);
+    }
+
+    return (1);
+  }
+  else if (!strcmp(argv[1], "-u") && argc == 3)
+  {
+   /*
+    * Test URI separation...
+    */
+
+    uri_status = httpSeparateURI(HTTP_URI_CODING_ALL, argv[2], scheme, sizeof(scheme), username, sizeof(username), hostname, sizeof(hostname), &port, resource, sizeof(resource));
+    printf("uri_status = %s\n", uri_status_strings[uri_status + 8]);
+    printf("scheme     = \"%s\"\n", scheme);
+    printf("username   = \"%s\"\n", username);
+    printf("hostname   = \"%s\"\n", hostname);
+    printf("port       = %d\n", port);
+    printf("resource   = \"%s\"\n", resource);
+
+    return (0);
+  }
+
+ /*
+  * Test HTTP GET requests...
+  */
+
+  http = NULL;
+  out = stdout;
+
+  for (i = 1; i < argc; i ++)
+  {
+    int new_auth;
+
+    if (!strcmp(argv[i], "-o"))
+    {
+      i ++;
+      if (i >= argc)
+        break;
+
+      out = fopen(argv[i], "wb");
+      continue;
+    }
+
+    httpSeparateURI(HTTP_URI_CODING_MOST, argv[i], scheme, sizeof(scheme),
+                    username, sizeof(username),
+                    hostname, sizeof(hostname), &port,
+		    resource, sizeof(resource));
+
+    if (!_cups_strcasecmp(scheme, "https") || !_cups_strcasecmp(scheme, "ipps") ||
+        port == 443)
+      encryption = HTTP_ENCRYPTION_ALWAYS;
+    else
+      encryption = HTTP_ENCRYPTION_IF_REQUESTED;
+
+    http = httpConnect(hostname, port, NULL, AF_UNSPEC, encryption, 1, 30000, NULL);
+    if (http == NULL)
+    {
+      perror(hostname);
+      continue;
+    }
+
+    if (httpIsEncrypted(http))
+    {
+      cups_array_t *creds;
+      char info[1024], expstr[256];
+      static const char *trusts[] = { "OK", "Invalid", "Changed", "Expired", "Renewed", "Unknown" };
+      if (!httpCopyCredentials(http, &creds))
+      {
+	cups_array_t *lcreds;
+        http_trust_t trust = httpCredentialsGetTrust(creds, hostname);
+
+        httpCredentialsString(creds, info, sizeof(info));
+
+	printf("Count: %u\n", (unsigned)cupsArrayGetCount(creds));
+        printf("Trust: %s\n", trusts[trust]);
+        printf("Expiration: %s\n", httpGetDateString(httpCredentialsGetExpiration(creds), expstr, sizeof(expstr)));
+        printf("IsValidName: %d\n", httpCredentialsAreValidForName(creds, hostname));
+        printf("String: \"%s\"\n", info);
+
+	printf("LoadCredentials: %s\n", httpLoadCredentials(NULL, &lcreds, hostname) ? "true" : "false");
+	httpCredentialsString(lcreds, info, sizeof(info));
+	printf("    Count: %u\n", (unsigned)cupsArrayGetCount(lcreds));
+	printf("    String: \"%s\"\n", info);
+
+        if (lcreds && cupsArrayGetCount(creds) == cupsArrayGetCount(lcreds))
+        {
+          http_credential_t	*cred, *lcred;
+
+          for (i = 1, cred = (http_credential_t *)cupsArrayGetFirst(creds), lcred = (http_credential_t *)cupsArrayGetFirst(lcreds);
+               cred && lcred;
+               i ++, cred = (http_credential_t *)cupsArrayGetNext(creds), lcred = (http_credential_t *)cupsArrayGetNext(lcreds))
+          {
+            if (cred->datalen != lcred->datalen)
+              printf("    Credential #%d: Different lengths (saved=%d, current=%d)\n", i, (int)cred->datalen, (int)lcred->datalen);
+            else if (memcmp(cred->data, lcred->data, cred->datalen))
+              printf("    Credential #%d: Different data\n", i);
+            else
+              printf("    Credential #%d: Matches\n", i);
+          }
+        }
+
+        if (trust != HTTP_TRUST_OK)
+	{
+	  printf("SaveCredentials: %s\n", httpSaveCredentials(NULL, creds, hostname) ? "true" : "false");
+	  trust = httpCredentialsGetTrust(creds, hostname);
+	  printf("New Trust: %s\n", trusts[trust]);
+	}
+
+        httpFreeCredentials(creds);
+      }
+      else
+        puts("No credentials!");
+    }
+
+    printf("Checking file \"%s\"...\n", resource);
+
+    new_auth = 0;
+
+    do
+    {
+      if (!_cups_strcasecmp(httpGetField(http, HTTP_FIELD_CONNECTION), "close"))
+      {
+	httpClearFields(http);
+	if (!httpReconnect(http, 30000, NULL))
+	{
+          status = HTTP_STATUS_ERROR;
+          break;
+	}
+      }
+
+      if (http->authstring && !strncmp(http->authstring, "Digest ", 7) && !new_auth)
+        _httpSetDigestAuthString(http, http->nextnonce, "HEAD", resource);
+
+      httpClearFields(http);
+      httpSetField(http, HTTP_FIELD_AUTHORIZATION, httpGetAuthString(http));
+      httpSetField(http, HTTP_FIELD_ACCEPT_LANGUAGE, "en");
+
+      if (httpWriteRequest(http, "HEAD", resource))
+      {
+        if (httpReconnect(http, 30000, NULL))
+        {
+          status = HTTP_STATUS_UNAUTHORIZED;
+          continue;
+        }
+        else
+        {
+          status = HTTP_STATUS_ERROR;
+          break;
+        }
+      }
+
+      while ((status = httpUpdate(http)) == HTTP_STATUS_CONTINUE);
+
+      new_auth = 0;
+
+      if (status == HTTP_STATUS_UNAUTHORIZED)
+      {
+       /*
+	* Flush any error message...
+	*/
+
+	httpFlush(http);
+
+       /*
+	* See if we can do authentication...
+	*/
+
+        new_auth = 1;
+
+	if (cupsDoAuthentication(http, "HEAD", resource))
+	{
+	  status = HTTP_STATUS_CUPS_AUTHORIZATION_CANCELED;
+	  break;
+	}
+
+	if (!httpReconnect(http, 30000, NULL))
+	{
+	  status = HTTP_STATUS_ERROR;
+	  break;
+	}
+
+	continue;
+      }
+#ifdef HAVE_TLS
+      else if (status == HTTP_STATUS_UPGRADE_REQUIRED)
+      {
+	/* Flush any error message... */
+	httpFlush(http);
+
+	/* Reconnect... */
+	if (!httpReconnect(http, 30000, NULL))
+	{
+	  status = HTTP_STATUS_ERROR;
+	  break;
+	}
+
+	/* Upgrade with encryption... */
+	httpSetEncryption(http, HTTP_ENCRYPTION_REQUIRED);
+
+	/* Try again, this time with encryption enabled... */
+	continue;
+      }
+#endif /* HAVE_TLS */
+    }
+    while (status == HTTP_STATUS_UNAUTHORIZED ||
+           status == HTTP_STATUS_UPGRADE_REQUIRED);
+
+    if (status == HTTP_STATUS_OK)
+      puts("HEAD OK:");
+    else
+      printf("HEAD failed with status %d...\n", status);
+
+    encoding = httpGetContentEncoding(http);
+
+    printf("Requesting file \"%s\" (Accept-Encoding: %s)...\n", resource,
+           encoding ? encoding : "identity");
+
+    new_auth = 0;
+
+    do
+    {
+      if (!_cups_strcasecmp(httpGetField(http, HTTP_FIELD_CONNECTION), "close"))
+      {
+	httpClearFields(http);
+	if (!httpReconnect(http, 30000, NULL))
+	{
+          status = HTTP_STATUS_ERROR;
+          break;
+	}
+      }
+
+      if (http->authstring && !strncmp(http->authstring, "Digest ", 7) && !new_auth)
+        _httpSetDigestAuthString(http, http->nextnonce, "GET", resource);
+
+      httpClearFields(http);
+      httpSetField(http, HTTP_FIELD_AUTHORIZATION, httpGetAuthString(http));
+      httpSetField(http, HTTP_FIELD_ACCEPT_LANGUAGE, "en");
+      httpSetField(http, HTTP_FIELD_ACCEPT_ENCODING, encoding);
+
+      if (httpWriteRequest(http, "GET", resource))
+      {
+        if (httpReconnect(http, 30000, NULL))
+        {
+          status = HTTP_STATUS_UNAUTHORIZED;
+          continue;
+        }
+        else
+        {
+          status = HTTP_STATUS_ERROR;
+          break;
+        }
+      }
+
+      while ((status = httpUpdate(http)) == HTTP_STATUS_CONTINUE);
+
+      new_auth = 0;
+
+      if (status == HTTP_STATUS_UNAUTHORIZED)
+      {
+       /*
+	* Flush any error message...
+	*/
+
+	httpFlush(http);
+
+       /*
+	* See if we can do authentication...
+	*/
+
+        new_auth = 1;
+
+	if (cupsDoAuthentication(http, "GET", resource))
+	{
+	  status = HTTP_STATUS_CUPS_AUTHORIZATION_CANCELED;
+	  break;
+	}
+
+	if (!httpReconnect(http, 30000, NULL))
+	{
+	  status = HTTP_STATUS_ERROR;
+	  break;
+	}
+
+	continue;
+      }
+#ifdef HAVE_TLS
+      else if (status == HTTP_STATUS_UPGRADE_REQUIRED)
+      {
+	/* Flush any error message... */
+	httpFlush(http);
+
+	/* Reconnect... */
+	if (!httpReconnect(http, 30000, NULL))
+	{
+	  status = HTTP_STATUS_ERROR;
+	  break;
+	}
+
+	/* Upgrade with encryption... */
+	httpSetEncryption(http, HTTP_ENCRYPTION_REQUIRED);
+
+	/* Try again, this time with encryption enabled... */
+	continue;
+      }
+#endif /* HAVE_TLS */
+    }
+    while (status == HTTP_STATUS_UNAUTHORIZED || status == HTTP_STATUS_UPGRADE_REQUIRED);
+
+    if (status == HTTP_STATUS_OK)
+      puts("GET OK:");
+    else
+      printf("GET failed with status %d...\n", status);
+
+    start  = time(NULL);
+    length = httpGetLength(http);
+    total  = 0;
 
     while ((bytes = httpRead(http, buffer, sizeof(buffer))) > 0)
     {
-      total += bytes;
-      fwrite(buffer, (size_t)bytes, 1, out);
-      if (out != stdout)
+      total += bytes;
+      fwrite(buffer, (size_t)bytes, 1, out);
+      if (out != stdout)
+      {
+        current = time(NULL);
+        if (current == start)
+          current ++;
+
+        printf("\r" CUPS_LLFMT "/" CUPS_LLFMT " bytes ("
+	       CUPS_LLFMT " bytes/sec)      ", CUPS_LLCAST total,
+	       CUPS_LLCAST length, CUPS_LLCAST (total / (current - start)));
+        fflush(stdout);
+      }
+    }
+  }
+
+  if (out != stdout)
+    putchar('\n');
+
+  puts("Closing connection to server...");
+  httpClose(http);
+
+  if (out != stdout)
+    fclose(out);
+
+  return (0);
+}
+
+
+/*
+ * 'arena_test()' - Test that arena responses are only used when enabled.
+ */
+
+static int				/* O - Number of failures */
+arena_test(http_t *http)		/* I - Connection to server */
+{
+  int		i;			/* Looping var */
+  ipp_t		*request,		/* IPP request */
+		*response;		/* IPP response */
+  bool		arena;			/* Arena response? */
+
+
+  for (i = 0; i < 3; i ++)
+  {
+   /*
+    * Default, enabled, and disabled again...
+    */
+
+    cupsSetResponseArena(i == 1);
+
+    request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, "ipp://127.0.0.1/ipp/print");
+
+    if ((response = cupsDoRequest(http, request, "/ipp/print")) == NULL || cupsLastError() >= IPP_STATUS_ERROR_BAD_REQUEST)
+    {
+      testEndMessage(false, "request %d failed: %s", i + 1, cupsLastErrorString());
+      ippDelete(response);
+      cupsSetResponseArena(false);
+      return (1);
+    }
+
+    arena = response->arena != NULL;
+
+    if (!ippFindAttribute(response, "printer-name", IPP_TAG_NAME))
+    {
+      testEndMessage(false, "request %d missing printer-name", i + 1);
+      ippDelete(response);
+      cupsSetResponseArena(false);
+      return (1);
+    }
+
+    ippDelete(response);
+
+    if (arena != (i == 1))
+    {
+      testEndMessage(false, "request %d %s an arena response", i + 1, arena ? "got" : "did not get");
+      cupsSetResponseArena(false);
+      return (1);
+    }
+  }
+
+  cupsSetResponseArena(false);
+
+  testEnd(true);
+
+  return (0);
+}
+
+
+/*
+ * 'async_cb()' - Receive the results of httpAddrGetListAsync().
+ */
+
+static void
+async_cb(async_test_t    *data,		/* I - Callback data */
+         http_addrlist_t *addrlist)	/* I - Addresses */
+{
+  cupsMutexLock(&data->mutex);
+  data->addrlist = addrlist;
+  data->done     = true;
+  cupsCondBroadcast(&data->cond);
+  cupsMutexUnlock(&data->mutex);
+}
+
+
+/*
+ * 'dest_cache_test()' - Test the cupsCopyDestInfo() cache.
+ */
+
+static int				/* O - Number of failures */
+dest_cache_test(http_t       *http,	/* I - Connection to server */
+                range_test_t *test,	/* I - Test data */
+                int          port)	/* I - Port number */
+{
+  size_t	i;			/* Looping var */
+  cups_dest_t	dest;			/* Destination */
+  cups_dinfo_t	*dinfo;			/* Destination information */
+  char		uri[1024];		/* Printer URI */
+  int		requests;		/* Number of requests */
+  static const struct
+  {
+    const char	*name;			/* Name of step */
+    int		ttl,			/* Cache TTL to set or `-1` for no change */
+		config_time,		/* printer-config-change-time value */
+		delay;			/* Delay before copy in seconds */
+    bool	clear;			/* Clear the cache first? */
+    int		requests;		/* Expected number of requests */
+  } steps[] =
+  {
+    { "disabled",		-1, 1, 0, false, 1 },
+    { "disabled again",		-1, 1, 0, false, 1 },
+    { "first",			60, 1, 0, false, 1 },
+    { "cached",			-1, 1, 0, false, 0 },
+    { "cleared",		-1, 1, 0, true,  1 },
+    { "revalidated",		1,  1, 2, false, 1 },
+    { "config changed",		-1, 2, 2, false, 2 },
+    { "cached after change",	60, 2, 0, false, 0 },
+    { "disabled by TTL 0",	0,  2, 0, false, 1 }
+  };
+
+
+  httpAssembleURI(HTTP_URI_CODING_ALL, uri, sizeof(uri), "ipp", NULL, "127.0.0.1", port, "/ipp/print");
+
+  memset(&dest, 0, sizeof(dest));
+  dest.name        = "test";
+  dest.num_options = cupsAddOption("device-uri", uri, 0, &dest.options);
+
+  for (i = 0; i < (sizeof(steps) / sizeof(steps[0])); i ++)
+  {
+    if (steps[i].ttl >= 0)
+      cupsSetDestInfoCacheTTL(steps[i].ttl);
+
+    if (steps[i].clear)
+      cupsClearDestInfoCache(uri);
+
+    if (steps[i].delay)
+      sleep((unsigned)steps[i].delay);
+
+    cupsMutexLock(&test->mutex);
+    test->config_time = steps[i].config_time;
+    requests          = test->requests;
+    cupsMutexUnlock(&test->mutex);
+
+    dinfo = cupsCopyDestInfo(http, &dest);
+
+    cupsMutexLock(&test->mutex);
+    requests = test->requests - requests;
+    cupsMutexUnlock(&test->mutex);
+
+    if (!dinfo)
+    {
+      testEndMessage(false, "%s: %s", steps[i].name, cupsLastErrorString());
+      break;
+    }
+
+    cupsFreeDestInfo(dinfo);
+
+    if (requests != steps[i].requests)
+    {
+      testEndMessage(false, "%s: got %d requests, expected %d", steps[i].name, requests, steps[i].requests);
+      break;
+    }
+  }
+
+  cupsSetDestInfoCacheTTL(0);
+  cupsFreeOptions(dest.num_options, dest.options);
+
+  if (i < (sizeof(steps) / sizeof(steps[0])))
+    return (1);
+
+  testEnd(true);
+
+  return (0);
+}
+
+
+/*
+ * 'post_test()' - Test cupsDoRequest() after the server closes a keep-alive
+ *                 connection.
+ */
+
+static int				/* O - Number of failures */
+post_test(http_t       *http,		/* I - Connection to server */
+          range_test_t *test)		/* I - Test data */
+{
+  int		i;			/* Looping var */
+  ipp_t		*request,		/* IPP request */
+		*response;		/* IPP response */
+  int		requests;		/* Number of requests */
+
+
+  cupsMutexLock(&test->mutex);
+  test->post_close = true;
+  requests         = test->requests;
+  cupsMutexUnlock(&test->mutex);
+
+  for (i = 0; i < 2; i ++)
+  {
+    request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
+    ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, "ipp://127.0.0.1/ipp/print");
+
+    if ((response = cupsDoRequest(http, request, "/ipp/print")) == NULL || cupsLastError() >= IPP_STATUS_ERROR_BAD_REQUEST)
+    {
+      testEndMessage(false, "request %d failed: %s", i + 1, cupsLastErrorString());
+      ippDelete(response);
+      return (1);
+    }
+
+    ippDelete(response);
+
+    if (i == 0 && !httpWait(http, 10000))
+    {
+     /*
+      * The server closes the connection after the first response...
+      */
+
+      testEndMessage(false, "server did not close the connection");
+      return (1);
+    }
+  }
+
+  cupsMutexLock(&test->mutex);
+  test->post_close = false;
+  requests         = test->requests - requests;
+  cupsMutexUnlock(&test->mutex);
+
+  testEndMessage(true, "%d requests", requests);
+
+  return (0);
+}
+
+
+/*
+ * 'range_client()' - Respond to GET requests from cupsGetFdRange().
+ */
+
+static void *				/* O - Thread exit status (unused) */
+range_client(range_client_t *client)	/* I - Client data */
+{
+  range_test_t	*test = client->test;	/* Test data */
+  http_t	*http = client->http;	/* Client connection */
+  http_state_t	state;			/* Request state */
+  http_status_t	status;			/* Request status */
+  char		uri[1024],		/* Request URI */
+		value[256];		/* Header value */
+  const char	*if_range;		/* If-Range value */
+  long long	first,			/* First byte */
+		last;			/* Last byte */
+  size_t	length;			/* Response length */
+  bool		drop,			/* Drop the connection? */
+		chunked;		/* Send a chunked response? */
+
+
+  if (test->tls && !httpSetEncryption(http, HTTP_ENCRYPTION_ALWAYS))
+  {
+    httpClose(http);
+    free(client);
+    return (NULL);
+  }
+
+  while (httpWait(http, 30000))
+  {
+    if ((state = httpReadRequest(http, uri, sizeof(uri))) == HTTP_STATE_WAITING)
+      continue;
+    else if (state != HTTP_STATE_GET && state != HTTP_STATE_POST && state != HTTP_STATE_PUT)
+      break;
+
+    while ((status = httpUpdate(http)) == HTTP_STATUS_CONTINUE);
+
+    if (status != HTTP_STATUS_OK)
+      break;
+
+    if (state == HTTP_STATE_POST)
+    {
+     /*
+      * Respond to an IPP request, optionally closing the connection
+      * afterwards without a "Connection: close" header...
+      */
+
+      ipp_t		*request,	/* IPP request */
+			*response;	/* IPP response */
+      ipp_state_t	ipp_state;	/* IPP read/write state */
+      int		config_time;	/* printer-config-change-time value */
+      char		buffer[8192];	/* Document data buffer */
+
+      if (httpGetExpect(http) == HTTP_STATUS_CONTINUE && !httpWriteResponse(http, HTTP_STATUS_CONTINUE))
+        break;
+
+      request = ippNew();
+
+      while ((ipp_state = ippRead(http, request)) != IPP_STATE_DATA && ipp_state != IPP_STATE_ERROR);
+
+      if (ipp_state == IPP_STATE_ERROR)
+      {
+        ippDelete(request);
+        break;
+      }
+
+      while (httpRead(http, buffer, sizeof(buffer)) > 0);
+
+      cupsMutexLock(&test->mutex);
+      test->requests ++;
+      drop        = test->post_close;
+      config_time = test->config_time;
+      cupsMutexUnlock(&test->mutex);
+
+      response = ippNewResponse(request);
+
+      if (ippGetOperation(request) == IPP_OP_GET_PRINTER_ATTRIBUTES)
+      {
+        ippAddString(response, IPP_TAG_PRINTER, IPP_TAG_NAME, "printer-name", NULL, "test");
+        ippAddInteger(response, IPP_TAG_PRINTER, IPP_TAG_INTEGER, "printer-config-change-time", config_time);
+      }
+
+      ippDelete(request);
+
+      httpClearFields(http);
+      httpSetField(http, HTTP_FIELD_CONTENT_TYPE, "application/ipp");
+      httpSetLength(http, ippLength(response));
+
+      if (!httpWriteResponse(http, HTTP_STATUS_OK))
+      {
+        ippDelete(response);
+        break;
+      }
+
+      while ((ipp_state = ippWrite(http, response)) != IPP_STATE_DATA && ipp_state != IPP_STATE_ERROR);
+
+      ippDelete(response);
+
+      if (ipp_state == IPP_STATE_ERROR)
+        break;
+
+      if (drop)
+      {
+        httpFlushWrite(http);
+        break;
+      }
+
+      continue;
+    }
+
+    if (state == HTTP_STATE_PUT)
+    {
+     /*
+      * Save the PUT data...
+      */
+
+      char	*ptr,			/* Pointer into data */
+		*end;			/* End of data */
+      ssize_t	bytes;			/* Bytes read */
+
+      if (httpGetExpect(http) == HTTP_STATUS_CONTINUE && !httpWriteResponse(http, HTTP_STATUS_CONTINUE))
+        break;
+
+      cupsMutexLock(&test->mutex);
+
+      for (ptr = test->put, end = test->put + test->length; ptr < end && (bytes = httpRead(http, ptr, (size_t)(end - ptr))) > 0; ptr += bytes);
+
+      test->put_length = (size_t)(ptr - test->put);
+
+      cupsMutexUnlock(&test->mutex);
+
+      httpFlush(http);
+      httpClearFields(http);
+      httpSetLength(http, 0);
+
+      if (!httpWriteResponse(http, HTTP_STATUS_CREATED))
+        break;
+
+      continue;
+    }
+
+    first    = 0;
+    last     = (long long)test->length - 1;
+    status   = HTTP_STATUS_OK;
+    if_range = httpGetField(http, HTTP_FIELD_IF_RANGE);
+
+    if (sscanf(httpGetField(http, HTTP_FIELD_RANGE), "bytes=%lld-%lld", &first, &last) >= 1 && (!if_range || !*if_range || !strcmp(if_range, "\"test\"")))
+    {
+      if (last >= (long long)test->length)
+        last = (long long)test->length - 1;
+
+      status = HTTP_STATUS_PARTIAL_CONTENT;
+    }
+    else
+    {
+      first = 0;
+      last  = (long long)test->length - 1;
+    }
+
+    cupsMutexLock(&test->mutex);
+    test->requests ++;
+    if ((drop = test->drops > 0) == true)
+      test->drops --;
+    cupsMutexUnlock(&test->mutex);
+
+    length = (size_t)(last - first + 1);
+
+    httpClearFields(http);
+    httpSetField(http, HTTP_FIELD_CONTENT_TYPE, "application/octet-stream");
+    httpSetField(http, HTTP_FIELD_ETAG, "\"test\"");
+
+    if (status == HTTP_STATUS_PARTIAL_CONTENT)
+    {
+      snprintf(value, sizeof(value), "bytes %lld-%lld/%lld", first, last, (long long)test->length);
+      httpSetField(http, HTTP_FIELD_CONTENT_RANGE, value);
+    }
+
+    chunked = !strcmp(uri, "/chunked");
+
+    httpSetLength(http, chunked ? 0 : length);
+
+    if (!httpWriteResponse(http, status))
+      break;
+
+    if (drop)
+    {
+      httpWrite(http, test->data + first, length / 2);
+      httpFlushWrite(http);
+      break;
+    }
+
+    if (httpWrite(http, test->data + first, length) < 0)
+      break;
+
+    if (chunked && httpWrite(http, "", 0) < 0)
+      break;
+  }
+
+  httpClose(http);
+  free(client);
+
+  return (NULL);
+}
+
+
+/*
+ * 'range_server()' - Accept connections for cupsGetFdRange().
+ */
+
+static void *				/* O - Thread exit status (unused) */
+range_server(range_test_t *test)	/* I - Test data */
+{
+  http_t		*http;		/* Client connection */
+  range_client_t	*client;	/* Client data */
+  bool			stop = false;	/* Stop the server? */
+  size_t		i;		/* Looping var */
+
+
+  while (!stop && (http = httpAcceptConnection(test->fd, true)) != NULL)
+  {
+    cupsMutexLock(&test->mutex);
+
+    if ((stop = test->stop) == true || test->num_clients >= (sizeof(test->clients) / sizeof(test->clients[0])) || (client = calloc(1, sizeof(range_client_t))) == NULL)
+    {
+      httpClose(http);
+    }
+    else
+    {
+      client->test = test;
+      client->http = http;
+
+      if ((test->clients[test->num_clients] = cupsThreadCreate((cups_thread_func_t)range_client, client)) == CUPS_THREAD_INVALID)
       {
-        current = time(NULL);
-        if (current == start)
-          current ++;
+        httpClose(http);
+        free(client);
+      }
+      else
+        test->num_clients ++;
+    }
 
-        printf("\r" CUPS_LLFMT "/" CUPS_LLFMT " bytes ("
-	       CUPS_LLFMT " bytes/sec)      ", CUPS_LLCAST total,
-	       CUPS_LLCAST length, CUPS_LLCAST (total / (current - start)));
-        fflush(stdout);
+    cupsMutexUnlock(&test->mutex);
+  }
+
+  for (i = 0; i < test->num_clients; i ++)
+    cupsThreadWait(test->clients[i]);
+
+  return (NULL);
+}
+
+
+/*
+ * 'range_test()' - Test cupsGetFdRange().
+ */
+
+static int				/* O - Number of failures */
+range_test(http_t       *http,		/* I - Connection to server */
+           range_test_t *test,		/* I - Test data */
+           off_t        offset,		/* I - Offset of first byte */
+           off_t        length,		/* I - Number of bytes or `0` for all */
+           size_t       num_connections)/* I - Maximum number of connections */
+{
+  int		fd;			/* Temporary file */
+  char		filename[1024],		/* Temporary filename */
+		*data;			/* Data from file */
+  struct stat	fileinfo;		/* File information */
+  http_status_t	status;			/* Status from cupsGetFdRange */
+  off_t		expected;		/* Expected number of bytes */
+  int		requests;		/* Number of requests */
+  int		ret = 0;		/* Number of failures */
+
+
+  if ((fd = cupsTempFd(NULL, NULL, filename, sizeof(filename))) < 0)
+  {
+    testEndMessage(false, "unable to create temporary file: %s", strerror(errno));
+    return (1);
+  }
+
+  expected = length ? length : (off_t)test->length - offset;
+
+  cupsMutexLock(&test->mutex);
+  requests = test->requests;
+  cupsMutexUnlock(&test->mutex);
+
+  if ((status = cupsGetFdRange(http, "/test", fd, offset, length, num_connections)) != HTTP_STATUS_OK)
+  {
+    testEndMessage(false, "%s", httpStatusString(status));
+    ret = 1;
+  }
+  else if (fstat(fd, &fileinfo) || fileinfo.st_size != (offset + expected))
+  {
+    testEndMessage(false, "got %ld bytes, expected %ld", (long)fileinfo.st_size, (long)(offset + expected));
+    ret = 1;
+  }
+  else if ((data = malloc((size_t)expected)) == NULL || pread(fd, data, (size_t)expected, offset) != (ssize_t)expected || memcmp(data, test->data + offset, (size_t)expected))
+  {
+    testEndMessage(false, "bad data");
+    free(data);
+    ret = 1;
+  }
+  else
+  {
+    cupsMutexLock(&test->mutex);
+    requests = test->requests - requests;
+    cupsMutexUnlock(&test->mutex);
+
+    testEndMessage(true, "%d requests", requests);
+    free(data);
+  }
+
+  close(fd);
+  unlink(filename);
+
+  return (ret);
+}
+
+
+/*
+ * 'read_buffer_test()' - Test httpReadBuffer() and httpSetBufferSize().
+ */
+
+static int				/* O - Number of failures */
+read_buffer_test(http_t       *http,	/* I - Connection to server */
+                 range_test_t *test,	/* I - Test data */
+                 const char   *resource)/* I - Resource to GET */
+{
+  http_status_t	status;			/* Status of GET */
+  const char	*data;			/* Pointer to data */
+  ssize_t	bytes;			/* Bytes read */
+  size_t	total = 0;		/* Total bytes read */
+  bool		grown = false,		/* Grown the buffer? */
+		shrunk = false;		/* Tried shrinking the buffer? */
+  int		used = 0;		/* Bytes buffered when shrinking */
+  char		peek;			/* Peeked byte */
+
+
+  if (!httpSetBufferSize(http, 65536, 0))
+  {
+    testEndMessage(false, "unable to set buffer size: %s", cupsLastErrorString());
+    return (1);
+  }
+
+  httpClearFields(http);
+  httpSetField(http, HTTP_FIELD_HOST, "127.0.0.1");
+
+  if (!httpWriteRequest(http, "GET", resource))
+  {
+    testEndMessage(false, "unable to send request: %s", cupsLastErrorString());
+    return (1);
+  }
+
+  while ((status = httpUpdate(http)) == HTTP_STATUS_CONTINUE);
+
+  if (status != HTTP_STATUS_OK)
+  {
+    httpFlush(http);
+    testEndMessage(false, "%s", httpStatusString(status));
+    return (1);
+  }
+
+  while ((bytes = httpReadBuffer(http, &data, 8192)) > 0)
+  {
+    if ((total + (size_t)bytes) > test->length || memcmp(data, test->data + total, (size_t)bytes))
+    {
+      httpFlush(http);
+      testEndMessage(false, "bad data at offset %u", (unsigned)total);
+      return (1);
+    }
+
+    total += (size_t)bytes;
+
+    if (!grown && total >= test->length / 3)
+    {
+     /*
+      * Grow the input buffer mid-stream...
+      */
+
+      grown = true;
+
+      if (!httpSetBufferSize(http, 262144, 0))
+      {
+        httpFlush(http);
+        testEndMessage(false, "unable to grow buffer: %s", cupsLastErrorString());
+        return (1);
+      }
+    }
+    else if (grown && !shrunk && total >= 2 * test->length / 3 && http->used == 0)
+    {
+     /*
+      * Let the server fill the socket buffers, peek to fill the input buffer,
+      * and then try shrinking it - this must fail if the unread data does not
+      * fit without losing any of it...
+      */
+
+      shrunk = true;
+
+      usleep(100000);
+
+      if (httpPeek(http, &peek, 1) != 1)
+      {
+        httpFlush(http);
+        testEndMessage(false, "unable to peek: %s", cupsLastErrorString());
+        return (1);
+      }
+
+      used = http->used;
+
+      if (httpSetBufferSize(http, HTTP_MAX_BUFFER, 0) != (used <= HTTP_MAX_BUFFER))
+      {
+        httpFlush(http);
+        testEndMessage(false, "shrinking buffer with %d bytes unread returned %s", used, used <= HTTP_MAX_BUFFER ? "false" : "true");
+        return (1);
       }
     }
   }
 
-  if (out != stdout)
-    putchar('\n');
+  if (bytes < 0)
+  {
+    httpFlush(http);
+    testEndMessage(false, "read error: %s", strerror(httpError(http)));
+    return (1);
+  }
+  else if (total != test->length)
+  {
+    testEndMessage(false, "got %u bytes, expected %u", (unsigned)total, (unsigned)test->length);
+    return (1);
+  }
 
-  puts("Closing connection to server...");
-  httpClose(http);
+  testEndMessage(true, "%d bytes unread when shrinking", used);
 
-  if (out != stdout)
-    fclose(out);
+  return (0);
+}
+
+
+/*
+ * 'stats_test()' - Test the HTTP statistics for a loopback request.
+ *
+ * Both ends of the connection are in this process, so every byte written must
+ * also be counted as read.
+ */
+
+static int				/* O - Number of failures */
+stats_test(http_t *http)		/* I - Connection to server */
+{
+  int		i;			/* Looping var */
+  ipp_t		*request;		/* IPP request */
+  cups_json_t	*stats = NULL,		/* Statistics */
+		*httpstats;		/* HTTP statistics */
+  double	reads,			/* Number of reads */
+		read_bytes,		/* Number of bytes read */
+		writes,			/* Number of writes */
+		write_bytes,		/* Number of bytes written */
+		requests;		/* Number of Get-Printer-Attributes requests */
+
+
+  cupsSetStatistics(true);
+
+  request = ippNewRequest(IPP_OP_GET_PRINTER_ATTRIBUTES);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, "ipp://127.0.0.1/ipp/print");
+
+  ippDelete(cupsDoRequest(http, request, "/ipp/print"));
+
+ /*
+  * The server thread may not have counted its last write yet, so give it up
+  * to a second to catch up...
+  */
+
+  for (i = 0; i < 100; i ++)
+  {
+    cupsJSONDelete(stats);
+
+    stats       = cupsGetStatistics();
+    httpstats   = cupsJSONFind(stats, "http");
+    read_bytes  = cupsJSONGetNumber(cupsJSONFind(httpstats, "read_bytes"));
+    write_bytes = cupsJSONGetNumber(cupsJSONFind(httpstats, "write_bytes"));
+
+    if (read_bytes == write_bytes)
+      break;
+
+    usleep(10000);
+  }
+
+  cupsSetStatistics(false);
+
+  reads    = cupsJSONGetNumber(cupsJSONFind(httpstats, "reads"));
+  writes   = cupsJSONGetNumber(cupsJSONFind(httpstats, "writes"));
+  requests = cupsJSONGetNumber(cupsJSONFind(cupsJSONFind(cupsJSONFind(stats, "requests"), "Get-Printer-Attributes"), "count"));
+
+  cupsJSONDelete(stats);
+
+  if (reads < 2 || writes < 2)
+  {
+    testEndMessage(false, "got %g reads and %g writes, expected at least 2 of each", reads, writes);
+    return (1);
+  }
+  else if (read_bytes <= 0.0 || read_bytes != write_bytes)
+  {
+    testEndMessage(false, "got %g bytes read and %g bytes written", read_bytes, write_bytes);
+    return (1);
+  }
+  else if (requests != 1.0)
+  {
+    testEndMessage(false, "got %g Get-Printer-Attributes requests, expected 1", requests);
+    return (1);
+  }
+
+  testEndMessage(true, "%g reads, %g writes, %g bytes", reads, writes, read_bytes);
+
+  return (0);
+}
+
+
+/*
+ * 'write_fd_test()' - Test cupsWriteRequestFd() with a regular file and a
+ *                     Content-Length request.
+ */
+
+static int				/* O - Number of failures */
+write_fd_test(http_t       *http,	/* I - Connection to server */
+              range_test_t *test)	/* I - Test data */
+{
+  int		fd;			/* Temporary file */
+  char		filename[1024];		/* Temporary filename */
+  ipp_t		*request,		/* IPP request */
+		*response;		/* IPP response */
+  http_status_t	status;			/* Write status */
+
+
+  if ((fd = cupsTempFd(NULL, NULL, filename, sizeof(filename))) < 0)
+  {
+    testEndMessage(false, "unable to create temporary file: %s", strerror(errno));
+    return (1);
+  }
+
+  if (write(fd, test->data, test->length) != (ssize_t)test->length || lseek(fd, 0, SEEK_SET) != 0)
+  {
+    testEndMessage(false, "unable to write temporary file: %s", strerror(errno));
+    close(fd);
+    unlink(filename);
+    return (1);
+  }
+
+  request = ippNewRequest(IPP_OP_PRINT_JOB);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri", NULL, "ipp://127.0.0.1/ipp/print");
+
+  if ((status = cupsSendRequest(http, request, "/ipp/print", ippLength(request) + test->length)) != HTTP_STATUS_CONTINUE)
+  {
+    testEndMessage(false, "cupsSendRequest returned %s", httpStatusString(status));
+    ippDelete(request);
+    close(fd);
+    unlink(filename);
+    return (1);
+  }
+
+  status = cupsWriteRequestFd(http, fd, 0);
+
+  close(fd);
+  unlink(filename);
+
+  if (status != HTTP_STATUS_CONTINUE)
+  {
+    testEndMessage(false, "cupsWriteRequestFd returned %s", httpStatusString(status));
+    ippDelete(request);
+    return (1);
+  }
+
+ /*
+  * The final call to httpWriteFd() sees no more data, which must not
+  * finish the request a second time...
+  */
+
+  response = cupsGetResponse(http, "/ipp/print");
+
+  ippDelete(request);
+
+  if (!response || cupsLastError() >= IPP_STATUS_ERROR_BAD_REQUEST)
+  {
+    testEndMessage(false, "%s", cupsLastErrorString());
+    ippDelete(response);
+    return (1);
+  }
+
+  ippDelete(response);
+
+  testEnd(true);
 
   return (0);
 }
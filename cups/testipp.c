@@ -13,9 +13,11 @@
  * Include necessary headers...
  */
 
+#include "cups.h"
 #include "file.h"
 #include "string-private.h"
 #include "ipp-private.h"
+#include "thread.h"
 #include "test-internal.h"
 #ifdef _WIN32
 #  include <io.h>
@@ -291,7 +293,10 @@ static ipp_uchar_t mixed[] =		/* Mixed value buffer */
 void	print_attributes(ipp_t *ipp, int indent);
 ssize_t	read_cb(_ippdata_t *data, ipp_uchar_t *buffer, size_t bytes);
 ssize_t	read_hex(cups_file_t *fp, ipp_uchar_t *buffer, size_t bytes);
+bool	string_tests(void);
+void	*string_thread(void *data);
 bool	token_cb(ipp_file_t *f, void *user_data, const char *token);
+bool	token_tests(void);
 ssize_t	write_cb(_ippdata_t *data, ipp_uchar_t *buffer, size_t bytes);
 
 
@@ -315,7 +320,10 @@ main(int  argc,			/* I - Number of command-line arguments */
   size_t	length;		/* Length of data */
   cups_file_t	*fp;		/* File pointer */
   size_t	i;		/* Looping var */
+  char		value[32];	/* String value */
   int		status;		/* Status of tests (0 = success, 1 = fail) */
+  cups_json_t	*stats,		/* Statistics */
+		*ippstats;	/* IPP statistics */
 #ifdef DEBUG
   const char	*name;		/* Option name */
 #endif /* DEBUG */
@@ -656,8 +664,196 @@ main(int  argc,			/* I - Number of command-line arguments */
     else
       testEnd(true);
 
+   /*
+    * Test indexed find with enough attributes to build the name index...
+    */
+
+    testBegin("ippFindAttribute(indexed)");
+
+    for (i = 0; i < 50; i ++)
+    {
+      snprintf(value, sizeof(value), "index-test-%u", (unsigned)i);
+      ippAddInteger(request, IPP_TAG_JOB, IPP_TAG_INTEGER, value, (int)i);
+    }
+
+    for (i = 0; i < 50; i ++)
+    {
+      snprintf(value, sizeof(value), "INDEX-test-%u", (unsigned)i);
+      if ((attr = ippFindAttribute(request, value, IPP_TAG_INTEGER)) == NULL || ippGetInteger(attr, 0) != (int)i)
+        break;
+    }
+
+    if (i < 50)
+    {
+      testEndMessage(false, "index-test-%u not found", (unsigned)i);
+      status = 1;
+    }
+    else if ((attr = ippFindAttribute(request, "media-col/media-size/x-dimension", IPP_TAG_INTEGER)) == NULL || ippGetInteger(attr, 0) != 21590)
+    {
+      testEndMessage(false, "media-col/media-size/x-dimension not found");
+      status = 1;
+    }
+    else if ((attr = ippFindNextAttribute(request, "media-col/media-size/x-dimension", IPP_TAG_INTEGER)) == NULL || ippGetInteger(attr, 0) != 21000)
+    {
+      testEndMessage(false, "second media-col/media-size/x-dimension not found");
+      status = 1;
+    }
+    else if (ippFindAttribute(request, "index-test-50", IPP_TAG_ZERO) != NULL)
+    {
+      testEndMessage(false, "found index-test-50");
+      status = 1;
+    }
+    else
+    {
+      ippDeleteAttribute(request, ippFindAttribute(request, "index-test-10", IPP_TAG_INTEGER));
+
+      attr = ippFindAttribute(request, "index-test-20", IPP_TAG_INTEGER);
+      ippSetName(request, &attr, "index-test-renamed");
+
+      ippAddInteger(request, IPP_TAG_JOB, IPP_TAG_INTEGER, "index-test-10", 100);
+
+      if ((attr = ippFindAttribute(request, "index-test-10", IPP_TAG_INTEGER)) == NULL || ippGetInteger(attr, 0) != 100)
+      {
+        testEndMessage(false, "index-test-10 not replaced");
+        status = 1;
+      }
+      else if (ippFindAttribute(request, "index-test-20", IPP_TAG_ZERO) != NULL)
+      {
+        testEndMessage(false, "found index-test-20 after rename");
+        status = 1;
+      }
+      else if ((attr = ippFindAttribute(request, "index-test-renamed", IPP_TAG_INTEGER)) == NULL || ippGetInteger(attr, 0) != 20)
+      {
+        testEndMessage(false, "index-test-renamed not found");
+        status = 1;
+      }
+      else if ((attr = ippFindAttribute(request, "index-test-11", IPP_TAG_INTEGER)) == NULL || ippGetInteger(attr, 0) != 11)
+      {
+        testEndMessage(false, "index-test-11 not found");
+        status = 1;
+      }
+      else
+        testEnd(true);
+    }
+
     ippDelete(request);
 
+   /*
+    * Read the data back into an arena message and confirm...
+    */
+
+    testBegin("Read Sample into Arena");
+
+    request   = ippNewWithArena();
+    data.rpos = 0;
+
+    while ((state = ippReadIO(&data, (ipp_io_cb_t)read_cb, 1, NULL, request)) != IPP_STATE_DATA)
+    {
+      if (state == IPP_STATE_ERROR)
+	break;
+    }
+
+    if (state != IPP_STATE_DATA)
+    {
+      testEndMessage(false, "%d bytes read", (int)data.rpos);
+      status = 1;
+    }
+    else if ((length = ippLength(request)) != sizeof(collection))
+    {
+      testEndMessage(false, "wrong ippLength(), %d instead of %d bytes", (int)length, (int)sizeof(collection));
+      print_attributes(request, 8);
+      status = 1;
+    }
+    else if ((attr = ippFindAttribute(request, "media-col/media-size/y-dimension", IPP_TAG_INTEGER)) == NULL || ippGetInteger(attr, 0) != 27940)
+    {
+      testEndMessage(false, "media-col/media-size/y-dimension not found or wrong value");
+      status = 1;
+    }
+    else
+      testEnd(true);
+
+    testBegin("ippSetString(arena-test)");
+
+    attr = ippAddString(request, IPP_TAG_JOB, IPP_TAG_KEYWORD, "arena-test", NULL, "value-0");
+    for (i = 1; attr && i < 100; i ++)
+    {
+      snprintf(value, sizeof(value), "value-%u", (unsigned)i);
+      if (!ippSetString(request, &attr, i, value))
+        break;
+    }
+
+    if (!attr || ippGetCount(attr) != 100)
+    {
+      testEndMessage(false, "got %u values, expected 100", (unsigned)ippGetCount(attr));
+      status = 1;
+    }
+    else if (strcmp(ippGetString(attr, 0, NULL), "value-0") || strcmp(ippGetString(attr, 99, NULL), "value-99"))
+    {
+      testEndMessage(false, "got \"%s\" and \"%s\", expected \"value-0\" and \"value-99\"", ippGetString(attr, 0, NULL), ippGetString(attr, 99, NULL));
+      status = 1;
+    }
+    else if (ippFindAttribute(request, "arena-test", IPP_TAG_KEYWORD) != attr)
+    {
+      testEndMessage(false, "attribute not found in message");
+      status = 1;
+    }
+    else
+      testEnd(true);
+
+    ippDelete(request);
+
+   /*
+    * Read and write the sample again with statistics enabled...
+    */
+
+    testBegin("cupsGetStatistics");
+
+    cupsSetStatistics(true);
+
+    request   = ippNew();
+    data.rpos = 0;
+
+    while ((state = ippReadIO(&data, (ipp_io_cb_t)read_cb, 1, NULL, request)) != IPP_STATE_DATA)
+    {
+      if (state == IPP_STATE_ERROR)
+	break;
+    }
+
+    ippSetState(request, IPP_STATE_IDLE);
+    data.wused = 0;
+
+    while ((state = ippWriteIO(&data, (ipp_io_cb_t)write_cb, 1, NULL, request)) != IPP_STATE_DATA)
+    {
+      if (state == IPP_STATE_ERROR)
+	break;
+    }
+
+    cupsSetStatistics(false);
+    ippDelete(request);
+
+    stats    = cupsGetStatistics();
+    ippstats = cupsJSONFind(stats, "ipp");
+
+    if (!ippstats)
+    {
+      testEndMessage(false, "no \"ipp\" statistics");
+      status = 1;
+    }
+    else if (cupsJSONGetNumber(cupsJSONFind(ippstats, "reads")) != 1 || cupsJSONGetNumber(cupsJSONFind(ippstats, "read_bytes")) != sizeof(collection) || cupsJSONGetNumber(cupsJSONFind(ippstats, "read_attributes")) != 4)
+    {
+      testEndMessage(false, "got %g reads, %g bytes, %g attributes, expected 1, %d, 4", cupsJSONGetNumber(cupsJSONFind(ippstats, "reads")), cupsJSONGetNumber(cupsJSONFind(ippstats, "read_bytes")), cupsJSONGetNumber(cupsJSONFind(ippstats, "read_attributes")), (int)sizeof(collection));
+      status = 1;
+    }
+    else if (cupsJSONGetNumber(cupsJSONFind(ippstats, "writes")) != 1 || cupsJSONGetNumber(cupsJSONFind(ippstats, "write_bytes")) != sizeof(collection) || cupsJSONGetNumber(cupsJSONFind(ippstats, "write_attributes")) != 4)
+    {
+      testEndMessage(false, "got %g writes, %g bytes, %g attributes, expected 1, %d, 4", cupsJSONGetNumber(cupsJSONFind(ippstats, "writes")), cupsJSONGetNumber(cupsJSONFind(ippstats, "write_bytes")), cupsJSONGetNumber(cupsJSONFind(ippstats, "write_attributes")), (int)sizeof(collection));
+      status = 1;
+    }
+    else
+      testEnd(true);
+
+    cupsJSONDelete(stats);
+
    /*
     * Read the bad collection data and confirm we get an error...
     */
@@ -772,6 +968,13 @@ main(int  argc,			/* I - Number of command-line arguments */
     }
 #endif /* DEBUG */
 
+   /*
+    * Test ippFileReadToken()...
+    */
+
+    if (!token_tests())
+      status = 1;
+
    /*
     * Test _ippFindOption() private API...
     */
@@ -784,6 +987,13 @@ main(int  argc,			/* I - Number of command-line arguments */
       testEnd(false);
       status = 1;
     }
+
+   /*
+    * Test the string pool...
+    */
+
+    if (!string_tests())
+      status = 1;
   }
   else
   {
@@ -985,6 +1195,141 @@ read_hex(cups_file_t *fp,		/* I - File to read from */
 }
 
 
+/*
+ * 'string_tests()' - Test the pre-seeded and concurrent string pool.
+ */
+
+bool					/* O - `true` on success, `false` on failure */
+string_tests(void)
+{
+  bool		ret = true;		/* Return value */
+  size_t	i,			/* Looping var */
+		num_threads,		/* Number of threads started */
+		count,			/* Number of strings */
+		count2,			/* Number of strings after test */
+		abytes,			/* Allocated bytes */
+		abytes2;		/* Allocated bytes after test */
+  cups_array_t	*keywords;		/* IPP keywords */
+  const char	*keyword;		/* Current keyword */
+  char		*s;			/* Pool string */
+  cups_thread_t	threads[8];		/* Test threads */
+  const char	*message = NULL;	/* Thread error message */
+
+
+ /*
+  * ippNew() has already been called, so all of the IPP keywords should be in
+  * the pool and allocating them must not add any new strings...
+  */
+
+  testBegin("_cupsStrAlloc(IPP keywords)");
+
+  keywords = _ippCreateKeywordArray();
+
+  for (keyword = (const char *)cupsArrayGetFirst(keywords); keyword; keyword = (const char *)cupsArrayGetNext(keywords))
+  {
+    _cupsStrStatistics(&abytes, NULL);
+    s = _cupsStrAlloc(keyword);
+    _cupsStrStatistics(&abytes2, NULL);
+    _cupsStrFree(s);
+
+    if (!s || strcmp(s, keyword) || abytes != abytes2)
+    {
+      testEndMessage(false, "\"%s\" not pre-seeded", keyword);
+      ret = false;
+      break;
+    }
+  }
+
+  if (ret)
+    testEndMessage(true, "%u keywords", (unsigned)cupsArrayGetCount(keywords));
+
+  cupsArrayDelete(keywords);
+
+ /*
+  * Allocate and free the same strings from several threads at once...
+  */
+
+  testBegin("_cupsStrAlloc/_cupsStrFree(%u threads)", (unsigned)(sizeof(threads) / sizeof(threads[0])));
+
+  count = _cupsStrStatistics(&abytes, NULL);
+
+  for (num_threads = 0; num_threads < (sizeof(threads) / sizeof(threads[0])); num_threads ++)
+  {
+    if ((threads[num_threads] = cupsThreadCreate(string_thread, NULL)) == CUPS_THREAD_INVALID)
+      break;
+  }
+
+  for (i = 0; i < num_threads; i ++)
+  {
+    const char *tmessage = (const char *)cupsThreadWait(threads[i]);
+					/* Thread error message */
+
+    if (tmessage && !message)
+      message = tmessage;
+  }
+
+  count2 = _cupsStrStatistics(&abytes2, NULL);
+
+  if (num_threads < (sizeof(threads) / sizeof(threads[0])))
+  {
+    testEndMessage(false, "unable to create threads");
+    ret = false;
+  }
+  else if (message)
+  {
+    testEndMessage(false, "%s", message);
+    ret = false;
+  }
+  else if (count != count2 || abytes != abytes2)
+  {
+    testEndMessage(false, "%u strings/%u bytes before, %u strings/%u bytes after", (unsigned)count, (unsigned)abytes, (unsigned)count2, (unsigned)abytes2);
+    ret = false;
+  }
+  else
+    testEnd(true);
+
+  return (ret);
+}
+
+
+/*
+ * 'string_thread()' - Allocate and free pool strings from a thread.
+ */
+
+void *					/* O - `NULL` on success, error message on failure */
+string_thread(void *data)		/* I - Thread data (unused) */
+{
+  int		i, j;			/* Looping vars */
+  char		temp[256],		/* Temporary string */
+		*strings[64];		/* Pool strings */
+
+
+  (void)data;
+
+  for (i = 0; i < 1000; i ++)
+  {
+    for (j = 0; j < 64; j ++)
+    {
+      snprintf(temp, sizeof(temp), "string-pool-test-%d", j);
+
+      if ((strings[j] = _cupsStrAlloc(temp)) == NULL)
+        return ((void *)"_cupsStrAlloc failed");
+      else if (strcmp(strings[j], temp))
+        return ((void *)"_cupsStrAlloc returned the wrong string");
+      else if (_cupsStrRetain(strings[j]) != strings[j])
+        return ((void *)"_cupsStrRetain returned the wrong string");
+
+      _cupsStrFree(strings[j]);
+    }
+
+    for (j = 0; j < 64; j ++)
+      _cupsStrFree(strings[j]);
+  }
+
+  return (NULL);
+}
+
+
 /*
  * 'token_cb()' - Token callback for ASCII IPP data file parser.
  */
@@ -1007,6 +1352,120 @@ token_cb(ipp_file_t *f,			/* I - IPP file data */
 }
 
 
+/*
+ * 'token_tests()' - Test ippFileReadToken() and token caching.
+ */
+
+bool					/* O - `true` on success, `false` on failure */
+token_tests(void)
+{
+  bool		ret = true;		/* Return value */
+  cups_file_t	*fp;			/* Test file */
+  ipp_file_t	*file;			/* IPP data file */
+  int		pass;			/* Current pass */
+  size_t	i;			/* Looping var */
+  char		token[1024];		/* Token from file */
+  static const char *data =		/* Test file contents */
+    "# Comment line\n"
+    "  TOKEN1 \"quoted string\"\t'regex.*'\n"
+    "ATTR keyword{value,\"two\\nlines\"}# trailing comment\n"
+    "escaped\\ space \"multi\nline\" {\n"
+    "}last";
+  static const char * const tokens[] =	/* Expected tokens */
+  {
+    "TOKEN1",
+    "quoted string",
+    "regex.*",
+    "ATTR",
+    "keyword",
+    "{",
+    "value",
+    ",",
+    "two\nlines",
+    "}",
+    "escaped space",
+    "multi\nline",
+    "{",
+    "}",
+    "last"
+  };
+  static const int linenums[] =		/* Expected line numbers */
+  {
+    2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 4, 5, 5, 6, 6
+  };
+
+
+  if ((fp = cupsFileOpen("testipp.tokens", "w")) == NULL)
+  {
+    testBegin("ippFileReadToken");
+    testEndMessage(false, "%s", strerror(errno));
+    return (false);
+  }
+
+  cupsFilePuts(fp, data);
+  cupsFileClose(fp);
+
+  file = ippFileNew(NULL, NULL, NULL, NULL);
+  ippFileSetCache(file, true);
+
+ /*
+  * Read the file twice, the second time from the token cache...
+  */
+
+  for (pass = 0; pass < 2 && ret; pass ++)
+  {
+    testBegin("ippFileReadToken(%s)", pass ? "cached" : "uncached");
+
+    if (!ippFileOpen(file, "testipp.tokens", "r"))
+    {
+      testEndMessage(false, "%s", cupsLastErrorString());
+      ret = false;
+      break;
+    }
+
+    for (i = 0; i < (sizeof(tokens) / sizeof(tokens[0])); i ++)
+    {
+      if (!ippFileReadToken(file, token, sizeof(token)))
+      {
+        testEndMessage(false, "got EOF, expected \"%s\"", tokens[i]);
+        ret = false;
+        break;
+      }
+      else if (strcmp(token, tokens[i]))
+      {
+        testEndMessage(false, "got \"%s\", expected \"%s\"", token, tokens[i]);
+        ret = false;
+        break;
+      }
+      else if (ippFileGetLineNumber(file) != linenums[i])
+      {
+        testEndMessage(false, "got line %d for \"%s\", expected %d", ippFileGetLineNumber(file), token, linenums[i]);
+        ret = false;
+        break;
+      }
+    }
+
+    if (ret && ippFileReadToken(file, token, sizeof(token)))
+    {
+      testEndMessage(false, "got \"%s\", expected EOF", token);
+      ret = false;
+    }
+    else if (ret)
+    {
+      testEnd(true);
+    }
+
+    ippFileClose(file);
+  }
+
+  ippFileDelete(file);
+
+  unlink("testipp.tokens");
+
+  return (ret);
+}
+
+
 /*
  * 'write_cb()' - Write data into a buffer.
  */
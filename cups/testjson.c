@@ -12,6 +12,29 @@
 #include "test-internal.h"
 
 
+//
+// Local types...
+//
+
+typedef struct test_buffer_s		// Memory buffer for stream tests
+{
+  char		data[65536];		// Buffer data
+  size_t	used,			// Bytes used
+		pos,			// Current read position
+		max_read;		// Maximum bytes per read
+} test_buffer_t;
+
+
+//
+// Local functions...
+//
+
+static void	do_index_tests(void);
+static void	do_stream_tests(cups_json_t *json);
+static ssize_t	read_buffer(test_buffer_t *tb, char *buffer, size_t bytes);
+static ssize_t	write_buffer(test_buffer_t *tb, char *buffer, size_t bytes);
+
+
 //
 // 'main()' - Main entry.
 //
@@ -213,6 +236,25 @@ main(int  argc,				// I - Number of command-line arguments
       testEndMessage(false, "%s", cupsLastErrorString());
     }
 
+    testBegin("cupsJSONSaveString(empty array/object)");
+    parent = cupsJSONNew(NULL, NULL, CUPS_JTYPE_OBJECT);
+    cupsJSONNew(parent, cupsJSONNewKey(parent, NULL, "array"), CUPS_JTYPE_ARRAY);
+    cupsJSONNew(parent, cupsJSONNewKey(parent, NULL, "object"), CUPS_JTYPE_OBJECT);
+    if ((s = cupsJSONSaveString(parent)) != NULL)
+    {
+      testEndMessage(!strcmp(s, "{\"array\":[],\"object\":{}}"), "%s", s);
+      free(s);
+    }
+    else
+    {
+      testEndMessage(false, "%s", cupsLastErrorString());
+    }
+
+    cupsJSONDelete(parent);
+
+    do_stream_tests(json);
+    do_index_tests();
+
     testBegin("cupsJSONDelete(root)");
     cupsJSONDelete(json);
     testEnd(true);
@@ -244,3 +286,397 @@ main(int  argc,				// I - Number of command-line arguments
 
   return (0);
 }
+
+
+//
+// 'do_index_tests()' - Test indexed lookups in large arrays and objects.
+//
+
+static void
+do_index_tests(void)
+{
+  int		i;			// Looping var
+  cups_json_t	*object,		// Object node
+		*array,			// Array node
+		*loaded,		// Loaded object
+		*current;		// Current node
+  char		key[32],		// Key string
+		*s;			// JSON string
+
+
+  testBegin("cupsJSONNewKey(1000 keys)");
+  object = cupsJSONNew(NULL, NULL, CUPS_JTYPE_OBJECT);
+  array  = NULL;
+
+  for (i = 0, current = NULL; i < 1000; i ++)
+  {
+    snprintf(key, sizeof(key), "key%d", i);
+    current = cupsJSONNewKey(object, current, key);
+
+    if (i == 999)
+      array = current = cupsJSONNew(object, current, CUPS_JTYPE_ARRAY);
+    else
+      current = cupsJSONNewNumber(object, current, i);
+  }
+
+  for (i = 0, current = NULL; i < 1000; i ++)
+    current = cupsJSONNewNumber(array, current, i);
+
+  testEndMessage(cupsJSONGetCount(object) == 2000 && cupsJSONGetCount(array) == 1000, "%u children", (unsigned)cupsJSONGetCount(object));
+
+  testBegin("cupsJSONFind(1000 keys)");
+  for (i = 0; i < 999; i ++)
+  {
+    snprintf(key, sizeof(key), "key%d", i);
+    if ((current = cupsJSONFind(object, key)) == NULL || cupsJSONGetNumber(current) != i)
+      break;
+  }
+
+  if (i < 999)
+    testEndMessage(false, "'%s' not found", key);
+  else if (cupsJSONFind(object, "key999") != array)
+    testEndMessage(false, "'key999' not found");
+  else if (cupsJSONFind(object, "missing"))
+    testEndMessage(false, "'missing' found");
+  else
+    testEnd(true);
+
+  testBegin("cupsJSONGetChild(1000 values)");
+  for (i = 999; i >= 0; i --)
+  {
+    if ((current = cupsJSONGetChild(array, (size_t)i)) == NULL || cupsJSONGetNumber(current) != i)
+      break;
+  }
+
+  if (i >= 0)
+    testEndMessage(false, "child %d not found", i);
+  else if (cupsJSONGetChild(array, 1000))
+    testEndMessage(false, "child 1000 found");
+  else
+    testEnd(true);
+
+  testBegin("cupsJSONDelete('key500')");
+  current = cupsJSONFind(object, "key500");
+  cupsJSONDelete(current);
+  current = cupsJSONGetChild(object, 1000);
+  cupsJSONDelete(current);
+  testEndMessage(!cupsJSONFind(object, "key500") && cupsJSONGetNumber(cupsJSONFind(object, "key501")) == 501 && cupsJSONGetCount(object) == 1998, "%u children", (unsigned)cupsJSONGetCount(object));
+
+  testBegin("cupsJSONNewKey('key500')");
+  current = cupsJSONNewKey(object, NULL, "key500");
+  cupsJSONNewString(object, current, "again");
+  current = cupsJSONFind(object, "key500");
+  testEnd(current && cupsJSONGetType(current) == CUPS_JTYPE_STRING && !strcmp(cupsJSONGetString(current), "again"));
+
+  testBegin("cupsJSONLoadString(1000 keys)");
+  if ((s = cupsJSONSaveString(object)) != NULL)
+  {
+    if ((loaded = cupsJSONLoadString(s)) != NULL)
+    {
+      current = cupsJSONGetChild(cupsJSONFind(loaded, "key999"), 998);
+
+      if (cupsJSONGetCount(loaded) == 2000 && cupsJSONGetNumber(current) == 998)
+        testEnd(true);
+      else
+        testEndMessage(false, "%u children", (unsigned)cupsJSONGetCount(loaded));
+
+      cupsJSONDelete(cupsJSONFind(loaded, "key999"));
+      cupsJSONDelete(loaded);
+    }
+    else
+    {
+      testEndMessage(false, "%s", cupsLastErrorString());
+    }
+
+    free(s);
+  }
+  else
+  {
+    testEndMessage(false, "%s", cupsLastErrorString());
+  }
+
+  cupsJSONDelete(object);
+}
+
+
+//
+// 'do_stream_tests()' - Test the JSON stream reader and writer.
+//
+
+static void
+do_stream_tests(cups_json_t *json)	// I - JSON root object
+{
+  int			i;		// Looping var
+  test_buffer_t		tb;		// Memory buffer
+  cups_jreader_t	*jr;		// JSON stream reader
+  cups_jwriter_t	*jw;		// JSON stream writer
+  cups_jtoken_t		token;		// Current token
+  cups_json_t		*value;		// Loaded value
+  char			*s;		// JSON string
+  size_t		count;		// Number of tokens
+  bool			ret;		// Return value
+  static const cups_jtoken_t tokens[] =	// Expected tokens
+  {
+    CUPS_JTOKEN_ARRAY_START,
+    CUPS_JTOKEN_STRING,
+    CUPS_JTOKEN_NUMBER,
+    CUPS_JTOKEN_OBJECT_START,
+    CUPS_JTOKEN_KEY,
+    CUPS_JTOKEN_ARRAY_START,
+    CUPS_JTOKEN_ARRAY_END,
+    CUPS_JTOKEN_KEY,
+    CUPS_JTOKEN_OBJECT_START,
+    CUPS_JTOKEN_OBJECT_END,
+    CUPS_JTOKEN_OBJECT_END,
+    CUPS_JTOKEN_TRUE,
+    CUPS_JTOKEN_FALSE,
+    CUPS_JTOKEN_NULL,
+    CUPS_JTOKEN_ARRAY_END,
+    CUPS_JTOKEN_EOF
+  };
+  static const char * const invalid[] =	// Invalid JSON strings
+  {
+    "",
+    "[1,]",
+    "[1 2]",
+    "{\"a\":}",
+    "{\"a\" 1}",
+    "{1:2}",
+    "{\"a\":1]",
+    "[tru]",
+    "[\"\\x\"]",
+    "[\"\\u12g4\"]",
+    "[\"unterminated]",
+    "[1e]",
+    "[--1]"
+  };
+
+
+  // Write the whole tree and compare against cupsJSONSaveString...
+  memset(&tb, 0, sizeof(tb));
+
+  testBegin("cupsJSONWriterNew(buffer)");
+  jw = cupsJSONWriterNew((cups_json_cb_t)write_buffer, &tb);
+  testEnd(jw != NULL);
+
+  testBegin("cupsJSONWriterAddJSON(root)");
+  testEnd(cupsJSONWriterAddJSON(jw, json));
+
+  testBegin("cupsJSONWriterDelete()");
+  testEnd(cupsJSONWriterDelete(jw));
+
+  testBegin("cupsJSONWriterAddJSON(root) == cupsJSONSaveString(root)");
+  if ((s = cupsJSONSaveString(json)) != NULL)
+  {
+    tb.data[tb.used] = '\0';
+
+    if (!strcmp(tb.data, s))
+      testEnd(true);
+    else
+      testEndMessage(false, "got '%s', expected '%s'", tb.data, s);
+
+    free(s);
+  }
+  else
+  {
+    testEndMessage(false, "%s", cupsLastErrorString());
+  }
+
+  // Read it back one byte at a time...
+  tb.max_read = 1;
+
+  testBegin("cupsJSONReaderNew(buffer)");
+  jr = cupsJSONReaderNew((cups_json_cb_t)read_buffer, &tb);
+  testEnd(jr != NULL);
+
+  testBegin("cupsJSONReaderNext(root)");
+  token = cupsJSONReaderNext(jr);
+  testEndMessage(token == CUPS_JTOKEN_OBJECT_START, "%d", token);
+
+  testBegin("cupsJSONReaderLoad(root)");
+  if ((value = cupsJSONReaderLoad(jr)) != NULL)
+  {
+    if (cupsJSONGetCount(value) == cupsJSONGetCount(json) && cupsJSONReaderGetDepth(jr) == 0)
+      testEnd(true);
+    else
+      testEndMessage(false, "%u children, depth %u", (unsigned)cupsJSONGetCount(value), (unsigned)cupsJSONReaderGetDepth(jr));
+
+    cupsJSONDelete(value);
+  }
+  else
+  {
+    testEndMessage(false, "%s", cupsLastErrorString());
+  }
+
+  testBegin("cupsJSONReaderNext(end)");
+  token = cupsJSONReaderNext(jr);
+  testEndMessage(token == CUPS_JTOKEN_EOF, "%d", token);
+
+  cupsJSONReaderDelete(jr);
+
+  // Write a document with escapes and empty arrays/objects...
+  memset(&tb, 0, sizeof(tb));
+
+  testBegin("cupsJSONWriterAdd*(array)");
+  if ((jw = cupsJSONWriterNew((cups_json_cb_t)write_buffer, &tb)) != NULL)
+  {
+    ret = cupsJSONWriterAdd(jw, CUPS_JTYPE_ARRAY) &&
+	  cupsJSONWriterAddString(jw, "tab\tquote\"newline\nbell\a") &&
+	  cupsJSONWriterAddNumber(jw, -1.5) &&
+	  cupsJSONWriterAdd(jw, CUPS_JTYPE_OBJECT) &&
+	  cupsJSONWriterAddKey(jw, "empty-array") &&
+	  cupsJSONWriterAdd(jw, CUPS_JTYPE_ARRAY) &&
+	  cupsJSONWriterEnd(jw) &&
+	  cupsJSONWriterAddKey(jw, "empty-object") &&
+	  cupsJSONWriterAdd(jw, CUPS_JTYPE_OBJECT) &&
+	  cupsJSONWriterEnd(jw) &&
+	  cupsJSONWriterEnd(jw) &&
+	  cupsJSONWriterAdd(jw, CUPS_JTYPE_TRUE) &&
+	  cupsJSONWriterAdd(jw, CUPS_JTYPE_FALSE) &&
+	  cupsJSONWriterAdd(jw, CUPS_JTYPE_NULL) &&
+	  cupsJSONWriterEnd(jw);
+
+    ret = cupsJSONWriterDelete(jw) && ret;
+    tb.data[tb.used] = '\0';
+
+    if (ret && !strcmp(tb.data, "[\"tab\\tquote\\\"newline\\nbell\\u0007\",-1.5,{\"empty-array\":[],\"empty-object\":{}},true,false,null]"))
+      testEnd(true);
+    else if (ret)
+      testEndMessage(false, "got '%s'", tb.data);
+    else
+      testEndMessage(false, "%s", cupsLastErrorString());
+  }
+  else
+  {
+    testEndMessage(false, "%s", cupsLastErrorString());
+  }
+
+  testBegin("cupsJSONReaderNext(array)");
+  tb.max_read = 7;
+
+  if ((jr = cupsJSONReaderNew((cups_json_cb_t)read_buffer, &tb)) != NULL)
+  {
+    for (count = 0; count < (sizeof(tokens) / sizeof(tokens[0])); count ++)
+    {
+      if ((token = cupsJSONReaderNext(jr)) != tokens[count])
+        break;
+
+      if (token == CUPS_JTOKEN_STRING && strcmp(cupsJSONReaderGetString(jr), "tab\tquote\"newline\nbell\a"))
+        break;
+      else if (token == CUPS_JTOKEN_NUMBER && cupsJSONReaderGetNumber(jr) != -1.5)
+        break;
+      else if (token == CUPS_JTOKEN_KEY && strncmp(cupsJSONReaderGetString(jr), "empty-", 6))
+        break;
+    }
+
+    if (count < (sizeof(tokens) / sizeof(tokens[0])))
+      testEndMessage(false, "token %u is %d, expected %d", (unsigned)count, token, tokens[count]);
+    else
+      testEnd(true);
+
+    cupsJSONReaderDelete(jr);
+  }
+  else
+  {
+    testEndMessage(false, "%s", cupsLastErrorString());
+  }
+
+  testBegin("cupsJSONReaderSkip(object)");
+  tb.pos      = 0;
+  tb.max_read = sizeof(tb.data);
+
+  if ((jr = cupsJSONReaderNew((cups_json_cb_t)read_buffer, &tb)) != NULL)
+  {
+    while ((token = cupsJSONReaderNext(jr)) != CUPS_JTOKEN_OBJECT_START && token > CUPS_JTOKEN_EOF);
+
+    if (token == CUPS_JTOKEN_OBJECT_START && cupsJSONReaderSkip(jr) && (token = cupsJSONReaderNext(jr)) == CUPS_JTOKEN_TRUE)
+      testEnd(true);
+    else
+      testEndMessage(false, "%d", token);
+
+    cupsJSONReaderDelete(jr);
+  }
+  else
+  {
+    testEndMessage(false, "%s", cupsLastErrorString());
+  }
+
+  // Writer misuse...
+  memset(&tb, 0, sizeof(tb));
+
+  testBegin("cupsJSONWriterAddKey(array)");
+  if ((jw = cupsJSONWriterNew((cups_json_cb_t)write_buffer, &tb)) != NULL)
+  {
+    ret = cupsJSONWriterAdd(jw, CUPS_JTYPE_ARRAY) && !cupsJSONWriterAddKey(jw, "key");
+    ret = !cupsJSONWriterDelete(jw) && ret;
+    testEnd(ret);
+  }
+  else
+  {
+    testEndMessage(false, "%s", cupsLastErrorString());
+  }
+
+  // Invalid JSON data...
+  for (i = 0; i < (int)(sizeof(invalid) / sizeof(invalid[0])); i ++)
+  {
+    testBegin("cupsJSONReaderNext('%s')", invalid[i]);
+
+    memset(&tb, 0, sizeof(tb));
+    cupsCopyString(tb.data, invalid[i], sizeof(tb.data));
+    tb.used     = strlen(tb.data);
+    tb.max_read = 2;
+
+    if ((jr = cupsJSONReaderNew((cups_json_cb_t)read_buffer, &tb)) != NULL)
+    {
+      while ((token = cupsJSONReaderNext(jr)) > CUPS_JTOKEN_EOF);
+
+      testEndMessage(token == CUPS_JTOKEN_ERROR, "%d", token);
+
+      cupsJSONReaderDelete(jr);
+    }
+    else
+    {
+      testEndMessage(false, "%s", cupsLastErrorString());
+    }
+  }
+}
+
+
+//
+// 'read_buffer()' - Read from a memory buffer.
+//
+
+static ssize_t				// O - Bytes read
+read_buffer(test_buffer_t *tb,		// I - Memory buffer
+            char          *buffer,	// I - Read buffer
+            size_t        bytes)	// I - Size of read buffer
+{
+  if (bytes > (tb->used - tb->pos))
+    bytes = tb->used - tb->pos;
+  if (tb->max_read && bytes > tb->max_read)
+    bytes = tb->max_read;
+
+  memcpy(buffer, tb->data + tb->pos, bytes);
+  tb->pos += bytes;
+
+  return ((ssize_t)bytes);
+}
+
+
+//
+// 'write_buffer()' - Write to a memory buffer.
+//
+
+static ssize_t				// O - Bytes written or `-1` on error
+write_buffer(test_buffer_t *tb,		// I - Memory buffer
+             char          *buffer,	// I - Write buffer
+             size_t        bytes)	// I - Number of bytes
+{
+  if (bytes >= (sizeof(tb->data) - tb->used))
+    return (-1);
+
+  memcpy(tb->data + tb->used, buffer, bytes);
+  tb->used += bytes;
+
+  return ((ssize_t)bytes);
+}
@@ -18,13 +18,29 @@
 #include <math.h>
 
 
+/*
+ * Local types...
+ */
+
+typedef struct test_buffer_s		/* Memory buffer for raster data */
+{
+  unsigned char	*data;			/* Buffer data */
+  size_t	alloc,			/* Allocated bytes */
+		used,			/* Used bytes */
+		offset;			/* Read offset */
+} test_buffer_t;
+
+
 /*
  * Local functions...
  */
 
 static int	do_ras_file(const char *filename);
 static int	do_raster_tests(cups_raster_mode_t mode);
+static int	do_simd_tests(void);
 static void	print_changes(cups_page_header_t *header, cups_page_header_t *expected);
+static ssize_t	read_buffer(test_buffer_t *b, unsigned char *buffer, size_t length);
+static ssize_t	write_buffer(test_buffer_t *b, unsigned char *buffer, size_t length);
 
 
 /*
@@ -44,6 +60,7 @@ main(int  argc,				/* I - Number of command-line args */
     errors += do_raster_tests(CUPS_RASTER_WRITE_COMPRESSED);
     errors += do_raster_tests(CUPS_RASTER_WRITE_PWG);
     errors += do_raster_tests(CUPS_RASTER_WRITE_APPLE);
+    errors += do_simd_tests();
   }
   else
   {
@@ -519,6 +536,214 @@ do_raster_tests(cups_raster_mode_t mode)/* O - Write mode */
 }
 
 
+/*
+ * 'do_simd_tests()' - Test that SIMD, scalar, and threaded compression produce
+ *                     identical output.
+ */
+
+static int				/* O - Number of errors */
+do_simd_tests(void)
+{
+  int			i;		/* Looping var */
+  unsigned		x, y,		/* Looping vars */
+			bpp,		/* Bytes per pixel */
+			seed = 1;	/* Random number seed */
+  size_t		j,		/* Looping var */
+			len;		/* Length of segment */
+  cups_raster_t		*r;		/* Raster stream */
+  cups_page_header_t	header;		/* Page header */
+  test_buffer_t		simd,		/* SIMD output */
+			scalar,		/* Scalar output */
+			threaded;	/* Threaded output */
+  unsigned char		*data,		/* Raster data */
+			*ptr,		/* Pointer into raster data */
+			*line;		/* Line read back */
+  int			errors = 0;	/* Number of errors */
+  static const struct
+  {
+    cups_cspace_t	cspace;		/* Color space */
+    unsigned		num_colors,	/* Number of colors */
+			bits;		/* Bits per color */
+  }			formats[] =	/* Formats to test */
+  {
+    { CUPS_CSPACE_K,       1,  8 },
+    { CUPS_CSPACE_K,       1, 16 },
+    { CUPS_CSPACE_RGB,     3,  8 },
+    { CUPS_CSPACE_CMYK,    4,  8 },
+    { CUPS_CSPACE_RGB,     3, 16 },
+    { CUPS_CSPACE_CMYK,    4, 16 },
+    { CUPS_CSPACE_DEVICEF, 15, 16 }
+  };
+
+
+  for (i = 0; i < (int)(sizeof(formats) / sizeof(formats[0])); i ++)
+  {
+    memset(&header, 0, sizeof(header));
+    header.cupsWidth        = 1000;
+    header.cupsHeight       = 64;
+    header.cupsBitsPerColor = formats[i].bits;
+    header.cupsBitsPerPixel = formats[i].bits * formats[i].num_colors;
+    header.cupsBytesPerLine = header.cupsWidth * header.cupsBitsPerPixel / 8;
+    header.cupsColorSpace   = formats[i].cspace;
+    header.cupsColorOrder   = CUPS_ORDER_CHUNKED;
+    header.cupsNumColors    = formats[i].num_colors;
+    header.HWResolution[0]  = 100;
+    header.HWResolution[1]  = 100;
+
+    bpp = header.cupsBitsPerPixel / 8;
+
+    testBegin("cupsRasterWritePixels(%u bytes per pixel)", bpp);
+
+    if ((data = malloc(header.cupsBytesPerLine * header.cupsHeight)) == NULL || (line = malloc(header.cupsBytesPerLine)) == NULL)
+    {
+      testEndMessage(false, "%s", strerror(errno));
+      free(data);
+      return (errors + 1);
+    }
+
+   /*
+    * Build lines with a mix of repeated, random, and partially matching
+    * pixels, plus some repeated lines...
+    */
+
+    for (y = 0; y < header.cupsHeight; y ++)
+    {
+      ptr = data + y * header.cupsBytesPerLine;
+
+      if (y > 0 && (y % 7) == 0)
+      {
+        memcpy(ptr, ptr - header.cupsBytesPerLine, header.cupsBytesPerLine);
+        continue;
+      }
+
+      for (x = 0; x < header.cupsWidth; x += (unsigned)len)
+      {
+        seed = seed * 1103515245 + 12345;
+        len  = 1 + (seed >> 16) % 300;
+
+        if (len > (header.cupsWidth - x))
+          len = header.cupsWidth - x;
+
+        switch ((seed >> 8) & 3)
+        {
+          case 0 : /* Repeated pixel */
+              ptr[0] = (unsigned char)(seed >> 24);
+              memset(ptr + 1, (int)(seed & 255), bpp - 1);
+              for (j = 1; j < len; j ++)
+                memcpy(ptr + j * bpp, ptr, bpp);
+              break;
+
+          case 1 : /* Random pixels */
+              for (j = 0; j < len * bpp; j ++)
+              {
+                seed   = seed * 1103515245 + 12345;
+                ptr[j] = (unsigned char)(seed >> 16);
+              }
+              break;
+
+          case 2 : /* Pixels that differ in one byte */
+              memset(ptr, (int)(seed & 255), len * bpp);
+              for (j = 0; j < len; j ++)
+                ptr[j * bpp + j % bpp] = (unsigned char)j;
+              break;
+
+          default : /* Short runs of 1 to 3 pixels */
+              for (j = 0; j < len; j ++)
+                memset(ptr + j * bpp, (int)((j / (1 + (seed >> 20) % 3)) & 255), bpp);
+              break;
+        }
+
+        ptr += len * bpp;
+      }
+    }
+
+   /*
+    * Write the page with and without SIMD and compare...
+    */
+
+    memset(&simd, 0, sizeof(simd));
+    memset(&scalar, 0, sizeof(scalar));
+    memset(&threaded, 0, sizeof(threaded));
+
+    if ((r = cupsRasterOpenIO((cups_raster_cb_t)write_buffer, &simd, CUPS_RASTER_WRITE_COMPRESSED)) != NULL)
+    {
+      cupsRasterWriteHeader(r, &header);
+      cupsRasterWritePixels(r, data, header.cupsBytesPerLine * header.cupsHeight);
+      cupsRasterClose(r);
+    }
+
+    if ((r = cupsRasterOpenIO((cups_raster_cb_t)write_buffer, &scalar, CUPS_RASTER_WRITE_COMPRESSED)) != NULL)
+    {
+      _cupsRasterSetSIMD(r, false);
+      cupsRasterWriteHeader(r, &header);
+      cupsRasterWritePixels(r, data, header.cupsBytesPerLine * header.cupsHeight);
+      cupsRasterClose(r);
+    }
+
+    if ((r = cupsRasterOpenIO((cups_raster_cb_t)write_buffer, &threaded, CUPS_RASTER_WRITE_COMPRESSED)) != NULL)
+    {
+      cupsRasterSetThreads(r, 3);
+      cupsRasterWriteHeader(r, &header);
+      for (y = 0; y < header.cupsHeight; y ++)
+        cupsRasterWritePixels(r, data + y * header.cupsBytesPerLine, header.cupsBytesPerLine);
+      cupsRasterClose(r);
+    }
+
+   /*
+    * The writers are closed, so only the reader is closed below...
+    */
+
+    r = NULL;
+
+    if (!simd.used || simd.used != scalar.used || memcmp(simd.data, scalar.data, simd.used))
+    {
+      testEndMessage(false, "%u bytes with SIMD, %u bytes without", (unsigned)simd.used, (unsigned)scalar.used);
+      errors ++;
+    }
+    else if (simd.used != threaded.used || memcmp(simd.data, threaded.data, simd.used))
+    {
+      testEndMessage(false, "%u bytes with threads, %u bytes without", (unsigned)threaded.used, (unsigned)simd.used);
+      errors ++;
+    }
+    else if ((r = cupsRasterOpenIO((cups_raster_cb_t)read_buffer, &simd, CUPS_RASTER_READ)) == NULL || !cupsRasterReadHeader(r, &header))
+    {
+      testEndMessage(false, "unable to read page header");
+      errors ++;
+    }
+    else
+    {
+     /*
+      * Read the page back and compare...
+      */
+
+      for (y = 0; y < header.cupsHeight; y ++)
+      {
+        if (cupsRasterReadPixels(r, line, header.cupsBytesPerLine) != header.cupsBytesPerLine || memcmp(line, data + y * header.cupsBytesPerLine, header.cupsBytesPerLine))
+          break;
+      }
+
+      if (y < header.cupsHeight)
+      {
+        testEndMessage(false, "raster line %u corrupt", y);
+        errors ++;
+      }
+      else
+        testEndMessage(true, "%u bytes", (unsigned)simd.used);
+    }
+
+    cupsRasterClose(r);
+
+    free(simd.data);
+    free(scalar.data);
+    free(threaded.data);
+    free(data);
+    free(line);
+  }
+
+  return (errors);
+}
+
+
 /*
  * 'print_changes()' - Print differences in the page header.
  */
@@ -688,3 +913,52 @@ print_changes(
   if (strcmp(header->cupsPageSizeName, expected->cupsPageSizeName))
     testError("    cupsPageSizeName (%s), expected (%s)", header->cupsPageSizeName, expected->cupsPageSizeName);
 }
+
+
+/*
+ * 'read_buffer()' - Read raster data from a memory buffer.
+ */
+
+static ssize_t				/* O - Bytes read */
+read_buffer(test_buffer_t *b,		/* I - Buffer */
+            unsigned char *buffer,	/* I - Read buffer */
+            size_t        length)	/* I - Number of bytes to read */
+{
+  if (length > (b->used - b->offset))
+    length = b->used - b->offset;
+
+  memcpy(buffer, b->data + b->offset, length);
+  b->offset += length;
+
+  return ((ssize_t)length);
+}
+
+
+/*
+ * 'write_buffer()' - Write raster data to a memory buffer.
+ */
+
+static ssize_t				/* O - Bytes written */
+write_buffer(test_buffer_t *b,		/* I - Buffer */
+             unsigned char *buffer,	/* I - Write buffer */
+             size_t        length)	/* I - Number of bytes to write */
+{
+  if ((b->used + length) > b->alloc)
+  {
+    size_t		alloc;		/* New allocation size */
+    unsigned char	*data;		/* New buffer */
+
+    alloc = b->alloc + length + 65536;
+
+    if ((data = realloc(b->data, alloc)) == NULL)
+      return (-1);
+
+    b->data  = data;
+    b->alloc = alloc;
+  }
+
+  memcpy(b->data + b->used, buffer, length);
+  b->used += length;
+
+  return ((ssize_t)length);
+}
@@ -18,6 +18,24 @@
 #include <sys/stat.h>
 
 
+/*
+ * Local types...
+ */
+
+typedef struct _http_tls_context_s	/* Cached TLS credentials */
+{
+  gnutls_certificate_credentials_t credentials;
+					/* GNU TLS credentials (must be first) */
+  _http_mode_t		mode;		/* Client or server */
+  char			crtfile[1024],	/* Certificate file, if any */
+			keyfile[1024];	/* Private key file, if any */
+  time_t		crtmtime,	/* Modification time of certificate file */
+			keymtime;	/* Modification time of private key file */
+  size_t		ref_count;	/* Number of connections using credentials */
+  bool			stale;		/* Removed from cache? */
+} _http_tls_context_t;
+
+
 /*
  * Local globals...
  */
@@ -26,6 +44,10 @@ static int		tls_auto_create = 0;
 					/* Auto-create self-signed certs? */
 static char		*tls_common_name = NULL;
 					/* Default common name */
+static cups_array_t	*tls_contexts = NULL;
+					/* Cached TLS credentials */
+static gnutls_datum_t	tls_ticket_key = { NULL, 0 };
+					/* Server session ticket key */
 static gnutls_x509_crl_t tls_crl = NULL;/* Certificate revocation list */
 static char		*tls_keypath = NULL;
 					/* Server cert keychain path */
@@ -40,7 +62,10 @@ static int		tls_options = -1,/* Options for TLS connections */
  * Local functions...
  */
 
+static int		http_gnutls_compare_contexts(_http_tls_context_t *a, _http_tls_context_t *b, void *data);
+static gnutls_certificate_credentials_t *http_gnutls_copy_credentials(http_t *http, const char *crtfile, const char *keyfile, int *status);
 static gnutls_x509_crt_t http_gnutls_create_credential(http_credential_t *credential);
+static void		http_gnutls_free_credentials(gnutls_certificate_credentials_t *credentials);
 static const char	*http_gnutls_default_path(char *buffer, size_t bufsize);
 static void		http_gnutls_load_crl(void);
 static const char	*http_gnutls_make_path(char *buffer, size_t bufsize, const char *dirname, const char *filename, const char *ext);
@@ -869,6 +894,137 @@ httpSaveCredentials(
 }
 
 
+/*
+ * 'http_gnutls_compare_contexts()' - Compare two cached TLS credentials.
+ */
+
+static int				/* O - Result of comparison */
+http_gnutls_compare_contexts(
+    _http_tls_context_t *a,		/* I - First credentials */
+    _http_tls_context_t *b,		/* I - Second credentials */
+    void                *data)		/* I - Callback data (unused) */
+{
+  int	result;				/* Result of comparison */
+
+
+  (void)data;
+
+  if ((result = (int)a->mode - (int)b->mode) != 0)
+    return (result);
+  else if ((result = strcmp(a->crtfile, b->crtfile)) != 0)
+    return (result);
+  else
+    return (strcmp(a->keyfile, b->keyfile));
+}
+
+
+/*
+ * 'http_gnutls_copy_credentials()' - Get (cached) TLS credentials for a connection.
+ *
+ * Credentials are shared by all connections with the same mode and
+ * certificate/key files.  Server credentials are reloaded when the certificate
+ * or private key file changes.  The returned credentials must be released
+ * using `http_gnutls_free_credentials`.
+ */
+
+static gnutls_certificate_credentials_t *
+					/* O - Credentials or `NULL` on error */
+http_gnutls_copy_credentials(
+    http_t     *http,			/* I - HTTP connection */
+    const char *crtfile,		/* I - Certificate file or `NULL` */
+    const char *keyfile,		/* I - Private key file or `NULL` */
+    int        *status)			/* O - GNU TLS status code */
+{
+  _http_tls_context_t	key,		/* Search key */
+			*ctx;		/* Cached credentials */
+  struct stat		fileinfo;	/* File information */
+
+
+  memset(&key, 0, sizeof(key));
+  key.mode = http->mode;
+
+  if (crtfile)
+  {
+    cupsCopyString(key.crtfile, crtfile, sizeof(key.crtfile));
+    if (!stat(crtfile, &fileinfo))
+      key.crtmtime = fileinfo.st_mtime;
+  }
+
+  if (keyfile)
+  {
+    cupsCopyString(key.keyfile, keyfile, sizeof(key.keyfile));
+    if (!stat(keyfile, &fileinfo))
+      key.keymtime = fileinfo.st_mtime;
+  }
+
+  *status = 0;
+
+  cupsMutexLock(&tls_mutex);
+
+  if (!tls_contexts)
+    tls_contexts = cupsArrayNew((cups_array_cb_t)http_gnutls_compare_contexts, NULL, NULL, 0, NULL, NULL);
+
+  if ((ctx = (_http_tls_context_t *)cupsArrayFind(tls_contexts, &key)) != NULL && (ctx->crtmtime != key.crtmtime || ctx->keymtime != key.keymtime))
+  {
+   /*
+    * Certificate or key has changed, remove the old credentials from the
+    * cache and free them once the last connection using them is done...
+    */
+
+    DEBUG_printf(("4http_gnutls_copy_credentials: Reloading \"%s\" and \"%s\".", key.crtfile, key.keyfile));
+
+    cupsArrayRemove(tls_contexts, ctx);
+
+    if (ctx->ref_count == 0)
+    {
+      gnutls_certificate_free_credentials(ctx->credentials);
+      free(ctx);
+    }
+    else
+      ctx->stale = true;
+
+    ctx = NULL;
+  }
+
+  if (!ctx)
+  {
+   /*
+    * Create new credentials...
+    */
+
+    if ((ctx = (_http_tls_context_t *)malloc(sizeof(_http_tls_context_t))) == NULL)
+    {
+      *status = GNUTLS_E_MEMORY_ERROR;
+      cupsMutexUnlock(&tls_mutex);
+      return (NULL);
+    }
+
+    memcpy(ctx, &key, sizeof(_http_tls_context_t));
+
+    if ((*status = gnutls_certificate_allocate_credentials(&ctx->credentials)) == 0 && http->mode == _HTTP_MODE_SERVER)
+    {
+      if ((*status = gnutls_certificate_set_x509_key_file(ctx->credentials, key.crtfile, key.keyfile, GNUTLS_X509_FMT_PEM)) != 0)
+        gnutls_certificate_free_credentials(ctx->credentials);
+    }
+
+    if (*status)
+    {
+      free(ctx);
+      cupsMutexUnlock(&tls_mutex);
+      return (NULL);
+    }
+
+    cupsArrayAdd(tls_contexts, ctx);
+  }
+
+  ctx->ref_count ++;
+
+  cupsMutexUnlock(&tls_mutex);
+
+  return (&ctx->credentials);
+}
+
+
 /*
  * 'http_gnutls_create_credential()' - Create a single credential in the internal format.
  */
@@ -955,6 +1111,42 @@ http_gnutls_default_path(char   *buffer,/* I - Path buffer */
 }
 
 
+/*
+ * 'http_gnutls_free_credentials()' - Release cached TLS credentials.
+ */
+
+static void
+http_gnutls_free_credentials(
+    gnutls_certificate_credentials_t *credentials)
+					/* I - Credentials */
+{
+  _http_tls_context_t	*ctx;		/* Cached credentials */
+
+
+  if (!credentials)
+    return;
+
+ /*
+  * The credentials are the first member of the cache entry...
+  */
+
+  ctx = (_http_tls_context_t *)credentials;
+
+  cupsMutexLock(&tls_mutex);
+
+  if (ctx->ref_count > 0)
+    ctx->ref_count --;
+
+  if (ctx->stale && ctx->ref_count == 0)
+  {
+    gnutls_certificate_free_credentials(ctx->credentials);
+    free(ctx);
+  }
+
+  cupsMutexUnlock(&tls_mutex);
+}
+
+
 /*
  * 'http_gnutls_load_crl()' - Load the certificate revocation list, if any.
  */
@@ -1284,21 +1476,8 @@ _httpTLSStart(http_t *http)		/* I - Connection to server */
     return (false);
   }
 
-  credentials = (gnutls_certificate_credentials_t *)
-                    malloc(sizeof(gnutls_certificate_credentials_t));
-  if (credentials == NULL)
-  {
-    DEBUG_printf(("8_httpStartTLS: Unable to allocate credentials: %s",
-                  strerror(errno)));
-    http->error  = errno;
-    http->status = HTTP_STATUS_ERROR;
-    _cupsSetHTTPError(HTTP_STATUS_ERROR);
-
-    return (false);
-  }
-
-  gnutls_certificate_allocate_credentials(credentials);
-  status = gnutls_init(&http->tls, http->mode == _HTTP_MODE_CLIENT ? GNUTLS_CLIENT : GNUTLS_SERVER);
+  credentials = NULL;
+  status      = gnutls_init(&http->tls, http->mode == _HTTP_MODE_CLIENT ? GNUTLS_CLIENT : GNUTLS_SERVER);
   if (!status)
     status = gnutls_set_default_priority(http->tls);
 
@@ -1311,8 +1490,6 @@ _httpTLSStart(http_t *http)		/* I - Connection to server */
     _cupsSetError(IPP_STATUS_ERROR_CUPS_PKI, gnutls_strerror(status), 0);
 
     gnutls_deinit(http->tls);
-    gnutls_certificate_free_credentials(*credentials);
-    free(credentials);
     http->tls = NULL;
 
     return (false);
@@ -1341,6 +1518,24 @@ _httpTLSStart(http_t *http)		/* I - Connection to server */
     }
 
     status = gnutls_server_name_set(http->tls, GNUTLS_NAME_DNS, hostname, strlen(hostname));
+
+    if (!status)
+    {
+      unsigned char	*data;		/* Cached session data */
+      size_t		datalen;	/* Length of session data */
+
+     /*
+      * Try resuming a previous session with this host...
+      */
+
+      if ((datalen = http_tls_get_session(http, &data)) > 0)
+      {
+        gnutls_session_set_data(http->tls, data, datalen);
+        free(data);
+      }
+
+      credentials = http_gnutls_copy_credentials(http, NULL, NULL, &status);
+    }
   }
   else
   {
@@ -1443,6 +1638,8 @@ _httpTLSStart(http_t *http)		/* I - Connection to server */
 	http->status = HTTP_STATUS_ERROR;
 	_cupsSetError(IPP_STATUS_ERROR_INTERNAL, _("Unable to create server credentials."), 1);
 	cupsMutexUnlock(&tls_mutex);
+	gnutls_deinit(http->tls);
+	http->tls = NULL;
 
 	return (false);
       }
@@ -1452,7 +1649,19 @@ _httpTLSStart(http_t *http)		/* I - Connection to server */
 
     DEBUG_printf(("4_httpTLSStart: Using certificate \"%s\" and private key \"%s\".", crtfile, keyfile));
 
-    status = gnutls_certificate_set_x509_key_file(*credentials, crtfile, keyfile, GNUTLS_X509_FMT_PEM);
+    credentials = http_gnutls_copy_credentials(http, crtfile, keyfile, &status);
+
+   /*
+    * Use a common session ticket key so clients can resume sessions...
+    */
+
+    cupsMutexLock(&tls_mutex);
+    if (!status && !tls_ticket_key.data)
+      status = gnutls_session_ticket_key_generate(&tls_ticket_key);
+    cupsMutexUnlock(&tls_mutex);
+
+    if (!status)
+      status = gnutls_session_ticket_enable_server(http->tls, &tls_ticket_key);
   }
 
   if (!status)
@@ -1467,8 +1676,7 @@ _httpTLSStart(http_t *http)		/* I - Connection to server */
     _cupsSetError(IPP_STATUS_ERROR_CUPS_PKI, gnutls_strerror(status), 0);
 
     gnutls_deinit(http->tls);
-    gnutls_certificate_free_credentials(*credentials);
-    free(credentials);
+    http_gnutls_free_credentials(credentials);
     http->tls = NULL;
 
     return (false);
@@ -1570,10 +1778,12 @@ _httpTLSStart(http_t *http)		/* I - Connection to server */
       _cupsSetError(IPP_STATUS_ERROR_CUPS_PKI, gnutls_strerror(status), 0);
 
       gnutls_deinit(http->tls);
-      gnutls_certificate_free_credentials(*credentials);
-      free(credentials);
+      http_gnutls_free_credentials(credentials);
       http->tls = NULL;
 
+      if (http->mode == _HTTP_MODE_CLIENT)
+        http_tls_set_session(http, NULL, 0);
+
       httpSetTimeout(http, old_timeout, old_cb, old_data);
 
       return (false);
@@ -1586,6 +1796,8 @@ _httpTLSStart(http_t *http)		/* I - Connection to server */
 
   httpSetTimeout(http, old_timeout, old_cb, old_data);
 
+  DEBUG_printf(("4_httpTLSStart: Session %s.", gnutls_session_is_resumed(http->tls) ? "resumed" : "negotiated"));
+
   http->tls_credentials = credentials;
 
   return (true);
@@ -1602,6 +1814,21 @@ _httpTLSStop(http_t *http)		/* I - Connection to server */
   int	error;				/* Error code */
 
 
+  if (http->mode == _HTTP_MODE_CLIENT && (gnutls_protocol_get_version(http->tls) != GNUTLS_TLS1_3 || (gnutls_session_get_flags(http->tls) & GNUTLS_SFLAGS_SESSION_TICKET)))
+  {
+   /*
+    * Save the session so that the next connection to this host can resume it...
+    */
+
+    gnutls_datum_t	data;		/* Session data */
+
+    if (!gnutls_session_get_data2(http->tls, &data))
+    {
+      http_tls_set_session(http, data.data, data.size);
+      gnutls_free(data.data);
+    }
+  }
+
   error = gnutls_bye(http->tls, http->mode == _HTTP_MODE_CLIENT ? GNUTLS_SHUT_RDWR : GNUTLS_SHUT_WR);
   if (error != GNUTLS_E_SUCCESS)
     _cupsSetError(IPP_STATUS_ERROR_INTERNAL, gnutls_strerror(errno), 0);
@@ -1611,8 +1838,7 @@ _httpTLSStop(http_t *http)		/* I - Connection to server */
 
   if (http->tls_credentials)
   {
-    gnutls_certificate_free_credentials(*(http->tls_credentials));
-    free(http->tls_credentials);
+    http_gnutls_free_credentials(http->tls_credentials);
     http->tls_credentials = NULL;
   }
 }
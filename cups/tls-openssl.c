@@ -20,6 +20,24 @@
 #define USE_EC 0			// Set to 1 to generate EC certs
 
 
+/*
+ * Local types...
+ */
+
+typedef struct _http_tls_context_s	// Cached TLS context
+{
+  _http_mode_t	mode;			// Client or server
+  int		options,		// TLS options
+		min_version,		// Minimum TLS version
+		max_version;		// Maximum TLS version
+  char		crtfile[1024],		// Certificate file, if any
+		keyfile[1024];		// Private key file, if any
+  time_t	crtmtime,		// Modification time of certificate file
+		keymtime;		// Modification time of private key file
+  SSL_CTX	*context;		// OpenSSL context
+} _http_tls_context_t;
+
+
 /*
  * Local functions...
  */
@@ -31,7 +49,10 @@ static int		http_bio_puts(BIO *h, const char *str);
 static int		http_bio_read(BIO *h, char *buf, int size);
 static int		http_bio_write(BIO *h, const char *buf, int num);
 
+static int		http_compare_contexts(_http_tls_context_t *a, _http_tls_context_t *b, void *data);
+static SSL_CTX		*http_copy_context(http_t *http, const char *crtfile, const char *keyfile);
 static X509		*http_create_credential(http_credential_t *credential);
+static void		http_free_context(_http_tls_context_t *ctx, void *data);
 static const char	*http_default_path(char *buffer, size_t bufsize);
 static time_t		http_get_date(X509 *cert, int which);
 //static void		http_load_crl(void);
@@ -50,6 +71,8 @@ static BIO_METHOD	*tls_bio_method = NULL;
 					/* OpenSSL BIO method */
 static char		*tls_common_name = NULL;
 					/* Default common name */
+static cups_array_t	*tls_contexts = NULL;
+					/* Cached TLS contexts */
 //static X509_CRL		*tls_crl = NULL;/* Certificate revocation list */
 static char		*tls_keypath = NULL;
 					/* Server cert keychain path */
@@ -949,23 +972,8 @@ _httpTLSStart(http_t *http)		// I - Connection to server
 {
   BIO		*bio;			// Basic input/output context
   SSL_CTX	*context;		// Encryption context
-  char		hostname[256],		// Hostname
-		cipherlist[256];	// List of cipher suites
+  char		hostname[256];		// Hostname
   unsigned long	error;			// Error code, if any
-  static const uint16_t versions[] =	// SSL/TLS versions
-  {
-    TLS1_VERSION,			// No more SSL support in OpenSSL
-    TLS1_VERSION,			// TLS/1.0
-    TLS1_1_VERSION,			// TLS/1.1
-    TLS1_2_VERSION,			// TLS/1.2
-#ifdef TLS1_3_VERSION
-    TLS1_3_VERSION,			// TLS/1.3
-    TLS1_3_VERSION			// TLS/1.3 (max)
-#else
-    TLS1_2_VERSION,			// TLS/1.2
-    TLS1_2_VERSION			// TLS/1.2 (max)
-#endif // TLS1_3_VERSION
-  };
 
 
   DEBUG_printf(("3_httpTLSStart(http=%p)", http));
@@ -990,7 +998,13 @@ _httpTLSStart(http_t *http)		// I - Connection to server
   if (http->mode == _HTTP_MODE_CLIENT)
   {
     // Negotiate a TLS connection as a client...
-    context = SSL_CTX_new(TLS_client_method());
+    if ((context = http_copy_context(http, NULL, NULL)) == NULL)
+    {
+      http->status = HTTP_STATUS_ERROR;
+      http->error  = EIO;
+
+      return (false);
+    }
   }
   else
   {
@@ -1001,8 +1015,6 @@ _httpTLSStart(http_t *http)		// I - Connection to server
 		*cnptr;			// Pointer into common name
     bool	have_creds = false;	// Have credentials?
 
-    context = SSL_CTX_new(TLS_server_method());
-
     // Find the TLS certificate...
     if (http->fields[HTTP_FIELD_HOST])
     {
@@ -1091,7 +1103,6 @@ _httpTLSStart(http_t *http)		// I - Connection to server
 	http->error  = errno = EINVAL;
 	http->status = HTTP_STATUS_ERROR;
 	_cupsSetError(IPP_STATUS_ERROR_INTERNAL, _("Unable to create server credentials."), 1);
-	SSL_CTX_free(context);
         cupsMutexUnlock(&tls_mutex);
 
 	return (false);
@@ -1103,38 +1114,16 @@ _httpTLSStart(http_t *http)		// I - Connection to server
     DEBUG_printf(("4_httpTLSStart: Using private key file '%s'.", keyfile));
     DEBUG_printf(("4_httpTLSStart: Using certificate file '%s'.", crtfile));
 
-    if (!SSL_CTX_use_PrivateKey_file(context, keyfile, SSL_FILETYPE_PEM) || !SSL_CTX_use_certificate_chain_file(context, crtfile))
+    if ((context = http_copy_context(http, crtfile, keyfile)) == NULL)
     {
       // Unable to load private key or certificate...
-      DEBUG_puts("4_httpTLSStart: Unable to use private key or certificate chain file.");
-      if ((error = ERR_get_error()) != 0)
-        _cupsSetError(IPP_STATUS_ERROR_CUPS_PKI, ERR_error_string(error, NULL), 0);
-
       http->status = HTTP_STATUS_ERROR;
       http->error  = EIO;
 
-      SSL_CTX_free(context);
-
       return (false);
     }
   }
 
-  // Set TLS options...
-  cupsCopyString(cipherlist, "HIGH:!DH:+DHE", sizeof(cipherlist));
-  if ((tls_options & _HTTP_TLS_ALLOW_RC4) && http->mode == _HTTP_MODE_CLIENT)
-    cupsConcatString(cipherlist, ":+RC4", sizeof(cipherlist));
-  else
-    cupsConcatString(cipherlist, ":!RC4", sizeof(cipherlist));
-  if (tls_options & _HTTP_TLS_DENY_CBC)
-    cupsConcatString(cipherlist, ":!SHA1:!SHA256:!SHA384", sizeof(cipherlist));
-  cupsConcatString(cipherlist, ":@STRENGTH", sizeof(cipherlist));
-
-  DEBUG_printf(("4_httpTLSStart: cipherlist='%s', tls_min_version=%d, tls_max_version=%d", cipherlist, tls_min_version, tls_max_version));
-
-  SSL_CTX_set_min_proto_version(context, versions[tls_min_version]);
-  SSL_CTX_set_max_proto_version(context, versions[tls_max_version]);
-  SSL_CTX_set_cipher_list(context, cipherlist);
-
   // Setup a TLS session
   cupsMutexLock(&tls_mutex);
   if (!tls_bio_method)
@@ -1157,6 +1146,25 @@ _httpTLSStart(http_t *http)		// I - Connection to server
 
   if (http->mode == _HTTP_MODE_CLIENT)
   {
+    unsigned char	*data;		// Cached session data
+    size_t		datalen;	// Length of session data
+
+    // Try resuming a previous session with this host...
+    if ((datalen = http_tls_get_session(http, &data)) > 0)
+    {
+      const unsigned char *dataptr = data;
+					// Pointer into session data
+      SSL_SESSION	*session;	// Previous session
+
+      if ((session = d2i_SSL_SESSION(NULL, &dataptr, (long)datalen)) != NULL)
+      {
+        SSL_set_session(http->tls, session);
+        SSL_SESSION_free(session);
+      }
+
+      free(data);
+    }
+
     // Negotiate as a client...
     DEBUG_puts("4_httpTLSStart: Calling SSL_connect...");
     if (SSL_connect(http->tls) < 1)
@@ -1173,10 +1181,14 @@ _httpTLSStart(http_t *http)		// I - Connection to server
       SSL_free(http->tls);
       http->tls = NULL;
 
+      http_tls_set_session(http, NULL, 0);
+
       DEBUG_printf(("4_httpTLSStart: Returning false (%s)", ERR_error_string(error, NULL)));
 
       return (false);
     }
+
+    DEBUG_printf(("4_httpTLSStart: Session %s.", SSL_session_reused(http->tls) ? "resumed" : "negotiated"));
   }
   else
   {
@@ -1216,10 +1228,30 @@ void
 _httpTLSStop(http_t *http)		// I - Connection to server
 {
   SSL_CTX	*context;		// Context for encryption
+  SSL_SESSION	*session;		// Current session
 
 
   context = SSL_get_SSL_CTX(http->tls);
 
+  if (http->mode == _HTTP_MODE_CLIENT && (session = SSL_get1_session(http->tls)) != NULL)
+  {
+    // Save the session so that the next connection to this host can resume it...
+    int			datalen;	// Length of session data
+    unsigned char	*data,		// Session data
+			*dataptr;	// Pointer into session data
+
+    if (SSL_SESSION_is_resumable(session) && (datalen = i2d_SSL_SESSION(session, NULL)) > 0 && (data = malloc((size_t)datalen)) != NULL)
+    {
+      dataptr = data;
+      if (i2d_SSL_SESSION(session, &dataptr) == datalen)
+        http_tls_set_session(http, data, (size_t)datalen);
+
+      free(data);
+    }
+
+    SSL_SESSION_free(session);
+  }
+
   SSL_shutdown(http->tls);
   SSL_CTX_free(context);
   SSL_free(http->tls);
@@ -1403,6 +1435,177 @@ http_bio_write(BIO        *h,		// I - BIO data
 }
 
 
+//
+// 'http_compare_contexts()' - Compare two cached TLS contexts.
+//
+
+static int				// O - Result of comparison
+http_compare_contexts(
+    _http_tls_context_t *a,		// I - First context
+    _http_tls_context_t *b,		// I - Second context
+    void                *data)		// I - Callback data (unused)
+{
+  int	result;				// Result of comparison
+
+
+  (void)data;
+
+  if ((result = (int)a->mode - (int)b->mode) != 0)
+    return (result);
+  else if ((result = a->options - b->options) != 0)
+    return (result);
+  else if ((result = a->min_version - b->min_version) != 0)
+    return (result);
+  else if ((result = a->max_version - b->max_version) != 0)
+    return (result);
+  else if ((result = strcmp(a->crtfile, b->crtfile)) != 0)
+    return (result);
+  else
+    return (strcmp(a->keyfile, b->keyfile));
+}
+
+
+//
+// 'http_copy_context()' - Get a (cached) TLS context for a connection.
+//
+// Contexts are shared by all connections with the same mode, TLS options, and
+// certificate/key files.  Server contexts are reloaded when the certificate or
+// private key file changes.  The returned context must be freed using
+// `SSL_CTX_free`.
+//
+
+static SSL_CTX *			// O - TLS context or `NULL` on error
+http_copy_context(http_t     *http,	// I - HTTP connection
+                  const char *crtfile,	// I - Certificate file or `NULL`
+                  const char *keyfile)	// I - Private key file or `NULL`
+{
+  _http_tls_context_t	key,		// Search key
+			*ctx;		// Cached context
+  SSL_CTX		*context;	// OpenSSL context
+  struct stat		fileinfo;	// File information
+  char			cipherlist[256];// List of cipher suites
+  unsigned long		error;		// Error code, if any
+  static const uint16_t versions[] =	// SSL/TLS versions
+  {
+    TLS1_VERSION,			// No more SSL support in OpenSSL
+    TLS1_VERSION,			// TLS/1.0
+    TLS1_1_VERSION,			// TLS/1.1
+    TLS1_2_VERSION,			// TLS/1.2
+#ifdef TLS1_3_VERSION
+    TLS1_3_VERSION,			// TLS/1.3
+    TLS1_3_VERSION			// TLS/1.3 (max)
+#else
+    TLS1_2_VERSION,			// TLS/1.2
+    TLS1_2_VERSION			// TLS/1.2 (max)
+#endif // TLS1_3_VERSION
+  };
+
+
+  memset(&key, 0, sizeof(key));
+  key.mode        = http->mode;
+  key.options     = tls_options;
+  key.min_version = tls_min_version;
+  key.max_version = tls_max_version;
+
+  if (crtfile)
+  {
+    cupsCopyString(key.crtfile, crtfile, sizeof(key.crtfile));
+    if (!stat(crtfile, &fileinfo))
+      key.crtmtime = fileinfo.st_mtime;
+  }
+
+  if (keyfile)
+  {
+    cupsCopyString(key.keyfile, keyfile, sizeof(key.keyfile));
+    if (!stat(keyfile, &fileinfo))
+      key.keymtime = fileinfo.st_mtime;
+  }
+
+  cupsMutexLock(&tls_mutex);
+
+  if (!tls_contexts)
+    tls_contexts = cupsArrayNew((cups_array_cb_t)http_compare_contexts, NULL, NULL, 0, NULL, (cups_afree_cb_t)http_free_context);
+
+  if ((ctx = (_http_tls_context_t *)cupsArrayFind(tls_contexts, &key)) != NULL && (ctx->crtmtime != key.crtmtime || ctx->keymtime != key.keymtime))
+  {
+    // Certificate or key has changed, create a new context...
+    DEBUG_printf(("4http_copy_context: Reloading \"%s\" and \"%s\".", key.crtfile, key.keyfile));
+    cupsArrayRemove(tls_contexts, ctx);
+    ctx = NULL;
+  }
+
+  if (!ctx)
+  {
+    // Create a new context...
+    if ((context = SSL_CTX_new(http->mode == _HTTP_MODE_CLIENT ? TLS_client_method() : TLS_server_method())) == NULL)
+    {
+      if ((error = ERR_get_error()) != 0)
+        _cupsSetError(IPP_STATUS_ERROR_CUPS_PKI, ERR_error_string(error, NULL), 0);
+
+      cupsMutexUnlock(&tls_mutex);
+
+      return (NULL);
+    }
+
+    if (http->mode == _HTTP_MODE_SERVER)
+    {
+      if (!SSL_CTX_use_PrivateKey_file(context, key.keyfile, SSL_FILETYPE_PEM) || !SSL_CTX_use_certificate_chain_file(context, key.crtfile))
+      {
+	// Unable to load private key or certificate...
+	DEBUG_puts("4http_copy_context: Unable to use private key or certificate chain file.");
+	if ((error = ERR_get_error()) != 0)
+	  _cupsSetError(IPP_STATUS_ERROR_CUPS_PKI, ERR_error_string(error, NULL), 0);
+
+	SSL_CTX_free(context);
+	cupsMutexUnlock(&tls_mutex);
+
+	return (NULL);
+      }
+
+      SSL_CTX_set_session_id_context(context, (const unsigned char *)"CUPS", 4);
+    }
+
+    // Set TLS options...
+    cupsCopyString(cipherlist, "HIGH:!DH:+DHE", sizeof(cipherlist));
+    if ((tls_options & _HTTP_TLS_ALLOW_RC4) && http->mode == _HTTP_MODE_CLIENT)
+      cupsConcatString(cipherlist, ":+RC4", sizeof(cipherlist));
+    else
+      cupsConcatString(cipherlist, ":!RC4", sizeof(cipherlist));
+    if (tls_options & _HTTP_TLS_DENY_CBC)
+      cupsConcatString(cipherlist, ":!SHA1:!SHA256:!SHA384", sizeof(cipherlist));
+    cupsConcatString(cipherlist, ":@STRENGTH", sizeof(cipherlist));
+
+    DEBUG_printf(("4http_copy_context: cipherlist='%s', tls_min_version=%d, tls_max_version=%d", cipherlist, tls_min_version, tls_max_version));
+
+    SSL_CTX_set_min_proto_version(context, versions[tls_min_version]);
+    SSL_CTX_set_max_proto_version(context, versions[tls_max_version]);
+    SSL_CTX_set_cipher_list(context, cipherlist);
+
+    // Add it to the cache...
+    if ((ctx = (_http_tls_context_t *)malloc(sizeof(_http_tls_context_t))) == NULL)
+    {
+      SSL_CTX_free(context);
+      cupsMutexUnlock(&tls_mutex);
+
+      return (NULL);
+    }
+
+    memcpy(ctx, &key, sizeof(_http_tls_context_t));
+    ctx->context = context;
+
+    cupsArrayAdd(tls_contexts, ctx);
+  }
+
+  // Return a new reference to the cached context...
+  context = ctx->context;
+  SSL_CTX_up_ref(context);
+
+  cupsMutexUnlock(&tls_mutex);
+
+  return (context);
+}
+
+
 /*
  * 'http_create_credential()' - Create a single credential in the internal format.
  */
@@ -1481,6 +1684,22 @@ http_default_path(
 }
 
 
+//
+// 'http_free_context()' - Free a cached TLS context.
+//
+
+static void
+http_free_context(
+    _http_tls_context_t *ctx,		// I - Context
+    void                *data)		// I - Callback data (unused)
+{
+  (void)data;
+
+  SSL_CTX_free(ctx->context);
+  free(ctx);
+}
+
+
 //
 // 'http_get_date()' - Get the notBefore or notAfter date of a certificate.
 //
@@ -27,6 +27,42 @@
 #endif /* _WIN32 */
 
 
+/*
+ * Local types...
+ */
+
+typedef struct _http_tls_session_s	// Cached client TLS session
+{
+  char		key[HTTP_MAX_HOST + 8];	// "hostname:port"
+  time_t	used;			// Last time session was saved/used
+  size_t	datalen;		// Length of session data
+  unsigned char	*data;			// Serialized session data
+} _http_tls_session_t;
+
+
+/*
+ * Local functions...
+ */
+
+static int		http_tls_compare_sessions(_http_tls_session_t *a, _http_tls_session_t *b, void *data);
+static void		http_tls_free_session(_http_tls_session_t *s, void *data);
+static size_t		http_tls_get_session(http_t *http, unsigned char **data);
+static const char	*http_tls_session_key(http_t *http, char *buffer, size_t bufsize);
+static void		http_tls_set_session(http_t *http, const unsigned char *data, size_t datalen);
+
+
+/*
+ * Local globals...
+ */
+
+#define _HTTP_TLS_MAX_SESSIONS	64	// Maximum number of cached sessions
+
+static cups_mutex_t	tls_session_mutex = CUPS_MUTEX_INITIALIZER;
+					// Mutex for session cache
+static cups_array_t	*tls_sessions = NULL;
+					// Cached client sessions
+
+
 /*
  * Include platform-specific TLS code...
  */
@@ -38,3 +74,177 @@
 #    include "tls-gnutls.c"
 #  endif /* HAVE_OPENSSL */
 #endif /* HAVE_TLS */
+
+
+//
+// 'http_tls_compare_sessions()' - Compare two cached sessions.
+//
+
+static int				// O - Result of comparison
+http_tls_compare_sessions(
+    _http_tls_session_t *a,		// I - First session
+    _http_tls_session_t *b,		// I - Second session
+    void                *data)		// I - Callback data (unused)
+{
+  (void)data;
+
+  return (strcmp(a->key, b->key));
+}
+
+
+//
+// 'http_tls_free_session()' - Free a cached session.
+//
+
+static void
+http_tls_free_session(
+    _http_tls_session_t *s,		// I - Session
+    void                *data)		// I - Callback data (unused)
+{
+  (void)data;
+
+  free(s->data);
+  free(s);
+}
+
+
+//
+// 'http_tls_get_session()' - Get a copy of the cached session for a connection.
+//
+// The returned data must be freed using `free`.
+//
+
+static size_t				// O - Length of session data or `0` if none
+http_tls_get_session(
+    http_t        *http,		// I - HTTP connection
+    unsigned char **data)		// O - Session data
+{
+  _http_tls_session_t	key,		// Search key
+			*s;		// Matching session
+  size_t		datalen = 0;	// Length of session data
+
+
+  *data = NULL;
+
+  if (!http_tls_session_key(http, key.key, sizeof(key.key)))
+    return (0);
+
+  cupsMutexLock(&tls_session_mutex);
+
+  if ((s = (_http_tls_session_t *)cupsArrayFind(tls_sessions, &key)) != NULL && (*data = malloc(s->datalen)) != NULL)
+  {
+    memcpy(*data, s->data, s->datalen);
+    datalen = s->datalen;
+    s->used = time(NULL);
+  }
+
+  cupsMutexUnlock(&tls_session_mutex);
+
+  DEBUG_printf(("4http_tls_get_session(http=%p) key=\"%s\", returning %u", (void *)http, key.key, (unsigned)datalen));
+
+  return (datalen);
+}
+
+
+//
+// 'http_tls_session_key()' - Make the session cache key for a connection.
+//
+
+static const char *			// O - Key string or `NULL` if none
+http_tls_session_key(
+    http_t *http,			// I - HTTP connection
+    char   *buffer,			// I - Key buffer
+    size_t bufsize)			// I - Size of key buffer
+{
+  if (http->mode != _HTTP_MODE_CLIENT || !http->hostname[0] || !http->hostaddr)
+    return (NULL);
+
+  snprintf(buffer, bufsize, "%s:%d", http->hostname, httpAddrGetPort(http->hostaddr));
+
+  return (buffer);
+}
+
+
+//
+// 'http_tls_set_session()' - Save (or forget) the session for a connection.
+//
+// Passing `NULL` for the data removes any cached session for the connection.
+//
+
+static void
+http_tls_set_session(
+    http_t              *http,		// I - HTTP connection
+    const unsigned char *data,		// I - Session data or `NULL`
+    size_t              datalen)	// I - Length of session data
+{
+  _http_tls_session_t	key,		// Search key
+			*s,		// Matching session
+			*oldest;	// Least recently used session
+  unsigned char		*copy = NULL;	// Copy of session data
+
+
+  if (!http_tls_session_key(http, key.key, sizeof(key.key)))
+    return;
+
+  DEBUG_printf(("4http_tls_set_session(http=%p, data=%p, datalen=%u) key=\"%s\"", (void *)http, (void *)data, (unsigned)datalen, key.key));
+
+  if (data && datalen > 0)
+  {
+    if ((copy = malloc(datalen)) == NULL)
+      return;
+
+    memcpy(copy, data, datalen);
+  }
+
+  cupsMutexLock(&tls_session_mutex);
+
+  if (!tls_sessions)
+    tls_sessions = cupsArrayNew((cups_array_cb_t)http_tls_compare_sessions, NULL, NULL, 0, NULL, (cups_afree_cb_t)http_tls_free_session);
+
+  if ((s = (_http_tls_session_t *)cupsArrayFind(tls_sessions, &key)) != NULL)
+  {
+    if (copy)
+    {
+      // Replace existing session data...
+      free(s->data);
+      s->data    = copy;
+      s->datalen = datalen;
+      s->used    = time(NULL);
+    }
+    else
+    {
+      // Forget session...
+      cupsArrayRemove(tls_sessions, s);
+    }
+  }
+  else if (copy)
+  {
+    if (cupsArrayGetCount(tls_sessions) >= _HTTP_TLS_MAX_SESSIONS)
+    {
+      // Expire the least recently used session...
+      for (oldest = s = (_http_tls_session_t *)cupsArrayGetFirst(tls_sessions); s; s = (_http_tls_session_t *)cupsArrayGetNext(tls_sessions))
+      {
+        if (s->used < oldest->used)
+          oldest = s;
+      }
+
+      cupsArrayRemove(tls_sessions, oldest);
+    }
+
+    if ((s = calloc(1, sizeof(_http_tls_session_t))) != NULL)
+    {
+      cupsCopyString(s->key, key.key, sizeof(s->key));
+      s->data    = copy;
+      s->datalen = datalen;
+      s->used    = time(NULL);
+
+      cupsArrayAdd(tls_sessions, s);
+    }
+    else
+    {
+      free(copy);
+    }
+  }
+
+  cupsMutexUnlock(&tls_session_mutex);
+}
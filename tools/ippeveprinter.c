@@ -38,6 +38,9 @@ extern char **environ;
 #  include <sys/fcntl.h>
 #  include <sys/wait.h>
 #  include <poll.h>
+#  ifdef HAVE_SYS_EPOLL_H
+#    include <sys/epoll.h>
+#  endif /* HAVE_SYS_EPOLL_H */
 #endif /* _WIN32 */
 
 #ifndef O_BINARY
@@ -223,8 +226,24 @@ typedef struct ippeve_client_s		/**** Client data ****/
 					/* Authenticated username, if any */
   ippeve_printer_t	*printer;	/* Printer */
   ippeve_job_t		*job;		/* Current job, if any */
+  bool			first_time;	/* First request on connection? */
+  time_t		activity;	/* Time of last activity (event loop) */
+  struct ippeve_client_s *next;		/* Next client in event loop list */
 } ippeve_client_t;
 
+#ifndef _WIN32
+typedef struct ippeve_evloop_s		/**** Event loop data ****/
+{
+  cups_mutex_t		mutex;		/* Mutex for lists */
+  cups_cond_t		cond;		/* Condition for pending clients */
+  ippeve_client_t	*pending,	/* Clients waiting for a worker */
+			*pending_last,	/* Last client waiting for a worker */
+			*idle;		/* Clients returned by workers */
+  bool			stop;		/* Stop the workers? */
+  int			wakeup[2];	/* Pipe for waking up the event loop */
+} ippeve_evloop_t;
+#endif // !_WIN32
+
 
 /*
  * Local functions...
@@ -279,14 +298,21 @@ static int		pam_func(int, const struct pam_message **, struct pam_response **, v
 static size_t		parse_options(ippeve_client_t *client, cups_option_t **options);
 static void		process_attr_message(ippeve_job_t *job, char *message);
 static void		*process_client(ippeve_client_t *client);
+#ifndef _WIN32
+static void		*process_events(ippeve_evloop_t *evloop);
+#endif // !_WIN32
 static int		process_http(ippeve_client_t *client);
 static int		process_ipp(ippeve_client_t *client);
 static void		*process_job(ippeve_job_t *job);
+static bool		process_request(ippeve_client_t *client);
 static void		process_state_message(ippeve_job_t *job, char *message);
 static bool		register_printer(ippeve_printer_t *printer);
 static bool		respond_http(ippeve_client_t *client, http_status_t code, const char *content_coding, const char *type, size_t length);
 static void		respond_ipp(ippeve_client_t *client, ipp_status_t status, const char *message, ...) _CUPS_FORMAT(3, 4);
 static void		respond_unsupported(ippeve_client_t *client, ipp_attribute_t *attr);
+#ifndef _WIN32
+static void		run_event_loop(ippeve_printer_t *printer);
+#endif // !_WIN32
 static void		run_printer(ippeve_printer_t *printer);
 static int		show_media(ippeve_client_t *client);
 static int		show_status(ippeve_client_t *client);
@@ -310,7 +336,9 @@ static int		KeepFiles = 0,	/* Keep spooled job files? */
 static const char	*PAMService = NULL;
 					/* PAM service */
 #ifndef _WIN32
-static int		StopPrinter = 0;/* Stop the printer server? */
+static int		EventWorkers = 0,
+					/* Number of event loop workers (0 = thread per client) */
+			StopPrinter = 0;/* Stop the printer server? */
 #endif // !_WIN32
 
 
@@ -361,6 +389,22 @@ main(int  argc,				/* I - Number of command-line args */
     {
       usage(0);
     }
+#ifndef _WIN32
+    else if (!strcmp(argv[i], "--event-loop"))
+    {
+      i ++;
+      if (i >= argc)
+        usage(1);
+
+      EventWorkers = atoi(argv[i]);
+
+      if (EventWorkers < 1 || EventWorkers > 1024)
+      {
+        cupsLangPrintf(stderr, _("%s: Bad number of workers \"%s\"."), argv[0], argv[i]);
+        usage(1);
+      }
+    }
+#endif // !_WIN32
     else if (!strcmp(argv[i], "--no-web-forms"))
     {
       web_forms = false;
@@ -989,7 +1033,8 @@ create_client(ippeve_printer_t *printer,	/* I - Printer */
     return (NULL);
   }
 
-  client->printer = printer;
+  client->printer    = printer;
+  client->first_time = true;
 
  /*
   * Accept the client and get the remote address...
@@ -4974,46 +5019,91 @@ process_client(ippeve_client_t *client)	/* I - Client */
   * Loop until we are out of requests or timeout (30 seconds)...
   */
 
-  bool first_time = true;		/* First time request? */
-
   while (httpWait(client->http, 30000))
   {
-    if (first_time)
-    {
-     /*
-      * See if we need to negotiate a TLS connection...
-      */
+    if (!process_request(client))
+      break;
+  }
 
-      char buf[1];			/* First byte from client */
+ /*
+  * Close the conection to the client and return...
+  */
 
-      if (recv(httpGetFd(client->http), buf, 1, MSG_PEEK) == 1 && (!buf[0] || !strchr("DGHOPT", buf[0])))
-      {
-        fprintf(stderr, "%s Starting HTTPS session.\n", client->hostname);
+  delete_client(client);
 
-	if (!httpSetEncryption(client->http, HTTP_ENCRYPTION_ALWAYS))
-	{
-	  fprintf(stderr, "%s Unable to encrypt connection: %s\n", client->hostname, cupsLastErrorString());
-	  break;
-        }
+  return (NULL);
+}
 
-        fprintf(stderr, "%s Connection now encrypted.\n", client->hostname);
-      }
 
-      first_time = false;
-    }
+#ifndef _WIN32
+/*
+ * 'process_events()' - Process clients queued by the event loop.
+ */
+
+static void *				/* O - Exit status */
+process_events(ippeve_evloop_t *evloop)	/* I - Event loop */
+{
+  ippeve_client_t	*client;	/* Current client */
+  bool			keep;		/* Keep the connection open? */
+
+
+  cupsMutexLock(&evloop->mutex);
 
-    if (!process_http(client))
+  for (;;)
+  {
+   /*
+    * Wait for a client with a request...
+    */
+
+    while (!evloop->pending && !evloop->stop)
+      cupsCondWait(&evloop->cond, &evloop->mutex, 0.0);
+
+    if (evloop->stop)
       break;
-  }
 
- /*
-  * Close the conection to the client and return...
-  */
+    client = evloop->pending;
 
-  delete_client(client);
+    if ((evloop->pending = client->next) == NULL)
+      evloop->pending_last = NULL;
+
+    cupsMutexUnlock(&evloop->mutex);
+
+   /*
+    * Process the request plus any pipelined requests that are already
+    * buffered, since the event loop won't see those...
+    */
+
+    do
+    {
+      keep = process_request(client);
+    }
+    while (keep && httpGetReady(client->http) > 0);
+
+    if (!keep)
+    {
+      delete_client(client);
+      cupsMutexLock(&evloop->mutex);
+      continue;
+    }
+
+   /*
+    * Hand the connection back to the event loop...
+    */
+
+    cupsMutexLock(&evloop->mutex);
+
+    client->next = evloop->idle;
+    evloop->idle = client;
+
+    if (write(evloop->wakeup[1], "", 1) < 0 && errno != EAGAIN)
+      perror("Unable to wake up event loop");
+  }
+
+  cupsMutexUnlock(&evloop->mutex);
 
   return (NULL);
 }
+#endif // !_WIN32
 
 
 /*
@@ -6213,6 +6303,43 @@ process_job(ippeve_job_t *job)		/* I - Job */
 }
 
 
+/*
+ * 'process_request()' - Process a single request, starting TLS on the first
+ *                       request as needed.
+ */
+
+static bool				/* O - `true` to keep the connection, `false` to close it */
+process_request(
+    ippeve_client_t *client)		/* I - Client */
+{
+  if (client->first_time)
+  {
+   /*
+    * See if we need to negotiate a TLS connection...
+    */
+
+    char buf[1];			/* First byte from client */
+
+    if (recv(httpGetFd(client->http), buf, 1, MSG_PEEK) == 1 && (!buf[0] || !strchr("DGHOPT", buf[0])))
+    {
+      fprintf(stderr, "%s Starting HTTPS session.\n", client->hostname);
+
+      if (!httpSetEncryption(client->http, HTTP_ENCRYPTION_ALWAYS))
+      {
+	fprintf(stderr, "%s Unable to encrypt connection: %s\n", client->hostname, cupsLastErrorString());
+	return (false);
+      }
+
+      fprintf(stderr, "%s Connection now encrypted.\n", client->hostname);
+    }
+
+    client->first_time = false;
+  }
+
+  return (process_http(client) != 0);
+}
+
+
 /*
  * 'process_state_message()' - Process a STATE: message from a command.
  */
@@ -6629,6 +6756,380 @@ respond_unsupported(
 }
 
 
+#ifndef _WIN32
+/*
+ * 'run_event_loop()' - Run the printer service using an event loop and a
+ *                      fixed pool of worker threads.
+ *
+ * The event loop owns all idle connections and waits for them to become
+ * readable using epoll() or poll().  Connections with a request are queued
+ * for the workers, which hand them back once the request has been processed.
+ */
+
+static void
+run_event_loop(
+    ippeve_printer_t *printer)		/* I - Printer */
+{
+  int			i;		/* Looping var */
+  ippeve_evloop_t	evloop;		/* Event loop data */
+  cups_thread_t		*workers;	/* Worker threads */
+  int			num_workers;	/* Number of worker threads */
+  cups_array_t		*clients;	/* Idle clients */
+  ippeve_client_t	*client,	/* Current client */
+			*next,		/* Next client */
+			*added,		/* Clients to add to the loop */
+			*ready,		/* Clients to queue for the workers */
+			*ready_last;	/* Last client to queue */
+  time_t		curtime;	/* Current time */
+  char			buffer[256];	/* Wakeup data */
+#ifdef HAVE_SYS_EPOLL_H
+  int			epfd;		/* epoll() descriptor */
+  int			num_events;	/* Number of events */
+  struct epoll_event	event,		/* Event to add */
+			events[64];	/* Events from epoll_wait() */
+#else
+  nfds_t		num_fds,	/* Number of file descriptors */
+			alloc_fds = 0;	/* Allocated file descriptors */
+  struct pollfd		*polldata = NULL;/* poll() data */
+  ippeve_client_t	**pollclients = NULL;
+					/* Clients for poll() data */
+#endif /* HAVE_SYS_EPOLL_H */
+
+
+ /*
+  * Setup the wakeup pipe and worker threads...
+  */
+
+  memset(&evloop, 0, sizeof(evloop));
+
+  if (pipe(evloop.wakeup))
+  {
+    perror("Unable to create event loop pipe");
+    return;
+  }
+
+  fcntl(evloop.wakeup[0], F_SETFL, fcntl(evloop.wakeup[0], F_GETFL) | O_NONBLOCK);
+  fcntl(evloop.wakeup[1], F_SETFL, fcntl(evloop.wakeup[1], F_GETFL) | O_NONBLOCK);
+  fcntl(evloop.wakeup[0], F_SETFD, fcntl(evloop.wakeup[0], F_GETFD) | FD_CLOEXEC);
+  fcntl(evloop.wakeup[1], F_SETFD, fcntl(evloop.wakeup[1], F_GETFD) | FD_CLOEXEC);
+
+#ifdef HAVE_SYS_EPOLL_H
+  if ((epfd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+  {
+    perror("Unable to create epoll() descriptor");
+    close(evloop.wakeup[0]);
+    close(evloop.wakeup[1]);
+    return;
+  }
+
+ /*
+  * The listeners and wakeup pipe are identified by pointers to their file
+  * descriptors, everything else is a client...
+  */
+
+  event.events   = EPOLLIN;
+  event.data.ptr = &printer->ipv4;
+  epoll_ctl(epfd, EPOLL_CTL_ADD, printer->ipv4, &event);
+
+  event.data.ptr = &printer->ipv6;
+  epoll_ctl(epfd, EPOLL_CTL_ADD, printer->ipv6, &event);
+
+  event.data.ptr = evloop.wakeup;
+  epoll_ctl(epfd, EPOLL_CTL_ADD, evloop.wakeup[0], &event);
+#endif /* HAVE_SYS_EPOLL_H */
+
+  cupsMutexInit(&evloop.mutex);
+  cupsCondInit(&evloop.cond);
+
+  clients = cupsArrayNew(NULL, NULL, NULL, 0, NULL, NULL);
+
+  if ((workers = calloc((size_t)EventWorkers, sizeof(cups_thread_t))) == NULL)
+  {
+    perror("Unable to allocate memory for workers");
+    StopPrinter = 1;
+  }
+
+  for (num_workers = 0; workers && num_workers < EventWorkers; num_workers ++)
+  {
+    if ((workers[num_workers] = cupsThreadCreate((cups_thread_func_t)process_events, &evloop)) == 0)
+    {
+      perror("Unable to create worker thread");
+      StopPrinter = 1;
+      break;
+    }
+  }
+
+  if (Verbosity)
+    fprintf(stderr, "Using event loop with %d worker threads.\n", num_workers);
+
+ /*
+  * Loop until we are killed or have a hard error...
+  */
+
+  while (!StopPrinter)
+  {
+    added = ready = ready_last = NULL;
+
+#ifdef HAVE_SYS_EPOLL_H
+    if ((num_events = epoll_wait(epfd, events, (int)(sizeof(events) / sizeof(events[0])), 1000)) < 0)
+    {
+      if (errno != EINTR)
+      {
+	perror("epoll_wait() failed");
+	break;
+      }
+
+      num_events = 0;
+    }
+
+    if (StopPrinter)
+      break;
+
+    for (i = 0; i < num_events; i ++)
+    {
+      if (events[i].data.ptr == &printer->ipv4 || events[i].data.ptr == &printer->ipv6)
+      {
+        if ((client = create_client(printer, *((int *)events[i].data.ptr))) != NULL)
+        {
+          client->next = added;
+          added        = client;
+        }
+      }
+      else if (events[i].data.ptr == evloop.wakeup)
+      {
+        while (read(evloop.wakeup[0], buffer, sizeof(buffer)) > 0);
+      }
+      else
+      {
+        client = (ippeve_client_t *)events[i].data.ptr;
+
+        epoll_ctl(epfd, EPOLL_CTL_DEL, httpGetFd(client->http), NULL);
+
+        if (ready_last)
+          ready_last->next = client;
+        else
+          ready = client;
+
+        ready_last   = client;
+        client->next = NULL;
+      }
+    }
+
+#else
+    if ((num_fds = (nfds_t)(3 + cupsArrayGetCount(clients))) > alloc_fds)
+    {
+      struct pollfd	*temp;		/* New poll() data */
+      ippeve_client_t	**tempclients;	/* New clients for poll() data */
+
+      if ((temp = realloc(polldata, (size_t)(num_fds + 32) * sizeof(struct pollfd))) == NULL)
+      {
+        perror("Unable to allocate memory for event loop");
+        break;
+      }
+
+      polldata = temp;
+
+      if ((tempclients = realloc(pollclients, (size_t)(num_fds + 32) * sizeof(ippeve_client_t *))) == NULL)
+      {
+        perror("Unable to allocate memory for event loop");
+        break;
+      }
+
+      pollclients = tempclients;
+      alloc_fds   = num_fds + 32;
+    }
+
+    polldata[0].fd     = printer->ipv4;
+    polldata[0].events = POLLIN;
+    polldata[1].fd     = printer->ipv6;
+    polldata[1].events = POLLIN;
+    polldata[2].fd     = evloop.wakeup[0];
+    polldata[2].events = POLLIN;
+
+    for (i = 3, client = (ippeve_client_t *)cupsArrayGetFirst(clients); client; i ++, client = (ippeve_client_t *)cupsArrayGetNext(clients))
+    {
+      polldata[i].fd     = httpGetFd(client->http);
+      polldata[i].events = POLLIN;
+      pollclients[i]     = client;
+    }
+
+    if (poll(polldata, num_fds, 1000) < 0)
+    {
+      if (errno != EINTR)
+      {
+	perror("poll() failed");
+	break;
+      }
+
+      num_fds = 0;
+    }
+
+    if (StopPrinter)
+      break;
+
+    for (i = 0; i < (int)num_fds; i ++)
+    {
+      if (!(polldata[i].revents & (POLLIN | POLLERR | POLLHUP)))
+        continue;
+
+      if (i < 2)
+      {
+        if ((client = create_client(printer, polldata[i].fd)) != NULL)
+        {
+          client->next = added;
+          added        = client;
+        }
+      }
+      else if (i == 2)
+      {
+        while (read(evloop.wakeup[0], buffer, sizeof(buffer)) > 0);
+      }
+      else
+      {
+        client = pollclients[i];
+
+        if (ready_last)
+          ready_last->next = client;
+        else
+          ready = client;
+
+        ready_last   = client;
+        client->next = NULL;
+      }
+    }
+#endif /* HAVE_SYS_EPOLL_H */
+
+   /*
+    * Queue clients with requests for the workers...
+    */
+
+    if (ready)
+    {
+      for (client = ready; client; client = client->next)
+        cupsArrayRemove(clients, client);
+
+      cupsMutexLock(&evloop.mutex);
+
+      if (evloop.pending_last)
+        evloop.pending_last->next = ready;
+      else
+        evloop.pending = ready;
+
+      evloop.pending_last = ready_last;
+
+      cupsCondBroadcast(&evloop.cond);
+      cupsMutexUnlock(&evloop.mutex);
+    }
+
+   /*
+    * Add new clients and clients returned by the workers to the loop...
+    */
+
+    cupsMutexLock(&evloop.mutex);
+    client      = evloop.idle;
+    evloop.idle = NULL;
+    cupsMutexUnlock(&evloop.mutex);
+
+    for (; client; client = next)
+    {
+      next         = client->next;
+      client->next = added;
+      added        = client;
+    }
+
+    curtime = time(NULL);
+
+    for (client = added; client; client = next)
+    {
+      next             = client->next;
+      client->next     = NULL;
+      client->activity = curtime;
+
+#ifdef HAVE_SYS_EPOLL_H
+      event.events   = EPOLLIN;
+      event.data.ptr = client;
+
+      if (epoll_ctl(epfd, EPOLL_CTL_ADD, httpGetFd(client->http), &event))
+      {
+        perror("Unable to add client to event loop");
+        delete_client(client);
+        continue;
+      }
+#endif /* HAVE_SYS_EPOLL_H */
+
+      cupsArrayAdd(clients, client);
+    }
+
+   /*
+    * Close connections that have been idle for 30 seconds...
+    */
+
+    for (client = (ippeve_client_t *)cupsArrayGetFirst(clients); client; client = (ippeve_client_t *)cupsArrayGetNext(clients))
+    {
+      if ((curtime - client->activity) >= 30)
+      {
+        cupsArrayRemove(clients, client);
+        delete_client(client);
+      }
+    }
+
+    if (printer->dnssd_collision)
+      register_printer(printer);
+
+   /*
+    * Clean out old jobs...
+    */
+
+    clean_jobs(printer);
+  }
+
+ /*
+  * Stop the workers and close all connections...
+  */
+
+  cupsMutexLock(&evloop.mutex);
+  evloop.stop = true;
+  cupsCondBroadcast(&evloop.cond);
+  cupsMutexUnlock(&evloop.mutex);
+
+  for (i = 0; i < num_workers; i ++)
+    cupsThreadWait(workers[i]);
+
+  free(workers);
+
+  for (client = evloop.pending; client; client = next)
+  {
+    next = client->next;
+    delete_client(client);
+  }
+
+  for (client = evloop.idle; client; client = next)
+  {
+    next = client->next;
+    delete_client(client);
+  }
+
+  for (client = (ippeve_client_t *)cupsArrayGetFirst(clients); client; client = (ippeve_client_t *)cupsArrayGetNext(clients))
+    delete_client(client);
+
+  cupsArrayDelete(clients);
+
+#ifdef HAVE_SYS_EPOLL_H
+  close(epfd);
+#else
+  free(polldata);
+  free(pollclients);
+#endif /* HAVE_SYS_EPOLL_H */
+
+  close(evloop.wakeup[0]);
+  close(evloop.wakeup[1]);
+
+  cupsCondDestroy(&evloop.cond);
+  cupsMutexDestroy(&evloop.mutex);
+}
+#endif // !_WIN32
+
+
 /*
  * 'run_printer()' - Run the printer service.
  */
@@ -6648,6 +7149,16 @@ run_printer(ippeve_printer_t *printer)	/* I - Printer */
 
   signal(SIGINT, signal_handler);
   signal(SIGTERM, signal_handler);
+
+ /*
+  * Use the event loop if requested...
+  */
+
+  if (EventWorkers > 0)
+  {
+    run_event_loop(printer);
+    return;
+  }
 #endif // !_WIN32
 
  /*
@@ -7390,6 +7901,9 @@ usage(int status)			/* O - Exit status */
 {
   cupsLangPuts(stdout, _("Usage: ippeveprinter [options] \"name\""));
   cupsLangPuts(stdout, _("Options:"));
+#ifndef _WIN32
+  cupsLangPuts(stdout, _("--event-loop workers    Use an event loop with a pool of worker threads"));
+#endif // !_WIN32
   cupsLangPuts(stdout, _("--help                  Show program help"));
   cupsLangPuts(stdout, _("--no-web-forms          Disable web forms for media and supplies"));
   cupsLangPuts(stdout, _("--pam-service service   Use the named PAM service"));
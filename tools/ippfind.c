@@ -25,12 +25,21 @@
 #endif /* _WIN32 */
 #include <regex.h>
 #include <cups/dnssd.h>
+#include <cups/json.h>
 
 #ifndef _WIN32
 extern char **environ;			/* Process environment variables */
 #endif /* !_WIN32 */
 
 
+/*
+ * Local constants...
+ */
+
+#define IPPFIND_MAX_RESOLVES	50	/* Default simultaneous resolves */
+#define IPPFIND_RESOLVE_TIMEOUT	10.0	/* Seconds before giving up on a resolve */
+
+
 /*
  * Structures...
  */
@@ -67,6 +76,7 @@ typedef enum ippfind_op_e		/* Operations for expressions */
   /* "Output" operations */
   IPPFIND_OP_EXEC,			/* Execute when true */
   IPPFIND_OP_LIST,			/* List when true */
+  IPPFIND_OP_PRINT_JSON,		/* Print JSON record when true */
   IPPFIND_OP_PRINT_NAME,		/* Print URI when true */
   IPPFIND_OP_PRINT_URI,			/* Print name when true */
   IPPFIND_OP_QUIET			/* No output when true */
@@ -97,6 +107,7 @@ typedef struct ippfind_srvs_s		/* Services array */
 typedef struct ippfind_srv_s		/* Service information */
 {
   cups_dnssd_resolve_t *resolve;	/* Resolve request */
+  double	resolve_time;		/* Time resolve was started */
   char		*name,			/* Service name */
 		*domain,		/* Domain name */
 		*regtype,		/* Registration type */
@@ -112,6 +123,16 @@ typedef struct ippfind_srv_s		/* Service information */
 		is_resolved;		/* Got the resolve data? */
 } ippfind_srv_t;
 
+typedef struct ippfind_pool_s		/* Pool of evaluation threads */
+{
+  cups_mutex_t	mutex;			/* Mutex for queue */
+  cups_cond_t	cond;			/* Condition for queue */
+  cups_array_t	*queue;			/* Services waiting to be evaluated */
+  ippfind_expr_t *expressions;		/* Expression tree */
+  bool		done;			/* No more services are coming? */
+  int		status;			/* Exit status */
+} ippfind_pool_t;
+
 
 /*
  * Local globals...
@@ -132,11 +153,13 @@ static int	ipp_version = 20;	/* IPP version for LIST */
 static void		browse_callback(cups_dnssd_browse_t *browse, void *context, cups_dnssd_flags_t flags, uint32_t if_index, const char *serviceName, const char *regtype, const char *replyDomain);
 static int		compare_services(ippfind_srv_t *a, ippfind_srv_t *b);
 static int		eval_expr(ippfind_srv_t *service, ippfind_expr_t *expressions);
+static void		*eval_services(ippfind_pool_t *pool);
 static int		exec_program(ippfind_srv_t *service, size_t num_args, char **args);
 static ippfind_srv_t	*get_service(ippfind_srvs_t *services, const char *serviceName, const char *regtype, const char *replyDomain) _CUPS_NONNULL(1,2,3,4);
 static double		get_time(void);
 static int		list_service(ippfind_srv_t *service);
 static ippfind_expr_t	*new_expr(ippfind_op_t op, bool invert, const char *value, const char *regex, char **args);
+static int		print_json(ippfind_srv_t *service);
 static void		resolve_callback(cups_dnssd_resolve_t *resolve, void *context, cups_dnssd_flags_t flags, uint32_t if_index, const char *fullName, const char *hostTarget, uint16_t port, size_t num_txt, cups_option_t *txt);
 static void		set_service_uri(ippfind_srv_t *service);
 static void		show_usage(void) _CUPS_NORETURN;
@@ -174,6 +197,12 @@ main(int  argc,				/* I - Number of command-line args */
 					/* Logic for next expression */
   int			invert = 0;	/* Invert expression? */
   double		endtime;	/* End time */
+  size_t		events = 0;	/* Number of DNS-SD callbacks seen */
+  size_t		max_resolves = IPPFIND_MAX_RESOLVES;
+					/* Maximum number of active resolves */
+  int			num_workers = 1;/* Number of evaluation threads */
+  ippfind_pool_t	pool;		/* Evaluation thread pool */
+  cups_thread_t		workers[64];	/* Evaluation threads */
   static const char * const ops[] =	/* Node operation names */
   {
     "NONE",
@@ -194,6 +223,7 @@ main(int  argc,				/* I - Number of command-line args */
     "URI_REGEX",
     "EXEC",
     "LIST",
+    "PRINT_JSON",
     "PRINT_NAME",
     "PRINT_URI",
     "QUIET"
@@ -489,6 +519,14 @@ main(int  argc,				/* I - Number of command-line args */
 
           have_output = 1;
         }
+        else if (!strcmp(argv[i], "--print-json"))
+        {
+          if ((temp = new_expr(IPPFIND_OP_PRINT_JSON, invert, NULL, NULL,
+                               NULL)) == NULL)
+            exit(IPPFIND_EXIT_MEMORY);
+
+          have_output = 1;
+        }
         else if (!strcmp(argv[i], "--print-name"))
         {
           if ((temp = new_expr(IPPFIND_OP_PRINT_NAME, invert, NULL, NULL,
@@ -677,6 +715,26 @@ main(int  argc,				/* I - Number of command-line args */
 		  exit(IPPFIND_EXIT_MEMORY);
 		break;
 
+            case 'R' :
+                i ++;
+                if (i >= argc)
+		{
+		  cupsLangPrintf(stderr,
+				  _("%s: Missing count for \"-R\"."),
+				  "ippfind");
+		  show_usage();
+		}
+
+                if (atoi(argv[i]) < 1)
+                {
+                  cupsLangPrintf(stderr, _("%s: Bad count %s for \"-R\"."),
+                                  "ippfind", argv[i]);
+                  show_usage();
+                }
+
+                max_resolves = (size_t)atoi(argv[i]);
+                break;
+
             case 'T' :
                 i ++;
                 if (i >= argc)
@@ -746,6 +804,26 @@ main(int  argc,				/* I - Number of command-line args */
 		  exit(IPPFIND_EXIT_MEMORY);
                 break;
 
+            case 'j' :
+                i ++;
+                if (i >= argc)
+		{
+		  cupsLangPrintf(stderr,
+				  _("%s: Missing count for \"-j\"."),
+				  "ippfind");
+		  show_usage();
+		}
+
+                num_workers = atoi(argv[i]);
+
+                if (num_workers < 1 || num_workers > (int)(sizeof(workers) / sizeof(workers[0])))
+                {
+                  cupsLangPrintf(stderr, _("%s: Bad count %s for \"-j\"."),
+                                  "ippfind", argv[i]);
+                  show_usage();
+                }
+                break;
+
             case 'l' :
 		if ((temp = new_expr(IPPFIND_OP_LIST, invert, NULL, NULL,
 				     NULL)) == NULL)
@@ -1151,6 +1229,8 @@ main(int  argc,				/* I - Number of command-line args */
 
       if ((service->resolve = cupsDNSSDResolveNew(dnssd, CUPS_DNSSD_IF_INDEX_ANY, name, regtype, domain, resolve_callback, service)) == NULL)
         exit(IPPFIND_EXIT_BONJOUR);
+
+      service->resolve_time = get_time();
     }
     else
     {
@@ -1166,6 +1246,31 @@ main(int  argc,				/* I - Number of command-line args */
     }
   }
 
+ /*
+  * Start the evaluation threads, if any...
+  */
+
+  memset(&pool, 0, sizeof(pool));
+
+  if (num_workers > 1)
+  {
+    cupsMutexInit(&pool.mutex);
+    cupsCondInit(&pool.cond);
+
+    pool.queue       = cupsArrayNew(NULL, NULL, NULL, 0, NULL, NULL);
+    pool.expressions = expressions;
+    pool.status      = IPPFIND_EXIT_FALSE;
+
+    for (i = 0; i < num_workers; i ++)
+    {
+      if ((workers[i] = cupsThreadCreate((cups_thread_func_t)eval_services, &pool)) == CUPS_THREAD_INVALID)
+      {
+        perror("ippfind: Unable to create evaluation thread");
+        exit(IPPFIND_EXIT_MEMORY);
+      }
+    }
+  }
+
  /*
   * Process browse/resolve requests...
   */
@@ -1186,14 +1291,47 @@ main(int  argc,				/* I - Number of command-line args */
 		active = 0,		/* Number of active resolves */
 		resolved = 0,		/* Number of resolved services */
 		processed = 0;		/* Number of processed services */
+    double	curtime = get_time();	/* Current time */
 
     cupsRWLockRead(&services.rwlock);
-    for (j = 0, count = cupsArrayGetCount(services.services); j < count; j ++)
+
+    count = cupsArrayGetCount(services.services);
+
+   /*
+    * Count the resolves that are still pending, giving up on any that have
+    * not answered in a reasonable amount of time...
+    */
+
+    for (j = 0; j < count; j ++)
+    {
+      service = (ippfind_srv_t *)cupsArrayGetElement(services.services, j);
+
+      if (!service->resolve || service->is_resolved)
+        continue;
+
+      if ((curtime - service->resolve_time) < IPPFIND_RESOLVE_TIMEOUT)
+      {
+        active ++;
+        continue;
+      }
+
+      if (getenv("IPPFIND_DEBUG"))
+        fprintf(stderr, "TIMEOUT %s\n", service->fullName);
+
+      cupsDNSSDResolveDelete(service->resolve);
+      service->resolve      = NULL;
+      service->is_processed = true;
+    }
+
+    for (j = 0; j < count; j ++)
     {
       service = (ippfind_srv_t *)cupsArrayGetElement(services.services, j);
 
       if (service->is_processed)
+      {
 	processed ++;
+	continue;
+      }
 
       if (service->is_resolved)
 	resolved ++;
@@ -1201,36 +1339,46 @@ main(int  argc,				/* I - Number of command-line args */
       if (!service->resolve && !service->is_resolved)
       {
        /*
-	* Found a service, now resolve it (but limit to 50 active resolves...)
+	* Found a service, now resolve it (but limit the number of active
+	* resolves so we don't flood the network...)
 	*/
 
-	if (active < 50)
+	if (active < max_resolves)
 	{
 	  if ((service->resolve = cupsDNSSDResolveNew(dnssd, CUPS_DNSSD_IF_INDEX_ANY, service->name, service->regtype, service->domain, resolve_callback, service)) == NULL)
 	    exit(IPPFIND_EXIT_BONJOUR);
 
+	  service->resolve_time = curtime;
 	  active ++;
 	}
       }
-      else if (service->is_resolved && !service->is_processed)
+      else if (service->is_resolved)
       {
        /*
-	* Resolved, not process this service against the expressions...
+	* Resolved, now process this service against the expressions...
 	*/
 
 	cupsDNSSDResolveDelete(service->resolve);
-	service->resolve = NULL;
+	service->resolve      = NULL;
+	service->is_processed = true;
 
         if (getenv("IPPFIND_DEBUG"))
           fprintf(stderr, "EVAL %s\n", service->uri);
 
-	if (eval_expr(service, expressions))
-	  status = IPPFIND_EXIT_TRUE;
+        if (num_workers > 1)
+        {
+         /*
+          * Hand the service off to the evaluation threads...
+          */
 
-	service->is_processed = true;
+          cupsMutexLock(&pool.mutex);
+          cupsArrayAdd(pool.queue, service);
+          cupsCondBroadcast(&pool.cond);
+          cupsMutexUnlock(&pool.mutex);
+        }
+	else if (eval_expr(service, expressions))
+	  status = IPPFIND_EXIT_TRUE;
       }
-      else if (service->resolve)
-	active ++;
     }
     cupsRWUnlock(&services.rwlock);
 
@@ -1239,16 +1387,34 @@ main(int  argc,				/* I - Number of command-line args */
     */
 
     if (getenv("IPPFIND_DEBUG"))
-      fprintf(stderr, "STATUS processed=%u, resolved=%u, count=%u\n", (unsigned)processed, (unsigned)resolved, (unsigned)count);
+      fprintf(stderr, "STATUS processed=%u, resolved=%u, active=%u, count=%u\n", (unsigned)processed, (unsigned)resolved, (unsigned)active, (unsigned)count);
 
     if (processed > 0 && processed == cupsArrayGetCount(services.services) && bonjour_timeout <= 1.0)
       break;
 
    /*
-    * Give the browsers/resolvers some time...
+    * Wait for the browsers/resolvers to deliver more results...
     */
 
-    usleep(250000);
+    events = cupsDNSSDWait(dnssd, events, 250);
+  }
+
+ /*
+  * Wait for the evaluation threads to finish any queued services...
+  */
+
+  if (num_workers > 1)
+  {
+    cupsMutexLock(&pool.mutex);
+    pool.done = true;
+    cupsCondBroadcast(&pool.cond);
+    cupsMutexUnlock(&pool.mutex);
+
+    for (i = 0; i < num_workers; i ++)
+      cupsThreadWait(workers[i]);
+
+    if (pool.status == IPPFIND_EXIT_TRUE)
+      status = IPPFIND_EXIT_TRUE;
   }
 
   if (bonjour_error)
@@ -1398,6 +1564,9 @@ eval_expr(ippfind_srv_t  *service,	/* I - Service */
       case IPPFIND_OP_LIST :
           result = list_service(service);
           break;
+      case IPPFIND_OP_PRINT_JSON :
+          result = print_json(service);
+          break;
       case IPPFIND_OP_PRINT_NAME :
           cupsLangPuts(stdout, service->name);
           result = 1;
@@ -1424,6 +1593,49 @@ eval_expr(ippfind_srv_t  *service,	/* I - Service */
 }
 
 
+/*
+ * 'eval_services()' - Evaluate queued services in a worker thread.
+ */
+
+static void *				/* O - Thread exit status */
+eval_services(ippfind_pool_t *pool)	/* I - Thread pool */
+{
+  ippfind_srv_t	*service;		/* Current service */
+  int		result;			/* Result of evaluation */
+
+
+  cupsMutexLock(&pool->mutex);
+
+  for (;;)
+  {
+    if ((service = (ippfind_srv_t *)cupsArrayGetFirst(pool->queue)) != NULL)
+    {
+     /*
+      * Evaluate the next service without holding the lock so that other
+      * threads can run their programs at the same time...
+      */
+
+      cupsArrayRemove(pool->queue, service);
+      cupsMutexUnlock(&pool->mutex);
+
+      result = eval_expr(service, pool->expressions);
+
+      cupsMutexLock(&pool->mutex);
+      if (result)
+        pool->status = IPPFIND_EXIT_TRUE;
+    }
+    else if (pool->done)
+      break;
+    else
+      cupsCondWait(&pool->cond, &pool->mutex, 0.0);
+  }
+
+  cupsMutexUnlock(&pool->mutex);
+
+  return (NULL);
+}
+
+
 /*
  * 'exec_program()' - Execute a program for a service.
  */
@@ -1639,7 +1851,7 @@ exec_program(ippfind_srv_t *service,	/* I - Service */
     */
 
     execve(program, myargv, myenvp);
-    exit(1);
+    _exit(1);
   }
   else if (pid < 0)
   {
@@ -1650,10 +1862,11 @@ exec_program(ippfind_srv_t *service,	/* I - Service */
   else
   {
    /*
-    * Wait for it to complete...
+    * Wait for it to complete (other threads may be waiting for their own
+    * children, so only wait for ours...)
     */
 
-    while (wait(&status) != pid)
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
       ;
   }
 #endif /* _WIN32 */
@@ -2073,6 +2286,62 @@ new_expr(ippfind_op_t op,		/* I - Operation */
 }
 
 
+/*
+ * 'print_json()' - Print a JSON record for a service.
+ *
+ * Each record is written as a single line so that the output of concurrent
+ * evaluations is not interleaved.
+ */
+
+static int				/* O - 1 if successful, 0 otherwise */
+print_json(ippfind_srv_t *service)	/* I - Service */
+{
+  cups_json_t	*json,			/* JSON object for service */
+		*current,		/* Current node */
+		*txt;			/* TXT record object */
+  size_t	i;			/* Looping var */
+  char		*s;			/* JSON string */
+
+
+  if ((json = cupsJSONNew(NULL, NULL, CUPS_JTYPE_OBJECT)) == NULL)
+    return (0);
+
+  current = cupsJSONNewKey(json, NULL, "name");
+  current = cupsJSONNewString(json, current, service->name);
+  current = cupsJSONNewKey(json, current, "regtype");
+  current = cupsJSONNewString(json, current, service->regtype);
+  current = cupsJSONNewKey(json, current, "domain");
+  current = cupsJSONNewString(json, current, service->domain);
+  current = cupsJSONNewKey(json, current, "hostname");
+  current = cupsJSONNewString(json, current, service->host);
+  current = cupsJSONNewKey(json, current, "port");
+  current = cupsJSONNewNumber(json, current, service->port);
+  current = cupsJSONNewKey(json, current, "uri");
+  current = cupsJSONNewString(json, current, service->uri ? service->uri : "");
+  current = cupsJSONNewKey(json, current, "local");
+  current = cupsJSONNew(json, current, service->is_local ? CUPS_JTYPE_TRUE : CUPS_JTYPE_FALSE);
+  current = cupsJSONNewKey(json, current, "txt");
+  txt     = cupsJSONNew(json, current, CUPS_JTYPE_OBJECT);
+
+  for (i = 0, current = NULL; i < service->num_txt; i ++)
+  {
+    current = cupsJSONNewKey(txt, current, service->txt[i].name);
+    current = cupsJSONNewString(txt, current, service->txt[i].value);
+  }
+
+  s = cupsJSONSaveString(json);
+  cupsJSONDelete(json);
+
+  if (!s)
+    return (0);
+
+  puts(s);
+  free(s);
+
+  return (1);
+}
+
+
 /*
  * 'resolve_callback()' - Process resolve data.
  */
@@ -2205,8 +2474,10 @@ show_usage(void)
   cupsLangPuts(stderr, _("Options:"));
   cupsLangPuts(stderr, _("-4                      Connect using IPv4"));
   cupsLangPuts(stderr, _("-6                      Connect using IPv6"));
+  cupsLangPuts(stderr, _("-R count                Set the maximum number of simultaneous resolves"));
   cupsLangPuts(stderr, _("-T seconds              Set the browse timeout in seconds"));
   cupsLangPuts(stderr, _("-V version              Set default IPP version"));
+  cupsLangPuts(stderr, _("-j count                Evaluate up to count services at once"));
   cupsLangPuts(stderr, _("--version               Show program version"));
   cupsLangPuts(stderr, _("Expressions:"));
   cupsLangPuts(stderr, _("-P number[-number]      Match port to number or range"));
@@ -2234,6 +2505,7 @@ show_usage(void)
   cupsLangPuts(stderr, _("--path regex            Match resource path to regular expression"));
   cupsLangPuts(stderr, _("--port number[-number]  Match port to number or range"));
   cupsLangPuts(stderr, _("--print                 Print URI if true"));
+  cupsLangPuts(stderr, _("--print-json            Print JSON record if true"));
   cupsLangPuts(stderr, _("--print-name            Print service name if true"));
   cupsLangPuts(stderr, _("--quiet                 Quietly report match via exit code"));
   cupsLangPuts(stderr, _("--remote                True if service is remote"));
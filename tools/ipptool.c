@@ -594,6 +594,9 @@ main(int  argc,				/* I - Number of command-line args */
 	        cupsLangPuts(stderr, _("ipptool: \"-i\" and \"-n\" are incompatible with \"--ippserver\", \"-P\", and \"-X\"."));
 		usage();
 	      }
+
+	      // Cache the tokens from the test files for the repeated runs...
+	      ippFileSetCache(data->parent, true);
 	      break;
 
           case 'j' : /* JSON output */
@@ -620,6 +623,9 @@ main(int  argc,				/* I - Number of command-line args */
 	        cupsLangPuts(stderr, _("ipptool: \"-i\" and \"-n\" are incompatible with \"--ippserver\", \"-P\", and \"-X\"."));
 		usage();
 	      }
+
+	      // Cache the tokens from the test files for the repeated runs...
+	      ippFileSetCache(data->parent, true);
 	      break;
 
           case 'q' : /* Be quiet */
@@ -8,23 +8,31 @@
 # information.
 #
 
-# Run ippeveprinter to provide an endpoint for testing...
-name="Test Printer $(date +%H%M%S)"
 status=0
+: >test.log
 
-echo "Running ippeveprinter..."
-CUPS_DEBUG_LOG=test-cups.log CUPS_DEBUG_LEVEL=4 CUPS_DEBUG_FILTER='^(http|_http|ipp|_ipp|cupsDNSSD|cupsDo|cupsGet|cupsSend)' ./ippeveprinter-static -vvv -a test.conf "$name" 2>test.log &
-ippeveprinter=$!
+# Run ippeveprinter with the thread-per-client and event loop servers...
+for options in "" "--event-loop 4"; do
+    # Run ippeveprinter to provide an endpoint for testing...
+    name="Test Printer $(date +%H%M%S)"
+    if test -n "$options"; then
+        name="$name (event loop)"
+    fi
 
-# Test the instance...
-echo "Running ippfind + ipptool..."
-./ippfind-static -T 30 --literal-name "$name" --exec ./ipptool-static -V 2.0 -tIf ../examples/document-letter.pdf '{}' ../examples/ipp-2.0.test \; || status=1
+    echo "Running ippeveprinter $options..."
+    CUPS_DEBUG_LOG=test-cups.log CUPS_DEBUG_LEVEL=4 CUPS_DEBUG_FILTER='^(http|_http|ipp|_ipp|cupsDNSSD|cupsDo|cupsGet|cupsSend)' ./ippeveprinter-static -vvv $options -a test.conf "$name" 2>>test.log &
+    ippeveprinter=$!
 
-if test $status = 1; then
-    echo "Unable to find test printer."
-fi
+    # Test the instance...
+    echo "Running ippfind + ipptool..."
+    if ! ./ippfind-static -T 30 --literal-name "$name" --exec ./ipptool-static -V 2.0 -tIf ../examples/document-letter.pdf '{}' ../examples/ipp-2.0.test \; ; then
+        echo "Unable to find test printer."
+        status=1
+    fi
 
-# Clean up
-kill $ippeveprinter
+    # Clean up
+    kill $ippeveprinter
+    wait $ippeveprinter 2>/dev/null
+done
 
 exit $status
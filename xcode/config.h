@@ -97,6 +97,20 @@
 /* #undef HAVE_GETEUID */
 
 
+/*
+ * Do we have the sys/epoll.h header file?
+ */
+
+/* #undef HAVE_SYS_EPOLL_H */
+
+
+/*
+ * Do we have the sys/sendfile.h header file?
+ */
+
+/* #undef HAVE_SYS_SENDFILE_H */
+
+
 /*
  * Do we have the langinfo.h header file?
  */